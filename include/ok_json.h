@@ -50,6 +50,51 @@ typedef unsigned short  uint16_t;
 typedef unsigned char   uint8_t;
 #endif
 
+/**
+ * Wider unsigned types.  okj_u64 holds the words of the word-at-a-time (SWAR)
+ * scanners and packed key prefixes; okj_u32 backs OkjSize when
+ * OK_JSON_LARGE_DOCS is defined, and the key hashes and selection state sets.
+ * They carry the library's own names so that a caller who includes the
+ * platform's <stdint.h> alongside this header sees no conflicting typedefs.
+ */
+#ifdef OK_JSON_USE_STDINT_H
+typedef uint64_t okj_u64;
+typedef uint32_t okj_u32;
+#else
+typedef unsigned long long okj_u64;
+typedef unsigned int       okj_u32;
+#endif
+
+/**
+ * @brief On x86/x86-64 targets with SSE2, uncomment this define (or pass
+ * -DOK_JSON_USE_SSE2) to scan string bodies sixteen bytes at a time with
+ * <emmintrin.h> intrinsics.  The portable eight-byte SWAR scanner is used
+ * otherwise and for the tail of every run; results are identical either way.
+ * #define OK_JSON_USE_SSE2
+ **/
+
+/**
+ * @brief Uncomment this define (or pass -DOK_JSON_COMPACT_TOKENS) to store
+ * parsed tokens as a structure-of-arrays tape (OkJsonTape) of one-byte types
+ * and OkjSize offsets from parser->json, instead of an array of OkJsonToken
+ * with a full char pointer each.  On x86-64 this takes a token from 24 bytes
+ * to 9 and makes the parser relocatable with its input.  Read tokens through
+ * okj_token_at() so callers work with either layout.  The ACSL contracts
+ * describe the default layout, except that those of the token writers also
+ * name the tape.
+ * #define OK_JSON_COMPACT_TOKENS
+ **/
+
+/**
+ * @brief Uncomment this define (or pass -DOK_JSON_LARGE_DOCS) to widen every
+ * byte position, length, token index and count (OkjSize) from 16 to 32 bits
+ * and raise OKJ_MAX_JSON_LEN from 4096 bytes to 2 GiB.  Pair it with
+ * okj_init_ex() and a caller-sized token buffer; the fixed in-struct arrays
+ * keep their OKJ_MAX_TOKENS and OKJ_MAX_DEPTH sizes.  Nesting depth, key
+ * lengths and okj_copy_string() stay 16-bit.
+ * #define OK_JSON_LARGE_DOCS
+ **/
+
 /**
  * @brief NULL is part of the C standard but lives in stddef.h which we avoid
  * pulling in.  Define it here if the platform header hasn't provided it.
@@ -95,13 +140,31 @@ typedef unsigned char   uint8_t;
  * terminating NUL character).  Inputs longer than this are rejected by
  * okj_parse() before any tokenisation begins.
  **/
+#ifdef OK_JSON_LARGE_DOCS
+#define OKJ_MAX_JSON_LEN 0x7FFFFFFFU
+#else
 #define OKJ_MAX_JSON_LEN 4096U
+#endif
+
+/**
+ * @brief Unsigned type of byte positions, lengths, token indices and counts.
+ * 16 bits by default; 32 bits with OK_JSON_LARGE_DOCS.  OKJ_SIZE_MAX is its
+ * largest value.
+ **/
+#ifdef OK_JSON_LARGE_DOCS
+typedef okj_u32 OkjSize;
+#define OKJ_SIZE_MAX 0xFFFFFFFFU
+#else
+typedef uint16_t OkjSize;
+#define OKJ_SIZE_MAX 0xFFFFU
+#endif
 
 /**
  * @brief Grammar context used internally to validate token sequence during
  * parsing.  Tracks what the parser currently expects next so that structural
  * errors (trailing commas, missing colons, non-string object keys, etc.) are
- * detected immediately rather than after the fact.
+ * detected immediately rather than after the fact.  The enumerator order is
+ * the row order of the grammar action table in ok_json.c.
  **/
 typedef enum
 {
@@ -137,7 +200,8 @@ typedef enum
     OKJ_ERROR_PARSING_FAILED       = 16,
     OKJ_ERROR_MAX_JSON_LEN_EXCEEDED = 17,
     OKJ_ERROR_MAX_DEPTH_EXCEEDED   = 18,
-    OKJ_ERROR_BRACKET_MISMATCH     = 19
+    OKJ_ERROR_BRACKET_MISMATCH     = 19,
+    OKJ_NEED_MORE_DATA             = 20  /* okj_feed(): not an error, send the next chunk */
 } OkjError;
 
 /**
@@ -155,23 +219,45 @@ typedef enum
 } OkJsonType;
 
 /**
- * @brief OK_JSON token structure
+ * @brief OK_JSON token structure.  For an object or array that was closed
+ * during the parse, `length` spans the opening to the matching closing
+ * bracket, `end` is the index of the first token after the container's last
+ * descendant, and `count` is the number of direct members or elements.  For
+ * scalars, and for containers left open by a failed parse, `length` is the
+ * token's own size (1 for an open bracket) and `end` and `count` are 0.
  **/
 typedef struct
 {
     OkJsonType type;
     char *start;           /* Pointer to start of token in JSON string */
-    uint16_t length;       /* Token length in bytes                    */
+    OkjSize  length;       /* Token length in bytes                    */
+    OkjSize  end;          /* Containers: index one past the last descendant token */
+    OkjSize  count;        /* Containers: direct member/element count  */
 } OkJsonToken;
 
+/**
+ * @brief Structure-of-arrays token storage used in place of OkJsonToken when
+ * OK_JSON_COMPACT_TOKENS is defined.  Entry i of each array describes token
+ * i; fields have the same meaning as in OkJsonToken, with the start pointer
+ * replaced by a byte offset from parser->json.
+ **/
+typedef struct
+{
+    uint8_t  type[OKJ_MAX_TOKENS];     /* OkJsonType of each token            */
+    OkjSize  offset[OKJ_MAX_TOKENS];   /* Token start, relative to parser->json */
+    OkjSize  length[OKJ_MAX_TOKENS];   /* Token length in bytes               */
+    OkjSize  end[OKJ_MAX_TOKENS];      /* Containers: index one past the last descendant token */
+    OkjSize  count[OKJ_MAX_TOKENS];    /* Containers: direct member/element count */
+} OkJsonTape;
+
 /**
  * @brief OK_JSON object structure
  **/
 typedef struct
 {
     char *start;           /* Pointer to start of token in JSON string */
-    uint16_t count;        /* Total count of object members            */
-    uint16_t length;       /* Full raw text length including braces    */
+    OkjSize  count;        /* Total count of object members            */
+    OkjSize  length;       /* Full raw text length including braces    */
 } OkJsonObject;
 
 /**
@@ -180,8 +266,8 @@ typedef struct
 typedef struct
 {
     char *start;           /* Pointer to start of token in JSON string */
-    uint16_t count;        /* Total count of array elements            */
-    uint16_t length;       /* Full raw text length including brackets  */
+    OkjSize  count;        /* Total count of array elements            */
+    OkjSize  length;       /* Full raw text length including brackets  */
 } OkJsonArray;
 
 /**
@@ -190,7 +276,7 @@ typedef struct
 typedef struct
 {
     char *start;           /* Pointer to start of token in JSON string */
-    uint16_t length;       /* Size of boolean in bytes                 */
+    OkjSize  length;       /* Size of boolean in bytes                 */
 } OkJsonBoolean;
 
 /**
@@ -199,7 +285,7 @@ typedef struct
 typedef struct
 {
     char *start;           /* Pointer to start of token in JSON string */
-    uint16_t length;       /* Size of number in bytes                  */
+    OkjSize  length;       /* Size of number in bytes                  */
 } OkJsonNumber;
 
 /**
@@ -208,24 +294,347 @@ typedef struct
 typedef struct
 {
     char *start;           /* Pointer to start of token in JSON string */
-    uint16_t length;       /* Size of string in bytes                  */
+    OkjSize  length;       /* Size of string in bytes                  */
 } OkJsonString;
 
 /**
- * @brief OK_JSON parser structure
+ * @brief One entry of an okj_get_many() batch.  The caller fills in `key`,
+ * `key_len` and `type` (OKJ_UNDEFINED accepts any value type); okj_get_many()
+ * fills in `value` and `status`, which holds the code the single-key getter
+ * for `type` would have returned.
+ **/
+typedef struct
+{
+    const char  *key;      /* Key name (need not be null-terminated)   */
+    uint16_t     key_len;  /* Length of key in bytes                  */
+    OkJsonType   type;     /* Expected value type, or OKJ_UNDEFINED    */
+    OkJsonToken  value;    /* Out: the value token                     */
+    OkjError     status;   /* Out: OKJ_SUCCESS or the getter's error   */
+} OkjGetRequest;
+
+/**
+ * @brief A key prepared once with okj_key_init() (or OKJ_KEY() for a string
+ * literal) for the _key getters.  The cached length, hash and leading-bytes
+ * prefix let most non-matching keys be rejected with an integer compare.
+ * `bytes` is not copied and must stay valid while the handle is in use.
+ **/
+typedef struct
+{
+    const char *bytes;     /* Key name (need not be null-terminated)   */
+    okj_u64     prefix;    /* First (up to) eight bytes, packed        */
+    okj_u32     hash;      /* FNV-1a of the key bytes                  */
+    uint16_t    length;    /* Length of key in bytes                   */
+} OkjKey;
+
+/**
+ * @brief Key ID recorded for a token that is not a registered object key.
+ **/
+#define OKJ_KEY_ID_NONE 0xFFU
+
+/**
+ * @brief A caller's registered key set, attached with okj_keys_attach().
+ * While parsing, each object key token equal to keys[n] is tagged with ID n
+ * in `ids`; every other token gets OKJ_KEY_ID_NONE.  `first` records, per
+ * ID, the value token of the first key carrying it.  All storage belongs to
+ * the caller.
+ **/
+typedef struct
+{
+    const OkjKey *keys;    /* Registered keys; the ID is the position  */
+    uint8_t      *ids;     /* Out: per token, key ID or OKJ_KEY_ID_NONE */
+    OkjSize      *first;   /* Out: per ID, first value token, or 0     */
+    uint8_t       n_keys;  /* Number of registered keys                */
+} OkjKeySet;
+
+/**
+ * @brief One reference token of a compiled JSON Pointer: the unescaped text,
+ * prepared as an object key, and the array index it spells if it is one.
  **/
 typedef struct
 {
+    OkjKey   key;          /* Unescaped segment as an object key       */
+    OkjSize  index;        /* Array index, or OKJ_SIZE_MAX if none     */
+} OkjPointerSegment;
+
+/**
+ * @brief An RFC 6901 JSON Pointer split and unescaped by
+ * okj_pointer_compile(), ready for repeated okj_pointer_find() calls.
+ **/
+typedef struct
+{
+    OkjPointerSegment *segments;   /* Caller storage                   */
+    uint16_t           n_segments; /* 0 for "", the whole document     */
+} OkjPointer;
+
+/**
+ * @brief Longest JSONPath query okj_path_compile() accepts, in steps.  The
+ * evaluator tracks which steps are live at each level in a 32-bit set.
+ **/
+#define OKJ_PATH_MAX_STEPS 31U
+
+/**
+ * @brief What one step of a compiled JSONPath query selects among the
+ * children of the current node.
+ **/
+typedef enum
+{
+    OKJ_PATH_CHILD,        /* .name or ['name']: the member named key  */
+    OKJ_PATH_INDEX,        /* [n]: array element n                     */
+    OKJ_PATH_WILDCARD,     /* .* or [*]: every child                   */
+    OKJ_PATH_FILTER        /* [?(@.name op literal)]: children passing */
+} OkjPathKind;
+
+/**
+ * @brief Comparison in a JSONPath filter step.  OKJ_PATH_EXISTS is the
+ * bare [?(@.name)] form.
+ **/
+typedef enum
+{
+    OKJ_PATH_EXISTS,
+    OKJ_PATH_EQ,
+    OKJ_PATH_NE,
+    OKJ_PATH_LT,
+    OKJ_PATH_LE,
+    OKJ_PATH_GT,
+    OKJ_PATH_GE
+} OkjPathOp;
+
+/**
+ * @brief One step of a compiled JSONPath query.  Names and literals point
+ * into the query text, which must outlive the compiled path.
+ **/
+typedef struct
+{
+    OkjKey      key;          /* CHILD: member name; FILTER: member tested */
+    const char *literal;      /* FILTER: operand text, quotes stripped    */
+    uint16_t    literal_len;  /* FILTER: length of the operand            */
+    OkJsonType  literal_type; /* FILTER: OKJ_NUMBER, STRING, BOOLEAN, NULL */
+    OkjSize     index;        /* INDEX: element number                    */
+    OkjPathKind kind;         /* What the step selects                    */
+    OkjPathOp   op;           /* FILTER: comparison                       */
+    uint8_t     recursive;    /* 1 after "..": matches at any depth below */
+} OkjPathStep;
+
+/**
+ * @brief A JSONPath query compiled by okj_path_compile(), ready for
+ * repeated okj_path_eval() calls.
+ **/
+typedef struct
+{
+    OkjPathStep *steps;       /* Caller storage                          */
+    uint16_t     n_steps;     /* 0 for "$", the whole document           */
+} OkjPath;
+
+/**
+ * @brief A set of JSONPath queries pushed down into okj_parse() with
+ * okj_select_attach().  Only the values they select, and the containers on
+ * the way to them, are stored as tokens.  The queries and this struct
+ * belong to the caller.
+ **/
+typedef struct
+{
+    const OkjPath *paths;     /* Queries; a value is kept if any selects it */
+    okj_u32        start;     /* Live states at the document root        */
+    okj_u32        done;      /* One completed-match bit per query       */
+    OkjSize        key_start; /* While parsing: offset of the pending key */
+    OkjSize        key_len;   /* While parsing: its length               */
+    uint8_t        n_paths;   /* Number of queries                       */
+} OkjSelect;
+
+/**
+ * @brief Incremental input state for okj_feed(), attached with
+ * okj_feed_attach().  Chunks are appended to the buffer given to okj_init(),
+ * which tokens point into as usual, so it must be able to hold the whole
+ * message.
+ **/
+typedef struct
+{
+    OkjSize  capacity;  /* Bytes the document buffer can hold        */
+    OkjError status;    /* Result of the last okj_feed() call        */
+    uint8_t  complete;  /* Set once the top-level value has ended    */
+    uint8_t  ended;     /* Set by the end-of-input call              */
+} OkjFeed;
+
+/**
+ * @brief One record of a newline-delimited (NDJSON / JSON Lines) buffer, as
+ * reported by okj_lines_next() and okj_parse_lines().
+ **/
+typedef struct
+{
+    OkjSize  offset;    /* First byte of the line in the buffer      */
+    OkjSize  length;    /* Line length, without the "\n" or "\r\n"   */
+    OkjError status;    /* okj_parse() result for the line           */
+} OkjRecord;
+
+/**
+ * @brief Position in a newline-delimited buffer, set up by okj_lines_init()
+ * and advanced by okj_lines_next().
+ **/
+typedef struct
+{
+    char    *buf;       /* Buffer of records, one per line           */
+    OkjSize  len;       /* Length of buf in bytes                    */
+    OkjSize  pos;       /* Start of the next line                    */
+} OkjLines;
+
+/**
+ * @brief Kinds of event reported by okj_parse_events().
+ **/
+typedef enum
+{
+    OKJ_EVENT_START_OBJECT,
+    OKJ_EVENT_END_OBJECT,
+    OKJ_EVENT_START_ARRAY,
+    OKJ_EVENT_END_ARRAY,
+    OKJ_EVENT_KEY,
+    OKJ_EVENT_STRING,
+    OKJ_EVENT_NUMBER,
+    OKJ_EVENT_BOOLEAN,
+    OKJ_EVENT_NULL
+} OkjEventType;
+
+/**
+ * @brief One okj_parse_events() event.  `start` and `length` cover the same
+ * bytes as the matching token would: the content of a key or string between
+ * its quotes (escapes not decoded), the text of a number or literal, the
+ * opening bracket for a START event, and the whole container, from opening
+ * to closing bracket, for an END event.  `depth` is the number of enclosing
+ * containers, so a container's START and END share one depth and its
+ * members are one deeper.
+ **/
+typedef struct
+{
+    OkjEventType type;
+    const char  *start;     /* First byte of the event's text            */
+    OkjSize      length;    /* Length of that text in bytes              */
+    uint16_t     depth;     /* Enclosing containers                      */
+} OkjEvent;
+
+/**
+ * @brief okj_parse_events() callback.  Return OKJ_SUCCESS to continue; any
+ * other value ends the parse, and okj_parse_events() returns it.
+ **/
+typedef OkjError (*OkjEventFn)(void *user, const OkjEvent *event);
+
+/**
+ * @brief One level of the container nesting stack: the type of the open
+ * object or array and the index of its token.
+ **/
+typedef struct
+{
+    OkJsonType type;       /* OKJ_OBJECT or OKJ_ARRAY                  */
+    OkjSize    token;      /* Index of the container's opening token, or
+                            * OKJ_SIZE_MAX when a selection skipped it */
+    okj_u32    live;       /* Selection states the children may match */
+    OkjSize    elem;       /* Selection: number of the next element    */
+} OkjDepthFrame;
+
+/**
+ * @brief One slot of an OkjHashIndex table.  `key` is the token index of an
+ * object key (0 marks an empty slot); `parent` is the index of the object it
+ * belongs to, or OKJ_SIZE_MAX for the entry that records the first STRING
+ * token in the document with those bytes.
+ **/
+typedef struct
+{
+    OkjSize parent;        /* Owning object, or OKJ_SIZE_MAX           */
+    OkjSize key;           /* Key token index; 0 when the slot is free */
+} OkjHashSlot;
+
+/**
+ * @brief Open-addressing hash index over object keys, attached to a parser
+ * with okj_hash_attach().  Slot storage belongs to the caller; no heap is
+ * used.  Built on the first lookup after a parse, or by okj_parse() itself
+ * when attached beforehand.
+ **/
+typedef struct
+{
+    OkjHashSlot *slots;    /* Caller storage, `capacity` entries       */
+    OkjSize      capacity; /* Power of two                             */
+    OkjSize      used;     /* Occupied slots                           */
+    uint8_t      state;    /* Unbuilt, ready, or too small (scan instead) */
+} OkjHashIndex;
+
+/**
+ * @brief OK_JSON parser structure.  okj_init() parses into the fixed-size
+ * storage embedded here.  okj_init_ex() points token_buf and depth_buf at
+ * caller-owned buffers instead; every parse and getter function then honours
+ * token_capacity and depth_capacity in place of OKJ_MAX_TOKENS and
+ * OKJ_MAX_DEPTH.
+ **/
+typedef struct
+{
+#ifdef OK_JSON_COMPACT_TOKENS
+    OkJsonTape     tape;                        /* Fixed-size token storage     */
+#else
     OkJsonToken    tokens[OKJ_MAX_TOKENS];      /* Fixed-size token storage     */
-    OkJsonType     depth_stack[OKJ_MAX_DEPTH];  /* Container-type at each depth */
+#endif
+    OkjDepthFrame  depth_stack[OKJ_MAX_DEPTH];  /* Open container at each depth */
     OkjParseContext context;                    /* Current grammar expectation  */
-    uint16_t       token_count;                 /* Number of parsed tokens      */
+    OkjSize        token_count;                 /* Number of parsed tokens      */
     uint16_t       depth;                       /* Current nesting depth        */
     char          *json;                        /* Pointer to input JSON string */
-    uint16_t       json_len;                    /* Length of JSON string in bytes (excluding any terminator) */
-    uint16_t       position;                    /* Current parsing position     */
+    OkjSize        json_len;                    /* Length of JSON string in bytes (excluding any terminator) */
+    OkjSize        position;                    /* Current parsing position     */
+    OkJsonToken   *token_buf;                   /* Caller token storage from okj_init_ex(), else NULL */
+    OkjDepthFrame *depth_buf;                   /* Caller depth storage from okj_init_ex(), else NULL */
+    OkjSize        token_capacity;              /* Token slots available        */
+    uint16_t       depth_capacity;              /* Maximum nesting depth        */
+    OkjHashIndex  *hash;                        /* Key index from okj_hash_attach(), else NULL */
+    OkjKeySet     *key_set;                     /* Registered keys from okj_keys_attach(), else NULL */
+    OkjSelect     *select;                      /* Pushed-down queries from okj_select_attach(), else NULL */
+    OkjFeed       *feed;                        /* Incremental input from okj_feed_attach(), else NULL */
 } OkJsonParser;
 
+/**
+ * @brief Position within the direct children of one object or array, set
+ * up by okj_iter_init() and advanced by okj_iter_next().
+ **/
+typedef struct
+{
+    const OkJsonParser *parser; /* Parsed document                       */
+    OkjSize             next;   /* Next child's token (the key, in objects) */
+    OkjSize             stop;   /* One past the container's last token   */
+    OkjSize             value;  /* Out: token of the last value returned */
+    OkJsonType          type;   /* OKJ_OBJECT or OKJ_ARRAY               */
+} OkjIter;
+
+/**
+ * @brief Lookup state for okj_cursor_find(): where the next search starts.
+ * Set up by okj_cursor_init().
+ **/
+typedef struct
+{
+    const OkJsonParser *parser; /* Parsed document                       */
+    OkjSize             next;   /* Token the next search starts at       */
+} OkjCursor;
+
+/**
+ * @brief A document read on demand by the okj_doc_ functions.  Nothing is
+ * tokenized up front: each accessor scans from a value's first byte and
+ * stops as soon as it has what it was asked for.
+ **/
+typedef struct
+{
+    char    *json;      /* Document text                             */
+    OkjSize  json_len;  /* Its length in bytes                       */
+} OkjDoc;
+
+/**
+ * @brief Position within the direct children of an object or array of an
+ * OkjDoc, set up by okj_doc_iter() and advanced by okj_doc_next() and
+ * okj_doc_find().
+ **/
+typedef struct
+{
+    const OkjDoc *doc;    /* Document being read                       */
+    OkjSize       pos;    /* Next unread byte, or the last value returned
+                           * if it is a container not yet stepped over */
+    OkJsonType    type;   /* OKJ_OBJECT or OKJ_ARRAY                   */
+    uint8_t       state;  /* Where pos is within the container         */
+    OkjError      status; /* OKJ_SUCCESS, or why iteration stopped early */
+} OkjDocIter;
+
 
 /**
  * @brief OK_JSON initialization routine
@@ -234,7 +643,45 @@ typedef struct
  * @param json_string Character stream of data you want to parse
  * @param json_len    Length of @p json_string in bytes (excluding any terminator)
  **/
-void okj_init(OkJsonParser *parser, char *json_string, uint16_t json_len);
+void okj_init(OkJsonParser *parser, char *json_string, OkjSize json_len);
+
+/**
+ * @brief OK_JSON initialization routine with caller-owned storage.  Tokens
+ *        and the nesting stack go to @p tokens and @p depth_stack instead of
+ *        the parser's embedded arrays, so each parser can be sized for its
+ *        message class without recompiling.  okj_parse() then fails with
+ *        OKJ_ERROR_MAX_TOKENS_EXCEEDED or OKJ_ERROR_MAX_DEPTH_EXCEEDED at the
+ *        given capacities.  Both buffers must outlive every use of @p parser.
+ *        Caller tokens are always OkJsonToken, even when
+ *        OK_JSON_COMPACT_TOKENS is defined.
+ *
+ * @param parser         Pointer to the main ok_json parser object
+ * @param json_string    Character stream of data you want to parse
+ * @param json_len       Length of @p json_string in bytes (excluding any terminator)
+ * @param tokens         Caller-owned token storage
+ * @param token_capacity Number of entries in @p tokens
+ * @param depth_stack    Caller-owned nesting stack
+ * @param depth_capacity Number of entries in @p depth_stack
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL;
+ *         OKJ_ERROR_NO_FREE_SPACE if either capacity is zero
+ **/
+OkjError okj_init_ex(OkJsonParser *parser, char *json_string, OkjSize json_len,
+                     OkJsonToken *tokens, OkjSize token_capacity,
+                     OkjDepthFrame *depth_stack, uint16_t depth_capacity);
+
+/**
+ * @brief Point an initialized parser at a new document for the next
+ *        okj_parse().  Only the read position, token count, nesting depth
+ *        and grammar state are reset: the token array is not cleared, since
+ *        a parse overwrites every token it reports.  Caller buffers from
+ *        okj_init_ex() and the hash, key set and selection attachments are
+ *        kept; an okj_feed_attach() state is dropped.
+ * @param parser      Parser set up by okj_init() or okj_init_ex()
+ * @param json_string Next document
+ * @param json_len    Length of @p json_string in bytes
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ **/
+OkjError okj_reset(OkJsonParser *parser, char *json_string, OkjSize json_len);
 
 /**
  * @brief OK_JSON parse routine
@@ -244,6 +691,118 @@ void okj_init(OkJsonParser *parser, char *json_string, uint16_t json_len);
  **/
 OkjError okj_parse(OkJsonParser *parser);
 
+/**
+ * @brief Check that @p json is exactly one valid JSON value, without a
+ *        parser and without writing tokens.  The grammar, string, UTF-8,
+ *        number and OKJ_MAX_DEPTH checks are those of okj_parse(), which
+ *        returns the same code for any input whose tokens fit its array;
+ *        here there is no token limit.  The only state besides the position
+ *        is a bit stack of the open containers, one bit per level, and the
+ *        offset of each, all O(OKJ_MAX_DEPTH).
+ * @param json     JSON text (need not be null-terminated)
+ * @param json_len Length of @p json in bytes
+ * @return OKJ_SUCCESS if the text is valid; OKJ_ERROR_BAD_POINTER if @p json
+ *         is NULL; otherwise the error okj_parse() reports for it
+ **/
+OkjError okj_validate(const char *json, OkjSize json_len);
+
+/**
+ * @brief Event (SAX) parse: report each value of @p json to @p on_event in
+ *        document order, with no parser and no tokens, so there is no
+ *        OKJ_MAX_TOKENS limit and memory is O(OKJ_MAX_DEPTH).  The checks
+ *        are okj_validate()'s.  Each event is reported once its own text
+ *        has been checked, so on malformed input the events before the
+ *        error have already been delivered.
+ * @param json     JSON text (need not be null-terminated)
+ * @param json_len Length of @p json in bytes
+ * @param on_event Callback for every event
+ * @param user     Passed unchanged to @p on_event
+ * @return OKJ_SUCCESS if the whole text was valid and every callback
+ *         returned OKJ_SUCCESS; OKJ_ERROR_BAD_POINTER if @p json or
+ *         @p on_event is NULL; the first other callback result; otherwise
+ *         the error okj_validate() reports
+ **/
+OkjError okj_parse_events(const char *json, OkjSize json_len, OkjEventFn on_event, void *user);
+
+/**
+ * @brief Switch a parser to incremental input.  Call after okj_init() or
+ *        okj_init_ex(), whose buffer then receives the chunks passed to
+ *        okj_feed(); any @c json_len bytes already in it count as received.
+ *        Resets the attached hash index and key set as okj_parse() does.
+ * @param parser   Pointer to the main ok_json parser object
+ * @param feed     Caller storage for the incremental state
+ * @param capacity Size of the document buffer in bytes
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is
+ *         NULL; OKJ_ERROR_NO_FREE_SPACE if @p capacity is below the bytes
+ *         already in the buffer
+ **/
+OkjError okj_feed_attach(OkJsonParser *parser, OkjFeed *feed, OkjSize capacity);
+
+/**
+ * @brief Append the next @p len bytes of the document and parse as far as
+ *        they allow.  Context, depth stack and tokens carry over between
+ *        calls.  A string, number or literal cut by the end of the chunk is
+ *        parsed once the bytes that end it arrive, so every split of the
+ *        input gives the tokens and result of okj_parse() on the whole.
+ *        Bytes already received into the buffer's free tail (e.g. by DMA)
+ *        are taken in place when @p chunk points there.  Call with
+ *        @p len 0 at end of input.
+ * @param parser Parser set up with okj_feed_attach()
+ * @param chunk  Next bytes of the document; may be NULL when @p len is 0
+ * @param len    Number of bytes in @p chunk, or 0 for end of input
+ * @return OKJ_NEED_MORE_DATA while the top-level value is unfinished;
+ *         OKJ_SUCCESS once it is complete (trailing whitespace may follow);
+ *         OKJ_ERROR_BAD_POINTER if @p parser is NULL or has no feed, or
+ *         @p chunk is NULL with @p len non-zero; OKJ_ERROR_NO_FREE_SPACE if
+ *         the chunk does not fit the buffer; otherwise the error okj_parse()
+ *         reports, with OKJ_ERROR_UNEXPECTED_END only from the end-of-input
+ *         call.  An error, or the end-of-input call, finishes the feed: later
+ *         calls return the same result.
+ **/
+OkjError okj_feed(OkJsonParser *parser, const char *chunk, OkjSize len);
+
+/**
+ * @brief Start reading a newline-delimited buffer (NDJSON / JSON Lines): one
+ *        JSON value per line, each ended by "\n" or "\r\n" or by the end of
+ *        the buffer.
+ * @param lines Caller-supplied reader state
+ * @param buf   Records; tokens of each record point into it
+ * @param len   Length of @p buf in bytes
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ **/
+OkjError okj_lines_init(OkjLines *lines, char *buf, OkjSize len);
+
+/**
+ * @brief Parse the next record with okj_reset() and okj_parse(), so one
+ *        parser serves the whole buffer with no per-record okj_init().
+ *        Lines holding only whitespace are skipped.  A malformed record is
+ *        reported in @p out and the next call moves on to the following
+ *        line.  The parser holds the record's tokens until the next call.
+ * @param parser Parser set up by okj_init() or okj_init_ex()
+ * @param lines  Reader from okj_lines_init()
+ * @param out    Receives the record's offset, length and parse status
+ * @return 1 when a record was parsed (whatever its status); 0 at the end of
+ *         the buffer or if any pointer is NULL
+ **/
+uint8_t okj_lines_next(OkJsonParser *parser, OkjLines *lines, OkjRecord *out);
+
+/**
+ * @brief Parse every record of a newline-delimited buffer with one parser,
+ *        as okj_lines_next(), and report each in @p records.
+ * @param parser    Parser set up by okj_init() or okj_init_ex()
+ * @param buf       Records, one per line
+ * @param len       Length of @p buf in bytes
+ * @param records   Caller storage for one OkjRecord per record
+ * @param capacity  Number of entries in @p records
+ * @param out_count Receives the number of records reported
+ * @return OKJ_SUCCESS when every record was reported, whatever their
+ *         statuses; OKJ_ERROR_BAD_POINTER if any pointer is NULL;
+ *         OKJ_ERROR_NO_FREE_SPACE if the buffer holds more than @p capacity
+ *         records (the first @p capacity are reported)
+ **/
+OkjError okj_parse_lines(OkJsonParser *parser, char *buf, OkjSize len,
+                         OkjRecord *records, OkjSize capacity, OkjSize *out_count);
+
 /**
  * @brief Retrieve the string value associated with a key in a parsed object.
  *        Scans the token array for a STRING token whose content matches @p key,
@@ -327,6 +886,71 @@ OkjError okj_get_object(OkJsonParser *parser, const char *key, uint16_t key_len,
  **/
 OkjError okj_get_token(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonToken *out_tok);
 
+/**
+ * @brief Copy token @p idx of a parsed document into @p out_tok.  Works with
+ *        either token layout, so code that walks the token array by index
+ *        need not know whether OK_JSON_COMPACT_TOKENS is defined.
+ * @param parser  Pointer to the main ok_json parser object
+ * @param idx     Token index, less than parser->token_count
+ * @param out_tok Caller-supplied OkJsonToken to receive the result
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or @p idx is not below parser->token_count
+ **/
+OkjError okj_token_at(const OkJsonParser *parser, OkjSize idx, OkJsonToken *out_tok);
+
+/**
+ * @brief Find the value of a direct member of one object.  Only the members
+ *        of the object at token @p object are compared, skipping over nested
+ *        containers, so keys in other subtrees and string values that happen
+ *        to equal @p key never match.  Cost grows with the object's member
+ *        count rather than the document's token count.  Use 0 for the root.
+ * @param parser    Pointer to the main ok_json parser object
+ * @param object    Token index of the object to search
+ * @param key       Key name to look up (need not be null-terminated)
+ * @param key_len   Length of @p key in bytes
+ * @param out_index Receives the token index of the member's value
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL,
+ *         @p object is not below parser->token_count, or the key is not found;
+ *         OKJ_ERROR_BAD_OBJECT if token @p object is not a closed object
+ **/
+OkjError okj_find_member(const OkJsonParser *parser, OkjSize object,
+                         const char *key, uint16_t key_len, OkjSize *out_index);
+
+/**
+ * @brief Retrieve the token for the value of a direct member of one object,
+ *        as okj_find_member() followed by okj_token_at().
+ * @param parser  Pointer to the main ok_json parser object
+ * @param object  Token index of the object to search
+ * @param key     Key name to look up (need not be null-terminated)
+ * @param key_len Length of @p key in bytes
+ * @param out_tok Caller-supplied OkJsonToken to receive the result
+ * @return As okj_find_member()
+ **/
+OkjError okj_get_member(const OkJsonParser *parser, OkjSize object,
+                        const char *key, uint16_t key_len, OkJsonToken *out_tok);
+
+/**
+ * @brief Attach a hash index over object keys so that the key-based getters,
+ *        okj_find_member() and okj_get_member() probe a table instead of
+ *        scanning tokens.  Call after okj_init() or okj_init_ex().  Attached
+ *        before okj_parse(), the table is filled when the parse succeeds;
+ *        attached after, on the first lookup.  Lookup results are identical
+ *        with or without the index.  If the table turns out too small, the
+ *        lookups quietly fall back to scanning.  About four slots per parsed
+ *        token is always enough; two per key and string value usually is.
+ *        A lookup that fills the table writes @p hash and @p slots even
+ *        through a `const OkJsonParser *`, so such lookups must not run
+ *        concurrently on one parser until the table has been built.
+ * @param parser   Pointer to the main ok_json parser object
+ * @param hash     Caller-supplied index header, valid as long as the parser
+ * @param slots    Caller-supplied slot storage, @p capacity entries
+ * @param capacity Number of slots, a power of two of at least 2
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL;
+ *         OKJ_ERROR_NO_FREE_SPACE if @p capacity is not a power of two >= 2
+ **/
+OkjError okj_hash_attach(OkJsonParser *parser, OkjHashIndex *hash,
+                         OkjHashSlot *slots, OkjSize capacity);
+
 /**
  * @brief Retrieve the entire raw array value associated with a key.
  *        Like okj_get_array() but also populates the @c length field with the
@@ -355,6 +979,453 @@ OkjError okj_get_array_raw(OkJsonParser *parser, const char *key, uint16_t key_l
  **/
 OkjError okj_get_object_raw(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonObject *out_obj);
 
+/**
+ * @brief Resolve a batch of keys in one walk over the tokens per 32
+ *        requests; each token is hashed once and probed against the
+ *        requested keys rather than compared with every one.  Each request
+ *        finds the same value its single-key getter would (the value after
+ *        the first STRING token equal to the key), and is type-checked
+ *        against its `type`.  For objects and arrays `value.count` and
+ *        `value.length` are always filled in and the OKJ_MAX_ARRAY_SIZE /
+ *        OKJ_MAX_OBJECT_SIZE caps do not apply, as with the _raw getters.
+ *        With a hash index attached each request is a single probe.
+ * @param parser     Pointer to the main ok_json parser object
+ * @param requests   Caller-supplied array of requests
+ * @param n_requests Number of entries in @p requests
+ * @return OKJ_SUCCESS if every request succeeded; OKJ_ERROR_BAD_POINTER if
+ *         @p parser or @p requests is NULL; otherwise the status of the first
+ *         request that failed.  Per-request status is in each `status`:
+ *         OKJ_ERROR_BAD_STRING / _NUMBER / _BOOLEAN / _ARRAY / _OBJECT when
+ *         the key is missing or the value has another type, and
+ *         OKJ_ERROR_BAD_POINTER for a NULL key or a missing key with type
+ *         OKJ_UNDEFINED (as okj_get_token())
+ **/
+OkjError okj_get_many(OkJsonParser *parser, OkjGetRequest *requests, uint16_t n_requests);
+
+/**
+ * @brief Prepare a key handle for the _key getters.  Computes the length,
+ *        hash and prefix once so that repeated lookups of the same key skip
+ *        that work and reject most other keys without a byte compare.
+ * @param out_key Caller-supplied OkjKey to receive the handle
+ * @param key     Key name (need not be null-terminated); referenced, not copied
+ * @param key_len Length of @p key in bytes
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL;
+ *         OKJ_ERROR_MAX_STR_LEN_EXCEEDED if @p key_len exceeds
+ *         OKJ_MAX_STRING_LEN (such a key could never match)
+ **/
+OkjError okj_key_init(OkjKey *out_key, const char *key, uint16_t key_len);
+
+/**
+ * @brief okj_key_init() for a string literal, taking the length from the
+ *        literal itself: @c OKJ_KEY(&k, "name").
+ **/
+#define OKJ_KEY(out_key, literal) \
+    okj_key_init((out_key), (literal), (uint16_t)(sizeof(literal) - 1U))
+
+/**
+ * @brief okj_get_string() with a prepared key handle.
+ * @return As okj_get_string(); OKJ_ERROR_BAD_POINTER also for a NULL @p key
+ **/
+OkjError okj_get_string_key(OkJsonParser *parser, const OkjKey *key, OkJsonString *out_str);
+
+/**
+ * @brief okj_get_number() with a prepared key handle.
+ * @return As okj_get_number(); OKJ_ERROR_BAD_POINTER also for a NULL @p key
+ **/
+OkjError okj_get_number_key(OkJsonParser *parser, const OkjKey *key, OkJsonNumber *out_num);
+
+/**
+ * @brief okj_get_boolean() with a prepared key handle.
+ * @return As okj_get_boolean(); OKJ_ERROR_BAD_POINTER also for a NULL @p key
+ **/
+OkjError okj_get_boolean_key(OkJsonParser *parser, const OkjKey *key, OkJsonBoolean *out_bool);
+
+/**
+ * @brief okj_get_array() with a prepared key handle.  Enforces
+ *        OKJ_MAX_ARRAY_SIZE.
+ * @return As okj_get_array(); OKJ_ERROR_BAD_POINTER also for a NULL @p key
+ **/
+OkjError okj_get_array_key(OkJsonParser *parser, const OkjKey *key, OkJsonArray *out_arr);
+
+/**
+ * @brief okj_get_object() with a prepared key handle.  Enforces
+ *        OKJ_MAX_OBJECT_SIZE.
+ * @return As okj_get_object(); OKJ_ERROR_BAD_POINTER also for a NULL @p key
+ **/
+OkjError okj_get_object_key(OkJsonParser *parser, const OkjKey *key, OkJsonObject *out_obj);
+
+/**
+ * @brief okj_get_token() with a prepared key handle.
+ * @return As okj_get_token()
+ **/
+OkjError okj_get_token_key(OkJsonParser *parser, const OkjKey *key, OkJsonToken *out_tok);
+
+/**
+ * @brief okj_find_member() with a prepared key handle.
+ * @return As okj_find_member()
+ **/
+OkjError okj_find_member_key(const OkJsonParser *parser, OkjSize object,
+                             const OkjKey *key, OkjSize *out_index);
+
+/**
+ * @brief Register a fixed key set so that okj_parse() tags every object key
+ *        token with an integer ID as it is scanned.  Lookups by ID are then a
+ *        table read (okj_find_by_id()) or an ID compare per member
+ *        (okj_find_member_by_id()), with no byte comparisons.  Call after
+ *        okj_init() or okj_init_ex() and before okj_parse().
+ * @param parser Pointer to the main ok_json parser object
+ * @param set    Caller-supplied key set header, valid as long as the parser
+ * @param keys   Keys to register, prepared with okj_key_init(); ID n is keys[n]
+ * @param n_keys Number of entries in @p keys, at most OKJ_KEY_ID_NONE
+ * @param ids    Caller storage for one ID per token (token_capacity entries)
+ * @param first  Caller storage for one value index per key (@p n_keys entries)
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or @p n_keys is 0
+ **/
+OkjError okj_keys_attach(OkJsonParser *parser, OkjKeySet *set, const OkjKey *keys,
+                         uint8_t n_keys, uint8_t *ids, OkjSize *first);
+
+/**
+ * @brief Find the value of the first object key registered as @p id.
+ *        Unlike the key-based getters, string values never match; only
+ *        object keys carry IDs.
+ * @param parser    Pointer to the main ok_json parser object
+ * @param id        Key ID (position in the registered key array)
+ * @param out_index Receives the token index of the value
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL,
+ *         no key set is attached, @p id is not registered, or no key in the
+ *         document has that ID
+ **/
+OkjError okj_find_by_id(const OkJsonParser *parser, uint8_t id, OkjSize *out_index);
+
+/**
+ * @brief okj_find_by_id() followed by okj_token_at().
+ * @return As okj_find_by_id()
+ **/
+OkjError okj_get_by_id(const OkJsonParser *parser, uint8_t id, OkJsonToken *out_tok);
+
+/**
+ * @brief okj_find_member() comparing key IDs instead of key bytes.
+ * @param parser    Pointer to the main ok_json parser object
+ * @param object    Token index of the object to search
+ * @param id        Key ID (position in the registered key array)
+ * @param out_index Receives the token index of the member's value
+ * @return As okj_find_member(); OKJ_ERROR_BAD_POINTER also when no key set
+ *         is attached or @p id is not registered
+ **/
+OkjError okj_find_member_by_id(const OkJsonParser *parser, OkjSize object,
+                               uint8_t id, OkjSize *out_index);
+
+/**
+ * @brief Compile an RFC 6901 JSON Pointer such as "/device/sensors/3/value".
+ *        Splits it at '/', unescapes "~1" to '/' and "~0" to '~', and
+ *        prepares each segment as both an object key and an array index, so
+ *        that resolving it later does no parsing.
+ * @param out_ptr      Caller-supplied OkjPointer to receive the result
+ * @param text         Pointer text (need not be null-terminated)
+ * @param text_len     Length of @p text in bytes
+ * @param segments     Caller storage for the segments
+ * @param max_segments Number of entries in @p segments
+ * @param buf          Caller storage for the unescaped text, @p text_len bytes;
+ *                     the segments refer to it, so it must outlive @p out_ptr
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL;
+ *         OKJ_ERROR_SYNTAX if @p text is not empty and does not start with
+ *         '/', or holds a '~' not followed by '0' or '1';
+ *         OKJ_ERROR_NO_FREE_SPACE if it has more than @p max_segments segments
+ **/
+OkjError okj_pointer_compile(OkjPointer *out_ptr, const char *text, uint16_t text_len,
+                             OkjPointerSegment *segments, uint16_t max_segments, char *buf);
+
+/**
+ * @brief Resolve a compiled JSON Pointer against a parsed document.  Each
+ *        step looks only at the children of the current container, skipping
+ *        nested values by their recorded end, so the cost is bounded by the
+ *        depth times the sibling counts on the path, not the document size.
+ *        Object steps use an attached hash index when there is one.
+ * @param parser    Pointer to the main ok_json parser object
+ * @param ptr       Compiled pointer
+ * @param out_index Receives the token index of the referenced value
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or nothing in the document is at that path (including paths through
+ *         a container left open by a failed parse)
+ **/
+OkjError okj_pointer_find(const OkJsonParser *parser, const OkjPointer *ptr, OkjSize *out_index);
+
+/**
+ * @brief okj_pointer_find() followed by okj_token_at().
+ * @return As okj_pointer_find()
+ **/
+OkjError okj_pointer_get(const OkJsonParser *parser, const OkjPointer *ptr, OkJsonToken *out_tok);
+
+/**
+ * @brief Find element @p n of a parsed array.  Constant time when no element
+ *        is an object or array, since element n is then token array + 1 + n;
+ *        otherwise the elements before it are stepped over one by one,
+ *        skipping nested containers by their recorded end.  For repeated
+ *        access to arrays of containers, see okj_array_offsets().
+ * @param parser    Pointer to the main ok_json parser object
+ * @param array     Token index of the array
+ * @param n         Zero-based element number
+ * @param out_index Receives the token index of the element
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL,
+ *         @p array is not below parser->token_count, or @p n is not below the
+ *         element count; OKJ_ERROR_BAD_ARRAY if token @p array is not a
+ *         closed array
+ **/
+OkjError okj_array_find(const OkJsonParser *parser, OkjSize array, OkjSize n, OkjSize *out_index);
+
+/**
+ * @brief okj_array_find() followed by okj_token_at().
+ * @return As okj_array_find()
+ **/
+OkjError okj_array_at(const OkJsonParser *parser, OkjSize array, OkjSize n, OkJsonToken *out_tok);
+
+/**
+ * @brief Record the token index of every element of a parsed array in a
+ *        caller-supplied table, in one pass, so that element n is then
+ *        simply @c offsets[n] whatever the element types.
+ * @param parser    Pointer to the main ok_json parser object
+ * @param array     Token index of the array
+ * @param offsets   Caller storage for one token index per element
+ * @param capacity  Number of entries in @p offsets
+ * @param out_count Receives the number of elements recorded
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or @p array is not below parser->token_count; OKJ_ERROR_BAD_ARRAY if
+ *         token @p array is not a closed array; OKJ_ERROR_NO_FREE_SPACE if
+ *         the array has more than @p capacity elements
+ **/
+OkjError okj_array_offsets(const OkJsonParser *parser, OkjSize array,
+                           OkjSize *offsets, OkjSize capacity, OkjSize *out_count);
+
+/**
+ * @brief Start iterating over the direct children of an object or array.
+ *        Nested containers are stepped over by their recorded end, so a
+ *        pass touches one entry per child however deep the children are.
+ * @param parser    Pointer to the main ok_json parser object
+ * @param container Token index of the object or array
+ * @param out_it    Caller-supplied iterator to initialise
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or @p container is not below parser->token_count;
+ *         OKJ_ERROR_BAD_OBJECT if token @p container is not a closed object
+ *         or array
+ **/
+OkjError okj_iter_init(const OkJsonParser *parser, OkjSize container, OkjIter *out_it);
+
+/**
+ * @brief Advance to the next direct child.  For objects @p key_tok receives
+ *        the member's key; for arrays it is set to an OKJ_UNDEFINED token.
+ *        Either output may be NULL.  The value's token index is left in
+ *        @c it->value, e.g. to iterate a nested container.
+ * @param it      Iterator from okj_iter_init()
+ * @param key_tok Receives the key token, or NULL
+ * @param val_tok Receives the value token, or NULL
+ * @return 1 if a child was produced; 0 once all children have been visited
+ *         or if @p it is NULL
+ **/
+uint8_t okj_iter_next(OkjIter *it, OkJsonToken *key_tok, OkJsonToken *val_tok);
+
+/**
+ * @brief Start a sequence of cursor lookups on a parsed document.  The
+ *        first search begins at token 0.
+ * @param parser     Pointer to the main ok_json parser object
+ * @param out_cursor Caller-supplied cursor to initialise
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ **/
+OkjError okj_cursor_init(const OkJsonParser *parser, OkjCursor *out_cursor);
+
+/**
+ * @brief Find the value of @p key, searching from just past the previous
+ *        match and wrapping around to the start once.  When keys are looked
+ *        up in document order each search succeeds at the first token it
+ *        examines, so extracting every field costs O(1) per field, not a
+ *        scan from the start.  The match is the first STRING token equal to
+ *        @p key at or after the cursor, which is the same value the key-based
+ *        getters find whenever the key occurs once.
+ * @param cursor    Cursor from okj_cursor_init()
+ * @param key       Key name to look up (need not be null-terminated)
+ * @param key_len   Length of @p key in bytes
+ * @param out_index Receives the token index of the value
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or the key is not found (the cursor then stays where it was)
+ **/
+OkjError okj_cursor_find(OkjCursor *cursor, const char *key, uint16_t key_len, OkjSize *out_index);
+
+/**
+ * @brief okj_cursor_find() followed by okj_token_at().
+ * @return As okj_cursor_find()
+ **/
+OkjError okj_cursor_get(OkjCursor *cursor, const char *key, uint16_t key_len, OkJsonToken *out_tok);
+
+/**
+ * @brief Compile a JSONPath query such as "$.store.book[?(@.price < 10)].title".
+ *        Supported: the root "$", child names (".name", "['name']"), array
+ *        indices ("[2]"), wildcards (".*", "[*]"), recursive descent ("..")
+ *        before any of these, and filters "[?(@.name)]" or
+ *        "[?(@.name op literal)]" with op one of == != < <= > >= and a
+ *        number, quoted string, true, false or null literal.
+ * @param out_path  Caller-supplied OkjPath to receive the result
+ * @param text      Query text (need not be null-terminated); the steps refer
+ *                  to it, so it must outlive @p out_path
+ * @param text_len  Length of @p text in bytes
+ * @param steps     Caller storage for the steps
+ * @param max_steps Number of entries in @p steps
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL;
+ *         OKJ_ERROR_SYNTAX if @p text is not a query of the supported form;
+ *         OKJ_ERROR_NO_FREE_SPACE if it has more than @p max_steps or
+ *         OKJ_PATH_MAX_STEPS steps
+ **/
+OkjError okj_path_compile(OkjPath *out_path, const char *text, uint16_t text_len,
+                          OkjPathStep *steps, uint16_t max_steps);
+
+/**
+ * @brief Evaluate a compiled JSONPath query in one forward pass over the
+ *        tokens.  Each open container carries the set of steps its children
+ *        may still match; containers that no step can reach are skipped by
+ *        their recorded end.  Matches are written in document order, each
+ *        token once.  Filters compare numbers by value and strings by their
+ *        raw token text.
+ * @param parser    Pointer to the main ok_json parser object
+ * @param path      Compiled query
+ * @param out       Caller storage for the matching token indices
+ * @param capacity  Number of entries in @p out
+ * @param out_count Receives the number of matches, including any that did
+ *                  not fit in @p out
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or nothing is parsed; OKJ_ERROR_BAD_OBJECT if the document was left
+ *         open by a failed parse; OKJ_ERROR_NO_FREE_SPACE if there are more
+ *         than @p capacity matches; OKJ_ERROR_MAX_DEPTH_EXCEEDED if the query
+ *         must descend more than OKJ_MAX_DEPTH levels; OKJ_ERROR_SYNTAX if
+ *         the tokens were pruned by okj_select_attach() and the query has an
+ *         [n] step
+ **/
+OkjError okj_path_eval(const OkJsonParser *parser, const OkjPath *path,
+                       OkjSize *out, OkjSize capacity, OkjSize *out_count);
+
+/**
+ * @brief Push JSONPath queries down into the parse.  Each later okj_parse()
+ *        stores tokens only for the values some query selects (with all
+ *        their descendants), the keys naming them, and the containers on the
+ *        way to them.  The result is a pruned copy of the document's token tree
+ *        that the getters, iterators and queries read as usual, with values
+ *        outside the selection simply absent.  Arrays on the way to a
+ *        selected value hold only their kept elements, renumbered from 0:
+ *        okj_array_at(), okj_array_find() and okj_iter_next() count those, and
+ *        okj_path_eval() refuses [n] steps on the pruned tokens.  Subtrees no
+ *        query can reach are walked without storing tokens but are checked
+ *        as fully as the rest, depth limit included, so okj_parse() and
+ *        okj_feed() return the same error codes with or without a
+ *        selection.  The root is always kept.
+ * @param parser  Pointer to the main ok_json parser object, after okj_init()
+ * @param sel     Caller storage for the selection state
+ * @param paths   Compiled queries; they and their text must outlive the parse
+ * @param n_paths Number of entries in @p paths
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or @p n_paths is 0; OKJ_ERROR_SYNTAX if a query has a filter step,
+ *         which cannot be decided before its subtree is parsed;
+ *         OKJ_ERROR_NO_FREE_SPACE if the queries have more than
+ *         OKJ_PATH_MAX_STEPS steps plus one per query in total
+ **/
+OkjError okj_select_attach(OkJsonParser *parser, OkjSelect *sel,
+                           const OkjPath *paths, uint8_t n_paths);
+
+/**
+ * @brief Set up on-demand access to a document.  No byte is read here: the
+ *        okj_doc_ accessors tokenize lazily from the value they are given,
+ *        need no token array and have no token budget.  Values they return
+ *        are OkJsonTokens whose scalars are fully checked; objects and arrays
+ *        are returned unscanned, with length 1 and end and count 0, as for a
+ *        container left open by okj_parse().  Values an accessor steps over
+ *        on the way are only delimited, not checked; run okj_validate()
+ *        first where the whole document must be valid.
+ * @param doc      Caller-supplied document handle to initialise
+ * @param json     JSON text (need not be null-terminated); must outlive @p doc
+ * @param json_len Length of @p json in bytes
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL;
+ *         OKJ_ERROR_MAX_JSON_LEN_EXCEEDED if @p json_len exceeds
+ *         OKJ_MAX_JSON_LEN
+ **/
+OkjError okj_doc_init(OkjDoc *doc, char *json, OkjSize json_len);
+
+/**
+ * @brief Read the document's top-level value.  Bytes after it are not looked
+ *        at.
+ * @param doc     Document from okj_doc_init()
+ * @param out_tok Receives the value
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL;
+ *         OKJ_ERROR_UNEXPECTED_END if the document is empty or whitespace;
+ *         otherwise the error okj_parse() reports for a malformed scalar
+ **/
+OkjError okj_doc_root(const OkjDoc *doc, OkJsonToken *out_tok);
+
+/**
+ * @brief Start iterating over the direct children of an object or array
+ *        returned by okj_doc_root() or another okj_doc_ accessor.
+ * @param doc       Document the container belongs to
+ * @param container The object or array value
+ * @param out_it    Caller-supplied iterator to initialise
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL;
+ *         OKJ_ERROR_BAD_OBJECT if @p container is not an object or array
+ *         value of @p doc
+ **/
+OkjError okj_doc_iter(const OkjDoc *doc, const OkJsonToken *container, OkjDocIter *out_it);
+
+/**
+ * @brief Advance to the next direct child, reading only as far as its first
+ *        byte if it is a container and through its end otherwise.  The
+ *        previous child, if a container, is stepped over first.  For objects
+ *        @p key_tok receives the member's key; for arrays it is set to an
+ *        OKJ_UNDEFINED token.  Either output may be NULL.
+ * @param it      Iterator from okj_doc_iter()
+ * @param key_tok Receives the key, or NULL
+ * @param val_tok Receives the value, or NULL
+ * @return 1 if a child was produced; 0 at the end of the container, on
+ *         malformed input (see @c it->status) or if @p it is NULL
+ **/
+uint8_t okj_doc_next(OkjDocIter *it, OkJsonToken *key_tok, OkJsonToken *val_tok);
+
+/**
+ * @brief Find the next member called @p key, starting where the iterator
+ *        stands.  Members before that are not revisited, so fields read in
+ *        document order cost one pass over the object in total.  Values of
+ *        the members passed over are stepped over without being checked.
+ *        The key is compared byte-wise to the raw key text.
+ * @param it      Iterator over an object, from okj_doc_iter()
+ * @param key     Key name (need not be null-terminated)
+ * @param key_len Length of @p key in bytes
+ * @param out_tok Receives the value
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or the rest of the object has no such key; OKJ_ERROR_BAD_OBJECT if
+ *         @p it is over an array; otherwise the error from @c it->status
+ **/
+OkjError okj_doc_find(OkjDocIter *it, const char *key, uint16_t key_len, OkJsonToken *out_tok);
+
+/**
+ * @brief Look up a member of an object, scanning from the object's start.
+ * @param doc     Document the object belongs to
+ * @param object  The object value
+ * @param key     Key name (need not be null-terminated)
+ * @param key_len Length of @p key in bytes
+ * @param out_tok Receives the value
+ * @return As okj_doc_find(); OKJ_ERROR_BAD_OBJECT also if @p object is not
+ *         an object value of @p doc
+ **/
+OkjError okj_doc_field(const OkjDoc *doc, const OkJsonToken *object,
+                       const char *key, uint16_t key_len, OkJsonToken *out_tok);
+
+/**
+ * @brief Read element @p n (0-based) of an array, stepping over the
+ *        elements before it without checking them.
+ * @param doc     Document the array belongs to
+ * @param array   The array value
+ * @param n       Element number
+ * @param out_tok Receives the element
+ * @return OKJ_SUCCESS on success; OKJ_ERROR_BAD_POINTER if any pointer is NULL
+ *         or the array has no element @p n; OKJ_ERROR_BAD_ARRAY if @p array
+ *         is not an array value of @p doc; otherwise the error from the
+ *         iteration
+ **/
+OkjError okj_doc_at(const OkjDoc *doc, const OkJsonToken *array, OkjSize n, OkJsonToken *out_tok);
+
 /**
  * @brief Copy a parsed string value into a caller-supplied buffer with
  *        guaranteed null-termination.  At most @p buf_size - 1 bytes of
@@ -375,7 +1446,7 @@ uint16_t okj_copy_string(const OkJsonString *str, char *buf, uint16_t buf_size);
  * @param parser Pointer to the main ok_json parser object
  * @return Count of OKJ_OBJECT tokens, or 0 if @p parser is NULL
  **/
-uint16_t okj_count_objects(const OkJsonParser *parser);
+OkjSize okj_count_objects(const OkJsonParser *parser);
 
 /**
  * @brief Return the total number of OKJ_ARRAY tokens in the parsed result.
@@ -384,7 +1455,7 @@ uint16_t okj_count_objects(const OkJsonParser *parser);
  * @param parser Pointer to the main ok_json parser object
  * @return Count of OKJ_ARRAY tokens, or 0 if @p parser is NULL
  **/
-uint16_t okj_count_arrays(const OkJsonParser *parser);
+OkjSize okj_count_arrays(const OkJsonParser *parser);
 
 /**
  * @brief Return the total number of tokens (elements of any type) produced
@@ -392,7 +1463,7 @@ uint16_t okj_count_arrays(const OkJsonParser *parser);
  * @param parser Pointer to the main ok_json parser object
  * @return Total token count, or 0 if @p parser is NULL
  **/
-uint16_t okj_count_elements(const OkJsonParser *parser);
+OkjSize okj_count_elements(const OkJsonParser *parser);
 
 /**
  * @brief Print a human-readable debug dump of every token in @p parser to
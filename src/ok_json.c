@@ -26,6 +26,17 @@
 
 #include "../include/ok_json.h"
 
+#ifdef OK_JSON_USE_SSE2
+/**
+ * Suppressing the following include line due to it being part of the conditional
+ * build code and not necessary unless you enable it in your downstream software.
+ * YOU MUST RESOLVE ANY SUBSEQUENT ANALYSIS, RULE, QUALITY BUGS & VIOLATIONS FOR
+ * ENABLING THIS.
+ */
+/* cppcheck-suppress missingIncludeSystem */
+#include <emmintrin.h>
+#endif
+
 
 /*@
   // 1. Frame Condition
@@ -113,37 +124,60 @@ static uint8_t okj_is_hex_digit(char c)
            ((c >= 'A') && (c <= 'F'));
 }
 
-/*@
-  // 1. Frame Condition
-  // The function modifies absolutely no external memory.
-  assigns \nothing;
-
-  // 2. Behaviors
-  // A valid UTF-8 continuation byte always has the top two bits set to 10.
-  // In hex, that means masking with 0xC0 (11000000) must equal 0x80 (10000000).
-  behavior is_continuation:
-    assumes (byte & 0xC0U) == 0x80U;
-    ensures \result == 1;
-
-  behavior not_continuation:
-    assumes (byte & 0xC0U) != 0x80U;
-    ensures \result == 0;
-
-  // 3. Completeness Guarantees
-  complete behaviors;
-  disjoint behaviors;
-*/
-static uint8_t okj_is_utf8_continuation(uint8_t byte)
+/**
+ * UTF-8 validation is table driven: every byte is mapped to one of twelve
+ * classes, and a nine-state DFA over those classes accepts exactly the
+ * well-formed sequences of RFC 3629 section 4 (no overlongs, no surrogates,
+ * nothing above U+10FFFF).
+ */
+#define OKJ_UTF8_ACCEPT 0U  /* Between sequences                      */
+#define OKJ_UTF8_REJECT 1U  /* Ill-formed; absorbing                  */
+#define OKJ_UTF8_STATES 9U
+#define OKJ_UTF8_CLASSES 12U
+
+/* Byte classes:
+ *   0: 00..7F  ASCII               6: E0        (then A0..BF)
+ *   1: 80..8F  continuation        7: E1..EC, EE..EF
+ *   2: 90..9F  continuation        8: ED        (then 80..9F)
+ *   3: A0..BF  continuation        9: F0        (then 90..BF)
+ *   4: C0, C1, F5..FF  never valid 10: F1..F3
+ *   5: C2..DF  two-byte lead       11: F4       (then 80..8F) */
+static const uint8_t okj_utf8_class[256] =
 {
-    uint8_t result = 0U;
-    
-    if ((byte & 0xC0U) == 0x80U)
-    {
-        result = 1U;
-    }
-
-    return result;
-}
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,  /* 00..0F */
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,  /* 10..1F */
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,  /* 20..2F */
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,  /* 30..3F */
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,  /* 40..4F */
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,  /* 50..5F */
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,  /* 60..6F */
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,  /* 70..7F */
+    1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U,  /* 80..8F */
+    2U, 2U, 2U, 2U, 2U, 2U, 2U, 2U, 2U, 2U, 2U, 2U, 2U, 2U, 2U, 2U,  /* 90..9F */
+    3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U,  /* A0..AF */
+    3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U, 3U,  /* B0..BF */
+    4U, 4U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U,  /* C0..CF */
+    5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U, 5U,  /* D0..DF */
+    6U, 7U, 7U, 7U, 7U, 7U, 7U, 7U, 7U, 7U, 7U, 7U, 7U, 8U, 7U, 7U,  /* E0..EF */
+    9U, 10U, 10U, 10U, 11U, 4U, 4U, 4U, 4U, 4U, 4U, 4U, 4U, 4U, 4U, 4U /* F0..FF */
+};
+
+/* okj_utf8_transition[state][class].  States 2..4 expect 1..3 more
+ * continuation bytes of any value; states 5..8 expect one continuation byte
+ * from the restricted range that follows E0, ED, F0 and F4 respectively. */
+static const uint8_t okj_utf8_transition[OKJ_UTF8_STATES][OKJ_UTF8_CLASSES] =
+{
+    /*  ASCII 80-8F 90-9F A0-BF  bad  C2-DF  E0   E1-EF  ED    F0  F1-F3  F4 */
+    {   0U,   1U,   1U,   1U,   1U,   2U,   5U,   3U,   6U,   7U,   4U,   8U },  /* 0 accept   */
+    {   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U },  /* 1 reject   */
+    {   1U,   0U,   0U,   0U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U },  /* 2 need 1   */
+    {   1U,   2U,   2U,   2U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U },  /* 3 need 2   */
+    {   1U,   3U,   3U,   3U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U },  /* 4 need 3   */
+    {   1U,   1U,   1U,   2U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U },  /* 5 after E0 */
+    {   1U,   2U,   2U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U },  /* 6 after ED */
+    {   1U,   1U,   3U,   3U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U },  /* 7 after F0 */
+    {   1U,   3U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U,   1U }   /* 8 after F4 */
+};
 
 /*@
   // Preconditions
@@ -173,8 +207,8 @@ static uint8_t okj_is_utf8_continuation(uint8_t byte)
   disjoint behaviors;
 */
 static uint8_t okj_validate_utf8_sequence(const char *src,
-                                          uint16_t    pos,
-                                          uint16_t    len,
+                                          OkjSize     pos,
+                                          OkjSize     len,
                                           uint16_t   *advance)
 {
     /* Validate one UTF-8 scalar-value sequence starting at src[pos], with
@@ -182,165 +216,44 @@ static uint8_t okj_validate_utf8_sequence(const char *src,
      * (1..4) and returns 1; on invalid/truncated input returns 0 without
      * reading past src[len - 1].
      *
-     * Every multi-byte read is gated by an explicit bounds check against
-     * `len` so that truncated input (a multi-byte lead at end-of-buffer)
-     * is rejected as invalid, not a heap-buffer-overread.
-     *
-     * TODO: Refactoring this to comply with single return rule has
-     * really made the cognitive complexity of this function worse.
-     * Need to refactor this again to reduce it. -RLM
-     */
+     * The DFA leaves the accept state on a lead byte and returns to it after
+     * the last continuation byte, or drops into the reject state at the
+     * first byte that cannot continue the sequence.  Either happens within
+     * four bytes.  A sequence cut short by `len` is still mid-way and is
+     * rejected as truncated. */
     uint8_t result = 0U;
 
     if ((src != NULL) && (advance != NULL) && (pos < len))
     {
-        uint8_t  b0         = (uint8_t)src[pos];
-        uint16_t bytes_left = (uint16_t)(len - pos);
+        OkjSize  bytes_left = (OkjSize)(len - pos);
+        uint16_t n          = 0U;
+        uint8_t  state      = OKJ_UTF8_ACCEPT;
+        uint8_t  done       = 0U;
 
-        if (b0 <= 0x7FU)
-        {
-            *advance = 1U;
-            result = 1U;
-        }
-        else if (bytes_left < 2U)
-        {
-            /* Need b1 but no byte after the lead is available — truncated. */
-            result = 0U;
-        }
-        else
+        /*@
+          loop invariant 0 <= n <= 4 && n <= bytes_left;
+          loop invariant state < OKJ_UTF8_STATES;
+          loop invariant done == 0 || done == 1;
+          loop invariant done == 0 ==> n < 4 && n < bytes_left;
+
+          loop assigns n, state, done;
+          loop variant 4 - n + (1 - done);
+        */
+        while (done == 0U)
         {
-            uint8_t b1 = (uint8_t)src[pos + 1U];
+            state = okj_utf8_transition[state][okj_utf8_class[(uint8_t)src[pos + n]]];
+            n++;
 
-            if ((b0 >= 0xC2U) && (b0 <= 0xDFU))
-            {
-                if (okj_is_utf8_continuation(b1) != 0U)
-                {
-                    *advance = 2U;
-                    result = 1U;
-                }
-                else
-                {
-                    result = 0U;
-                }
-            }
-            else if (bytes_left < 3U)
+            if ((state <= OKJ_UTF8_REJECT) || (n >= bytes_left) || (n >= 4U))
             {
-                /* Need b2 but fewer than 3 bytes available — truncated or
-                 * the lead byte is in an invalid range (e.g. 0x80..0xC1)
-                 * that the validator can only classify as "not a 2-byte
-                 * sequence" after reading b2. */
-                result = 0U;
+                done = 1U;
             }
-            else
-            {
-                uint8_t b2 = (uint8_t)src[pos + 2U];
-
-                if (b0 == 0xE0U)
-                {
-                    if ((b1 >= 0xA0U) && (b1 <= 0xBFU) &&
-                        (okj_is_utf8_continuation(b2) != 0U))
-                    {
-                        *advance = 3U;
-                        result = 1U;
-                    }
-                    else
-                    {
-                        result = 0U;
-                    }
-                }
-                else
-                {
-                    if (((b0 >= 0xE1U) && (b0 <= 0xECU)) ||
-                        ((b0 >= 0xEEU) && (b0 <= 0xEFU)))
-                    {
-                        if ((okj_is_utf8_continuation(b1) != 0U) &&
-                            (okj_is_utf8_continuation(b2) != 0U))
-                        {
-                            *advance = 3U;
-                            result = 1U;
-                        }
-                        else
-                        {
-                            result = 0U;
-                        }
-                    }
-                    else
-                    {
-                        if (b0 == 0xEDU)
-                        {
-                            if ((b1 >= 0x80U) && (b1 <= 0x9FU) &&
-                                (okj_is_utf8_continuation(b2) != 0U))
-                            {
-                                *advance = 3U;
-                                result = 1U;
-                            }
-                            else
-                            {
-                                result = 0U;
-                            }
-                        }
-                        else if (bytes_left < 4U)
-                        {
-                            /* Need b3 for 4-byte paths (or to reject invalid
-                             * lead bytes in 0x80..0xC1 / 0xF5..0xFF). */
-                            result = 0U;
-                        }
-                        else
-                        {
-                            uint8_t b3 = (uint8_t)src[pos + 3U];
+        }
 
-                            if (b0 == 0xF0U)
-                            {
-                                if ((b1 >= 0x90U) && (b1 <= 0xBFU) &&
-                                    (okj_is_utf8_continuation(b2) != 0U) &&
-                                    (okj_is_utf8_continuation(b3) != 0U))
-                                {
-                                    *advance = 4U;
-                                    result = 1U;
-                                }
-                                else
-                                {
-                                    result = 0U;
-                                }
-                            }
-                            else
-                            {
-                                if ((b0 >= 0xF1U) && (b0 <= 0xF3U))
-                                {
-                                    if ((okj_is_utf8_continuation(b1) != 0U) &&
-                                        (okj_is_utf8_continuation(b2) != 0U) &&
-                                        (okj_is_utf8_continuation(b3) != 0U))
-                                    {
-                                        *advance = 4U;
-                                        result = 1U;
-                                    }
-                                    else
-                                    {
-                                        result = 0U;
-                                    }
-                                }
-                                else
-                                {
-                                    if (b0 == 0xF4U)
-                                    {
-                                        if ((b1 >= 0x80U) && (b1 <= 0x8FU) &&
-                                            (okj_is_utf8_continuation(b2) != 0U) &&
-                                            (okj_is_utf8_continuation(b3) != 0U))
-                                        {
-                                            *advance = 4U;
-                                            result = 1U;
-                                        }
-                                        else
-                                        {
-                                            result = 0U;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+        if (state == OKJ_UTF8_ACCEPT)
+        {
+            *advance = n;
+            result = 1U;
         }
     }
 
@@ -528,7 +441,7 @@ static const char *okj_skip_string(const char *p, const char *end)
   // The number of elements can never exceed the total number of bytes in the buffer.
   ensures \result <= end - start;
 */
-static uint16_t okj_count_array_elements(const char *start, const char *end)
+static OkjSize okj_count_array_elements(const char *start, const char *end)
 {
     /* Count the number of elements in a JSON array whose text begins at `start`
      * (which must point to the '[' character).  `end` is one past the last valid
@@ -538,7 +451,7 @@ static uint16_t okj_count_array_elements(const char *start, const char *end)
 
     const char *p = start;
 
-    uint16_t count = 0U;
+    OkjSize count = 0U;
 
     if ((p != NULL) && (*p == '['))
     {
@@ -636,7 +549,7 @@ static uint16_t okj_count_array_elements(const char *start, const char *end)
   // The number of members can never exceed the total number of bytes in the buffer.
   ensures \result <= end - start;
 */
-static uint16_t okj_count_object_members(const char *start, const char *end)
+static OkjSize okj_count_object_members(const char *start, const char *end)
 {
   /* Count the number of key-value members in a JSON object whose text begins
    * at `start` (which must point to the '{' character).  `end` is one past the
@@ -645,7 +558,7 @@ static uint16_t okj_count_object_members(const char *start, const char *end)
   
     const char *p = start;
 
-    uint16_t count = 0U;
+    OkjSize count = 0U;
 
     if ((p != NULL) && (*p == '{'))
     {
@@ -720,7 +633,7 @@ static uint16_t okj_count_object_members(const char *start, const char *end)
   // The length can never exceed the total number of bytes in the buffer.
   ensures \result <= end - start;
 */
-static uint16_t okj_measure_container(const char *start, const char *end)
+static OkjSize okj_measure_container(const char *start, const char *end)
 {
     /* Measure the full byte length of a JSON array or object starting at `start`
      * (which must point to '[' or '{').  `end` is one past the last valid byte of
@@ -820,803 +733,6667 @@ static uint16_t okj_measure_container(const char *start, const char *end)
         diff = p - start;
     }
 
-    return (uint16_t)diff;
+    return (OkjSize)diff;
 }
 
 /*@
   // 1. Preconditions
-  // The parser pointer can be NULL, or it must point to a valid struct.
-  requires parser == \null || \valid(parser);
-  
-  // IF the parser is not NULL, the JSON payload it points to must be 
-  // safely readable from index 0 up to json_len - 1.
-  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
-  
-  // IF the parser is not NULL, the current position must not already 
-  // exceed the payload length.
-  requires parser != \null ==> parser->position <= parser->json_len;
-
-  // 2. Behaviors (These handle the 'assigns' automatically)
-  behavior is_null:
-    assumes parser == \null;
-    assigns \nothing;
+  // Exactly eight bytes starting at src are read.
+  requires \valid_read(src + (0 .. 7));
 
-  behavior valid_parser:
-    assumes parser != \null;
-    assigns parser->position;
-    ensures parser->position >= \old(parser->position); // Position never goes backwards
-    ensures parser->position <= parser->json_len;       // Position never exceeds buffer
+  // 2. Frame Condition
+  assigns \nothing;
+*/
+static okj_u64 okj_load_word(const char *src)
+{
+    /* Assemble the eight bytes at `src` into a word with src[0] in the least
+     * significant byte.  Built from individual byte reads so there are no
+     * alignment or strict-aliasing concerns (MISRA C:2012 Rule 11.3); written
+     * as a single expression so an optimising compiler recognises the idiom
+     * and emits one unaligned load. */
+    okj_u64 word = ((okj_u64)(uint8_t)src[0])        |
+                   ((okj_u64)(uint8_t)src[1] << 8U)   |
+                   ((okj_u64)(uint8_t)src[2] << 16U)  |
+                   ((okj_u64)(uint8_t)src[3] << 24U)  |
+                   ((okj_u64)(uint8_t)src[4] << 32U)  |
+                   ((okj_u64)(uint8_t)src[5] << 40U)  |
+                   ((okj_u64)(uint8_t)src[6] << 48U)  |
+                   ((okj_u64)(uint8_t)src[7] << 56U);
+
+    return word;
+}
 
-  complete behaviors;
-  disjoint behaviors;
+/*@
+  // 1. Frame Condition
+  assigns \nothing;
 */
-static void okj_skip_whitespace(OkJsonParser *parser)
+static okj_u64 okj_swar_nonzero_bytes(okj_u64 x)
 {
-    if (parser != NULL)
-    {
-        /*@
-          // LOOP INVARIANTS: These are mathematically proven before the loop 
-          // starts, at the end of every iteration, and after the loop exits.
-          // Split into individual goals for the prover.
+    /* Returns a mask with the high bit of each byte set when the matching
+     * byte of `x` is non-zero and clear when it is zero.  Adding 0x7F to the
+     * low seven bits can never carry out of a byte, so unlike the classic
+     * "has zero byte" trick every lane of the result is exact. */
+    const okj_u64 low7 = 0x7F7F7F7F7F7F7F7FULL;
 
-          loop invariant \at(parser->position, Pre) <= parser->position;
-          loop invariant parser->position <= parser->json_len;
-          
-          loop assigns parser->position;
-          loop variant parser->json_len - parser->position;
-        */
-        while ((parser->position < parser->json_len) &&
-               (okj_is_whitespace(parser->json[parser->position]) == 1U))
-        {
-            parser->position++;
-        }
-    }
+    return (((x & low7) + low7) | x) & ~low7;
 }
 
 /*@
-  // Preconditions
-  //
-  // parser may be NULL — we handle that gracefully by returning
-  // OKJ_ERROR_BAD_POINTER.  If non-NULL, the struct must be valid for r/w
-  // and the json buffer it references must be readable for the full
-  // json_len bytes (otherwise every indexed read inside the inner loops
-  // is undefined behavior — the class of bug Issue #69 reported).
-  requires parser == \null || \valid(parser);
-  requires parser != \null ==>
-             \valid_read(parser->json + (0 .. parser->json_len - 1));
-  requires parser != \null ==> parser->position <= parser->json_len;
-  requires parser != \null ==>
-             \valid(parser->tokens + (0 .. OKJ_MAX_TOKENS - 1));
-
-  // Behaviors carry the frame condition — ACSL does not support a ternary
-  // in the assigns clause, so we split the two cases into behaviors.
-  behavior null_parser:
-    assumes parser == \null;
-    assigns \nothing;
+  // 1. Frame Condition
+  assigns \nothing;
+*/
+static okj_u64 okj_swar_non_whitespace(okj_u64 word)
+{
+    /* Classify eight bytes at once: the high bit of a lane is set when that
+     * byte is NOT one of the four RFC 8259 whitespace characters (the same
+     * set okj_is_whitespace() accepts). */
+    const okj_u64 ones = 0x0101010101010101ULL;
+
+    return okj_swar_nonzero_bytes(word ^ (ones * 0x20U)) &
+           okj_swar_nonzero_bytes(word ^ (ones * 0x09U)) &
+           okj_swar_nonzero_bytes(word ^ (ones * 0x0AU)) &
+           okj_swar_nonzero_bytes(word ^ (ones * 0x0DU));
+}
 
-  behavior valid_parser:
-    assumes parser != \null;
-    assigns *parser;
-    ensures parser->position <= parser->json_len;
+/*@
+  // 1. Preconditions
+  // Only lane high bits may be set and at least one of them must be.
+  requires mask != 0;
+  requires (mask & ~0x8080808080808080) == 0;
 
-  complete behaviors;
-  disjoint behaviors;
+  // 2. Frame Condition
+  assigns \nothing;
 
-  // NOTE: Full WP verification of this function requires extensive loop
-  // invariants on the string/number/escape inner loops.  This is tracked
-  // as follow-up work (see TODO_LIST).  Adding this function to -wp-fct
-  // without those invariants will produce unverified goals.
- */
-/*
- * TODO: Refactor to reduce complexity. -RLM
- */
-static OkjError okj_parse_value(OkJsonParser *parser)
+  // 3. Postconditions
+  ensures \result <= 7;
+*/
+static uint16_t okj_swar_first_byte(okj_u64 mask)
 {
-    OkjError    result  = OKJ_SUCCESS;
-    OkJsonToken *tok    = NULL;
+    /* Return the index (0..7) of the lowest byte lane whose high bit is set
+     * in `mask`.  Isolating the lowest set bit leaves 1 << (8k + 7); after
+     * shifting down, multiplying by 0x0001020304050607 moves byte (7 - k) of
+     * the constant, whose value is k, into the top byte.  No intrinsics and
+     * no data-dependent branches. */
+    const okj_u64 lowest = (mask & (~mask + 1U)) >> 7U;
+
+    /* The final mask is a no-op for well-formed input; it makes the 0..7
+     * range evident to the WP prover. */
+    return (uint16_t)(((lowest * 0x0001020304050607ULL) >> 56U) & 7U);
+}
 
-    if (parser == NULL)
-    {
-        result = OKJ_ERROR_BAD_POINTER;
-    }
-    else
-    {
-        okj_skip_whitespace(parser);
+/*@
+  // 1. Preconditions
+  requires src != \null && non_ascii != \null;
+  requires \valid(non_ascii);
+  requires pos <= limit;
+  requires \valid_read(src + (pos .. limit - 1));
 
-        if (parser->position >= parser->json_len)
+  // 2. Frame Condition
+  assigns *non_ascii;
+
+  // 3. Postconditions
+  ensures pos <= \result <= limit;
+  ensures *non_ascii == 0 || *non_ascii == 1;
+*/
+static OkjSize okj_scan_string_run(const char *src,
+                                   OkjSize     pos,
+                                   OkjSize     limit,
+                                   uint8_t    *non_ascii)
+{
+    /* Find the first byte in src[pos .. limit - 1] that ends a plain run of
+     * string content: a '"', a '\\' or a control character (< 0x20).  Returns
+     * its index, or `limit` if there is none.  *non_ascii is set to 1 when any
+     * byte >= 0x80 occurs before that index, i.e. when the run still needs
+     * UTF-8 validation; a pure-ASCII run is valid as it stands.
+     *
+     * Blocks are only loaded when they lie entirely below `limit`; the tail
+     * is finished byte-wise, so the scan never reads past the caller's
+     * bound.  With OK_JSON_USE_SSE2 defined the main loop classifies sixteen
+     * bytes per step with SSE2; otherwise eight bytes per step with SWAR. */
+    OkjSize  p     = pos;
+    uint8_t  high  = 0U;
+    uint8_t  found = 0U;
+
+#ifdef OK_JSON_USE_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    const __m128i ctrl_max = _mm_set1_epi8(0x1F);
+
+    while ((found == 0U) && ((OkjSize)(limit - p) >= 16U))
+    {
+        __m128i  v    = _mm_loadu_si128((const __m128i *)&src[p]);
+        __m128i  ctrl = _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl_max), ctrl_max);
+        __m128i  spec = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                                  _mm_cmpeq_epi8(v, bslash)),
+                                     ctrl);
+        uint16_t smask = (uint16_t)_mm_movemask_epi8(spec);
+        uint16_t hmask = (uint16_t)_mm_movemask_epi8(v);
+
+        if (smask == 0U)
         {
-            /* End of input — nothing to do. */
+            if (hmask != 0U)
+            {
+                high = 1U;
+            }
+
+            p += 16U;
         }
         else
         {
+            uint16_t lowest = (uint16_t)(smask & (uint16_t)(~smask + 1U));
+            uint16_t idx    = 0U;
 
-        char c = parser->json[parser->position];
-
-        if (c == '{')
-        {
-            /* Object open is only valid in a value position. */
-            if ((parser->context != OKJ_CTX_WANT_VALUE) &&
-                (parser->context != OKJ_CTX_WANT_VALUE_OR_CLOSE))
+            while ((lowest >> idx) != 1U)
             {
-                result = OKJ_ERROR_SYNTAX;
+                idx++;
             }
-            else
-            {
-                if (parser->depth >= (uint16_t)OKJ_MAX_DEPTH)
-                {
-                    result = OKJ_ERROR_MAX_DEPTH_EXCEEDED;
-                }
-                else
-                {
-                    tok         = &parser->tokens[parser->token_count];
-                    tok->type   = OKJ_OBJECT;
-                    tok->start  = &parser->json[parser->position];
-                    tok->length = 1U;
-
-                    parser->depth_stack[parser->depth] = OKJ_OBJECT;
-                    parser->depth++;
-                    parser->position++;
-                    parser->token_count++;
 
-                    /* After '{' we expect a key string or immediate '}' (empty object). */
-                    parser->context = OKJ_CTX_WANT_KEY_OR_CLOSE;
-                }
+            if ((hmask & (uint16_t)(lowest - 1U)) != 0U)
+            {
+                high = 1U;
             }
+
+            p += idx;
+            found = 1U;
         }
-        else if (c == '[')
+    }
+#endif /* OK_JSON_USE_SSE2 */
+
+    /*@
+      loop invariant pos <= p <= limit;
+      loop invariant found == 0 || found == 1;
+      loop invariant high == 0 || high == 1;
+
+      loop assigns p, found, high;
+      loop variant limit - p + (1 - found);
+    */
+    while ((found == 0U) && ((OkjSize)(limit - p) >= 8U))
+    {
+        const okj_u64 ones  = 0x0101010101010101ULL;
+        const okj_u64 low7  = 0x7F7F7F7F7F7F7F7FULL;
+        const okj_u64 highs = ~low7;
+
+        okj_u64 w = okj_load_word(&src[p]);
+
+        /* Lanes >= 0x20 (or with the high bit set) get their high bit set;
+         * the complement marks the control characters. */
+        okj_u64 printable = (((w & low7) + (ones * 0x60U)) | w) & highs;
+        okj_u64 special   = (~okj_swar_nonzero_bytes(w ^ (ones * 0x22U)) & highs) |
+                             (~okj_swar_nonzero_bytes(w ^ (ones * 0x5CU)) & highs) |
+                             (~printable & highs);
+
+        if (special == 0U)
         {
-            /* Array open is only valid in a value position. */
-            if ((parser->context != OKJ_CTX_WANT_VALUE) &&
-                (parser->context != OKJ_CTX_WANT_VALUE_OR_CLOSE))
+            if ((w & highs) != 0U)
             {
-                result = OKJ_ERROR_SYNTAX;
+                high = 1U;
             }
-            else
-            {
-                if (parser->depth >= (uint16_t)OKJ_MAX_DEPTH)
-                {
-                    result = OKJ_ERROR_MAX_DEPTH_EXCEEDED;
-                }
-                else
-                {
-                    tok         = &parser->tokens[parser->token_count];
-                    tok->type   = OKJ_ARRAY;
-                    tok->start  = &parser->json[parser->position];
-                    tok->length = 1U;
-
-                    parser->depth_stack[parser->depth] = OKJ_ARRAY;
-                    parser->depth++;
-                    parser->position++;
-                    parser->token_count++;
 
-                    /* After '[' we expect a value or immediate ']' (empty array). */
-                    parser->context = OKJ_CTX_WANT_VALUE_OR_CLOSE;
-                }
-            }
+            p += 8U;
         }
-        else if (c == '}')
+        else
         {
-            /* '}' is valid:
-            *  - after a value in a non-empty object (WANT_SEP_OR_CLOSE), or
-            *  - immediately after '{' to close an empty object (WANT_KEY_OR_CLOSE).
-            * It is NOT valid after a trailing comma (WANT_KEY). */
-            if ((parser->context != OKJ_CTX_WANT_SEP_OR_CLOSE) &&
-                (parser->context != OKJ_CTX_WANT_KEY_OR_CLOSE))
+            uint16_t idx = okj_swar_first_byte(special);
+
+            /* Only the lanes before the special byte belong to the run. */
+            if ((w & highs & ((0x01ULL << (8U * idx)) - 1U)) != 0U)
             {
-                result = OKJ_ERROR_SYNTAX;
+                high = 1U;
             }
-            else
-            {
-                /* Validate the closing bracket against the depth stack. */
-                if (parser->depth == 0U)
-                {
-                    result = OKJ_ERROR_BRACKET_MISMATCH;
-                }
-                else
-                {
-                    parser->depth--;
 
-                    if (parser->depth_stack[parser->depth] != OKJ_OBJECT)
-                    {
-                        result = OKJ_ERROR_BRACKET_MISMATCH;
-                    }
-                    else
-                    {
-                        parser->position++;
+            p += idx;
+            found = 1U;
+        }
+    }
 
-                        /* Update context for the enclosing container (if any). */
-                        if (parser->depth > 0U)
-                        {
-                            parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
-                        }
-                    }
-                }
-            }
+    /*@
+      loop invariant pos <= p <= limit;
+      loop invariant high == 0 || high == 1;
+
+      loop assigns p, high;
+      loop variant limit - p;
+    */
+    while ((found == 0U) && (p < limit) &&
+           (src[p] != '"') && (src[p] != '\\') &&
+           ((uint8_t)src[p] >= 0x20U))
+    {
+        if ((uint8_t)src[p] >= 0x80U)
+        {
+            high = 1U;
         }
-        else if (c == ']')
+
+        p++;
+    }
+
+    *non_ascii = high;
+
+    return p;
+}
+
+/*@
+  // 1. Preconditions
+  requires src != \null && stop != \null;
+  requires \valid(stop);
+  requires pos <= end <= len;
+  requires \valid_read(src + (0 .. len - 1));
+
+  // 2. Frame Condition
+  assigns *stop;
+
+  // 3. Postconditions
+  ensures \result == 0 || \result == 1;
+  ensures pos <= *stop <= len;
+  ensures \result == 1 ==> *stop >= end;
+*/
+static uint8_t okj_validate_utf8_block(const char *src,
+                                       OkjSize     pos,
+                                       OkjSize     end,
+                                       OkjSize     len,
+                                       OkjSize    *stop)
+{
+    /* Validate every UTF-8 sequence that starts in src[pos .. end - 1].  The
+     * last one may run on past `end` (but never past `len`), so *stop is
+     * the index just after it, which can exceed `end`.  Returns 1 if all are
+     * well-formed; otherwise returns 0 with *stop at the start of the first
+     * ill-formed sequence.
+     *
+     * ASCII is confirmed a block at a time by testing the high bit of every
+     * byte at once (sixteen with OK_JSON_USE_SSE2, else eight), skipping
+     * straight to the first non-ASCII byte.  Only there is the DFA in
+     * okj_validate_utf8_sequence() run, once per multi-byte sequence. */
+    OkjSize  p       = pos;
+    uint16_t advance = 0U;
+    uint8_t  result  = 1U;
+
+    /*@
+      loop invariant pos <= p <= len;
+      loop invariant result == 0 || result == 1;
+      loop invariant result == 0 ==> p < end;
+
+      loop assigns p, advance, result;
+      loop variant len - p + result;
+    */
+    while ((result == 1U) && (p < end))
+    {
+        uint16_t skip = 0U;
+
+#ifdef OK_JSON_USE_SSE2
+        if ((OkjSize)(end - p) >= 16U)
         {
-            /* ']' is valid:
-            *  - after a value in a non-empty array (WANT_SEP_OR_CLOSE), or
-            *  - immediately after '[' to close an empty array (WANT_VALUE_OR_CLOSE).
-            * It is NOT valid after a trailing comma (WANT_VALUE). */
-            if ((parser->context != OKJ_CTX_WANT_SEP_OR_CLOSE) &&
-                (parser->context != OKJ_CTX_WANT_VALUE_OR_CLOSE))
+            uint16_t hmask = (uint16_t)_mm_movemask_epi8(
+                                 _mm_loadu_si128((const __m128i *)&src[p]));
+
+            if (hmask == 0U)
             {
-                result = OKJ_ERROR_SYNTAX;
+                skip = 16U;
             }
             else
             {
-                if (parser->depth == 0U)
+                while (((hmask >> skip) & 1U) == 0U)
                 {
-                    result = OKJ_ERROR_BRACKET_MISMATCH;
+                    skip++;
                 }
-                else
-                {
-                    parser->depth--;
+            }
+        }
+        else
+#endif /* OK_JSON_USE_SSE2 */
+        if ((OkjSize)(end - p) >= 8U)
+        {
+            okj_u64 high = okj_load_word(&src[p]) & 0x8080808080808080ULL;
 
-                    if (parser->depth_stack[parser->depth] != OKJ_ARRAY)
-                    {
-                        result = OKJ_ERROR_BRACKET_MISMATCH;
-                    }
-                    else
-                    {
-                        parser->position++;
+            skip = (high == 0U) ? 8U : okj_swar_first_byte(high);
+        }
+        else if ((uint8_t)src[p] < 0x80U)
+        {
+            skip = 1U;
+        }
+        else
+        {
+            /* Non-ASCII byte in the tail: skip stays 0. */
+        }
 
-                        if (parser->depth > 0U)
-                        {
-                            parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
-                        }
-                    }
-                }
-            }
+        if (skip != 0U)
+        {
+            p += skip;
         }
-        else if (c == ',')
+        else if (okj_validate_utf8_sequence(src, p, len, &advance) == 1U)
         {
-            /* Comma is only valid after a completed value.  Trailing commas
-            * (comma followed immediately by a closing bracket) are forbidden
-            * by RFC 8259. */
-            if (parser->context != OKJ_CTX_WANT_SEP_OR_CLOSE)
-            {
-                result = OKJ_ERROR_SYNTAX;
-            }
-            else
-            {
-                if (parser->depth == 0U)
-                {
-                    result = OKJ_ERROR_SYNTAX;    /* comma outside any container */
-                }
-                else
-                {
-                    parser->position++;
+            p += advance;
+        }
+        else
+        {
+            result = 0U;
+        }
+    }
 
-                    /* What comes next depends on whether we are inside an object or array.
-                    * Note: WANT_KEY (not WANT_KEY_OR_CLOSE) prevents trailing commas. */
-                    if (parser->depth_stack[parser->depth - 1U] == OKJ_OBJECT)
-                    {
-                        parser->context = OKJ_CTX_WANT_KEY;
-                    }
-                    else
-                    {
-                        parser->context = OKJ_CTX_WANT_VALUE;
-                    }
-                }
-            }
+    *stop = p;
+
+    return result;
+}
+
+/*@
+  requires \valid_read(json + (0 .. len - 1));
+  requires start <= len;
+  assigns \nothing;
+  ensures start <= \result <= len;
+*/
+static OkjSize okj_space_end(const char *json, OkjSize len, OkjSize start)
+{
+    /* Offset of the first non-whitespace byte at or after `start`, or `len`. */
+
+    OkjSize  pos   = start;
+    uint16_t head  = 0U;
+    uint8_t  found = 0U;
+
+    /* Compact JSON has no whitespace between most tokens and pretty
+     * printers mostly emit short runs (a newline plus a few spaces).
+     * Those are cheapest byte-wise, so the first word's worth of bytes is
+     * examined one at a time before switching to the word pass. */
+
+    /*@
+      loop invariant start <= pos;
+      loop invariant pos <= len;
+      loop invariant 0 <= head <= 8;
+      loop invariant found == 0 || found == 1;
+
+      loop assigns pos, head, found;
+      loop variant 8 - head + (1 - found);
+    */
+    while ((found == 0U) && (head < 8U) && (pos < len))
+    {
+        if (okj_is_whitespace(json[pos]) == 1U)
+        {
+            pos++;
+            head++;
+        }
+        else
+        {
+            found = 1U;
+        }
+    }
+
+    /* Word-at-a-time pass: classify eight bytes per iteration and, on the
+     * first word that holds a non-whitespace byte, jump straight to it.
+     * A word is only loaded when all eight of its bytes lie below
+     * len, so the scan never reads past the caller's buffer.  Runs
+     * of plain spaces (indentation) are settled with one compare before
+     * the full four-character classification. */
+
+    /*@
+      loop invariant start <= pos;
+      loop invariant pos <= len;
+      loop invariant found == 0 || found == 1;
+
+      loop assigns pos, found;
+      loop variant len - pos + (1 - found);
+    */
+    while ((found == 0U) && ((OkjSize)(len - pos) >= 8U))
+    {
+        okj_u64 word = okj_load_word(&json[pos]);
+
+        if (word == 0x2020202020202020ULL)
+        {
+            pos += 8U;
         }
-        else if (c == ':')
+        else
         {
-            /* Colon is only valid immediately after an object key string. */
-            if (parser->context != OKJ_CTX_WANT_COLON)
+            okj_u64 mask = okj_swar_non_whitespace(word);
+
+            if (mask == 0U)
             {
-                result = OKJ_ERROR_SYNTAX;
+                pos += 8U;
             }
             else
             {
-                parser->position++;
-                parser->context = OKJ_CTX_WANT_VALUE;
+                pos += okj_swar_first_byte(mask);
+                found = 1U;
             }
         }
-        else if (c == '"')
+    }
+
+    /* Byte-wise tail: covers the final partial word (fewer than eight
+     * bytes left) and is a no-op when the word pass already stopped on
+     * a non-whitespace byte. */
+
+    /*@
+      // LOOP INVARIANTS: These are mathematically proven before the loop 
+      // starts, at the end of every iteration, and after the loop exits.
+      // Split into individual goals for the prover.
+
+      loop invariant start <= pos;
+      loop invariant pos <= len;
+      
+      loop assigns pos;
+      loop variant len - pos;
+    */
+    while ((found == 0U) && (pos < len) && (okj_is_whitespace(json[pos]) == 1U))
+    {
+        pos++;
+    }
+
+    return pos;
+}
+
+/*@
+  // 1. Preconditions
+  // The parser pointer can be NULL, or it must point to a valid struct.
+  requires parser == \null || \valid(parser);
+  
+  // IF the parser is not NULL, the JSON payload it points to must be 
+  // safely readable from index 0 up to json_len - 1.
+  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
+  
+  // IF the parser is not NULL, the current position must not already 
+  // exceed the payload length.
+  requires parser != \null ==> parser->position <= parser->json_len;
+
+  // 2. Behaviors (These handle the 'assigns' automatically)
+  behavior is_null:
+    assumes parser == \null;
+    assigns \nothing;
+
+  behavior valid_parser:
+    assumes parser != \null;
+    assigns parser->position;
+    ensures parser->position >= \old(parser->position); // Position never goes backwards
+    ensures parser->position <= parser->json_len;       // Position never exceeds buffer
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+static inline void okj_skip_whitespace(OkJsonParser *parser)
+{
+    if (parser != NULL)
+    {
+        parser->position = okj_space_end(parser->json, parser->json_len, parser->position);
+    }
+}
+
+/**
+ * The token grammar is data: okj_char_class maps the first byte of a token to
+ * one of twelve classes, and okj_grammar_action maps (context, class) to what
+ * okj_parse_value() does with it.  Everything not listed is a syntax error.
+ */
+#define OKJ_CC_OTHER     0U   /* Cannot start a token                    */
+#define OKJ_CC_LBRACE    1U   /* {                                       */
+#define OKJ_CC_LBRACKET  2U   /* [                                       */
+#define OKJ_CC_RBRACE    3U   /* }                                       */
+#define OKJ_CC_RBRACKET  4U   /* ]                                       */
+#define OKJ_CC_COMMA     5U   /* ,                                       */
+#define OKJ_CC_COLON     6U   /* :                                       */
+#define OKJ_CC_QUOTE     7U   /* "                                       */
+#define OKJ_CC_NUMBER    8U   /* - 0..9                                  */
+#define OKJ_CC_TRUE      9U   /* t                                       */
+#define OKJ_CC_FALSE    10U   /* f                                       */
+#define OKJ_CC_NULL     11U   /* n                                       */
+#define OKJ_CHAR_CLASSES 12U
+
+#define OKJ_ACT_SYNTAX        0U
+#define OKJ_ACT_OPEN_OBJECT   1U
+#define OKJ_ACT_OPEN_ARRAY    2U
+#define OKJ_ACT_CLOSE_OBJECT  3U
+#define OKJ_ACT_CLOSE_ARRAY   4U
+#define OKJ_ACT_COMMA         5U
+#define OKJ_ACT_COLON         6U
+#define OKJ_ACT_KEY           7U
+#define OKJ_ACT_STRING        8U
+#define OKJ_ACT_NUMBER        9U
+#define OKJ_ACT_TRUE         10U
+#define OKJ_ACT_FALSE        11U
+#define OKJ_ACT_NULL         12U
+
+#define OKJ_GRAMMAR_CONTEXTS  6U
+
+static const uint8_t okj_char_class[256] =
+{
+    ['{'] = OKJ_CC_LBRACE,   ['['] = OKJ_CC_LBRACKET,
+    ['}'] = OKJ_CC_RBRACE,   [']'] = OKJ_CC_RBRACKET,
+    [','] = OKJ_CC_COMMA,    [':'] = OKJ_CC_COLON,
+    ['"'] = OKJ_CC_QUOTE,    ['-'] = OKJ_CC_NUMBER,
+    ['0'] = OKJ_CC_NUMBER,   ['1'] = OKJ_CC_NUMBER,
+    ['2'] = OKJ_CC_NUMBER,   ['3'] = OKJ_CC_NUMBER,
+    ['4'] = OKJ_CC_NUMBER,   ['5'] = OKJ_CC_NUMBER,
+    ['6'] = OKJ_CC_NUMBER,   ['7'] = OKJ_CC_NUMBER,
+    ['8'] = OKJ_CC_NUMBER,   ['9'] = OKJ_CC_NUMBER,
+    ['t'] = OKJ_CC_TRUE,     ['f'] = OKJ_CC_FALSE,
+    ['n'] = OKJ_CC_NULL
+};
+
+/* okj_grammar_action[context][class], rows in OkjParseContext order:
+ *  - '}' closes an object after a member value or straight after '{' (never
+ *    after a trailing comma, which leaves OKJ_CTX_WANT_KEY);
+ *  - ']' likewise closes an array after a value or straight after '[';
+ *  - ',' and ':' are only valid after a completed value and a key;
+ *  - keys must be strings; numbers and literals are values only. */
+static const uint8_t okj_grammar_action[OKJ_GRAMMAR_CONTEXTS][OKJ_CHAR_CLASSES] =
+{
+    /* OKJ_CTX_WANT_VALUE */
+    { OKJ_ACT_SYNTAX, OKJ_ACT_OPEN_OBJECT, OKJ_ACT_OPEN_ARRAY, OKJ_ACT_SYNTAX,
+      OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_STRING,
+      OKJ_ACT_NUMBER, OKJ_ACT_TRUE, OKJ_ACT_FALSE, OKJ_ACT_NULL },
+
+    /* OKJ_CTX_WANT_VALUE_OR_CLOSE */
+    { OKJ_ACT_SYNTAX, OKJ_ACT_OPEN_OBJECT, OKJ_ACT_OPEN_ARRAY, OKJ_ACT_SYNTAX,
+      OKJ_ACT_CLOSE_ARRAY, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_STRING,
+      OKJ_ACT_NUMBER, OKJ_ACT_TRUE, OKJ_ACT_FALSE, OKJ_ACT_NULL },
+
+    /* OKJ_CTX_WANT_KEY */
+    { OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX,
+      OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_KEY,
+      OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX },
+
+    /* OKJ_CTX_WANT_KEY_OR_CLOSE */
+    { OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_CLOSE_OBJECT,
+      OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_KEY,
+      OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX },
+
+    /* OKJ_CTX_WANT_COLON */
+    { OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX,
+      OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_COLON, OKJ_ACT_SYNTAX,
+      OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX },
+
+    /* OKJ_CTX_WANT_SEP_OR_CLOSE */
+    { OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_CLOSE_OBJECT,
+      OKJ_ACT_CLOSE_ARRAY, OKJ_ACT_COMMA, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX,
+      OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX, OKJ_ACT_SYNTAX }
+};
+
+/*
+ * Token accessors.  Tokens live in the caller's OkJsonToken buffer after
+ * okj_init_ex(), and otherwise in the parser's own storage: tokens[], or the
+ * tape when OK_JSON_COMPACT_TOKENS is defined.  Only okj_init(),
+ * okj_store_token(), okj_emit_token() and okj_close_container() write that
+ * storage; everything else reads it through these, so the getters are the
+ * same code for every layout.  Callers guarantee idx < parser->token_count.
+ */
+static inline OkJsonType okj_tok_type(const OkJsonParser *parser, OkjSize idx)
+{
+    OkJsonType type;
+
+    if (parser->token_buf != NULL)
+    {
+        type = parser->token_buf[idx].type;
+    }
+    else
+    {
+#ifdef OK_JSON_COMPACT_TOKENS
+        type = (OkJsonType)parser->tape.type[idx];
+#else
+        type = parser->tokens[idx].type;
+#endif
+    }
+
+    return type;
+}
+
+static inline char *okj_tok_start(const OkJsonParser *parser, OkjSize idx)
+{
+    char *start;
+
+    if (parser->token_buf != NULL)
+    {
+        start = parser->token_buf[idx].start;
+    }
+    else
+    {
+#ifdef OK_JSON_COMPACT_TOKENS
+        start = &parser->json[parser->tape.offset[idx]];
+#else
+        start = parser->tokens[idx].start;
+#endif
+    }
+
+    return start;
+}
+
+static inline OkjSize okj_tok_length(const OkJsonParser *parser, OkjSize idx)
+{
+    OkjSize length;
+
+    if (parser->token_buf != NULL)
+    {
+        length = parser->token_buf[idx].length;
+    }
+    else
+    {
+#ifdef OK_JSON_COMPACT_TOKENS
+        length = parser->tape.length[idx];
+#else
+        length = parser->tokens[idx].length;
+#endif
+    }
+
+    return length;
+}
+
+static inline OkjSize okj_tok_end(const OkJsonParser *parser, OkjSize idx)
+{
+    OkjSize end;
+
+    if (parser->token_buf != NULL)
+    {
+        end = parser->token_buf[idx].end;
+    }
+    else
+    {
+#ifdef OK_JSON_COMPACT_TOKENS
+        end = parser->tape.end[idx];
+#else
+        end = parser->tokens[idx].end;
+#endif
+    }
+
+    return end;
+}
+
+static inline OkjSize okj_tok_count(const OkJsonParser *parser, OkjSize idx)
+{
+    OkjSize count;
+
+    if (parser->token_buf != NULL)
+    {
+        count = parser->token_buf[idx].count;
+    }
+    else
+    {
+#ifdef OK_JSON_COMPACT_TOKENS
+        count = parser->tape.count[idx];
+#else
+        count = parser->tokens[idx].count;
+#endif
+    }
+
+    return count;
+}
+
+/*
+ * The parser's own token storage as the ACSL contracts of its writers see it:
+ * OKJ_OWN_TOKENS(p, i) names the memory of token(s) i, and the okj_own_*
+ * logic functions read its fields.  These only apply while token_buf is
+ * NULL; with a caller buffer the contracts name token_buf[i] directly.
+ */
+#ifdef OK_JSON_COMPACT_TOKENS
+#define OKJ_OWN_TOKENS(p, i) (p)->tape.type[i], (p)->tape.offset[i], (p)->tape.length[i], \
+                             (p)->tape.end[i], (p)->tape.count[i]
+/*@
+  logic integer okj_own_type{L}(OkJsonParser *p, integer i)   = p->tape.type[i];
+  logic integer okj_own_offset{L}(OkJsonParser *p, integer i) = p->tape.offset[i];
+  logic integer okj_own_length{L}(OkJsonParser *p, integer i) = p->tape.length[i];
+  logic integer okj_own_end{L}(OkJsonParser *p, integer i)    = p->tape.end[i];
+*/
+#else
+#define OKJ_OWN_TOKENS(p, i) (p)->tokens[i]
+/*@
+  logic integer okj_own_type{L}(OkJsonParser *p, integer i)   = p->tokens[i].type;
+  logic integer okj_own_offset{L}(OkJsonParser *p, integer i) = p->tokens[i].start - p->json;
+  logic integer okj_own_length{L}(OkJsonParser *p, integer i) = p->tokens[i].length;
+  logic integer okj_own_end{L}(OkJsonParser *p, integer i)    = p->tokens[i].end;
+*/
+#endif
+
+/*@
+  logic integer okj_frame_token{L}(OkJsonParser *p, integer d) =
+    p->depth_buf != \null ? p->depth_buf[d].token : p->depth_stack[d].token;
+
+  logic OkjDepthFrame *okj_frame{L}(OkJsonParser *p, integer d) =
+    p->depth_buf != \null ? &p->depth_buf[d] : &p->depth_stack[d];
+*/
+
+/*@
+  requires \valid(parser);
+  requires idx < parser->token_capacity;
+  requires \valid_read(tok);
+  requires \base_addr(tok->start) == \base_addr(parser->json);
+  requires parser->json <= tok->start <= parser->json + parser->json_len;
+  requires parser->token_buf != \null ==>
+             \valid(parser->token_buf + idx) && \separated(parser, parser->token_buf + idx);
+  requires parser->token_buf == \null ==> idx < OKJ_MAX_TOKENS;
+  requires \separated(tok, parser);
+
+  assigns OKJ_OWN_TOKENS(parser, idx), parser->token_buf[idx];
+
+  ensures parser->token_buf != \null ==>
+            parser->token_buf[idx].type   == tok->type &&
+            parser->token_buf[idx].start  == tok->start &&
+            parser->token_buf[idx].length == tok->length &&
+            parser->token_buf[idx].end    == tok->end;
+  ensures parser->token_buf == \null ==>
+            okj_own_type(parser, idx)   == tok->type &&
+            okj_own_offset(parser, idx) == tok->start - parser->json &&
+            okj_own_length(parser, idx) == tok->length &&
+            okj_own_end(parser, idx)    == tok->end;
+*/
+static void okj_store_token(OkJsonParser *parser, OkjSize idx, const OkJsonToken *tok)
+{
+    /* Write token `idx` to whichever storage the parser is using. */
+
+    if (parser->token_buf != NULL)
+    {
+        parser->token_buf[idx] = *tok;
+    }
+    else
+    {
+#ifdef OK_JSON_COMPACT_TOKENS
+        parser->tape.type[idx]   = (uint8_t)tok->type;
+        parser->tape.offset[idx] = (OkjSize)(tok->start - parser->json);
+        parser->tape.length[idx] = tok->length;
+        parser->tape.end[idx]    = tok->end;
+        parser->tape.count[idx]  = tok->count;
+#else
+        parser->tokens[idx] = *tok;
+#endif
+    }
+}
+
+/*@
+  requires \valid(parser);
+  requires d < parser->depth_capacity;
+  assigns \nothing;
+*/
+static inline OkjDepthFrame *okj_depth_frame(OkJsonParser *parser, uint16_t d)
+{
+    /* Depth frame `d` in the caller's buffer after okj_init_ex(), otherwise
+     * in parser->depth_stack. */
+
+    OkjDepthFrame *frame;
+
+    if (parser->depth_buf != NULL)
+    {
+        frame = &parser->depth_buf[d];
+    }
+    else
+    {
+        frame = &parser->depth_stack[d];
+    }
+
+    return frame;
+}
+
+/*@
+  requires \valid(parser);
+  requires parser->token_count < parser->token_capacity;
+  requires parser->depth <= parser->depth_capacity;
+  requires \valid_read(parser->json + (0 .. parser->json_len - 1));
+  requires start < parser->json_len;
+
+  requires parser->depth > 0 ==>
+           okj_frame_token(parser, parser->depth - 1) < parser->token_count;
+  requires parser->token_buf != \null ==>
+           \valid(parser->token_buf + (0 .. parser->token_capacity - 1)) &&
+           \separated(parser, parser->token_buf + (0 .. parser->token_capacity - 1));
+  requires parser->token_buf == \null ==> parser->token_capacity <= OKJ_MAX_TOKENS;
+  requires parser->depth_buf != \null ==>
+           \valid_read(parser->depth_buf + (0 .. parser->depth_capacity - 1));
+  requires parser->depth_buf == \null ==> parser->depth_capacity <= OKJ_MAX_DEPTH;
+
+  requires parser->key_set != \null ==>
+           \valid(parser->key_set->ids + parser->token_count);
+
+  assigns OKJ_OWN_TOKENS(parser, 0 .. OKJ_MAX_TOKENS - 1),
+          parser->token_buf[0 .. parser->token_capacity - 1],
+          parser->token_count,
+          parser->key_set->ids[parser->token_count];
+
+  ensures parser->token_count == \old(parser->token_count) + 1;
+  ensures parser->token_buf != \null ==>
+            parser->token_buf[\old(parser->token_count)].type   == type &&
+            parser->token_buf[\old(parser->token_count)].start  == parser->json + start &&
+            parser->token_buf[\old(parser->token_count)].length == length &&
+            parser->token_buf[\old(parser->token_count)].end    == 0;
+  ensures parser->token_buf == \null ==>
+            okj_own_type(parser, \old(parser->token_count))   == type &&
+            okj_own_offset(parser, \old(parser->token_count)) == start &&
+            okj_own_length(parser, \old(parser->token_count)) == length &&
+            okj_own_end(parser, \old(parser->token_count))    == 0;
+*/
+static void okj_emit_token(OkJsonParser *parser, OkJsonType type, OkjSize start, OkjSize length)
+{
+    /* Append a token at `start` in the JSON buffer and credit it to the
+     * enclosing container: every value in an array counts as one element,
+     * but in an object only the key counts, so a member is counted once.
+     * Must be called before the grammar context is advanced past the token. */
+
+    OkJsonToken tok;
+
+    tok.type   = type;
+    tok.start  = &parser->json[start];
+    tok.length = length;
+    tok.end    = 0U;
+    tok.count  = 0U;
+
+    okj_store_token(parser, parser->token_count, &tok);
+
+    if (parser->depth > 0U)
+    {
+        const OkjDepthFrame *frame = okj_depth_frame(parser, (uint16_t)(parser->depth - 1U));
+
+        if ((frame->type == OKJ_ARRAY)                  ||
+            (parser->context == OKJ_CTX_WANT_KEY)       ||
+            (parser->context == OKJ_CTX_WANT_KEY_OR_CLOSE))
+        {
+            if (parser->token_buf != NULL)
+            {
+                parser->token_buf[frame->token].count++;
+            }
+            else
+            {
+#ifdef OK_JSON_COMPACT_TOKENS
+                parser->tape.count[frame->token]++;
+#else
+                parser->tokens[frame->token].count++;
+#endif
+            }
+        }
+    }
+
+    if (parser->key_set != NULL)
+    {
+        /* Object keys are re-tagged by okj_key_intern() once identified. */
+        parser->key_set->ids[parser->token_count] = OKJ_KEY_ID_NONE;
+    }
+
+    parser->token_count++;
+}
+
+/*@
+  requires \valid(parser) && \valid(parser->key_set);
+  requires tok < parser->token_count;
+  requires \valid_read(parser->key_set->keys + (0 .. parser->key_set->n_keys - 1));
+
+  assigns parser->key_set->ids[tok],
+          parser->key_set->first[0 .. parser->key_set->n_keys - 1];
+*/
+static void okj_key_intern(OkJsonParser *parser, OkjSize tok)
+{
+    /* Tag key token `tok` with the ID of the registered key it equals.  A
+     * linear pass suits the small fixed schemas this is meant for; length
+     * and last byte reject most candidates before okj_match(). */
+    OkjKeySet  *set   = parser->key_set;
+    const char *start = okj_tok_start(parser, tok);
+    OkjSize     len   = okj_tok_length(parser, tok);
+    uint8_t     id;
+
+    /*@
+      loop invariant 0 <= id <= set->n_keys;
+      loop assigns id, set->ids[tok], set->first[0 .. set->n_keys - 1];
+      loop variant set->n_keys - id;
+    */
+    for (id = 0U; id < set->n_keys; id++)
+    {
+        const OkjKey *key = &set->keys[id];
+
+        if ((key->length == len) &&
+            ((len == 0U) || (key->bytes[len - 1U] == start[len - 1U])) &&
+            (okj_match(start, key->bytes, (uint16_t)len) == 1U))
+        {
+            set->ids[tok] = id;
+
+            if (set->first[id] == 0U)
+            {
+                set->first[id] = (OkjSize)(tok + 1U);
+            }
+
+            break;
+        }
+    }
+}
+
+/*@
+  requires \valid(parser);
+  requires parser->depth < parser->depth_capacity;
+  requires parser->token_count <= parser->token_capacity;
+  requires parser->position < parser->json_len;
+  requires okj_frame_token(parser, parser->depth) == OKJ_SIZE_MAX ||
+           okj_frame_token(parser, parser->depth) < parser->token_count;
+  requires parser->token_buf != \null ==>
+           \valid(parser->token_buf + (0 .. parser->token_capacity - 1)) &&
+           \separated(parser, parser->token_buf + (0 .. parser->token_capacity - 1));
+  requires parser->token_buf == \null ==> parser->token_capacity <= OKJ_MAX_TOKENS;
+  requires parser->depth_buf != \null ==>
+           \valid_read(parser->depth_buf + (0 .. parser->depth_capacity - 1));
+  requires parser->depth_buf == \null ==> parser->depth_capacity <= OKJ_MAX_DEPTH;
+
+  assigns OKJ_OWN_TOKENS(parser, 0 .. OKJ_MAX_TOKENS - 1),
+          parser->token_buf[0 .. parser->token_capacity - 1];
+
+  ensures okj_frame_token(parser, parser->depth) != OKJ_SIZE_MAX ==>
+            (parser->token_buf != \null ?
+               parser->token_buf[okj_frame_token(parser, parser->depth)].end :
+               okj_own_end(parser, okj_frame_token(parser, parser->depth)))
+            == parser->token_count;
+*/
+static void okj_close_container(OkJsonParser *parser)
+{
+    /* Finish the container whose closing bracket sits at parser->position.
+     * parser->depth has already been popped, so it indexes the container's
+     * own depth frame.  Every descendant has been emitted by now, so
+     * token_count is one past the last of them. */
+
+    OkjSize idx = okj_depth_frame(parser, parser->depth)->token;
+
+    if (idx == OKJ_SIZE_MAX)
+    {
+        /* Skipped by a selection: no token to finish. */
+    }
+    else
+    {
+        OkjSize offset = (OkjSize)(okj_tok_start(parser, idx) - parser->json);
+        OkjSize length = (OkjSize)((parser->position + 1U) - offset);
+
+        if (parser->token_buf != NULL)
+        {
+            parser->token_buf[idx].end    = parser->token_count;
+            parser->token_buf[idx].length = length;
+        }
+        else
+        {
+#ifdef OK_JSON_COMPACT_TOKENS
+            parser->tape.end[idx]    = parser->token_count;
+            parser->tape.length[idx] = length;
+#else
+            parser->tokens[idx].end    = parser->token_count;
+            parser->tokens[idx].length = length;
+#endif
+        }
+    }
+}
+
+/*@
+  requires \valid_read(parser);
+  requires idx < parser->token_count <= OKJ_MAX_TOKENS;
+  requires \valid(out_count) && \valid(out_length);
+  requires \base_addr(parser->tokens[idx].start) == \base_addr(parser->json);
+  requires parser->json <= parser->tokens[idx].start < parser->json + parser->json_len;
+  requires \valid_read(parser->json + (0 .. parser->json_len - 1));
+
+  assigns *out_count, *out_length;
+*/
+static void okj_container_extent(const OkJsonParser *parser, OkjSize idx,
+                                 OkjSize *out_count, OkjSize *out_length)
+{
+    /* Child count and byte length of the container at token `idx`.  A
+     * container closed during the parse carries both on its token; one left
+     * open by a failed parse falls back to rescanning the source text. */
+
+    if (okj_tok_end(parser, idx) != 0U)
+    {
+        *out_count  = okj_tok_count(parser, idx);
+        *out_length = okj_tok_length(parser, idx);
+    }
+    else
+    {
+        const char *start = okj_tok_start(parser, idx);
+        const char *end   = parser->json + parser->json_len;
+
+        if (okj_tok_type(parser, idx) == OKJ_OBJECT)
+        {
+            *out_count = okj_count_object_members(start, end);
+        }
+        else
+        {
+            *out_count = okj_count_array_elements(start, end);
+        }
+
+        *out_length = okj_measure_container(start, end);
+    }
+}
+
+/*@
+  requires len > 0 ==> \valid_read(s + (0 .. len - 1));
+  assigns \nothing;
+*/
+static okj_u64 okj_key_prefix(const char *s, OkjSize len)
+{
+    /* The first (up to) eight bytes packed into one integer, byte i at bits
+     * 8i..8i+7.  Built byte by byte, so it is the same on every host. */
+    okj_u64 prefix = 0U;
+    OkjSize  n      = (len < 8U) ? len : 8U;
+    OkjSize  i;
+
+    /*@
+      loop invariant 0 <= i <= n;
+      loop assigns i, prefix;
+      loop variant n - i;
+    */
+    for (i = 0U; i < n; i++)
+    {
+        prefix |= (okj_u64)(uint8_t)s[i] << (8U * i);
+    }
+
+    return prefix;
+}
+
+/*@
+  requires \valid_read(path) && \valid_read(path->steps + (0 .. path->n_steps - 1));
+  requires path->n_steps <= OKJ_PATH_MAX_STEPS;
+  requires key != \null ==> \valid_read(key) &&
+                            \valid_read(key->bytes + (0 .. key->length - 1));
+  assigns \nothing;
+*/
+static inline okj_u32 okj_path_next(const OkjPath *path, okj_u32 live, const OkjKey *key,
+                                     OkjSize elem, okj_u32 filter_hits)
+{
+    /* One JSONPath transition.  `live` is the set of steps a node's children
+     * are candidates for; the result is the set for one child, named `key`
+     * in an object or element `elem` of an array (`key` NULL).  Only the
+     * bytes, length and prefix of `key` are used.  Bit s + 1 is
+     * set when step s selects the child, bit n_steps meaning a full match,
+     * and a live recursive step stays live below.  Filter steps need the
+     * child's subtree, so the caller decides them and passes the ones that
+     * hold in `filter_hits`. */
+    okj_u32 next = 0U;
+    uint16_t s;
+
+    /*@
+      loop invariant 0 <= s <= path->n_steps;
+      loop assigns s, next;
+      loop variant path->n_steps - s;
+    */
+    for (s = 0U; s < path->n_steps; s++)
+    {
+        const OkjPathStep *step = &path->steps[s];
+        okj_u32            bit  = (okj_u32)1U << s;
+        uint8_t            hit  = 0U;
+
+        if ((live & bit) == 0U)
+        {
+            /* Step s is not live here. */
+        }
+        else if (step->kind == OKJ_PATH_CHILD)
+        {
+            hit = ((key != NULL) && (key->length == step->key.length) &&
+                   (key->prefix == step->key.prefix) &&
+                   ((key->length <= 8U) ||
+                    (okj_match(key->bytes + 8, step->key.bytes + 8,
+                               (uint16_t)(key->length - 8U)) == 1U))) ? 1U : 0U;
+        }
+        else if (step->kind == OKJ_PATH_INDEX)
+        {
+            hit = ((key == NULL) && (elem == step->index)) ? 1U : 0U;
+        }
+        else if (step->kind == OKJ_PATH_WILDCARD)
+        {
+            hit = 1U;
+        }
+        else
+        {
+            hit = ((filter_hits & bit) != 0U) ? 1U : 0U;
+        }
+
+        if (hit != 0U)
+        {
+            next |= bit << 1U;
+        }
+
+        if (((live & bit) != 0U) && (step->recursive != 0U))
+        {
+            next |= bit;
+        }
+    }
+
+    return next;
+}
+
+/* Depth frame `live` value for a subtree a selection keeps whole.  Query
+ * states never reach bit 31, see okj_select_attach(). */
+#define OKJ_SELECT_ALL 0x80000000U
+
+/*@
+  requires \valid(parser) && \valid(live) && \valid(emit);
+  requires parser->depth <= parser->depth_capacity;
+  requires parser->token_count <= parser->token_capacity;
+  requires parser->token_buf != \null ==>
+           \valid(parser->token_buf + (0 .. parser->token_capacity - 1)) &&
+           \separated(parser, parser->token_buf + (0 .. parser->token_capacity - 1));
+  requires parser->token_buf == \null ==> parser->token_capacity <= OKJ_MAX_TOKENS;
+  requires parser->key_set != \null ==>
+           \valid(parser->key_set->ids + (0 .. parser->token_capacity - 1));
+
+  assigns *live, *emit, parser->context,
+          okj_frame(parser, parser->depth - 1)->elem,
+          OKJ_OWN_TOKENS(parser, 0 .. OKJ_MAX_TOKENS - 1),
+          parser->token_buf[0 .. parser->token_capacity - 1],
+          parser->token_count,
+          parser->key_set->ids[0 .. parser->token_capacity - 1],
+          parser->key_set->first[0 .. parser->key_set->n_keys - 1];
+  ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_MAX_TOKENS_EXCEEDED;
+*/
+static inline OkjError okj_select_value(OkJsonParser *parser, uint8_t is_container,
+                                        okj_u32 *live, uint8_t *emit)
+{
+    /* Called once for every value the parser meets, just before its token
+     * would be emitted.  Without a selection every value is kept.  With one,
+     * decide from the enclosing frame whether this value is kept (*emit) and
+     * which query states its children inherit (*live); a kept object member
+     * first gets the key token that okj_parse_value() held back. */
+    OkjError result = OKJ_SUCCESS;
+
+    *live = OKJ_SELECT_ALL;
+    *emit = 1U;
+
+    if (parser->select != NULL)
+    {
+        const OkjSelect *sel = parser->select;
+        OkjDepthFrame   *frame = NULL;
+        okj_u32          m     = sel->start;
+
+        if (parser->depth > 0U)
+        {
+            frame = okj_depth_frame(parser, (uint16_t)(parser->depth - 1U));
+            m     = frame->live;
+        }
+
+        if ((frame != NULL) && (m != OKJ_SELECT_ALL) && (m != 0U))
+        {
+            const OkjKey *key  = NULL;
+            OkjKey        member;
+            okj_u32       next = 0U;
+            okj_u32       off  = 0U;
+            uint8_t       p;
+
+            if (frame->type == OKJ_OBJECT)
+            {
+                member.bytes  = &parser->json[sel->key_start];
+                member.length = (uint16_t)sel->key_len;
+                member.prefix = okj_key_prefix(member.bytes, sel->key_len);
+                member.hash   = 0U;
+                key           = &member;
+            }
+
+            /*@
+              loop invariant 0 <= p <= sel->n_paths;
+              loop assigns p, off, next;
+              loop variant sel->n_paths - p;
+            */
+            for (p = 0U; p < sel->n_paths; p++)
+            {
+                const OkjPath *path = &sel->paths[p];
+                okj_u32        mask = ((okj_u32)2U << path->n_steps) - 1U;
+                okj_u32        sub  = (m >> off) & mask;
+
+                if (sub != 0U)
+                {
+                    next |= okj_path_next(path, sub, key, frame->elem, 0U) << off;
+                }
+
+                off += (okj_u32)path->n_steps + 1U;
+            }
+
+            m = next;
+        }
+
+        if (frame != NULL)
+        {
+            frame->elem++;
+        }
+
+        if ((m != OKJ_SELECT_ALL) && ((m & sel->done) != 0U))
+        {
+            m = OKJ_SELECT_ALL;
+        }
+
+        *live = m;
+        *emit = ((frame == NULL) || (m == OKJ_SELECT_ALL) ||
+                 ((is_container != 0U) && (m != 0U))) ? 1U : 0U;
+
+        if ((*emit != 0U) && (frame != NULL) && (frame->type == OKJ_OBJECT) &&
+            (frame->live != OKJ_SELECT_ALL))
+        {
+            /* The held-back key, credited to the object as okj_emit_token()
+             * does for keys read in key position. */
+            if ((OkjSize)(parser->token_count + 1U) >= parser->token_capacity)
+            {
+                result = OKJ_ERROR_MAX_TOKENS_EXCEEDED;
+            }
+            else
+            {
+                parser->context = OKJ_CTX_WANT_KEY;
+                okj_emit_token(parser, OKJ_STRING, sel->key_start, sel->key_len);
+                parser->context = OKJ_CTX_WANT_VALUE;
+
+                if (parser->key_set != NULL)
+                {
+                    okj_key_intern(parser, (OkjSize)(parser->token_count - 1U));
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid(parser);
+  requires start < parser->json_len;
+  requires parser->depth <= parser->depth_capacity;
+  requires parser->token_count < parser->token_capacity;
+  requires parser->token_buf != \null ==>
+           \valid(parser->token_buf + (0 .. parser->token_capacity - 1)) &&
+           \separated(parser, parser->token_buf + (0 .. parser->token_capacity - 1));
+  requires parser->token_buf == \null ==> parser->token_capacity <= OKJ_MAX_TOKENS;
+  requires parser->key_set != \null ==>
+           \valid(parser->key_set->ids + (0 .. parser->token_capacity - 1));
+
+  assigns parser->context,
+          okj_frame(parser, parser->depth - 1)->elem,
+          OKJ_OWN_TOKENS(parser, 0 .. OKJ_MAX_TOKENS - 1),
+          parser->token_buf[0 .. parser->token_capacity - 1],
+          parser->token_count,
+          parser->key_set->ids[0 .. parser->token_capacity - 1],
+          parser->key_set->first[0 .. parser->key_set->n_keys - 1];
+  ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_MAX_TOKENS_EXCEEDED;
+*/
+static inline OkjError okj_emit_value(OkJsonParser *parser, OkJsonType type, OkjSize start, OkjSize length)
+{
+    /* okj_emit_token() for a string, number or literal value, unless an
+     * attached selection leaves it out. */
+    okj_u32 live = OKJ_SELECT_ALL;
+    uint8_t  emit = 1U;
+    OkjError result = okj_select_value(parser, 0U, &live, &emit);
+
+    if ((result == OKJ_SUCCESS) && (emit != 0U))
+    {
+        okj_emit_token(parser, type, start, length);
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(json + (0 .. json_len - 1));
+  requires \valid(pos);
+  requires *pos < json_len && json[*pos] == '"';
+  assigns *pos;
+  ensures *pos <= json_len;
+  ensures \result == OKJ_SUCCESS ==> *pos < json_len && json[*pos] == '"';
+*/
+static OkjError okj_scan_string(const char *json, OkjSize json_len, OkjSize *pos)
+{
+    /* Check the string whose opening '"' is at *pos: escapes, control
+     * characters, UTF-8 and the OKJ_MAX_STRING_LEN cap.  On success *pos is
+     * left on the closing '"'; on failure wherever the error was found. */
+
+    OkjError result     = OKJ_SUCCESS;
+    OkjSize  position   = *pos + 1U;   /* skip opening '"' */
+    OkjSize  start_pos  = position;
+    uint8_t  loop_break = 0U;
+
+    while ((position < json_len)    &&
+           (json[position] != '"')  &&
+           (loop_break != 1U))
+    {
+        if ((position - start_pos) >= (OkjSize)OKJ_MAX_STRING_LEN)
+        {
+            loop_break = 1U;
+        }
+        else
+        {
+            if (json[position] == '\\')
+            {
+                position++;     /* consume backslash */
+
+                if (position >= json_len)
+                {
+                    loop_break = 1U;  /* truncated input: backslash at end of stream */
+                }
+                else
+                {
+                    char esc_char = json[position];
+
+                    if ((esc_char == '"')  || (esc_char == '\\') ||
+                        (esc_char == '/')  || (esc_char == 'b')  ||
+                        (esc_char == 'f')  || (esc_char == 'n')  ||
+                        (esc_char == 'r')  || (esc_char == 't'))
+                    {
+                        position++;     /* consume the escape character */
+                    }
+                    else if (esc_char == 'u')
+                    {
+                        position++;     /* consume 'u' */
+
+                        uint16_t h;
+
+                        /* RFC 8259 §7: \u escape MUST be followed by exactly 4
+                         * hex digits.  Each digit read requires a bounds check —
+                         * the outer while loop only guards entry into the string
+                         * body, not individual reads inside this inner for loop.
+                         * Without the check, truncated input such as
+                         * {"a":"\uAB (10 bytes, no NUL terminator) causes a
+                         * heap-buffer-overread past json[json_len - 1].
+                         *
+                         * We also gate every iteration on loop_break so that once
+                         * an error is detected, position does not continue to
+                         * advance past the error point. */
+                        for (h = 0U; h < 4U; h++)
+                        {
+                            if (loop_break == 0U)
+                            {
+                                if (position >= json_len)
+                                {
+                                    result = OKJ_ERROR_BAD_STRING;
+                                    loop_break = 1U;
+                                }
+                                else if (okj_is_hex_digit(json[position]) == 0U)
+                                {
+                                    result = OKJ_ERROR_BAD_STRING;
+                                    loop_break = 1U;
+                                }
+                                else
+                                {
+                                    position++;
+                                }
+                            }
+                        }
+                    }
+                    else
+                    {
+                        result = OKJ_ERROR_BAD_STRING;
+                    }
+                }
+
+                if (result != OKJ_SUCCESS)
+                {
+                    loop_break = 1U;
+                }
+            }
+            else
+            {
+                /* RFC 8259 §7: bare control characters (U+0000–U+001F) are
+                 * forbidden inside strings; they must be represented as
+                 * escape sequences (e.g. \n, \t, \uXXXX). */
+                if ((unsigned char)json[position] < 0x20U)
+                {
+                    result = OKJ_ERROR_BAD_STRING;
+                    loop_break = 1U;
+                }
+                else
+                {
+                    /* Bulk-scan the plain run that starts here, up to the
+                     * next '"', '\\' or control character.  The scan is
+                     * capped at the OKJ_MAX_STRING_LEN boundary so that the
+                     * top-of-loop length check fires at exactly the same
+                     * byte as the one-code-point-at-a-time loop did. */
+                    OkjSize run_limit = (OkjSize)(start_pos + (OkjSize)OKJ_MAX_STRING_LEN);
+                    OkjSize run_end   = 0U;
+                    uint8_t  non_ascii = 0U;
+
+                    if (run_limit > json_len)
+                    {
+                        run_limit = json_len;
+                    }
+
+                    run_end = okj_scan_string_run(json, position, run_limit, &non_ascii);
+
+                    if (non_ascii == 0U)
+                    {
+                        /* Pure ASCII: every byte in the run is valid. */
+                        position = run_end;
+                    }
+                    else
+                    {
+                        /* The run holds at least one multi-byte sequence.
+                         * okj_validate_utf8_block() is bounded by the buffer
+                         * length, so truncated input like {"a":"\xC2 (lead
+                         * byte at end of buffer) or invalid lead bytes in
+                         * 0x80..0xC1 / 0xF5..0xFF at EOF are rejected without
+                         * a heap-buffer-overread.  A sequence may run past
+                         * run_end only when it starts below the length cap. */
+                        if (okj_validate_utf8_block(json, position, run_end,
+                                                    json_len, &position) == 0U)
+                        {
+                            result = OKJ_ERROR_BAD_STRING;
+                            loop_break = 1U;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (result != OKJ_SUCCESS)
+    {
+        /* Error set inside loop (e.g. invalid escape sequence). */
+    }
+    else if (position >= json_len)
+    {
+        /* Reached end of input before the closing quote. */
+        result = OKJ_ERROR_UNEXPECTED_END;
+    }
+    else if (json[position] != '"')
+    {
+        /* Loop exited due to the length limit, not a closing quote. */
+        result = OKJ_ERROR_MAX_STR_LEN_EXCEEDED;
+    }
+    else if ((position - start_pos) > (OkjSize)OKJ_MAX_STRING_LEN)
+    {
+        /* An escape sequence whose first byte landed just below the
+         * OKJ_MAX_STRING_LEN ceiling advanced position one past the
+         * limit in a single loop iteration before the top-of-loop
+         * length check could fire.  The raw string content therefore
+         * exceeds the declared maximum; reject it. */
+        result = OKJ_ERROR_MAX_STR_LEN_EXCEEDED;
+    }
+    else
+    {
+        /* Closing quote found within the limit. */
+    }
+
+    *pos = position;
+
+    return result;
+}
+
+/*@
+  requires \valid_read(json + (0 .. json_len - 1));
+  requires \valid(pos);
+  requires *pos < json_len;
+  assigns *pos;
+  ensures \old(*pos) <= *pos <= json_len;
+  ensures \result == 0 || \result == 1;
+*/
+static uint8_t okj_scan_number(const char *json, OkjSize json_len, OkjSize *pos)
+{
+    /* Check the number that starts at *pos against the RFC 8259 grammar and
+     * leave *pos one past it.  Returns 1 if the number is well formed. */
+
+    OkjSize position  = *pos;
+    uint8_t number_ok = 1U;
+
+    /* Step 1: optional leading minus */
+    if (json[position] == '-')
+    {
+        position++;     /* consume '-' */
+
+        if ((position >= json_len) ||
+            (okj_is_digit(json[position]) == 0U))
+        {
+            number_ok = 0U;     /* bare minus is not a valid number */
+        }
+    }
+
+    /* Step 2: integer part — zero OR digit1-9 *DIGIT */
+    if (number_ok != 0U)
+    {
+        if ((position < json_len) && (json[position] == '0'))
+        {
+            position++;     /* consume '0' */
+
+            if ((position < json_len) &&
+                (okj_is_digit(json[position]) != 0U))
+            {
+                number_ok = 0U;     /* leading zero: "012" is invalid */
+            }
+        }
+        else
+        {
+            while ((position < json_len) &&
+                   (okj_is_digit(json[position]) != 0U))
+            {
+                position++;
+            }
+        }
+    }
+
+    /* Step 3: optional fractional part — '.' 1*DIGIT */
+    if ((number_ok != 0U) &&
+        (position < json_len) &&
+        (json[position] == '.'))
+    {
+        position++;     /* consume '.' */
+
+        if ((position >= json_len) ||
+            (okj_is_digit(json[position]) == 0U))
+        {
+            number_ok = 0U;     /* decimal point must be followed by a digit */
+        }
+        else
+        {
+            while ((position < json_len) &&
+                   (okj_is_digit(json[position]) != 0U))
+            {
+                position++;
+            }
+        }
+    }
+
+    /* Step 4: optional exponent part — ('e'/'E') [sign] 1*DIGIT */
+    if ((number_ok != 0U) &&
+        (position < json_len) &&
+        ((json[position] == 'e') || (json[position] == 'E')))
+    {
+        position++;     /* consume 'e' or 'E' */
+
+        if ((position < json_len) &&
+            ((json[position] == '+') || (json[position] == '-')))
+        {
+            position++;     /* consume optional sign */
+        }
+
+        if ((position >= json_len) ||
+            (okj_is_digit(json[position]) == 0U))
+        {
+            number_ok = 0U;     /* exponent requires at least one digit */
+        }
+        else
+        {
+            while ((position < json_len) &&
+                   (okj_is_digit(json[position]) != 0U))
+            {
+                position++;
+            }
+        }
+    }
+
+    *pos = position;
+
+    return number_ok;
+}
+
+/*@
+  requires \valid_read(json + (0 .. json_len - 1));
+  requires \valid_read(lit + (0 .. lit_len - 1));
+  requires \valid(pos);
+  requires *pos <= json_len;
+  assigns *pos;
+  ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_SYNTAX;
+*/
+static OkjError okj_scan_literal(const char *json, OkjSize json_len, OkjSize *pos,
+                                 const char *lit, uint16_t lit_len)
+{
+    /* Match the keyword `lit` (true, false or null) at *pos and advance past
+     * it.  RFC 8259: the keyword must end at a value boundary, so "truetrue"
+     * is rejected; end of input is always a valid boundary. */
+
+    OkjError result = OKJ_ERROR_SYNTAX;
+
+    if (((OkjSize)(json_len - *pos) >= (OkjSize)lit_len) &&
+        (okj_match(&json[*pos], lit, lit_len) == 1U))
+    {
+        *pos += (OkjSize)lit_len;
+
+        if ((*pos >= json_len) ||
+            (okj_is_value_terminator(json[*pos]) == 1U))
+        {
+            result = OKJ_SUCCESS;
+        }
+    }
+
+    return result;
+}
+
+/* Words in the okj_walk_value() bit stack.  Bit d is set while the container
+ * open at depth d is an object and clear while it is an array. */
+#define OKJ_VALIDATE_WORDS ((OKJ_MAX_DEPTH + 63U) / 64U)
+
+/*@
+  requires on_event == \null || \valid_function(on_event);
+
+  behavior no_listener:
+    assumes on_event == \null;
+    assigns \nothing;
+    ensures \result == OKJ_SUCCESS;
+*/
+static inline OkjError okj_event(OkjEventFn on_event, void *user, OkjEventType type,
+                                 const char *start, OkjSize length, uint16_t depth)
+{
+    /* Report one event, if anyone is listening. */
+
+    OkjError result = OKJ_SUCCESS;
+
+    if (on_event != NULL)
+    {
+        OkjEvent event;
+
+        event.type   = type;
+        event.start  = start;
+        event.length = length;
+        event.depth  = depth;
+
+        result = on_event(user, &event);
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(json + (0 .. json_len - 1));
+  requires \valid(at) && *at <= json_len;
+  requires max_depth <= OKJ_MAX_DEPTH;
+  requires on_event == \null || \valid_function(on_event);
+
+  behavior no_listener:
+    assumes on_event == \null;
+    assigns *at;
+    ensures *at <= json_len;
+    ensures \result != OKJ_ERROR_BAD_POINTER;
+    ensures \result != OKJ_ERROR_MAX_TOKENS_EXCEEDED;
+*/
+static OkjError okj_walk_value(const char *json, OkjSize json_len, OkjSize *at,
+                               uint16_t max_depth, OkjEventFn on_event, void *user)
+{
+    /* okj_parse_value()'s dispatch with the token and frame writes taken
+     * out, shared by okj_walk() and okj_select_skip(): each step reads one
+     * token and, when a value ends, either finishes the value that started
+     * at *at or expects a separator.  At most max_depth containers may be
+     * open at once.  Besides the bit stack, only the offset of each open
+     * container is kept, for the span of its END event.  On return *at is
+     * one past the value, or where the token that failed starts. */
+
+    OkjError        result = OKJ_SUCCESS;
+    okj_u64         objects[OKJ_VALIDATE_WORDS] = { 0U };
+    OkjSize         opened[OKJ_MAX_DEPTH];
+    OkjParseContext context  = OKJ_CTX_WANT_VALUE;
+    OkjSize         pos      = *at;
+    OkjSize         token    = *at;
+    uint16_t        depth    = 0U;
+    uint8_t         complete = 0U;
+
+    /*@
+      loop invariant pos <= json_len && token <= json_len;
+      loop invariant depth <= max_depth;
+      loop assigns pos, token, depth, context, complete, result,
+                   objects[0 .. OKJ_VALIDATE_WORDS - 1], opened[0 .. OKJ_MAX_DEPTH - 1];
+    */
+    while ((result == OKJ_SUCCESS) && (complete == 0U))
+    {
+        uint8_t ended = 0U;
+
+        pos   = okj_space_end(json, json_len, pos);
+        token = pos;
+
+        if (pos >= json_len)
+        {
+            /* No value at all, or containers still open. */
+            result = OKJ_ERROR_UNEXPECTED_END;
+        }
+        else
+        {
+            char    c      = json[pos];
+            uint8_t action = okj_grammar_action[context][okj_char_class[(uint8_t)c]];
+
+            switch (action)
+            {
+                case OKJ_ACT_OPEN_OBJECT:
+                case OKJ_ACT_OPEN_ARRAY:
+                    if (depth >= max_depth)
+                    {
+                        result = OKJ_ERROR_MAX_DEPTH_EXCEEDED;
+                    }
+                    else
+                    {
+                        okj_u64 bit = (okj_u64)1U << (depth % 64U);
+
+                        if (action == OKJ_ACT_OPEN_OBJECT)
+                        {
+                            objects[depth / 64U] |= bit;
+                            context = OKJ_CTX_WANT_KEY_OR_CLOSE;
+                            result  = okj_event(on_event, user, OKJ_EVENT_START_OBJECT, &json[pos], 1U, depth);
+                        }
+                        else
+                        {
+                            objects[depth / 64U] &= ~bit;
+                            context = OKJ_CTX_WANT_VALUE_OR_CLOSE;
+                            result  = okj_event(on_event, user, OKJ_EVENT_START_ARRAY, &json[pos], 1U, depth);
+                        }
+
+                        opened[depth] = pos;
+                        depth++;
+                        pos++;
+                    }
+                    break;
+
+                case OKJ_ACT_CLOSE_OBJECT:
+                case OKJ_ACT_CLOSE_ARRAY:
+                    if (depth == 0U)
+                    {
+                        result = OKJ_ERROR_BRACKET_MISMATCH;
+                    }
+                    else
+                    {
+                        uint16_t top       = (uint16_t)(depth - 1U);
+                        uint8_t  is_object = (uint8_t)((objects[top / 64U] >> (top % 64U)) & 1U);
+
+                        if (is_object != ((action == OKJ_ACT_CLOSE_OBJECT) ? 1U : 0U))
+                        {
+                            result = OKJ_ERROR_BRACKET_MISMATCH;
+                        }
+                        else
+                        {
+                            result = okj_event(on_event, user,
+                                               (is_object == 1U) ? OKJ_EVENT_END_OBJECT : OKJ_EVENT_END_ARRAY,
+                                               &json[opened[top]], (OkjSize)(pos - opened[top] + 1U), top);
+                            depth = top;
+                            pos++;
+                            ended = 1U;
+                        }
+                    }
+                    break;
+
+                case OKJ_ACT_COMMA:
+                    if (depth == 0U)
+                    {
+                        result = OKJ_ERROR_SYNTAX;
+                    }
+                    else
+                    {
+                        uint16_t top = (uint16_t)(depth - 1U);
+
+                        pos++;
+
+                        /* WANT_KEY, not WANT_KEY_OR_CLOSE: no trailing commas. */
+                        if (((objects[top / 64U] >> (top % 64U)) & 1U) != 0U)
+                        {
+                            context = OKJ_CTX_WANT_KEY;
+                        }
+                        else
+                        {
+                            context = OKJ_CTX_WANT_VALUE;
+                        }
+                    }
+                    break;
+
+                case OKJ_ACT_COLON:
+                    pos++;
+                    context = OKJ_CTX_WANT_VALUE;
+                    break;
+
+                case OKJ_ACT_KEY:
+                case OKJ_ACT_STRING:
+                {
+                    OkjSize start = (OkjSize)(pos + 1U);   /* skip opening '"' */
+
+                    result = okj_scan_string(json, json_len, &pos);
+
+                    if (result == OKJ_SUCCESS)
+                    {
+                        if (action == OKJ_ACT_KEY)
+                        {
+                            context = OKJ_CTX_WANT_COLON;
+                            result  = okj_event(on_event, user, OKJ_EVENT_KEY,
+                                                &json[start], (OkjSize)(pos - start), depth);
+                        }
+                        else
+                        {
+                            ended  = 1U;
+                            result = okj_event(on_event, user, OKJ_EVENT_STRING,
+                                               &json[start], (OkjSize)(pos - start), depth);
+                        }
+
+                        pos++;   /* closing '"' */
+                    }
+                    break;
+                }
+
+                case OKJ_ACT_NUMBER:
+                {
+                    OkjSize start = pos;
+
+                    if (okj_scan_number(json, json_len, &pos) == 1U)
+                    {
+                        ended  = 1U;
+                        result = okj_event(on_event, user, OKJ_EVENT_NUMBER,
+                                           &json[start], (OkjSize)(pos - start), depth);
+                    }
+                    else
+                    {
+                        result = OKJ_ERROR_BAD_NUMBER;
+                    }
+                    break;
+                }
+
+                case OKJ_ACT_TRUE:
+                    result = okj_scan_literal(json, json_len, &pos, "true", 4U);
+                    ended  = 1U;
+
+                    if (result == OKJ_SUCCESS)
+                    {
+                        result = okj_event(on_event, user, OKJ_EVENT_BOOLEAN, &json[pos - 4U], 4U, depth);
+                    }
+                    break;
+
+                case OKJ_ACT_FALSE:
+                    result = okj_scan_literal(json, json_len, &pos, "false", 5U);
+                    ended  = 1U;
+
+                    if (result == OKJ_SUCCESS)
+                    {
+                        result = okj_event(on_event, user, OKJ_EVENT_BOOLEAN, &json[pos - 5U], 5U, depth);
+                    }
+                    break;
+
+                case OKJ_ACT_NULL:
+                    result = okj_scan_literal(json, json_len, &pos, "null", 4U);
+                    ended  = 1U;
+
+                    if (result == OKJ_SUCCESS)
+                    {
+                        result = okj_event(on_event, user, OKJ_EVENT_NULL, &json[pos - 4U], 4U, depth);
+                    }
+                    break;
+
+                default:
+                    result = OKJ_ERROR_SYNTAX;
+                    break;
+            }
+        }
+
+        if ((result == OKJ_SUCCESS) && (ended == 1U))
+        {
+            if (depth == 0U)
+            {
+                complete = 1U;
+            }
+            else
+            {
+                context = OKJ_CTX_WANT_SEP_OR_CLOSE;
+            }
+        }
+    }
+
+    *at = (result == OKJ_SUCCESS) ? pos : token;
+
+    return result;
+}
+
+
+/*@
+  requires \valid_read(json + (0 .. len - 1));
+  requires pos < len;
+  assigns \nothing;
+  ensures \result == 0 || \result == 1;
+*/
+static uint8_t okj_token_complete(const char *json, OkjSize len, OkjSize pos, OkjSize last_end)
+{
+    /* 1 when okj_parse_value() can decide the token that starts at `pos`
+     * from the bytes below `len`, i.e. more input could not change its
+     * outcome.  Strings need their closing quote, or enough bytes that the
+     * OKJ_MAX_STRING_LEN check fires first.  Numbers and literals need a
+     * byte that ends them: `last_end` is the index of the last value
+     * terminator below `len`, and any such byte after `pos` stops their
+     * scan.  Anything else is one byte long. */
+
+    uint8_t complete = 1U;
+    OkjSize scan     = pos;
+
+    switch (okj_char_class[(uint8_t)json[pos]])
+    {
+        case OKJ_CC_QUOTE:
+            if ((OkjSize)(len - pos) <= (OkjSize)(OKJ_MAX_STRING_LEN + 8U))
+            {
+                complete = 0U;
+                scan++;
+
+                /*@
+                  loop assigns scan, complete;
+                  loop variant len - scan;
+                */
+                while ((complete == 0U) && (scan < len))
+                {
+                    if (json[scan] == '\\')
+                    {
+                        scan += 2U;
+                    }
+                    else
+                    {
+                        if (json[scan] == '"')
+                        {
+                            complete = 1U;
+                        }
+
+                        scan++;
+                    }
+                }
+            }
+            break;
+
+        case OKJ_CC_NUMBER:
+        case OKJ_CC_TRUE:
+        case OKJ_CC_FALSE:
+        case OKJ_CC_NULL:
+            complete = (pos < last_end) ? 1U : 0U;
+            break;
+
+        default:
+            /* Structural character, or one no token starts with. */
+            break;
+    }
+
+    return complete;
+}
+
+/*@
+  requires \valid(parser) && 0 < parser->depth < parser->depth_capacity;
+  requires parser->depth_capacity - parser->depth <= OKJ_MAX_DEPTH;
+  requires parser->position < parser->json_len;
+  requires \valid_read(parser->json + (0 .. parser->json_len - 1));
+  requires parser->feed != \null ==> \valid_read(parser->feed);
+  assigns parser->position, parser->context,
+          okj_frame(parser, parser->depth - 1)->elem;
+*/
+static OkjError okj_select_skip(OkJsonParser *parser)
+{
+    /* Step over the container at parser->position, which okj_select_value()
+     * dropped with nothing inside that a query can reach.  okj_walk_value()
+     * checks it as okj_parse() would, nesting included, without storing a
+     * token.  If okj_feed() has not yet received the bytes that decide the
+     * outcome, it waits for more and this container is tried again, so
+     * every split still gives okj_parse()'s result. */
+    OkjSize  pos    = parser->position;
+    OkjError result = okj_walk_value(parser->json, parser->json_len, &pos,
+                                     (uint16_t)(parser->depth_capacity - parser->depth),
+                                     NULL, NULL);
+
+    if (result == OKJ_SUCCESS)
+    {
+        parser->position = pos;
+        parser->context  = OKJ_CTX_WANT_SEP_OR_CLOSE;
+    }
+    else if ((parser->feed != NULL) && (parser->feed->ended == 0U))
+    {
+        /* As in okj_parse_tokens(): the failure stands only if the token it
+         * was found at is already decided by the bytes received. */
+        OkjSize last_end = parser->json_len;
+
+        /*@
+          loop assigns last_end;
+          loop variant last_end;
+        */
+        while ((last_end > pos) &&
+               (okj_is_value_terminator(parser->json[last_end - 1U]) == 0U))
+        {
+            last_end--;
+        }
+
+        if (last_end > pos)
+        {
+            last_end--;
+        }
+
+        if ((pos >= parser->json_len) ||
+            (okj_token_complete(parser->json, parser->json_len, pos, last_end) == 0U))
+        {
+            /* Counted again on the retry. */
+            okj_depth_frame(parser, (uint16_t)(parser->depth - 1U))->elem--;
+            result = OKJ_NEED_MORE_DATA;
+        }
+        else
+        {
+            parser->position = pos;
+        }
+    }
+    else
+    {
+        parser->position = pos;
+    }
+
+    return result;
+}
+
+/*@
+  // Preconditions
+  //
+  // parser may be NULL — we handle that gracefully by returning
+  // OKJ_ERROR_BAD_POINTER.  If non-NULL, the struct must be valid for r/w
+  // and the json buffer it references must be readable for the full
+  // json_len bytes (otherwise every indexed read inside the inner loops
+  // is undefined behavior — the class of bug Issue #69 reported).
+  requires parser == \null || \valid(parser);
+  requires parser != \null ==>
+             \valid_read(parser->json + (0 .. parser->json_len - 1));
+  requires parser != \null ==> parser->position <= parser->json_len;
+  requires parser != \null ==>
+             \valid(parser->tokens + (0 .. OKJ_MAX_TOKENS - 1));
+
+  // Behaviors carry the frame condition — ACSL does not support a ternary
+  // in the assigns clause, so we split the two cases into behaviors.
+  behavior null_parser:
+    assumes parser == \null;
+    assigns \nothing;
+
+  behavior valid_parser:
+    assumes parser != \null;
+    assigns *parser;
+    ensures parser->position <= parser->json_len;
+
+  complete behaviors;
+  disjoint behaviors;
+
+  // NOTE: Full WP verification of this function requires extensive loop
+  // invariants on the string/number/escape inner loops.  This is tracked
+  // as follow-up work (see TODO_LIST).  Adding this function to -wp-fct
+  // without those invariants will produce unverified goals.
+ */
+/*
+ * TODO: Refactor to reduce complexity. -RLM
+ */
+static OkjError okj_parse_value(OkJsonParser *parser)
+{
+    OkjError    result  = OKJ_SUCCESS;
+
+    if (parser == NULL)
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        okj_skip_whitespace(parser);
+
+        if (parser->position >= parser->json_len)
+        {
+            /* End of input — nothing to do. */
+        }
+        else
+        {
+
+        char    c      = parser->json[parser->position];
+        uint8_t action = okj_grammar_action[parser->context][okj_char_class[(uint8_t)c]];
+
+        /* One lookup in okj_grammar_action decides whether this character may
+         * appear in the current context and, if so, what it does.  Every
+         * disallowed combination is OKJ_ACT_SYNTAX and lands in default. */
+        switch (action)
+        {
+            case OKJ_ACT_OPEN_OBJECT:
+                if (parser->depth >= parser->depth_capacity)
+                {
+                    result = OKJ_ERROR_MAX_DEPTH_EXCEEDED;
+                }
+                else
+                {
+                    okj_u32 live = OKJ_SELECT_ALL;
+                    uint8_t  emit = 1U;
+
+                    result = okj_select_value(parser, 1U, &live, &emit);
+
+                    /* An unreachable container is walked without tokens;
+                     * deeper than the walker's stack it is framed below
+                     * and its values are dropped one by one instead. */
+                    if ((result == OKJ_SUCCESS) && (emit == 0U) &&
+                        ((uint16_t)(parser->depth_capacity - parser->depth) <= (uint16_t)OKJ_MAX_DEPTH))
+                    {
+                        result = okj_select_skip(parser);
+                    }
+                    else if (result == OKJ_SUCCESS)
+                    {
+                        OkjDepthFrame *frame = okj_depth_frame(parser, parser->depth);
+
+                        frame->type  = OKJ_OBJECT;
+                        frame->token = OKJ_SIZE_MAX;
+                        frame->live  = live;
+                        frame->elem  = 0U;
+
+                        if (emit != 0U)
+                        {
+                            okj_emit_token(parser, OKJ_OBJECT, parser->position, 1U);
+                            frame->token = (OkjSize)(parser->token_count - 1U);
+                        }
+
+                        parser->depth++;
+                        parser->position++;
+
+                        /* After '{' we expect a key string or immediate '}' (empty object). */
+                        parser->context = OKJ_CTX_WANT_KEY_OR_CLOSE;
+                    }
+                }
+                break;
+
+            case OKJ_ACT_OPEN_ARRAY:
+                if (parser->depth >= parser->depth_capacity)
+                {
+                    result = OKJ_ERROR_MAX_DEPTH_EXCEEDED;
+                }
+                else
+                {
+                    okj_u32 live = OKJ_SELECT_ALL;
+                    uint8_t  emit = 1U;
+
+                    result = okj_select_value(parser, 1U, &live, &emit);
+
+                    if ((result == OKJ_SUCCESS) && (emit == 0U) &&
+                        ((uint16_t)(parser->depth_capacity - parser->depth) <= (uint16_t)OKJ_MAX_DEPTH))
+                    {
+                        result = okj_select_skip(parser);
+                    }
+                    else if (result == OKJ_SUCCESS)
+                    {
+                        OkjDepthFrame *frame = okj_depth_frame(parser, parser->depth);
+
+                        frame->type  = OKJ_ARRAY;
+                        frame->token = OKJ_SIZE_MAX;
+                        frame->live  = live;
+                        frame->elem  = 0U;
+
+                        if (emit != 0U)
+                        {
+                            okj_emit_token(parser, OKJ_ARRAY, parser->position, 1U);
+                            frame->token = (OkjSize)(parser->token_count - 1U);
+                        }
+
+                        parser->depth++;
+                        parser->position++;
+
+                        /* After '[' we expect a value or immediate ']' (empty array). */
+                        parser->context = OKJ_CTX_WANT_VALUE_OR_CLOSE;
+                    }
+                }
+                break;
+
+            case OKJ_ACT_CLOSE_OBJECT:
+                /* Validate the closing bracket against the depth stack. */
+                if (parser->depth == 0U)
+                {
+                    result = OKJ_ERROR_BRACKET_MISMATCH;
+                }
+                else
+                {
+                    parser->depth--;
+
+                    if (okj_depth_frame(parser, parser->depth)->type != OKJ_OBJECT)
+                    {
+                        result = OKJ_ERROR_BRACKET_MISMATCH;
+                    }
+                    else
+                    {
+                        okj_close_container(parser);
+                        parser->position++;
+
+                        /* Update context for the enclosing container (if any). */
+                        if (parser->depth > 0U)
+                        {
+                            parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
+                        }
+                    }
+                }
+                break;
+
+            case OKJ_ACT_CLOSE_ARRAY:
+                if (parser->depth == 0U)
+                {
+                    result = OKJ_ERROR_BRACKET_MISMATCH;
+                }
+                else
+                {
+                    parser->depth--;
+
+                    if (okj_depth_frame(parser, parser->depth)->type != OKJ_ARRAY)
+                    {
+                        result = OKJ_ERROR_BRACKET_MISMATCH;
+                    }
+                    else
+                    {
+                        okj_close_container(parser);
+                        parser->position++;
+
+                        if (parser->depth > 0U)
+                        {
+                            parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
+                        }
+                    }
+                }
+                break;
+
+            case OKJ_ACT_COMMA:
+                if (parser->depth == 0U)
+                {
+                    result = OKJ_ERROR_SYNTAX;    /* comma outside any container */
+                }
+                else
+                {
+                    parser->position++;
+
+                    /* What comes next depends on whether we are inside an object or array.
+                    * Note: WANT_KEY (not WANT_KEY_OR_CLOSE) prevents trailing commas. */
+                    if (okj_depth_frame(parser, (uint16_t)(parser->depth - 1U))->type == OKJ_OBJECT)
+                    {
+                        parser->context = OKJ_CTX_WANT_KEY;
+                    }
+                    else
+                    {
+                        parser->context = OKJ_CTX_WANT_VALUE;
+                    }
+                }
+                break;
+
+            case OKJ_ACT_COLON:
+                parser->position++;
+                parser->context = OKJ_CTX_WANT_VALUE;
+                break;
+
+            case OKJ_ACT_KEY:
+            case OKJ_ACT_STRING:
+            {
+                /* 1 when this string is an object key */
+                uint8_t is_key = (action == OKJ_ACT_KEY) ? 1U : 0U;
+
+                OkjSize start_pos  = parser->position + 1U;  /* skip opening '"' */
+
+                result = okj_scan_string(parser->json, parser->json_len, &parser->position);
+
+                if (result == OKJ_SUCCESS)
+                {
+                    OkjSize length = (OkjSize)(parser->position - start_pos);
+
+                    if (is_key == 0U)
+                    {
+                        result = okj_emit_value(parser, OKJ_STRING, start_pos, length);
+                    }
+                    else if ((parser->select != NULL) &&
+                             (okj_depth_frame(parser, (uint16_t)(parser->depth - 1U))->live != OKJ_SELECT_ALL))
+                    {
+                        /* Held back: okj_select_value() emits it if the value is kept. */
+                        parser->select->key_start = start_pos;
+                        parser->select->key_len   = length;
+                    }
+                    else
+                    {
+                        okj_emit_token(parser, OKJ_STRING, start_pos, length);
+
+                        if (parser->key_set != NULL)
+                        {
+                            okj_key_intern(parser, (OkjSize)(parser->token_count - 1U));
+                        }
+                    }
+
+                    parser->position++;   /* advance past closing '"' */
+
+                    /* Update grammar context based on whether this string was a key
+                    * (next: colon) or a value (next: separator or closing bracket). */
+                    if (is_key != 0U)
+                    {
+                        parser->context = OKJ_CTX_WANT_COLON;
+                    }
+                    else if (parser->depth > 0U)
+                    {
+                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
+                    }
+                    else
+                    {
+                        /* Top-level string value: the main loop handles the exit. */
+                    }
+                }
+                break;
+            }
+
+            case OKJ_ACT_NUMBER:
+            {
+                OkjSize start_pos = parser->position;
+                uint8_t number_ok = okj_scan_number(parser->json, parser->json_len,
+                                                    &parser->position);
+
+                if (number_ok != 0U)
+                {
+                    result = okj_emit_value(parser, OKJ_NUMBER, start_pos,
+                                            (OkjSize)(parser->position - start_pos));
+
+                    if (parser->depth > 0U)
+                    {
+                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
+                    }
+                }
+                else
+                {
+                    result = OKJ_ERROR_BAD_NUMBER;
+                }
+                break;
+            }
+
+            case OKJ_ACT_TRUE:
+                result = okj_scan_literal(parser->json, parser->json_len, &parser->position,
+                                          "true", 4U);
+
+                if (result == OKJ_SUCCESS)
+                {
+                    result = okj_emit_value(parser, OKJ_BOOLEAN, (OkjSize)(parser->position - 4U), 4U);
+
+                    if (parser->depth > 0U)
+                    {
+                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
+                    }
+                }
+                break;
+
+            case OKJ_ACT_FALSE:
+                result = okj_scan_literal(parser->json, parser->json_len, &parser->position,
+                                          "false", 5U);
+
+                if (result == OKJ_SUCCESS)
+                {
+                    result = okj_emit_value(parser, OKJ_BOOLEAN, (OkjSize)(parser->position - 5U), 5U);
+
+                    if (parser->depth > 0U)
+                    {
+                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
+                    }
+                }
+                break;
+
+            case OKJ_ACT_NULL:
+                result = okj_scan_literal(parser->json, parser->json_len, &parser->position,
+                                          "null", 4U);
+
+                if (result == OKJ_SUCCESS)
+                {
+                    result = okj_emit_value(parser, OKJ_NULL, (OkjSize)(parser->position - 4U), 4U);
+
+                    if (parser->depth > 0U)
+                    {
+                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
+                    }
+                }
+                break;
+
+            default:
+                /* OKJ_ACT_SYNTAX: not allowed in this context, or not a
+                 * character that can start any token. */
+                result = OKJ_ERROR_SYNTAX;
+                break;
+        }
+
+        } /* end else (position < json_len) */
+    }
+
+    return result;
+}
+
+/* okj_find_value_index() result for an absent key.  Token indices stay below
+ * token_capacity, which is at most OKJ_SIZE_MAX, so this is never a real index. */
+#define OKJ_NOT_FOUND OKJ_SIZE_MAX
+
+/* OkjHashIndex states.  A table that overflows while being filled is left
+ * FULL and lookups scan tokens as they would without an index. */
+#define OKJ_HASH_UNBUILT 0U
+#define OKJ_HASH_READY   1U
+#define OKJ_HASH_FULL    2U
+
+/* Parent recorded for the first-occurrence entry of each STRING token, which
+ * is what the document-wide getters look up. */
+#define OKJ_HASH_ANY OKJ_SIZE_MAX
+
+/*@
+  requires key_len > 0 ==> \valid_read(key + (0 .. key_len - 1));
+  assigns \nothing;
+*/
+static okj_u32 okj_hash_key(const char *key, uint16_t key_len)
+{
+    /* FNV-1a over the key bytes.  Independent of the owning object so that
+     * an OkjKey can carry it precomputed; okj_hash_mix() adds the parent. */
+    okj_u32 h = 2166136261U;
+    uint16_t i;
+
+    /*@
+      loop invariant 0 <= i <= key_len;
+      loop assigns i, h;
+      loop variant key_len - i;
+    */
+    for (i = 0U; i < key_len; i++)
+    {
+        h ^= (okj_u32)(uint8_t)key[i];
+        h *= 16777619U;
+    }
+
+    return h;
+}
+
+/*@
+  assigns \nothing;
+*/
+static okj_u32 okj_hash_mix(okj_u32 key_hash, OkjSize parent)
+{
+    /* One more FNV step with the parent index, then fold the high bits down
+     * since only the low bits pick the slot. */
+    okj_u32 h = (key_hash ^ (okj_u32)parent) * 16777619U;
+
+    return h ^ (h >> 15);
+}
+
+/*@
+  requires \valid(key);
+  requires key_len > 0 ==> \valid_read(bytes + (0 .. key_len - 1));
+  assigns *key;
+*/
+static void okj_key_fill(OkjKey *key, const char *bytes, uint16_t key_len)
+{
+    key->bytes  = bytes;
+    key->length = key_len;
+    key->hash   = okj_hash_key(bytes, key_len);
+    key->prefix = okj_key_prefix(bytes, key_len);
+}
+
+/*@
+  requires \valid_read(parser);
+  requires parser->json <= start <= parser->json + parser->json_len;
+  requires len > 0 ==> \valid_read(start + (0 .. len - 1));
+  assigns \nothing;
+*/
+static inline okj_u64 okj_tok_prefix(const OkJsonParser *parser, const char *start, OkjSize len)
+{
+    /* okj_key_prefix() of a token's bytes, as one word load masked to `len`
+     * bytes whenever eight bytes from `start` lie inside the document.  A
+     * key is always followed by its closing quote, a colon, a value and a
+     * brace, so only short strings at the very end take the byte loop. */
+    okj_u64 prefix;
+    OkjSize room = (OkjSize)((parser->json + parser->json_len) - start);
+
+    if (room >= 8U)
+    {
+        prefix = okj_load_word(start);
+
+        if (len < 8U)
+        {
+            prefix &= ((okj_u64)1U << (8U * len)) - 1U;
+        }
+    }
+    else
+    {
+        prefix = okj_key_prefix(start, len);
+    }
+
+    return prefix;
+}
+
+/*@
+  requires \valid_read(parser) && \valid_read(key);
+  requires idx < parser->token_count;
+  assigns \nothing;
+  ensures \result == 0 || \result == 1;
+*/
+static uint8_t okj_key_matches(const OkJsonParser *parser, OkjSize idx, const OkjKey *key)
+{
+    /* 1 if token `idx` holds exactly the bytes of `key`.  Length, the last
+     * byte (keys often share a prefix, as in "field_01", "field_02") and
+     * then the packed prefix settle most mismatches; only keys longer than
+     * eight bytes ever compare the rest. */
+    uint8_t     result = 0U;
+    OkjSize     len    = okj_tok_length(parser, idx);
+    const char *start  = okj_tok_start(parser, idx);
+
+    if ((len == key->length) &&
+        ((len == 0U) || (start[len - 1U] == key->bytes[len - 1U])) &&
+        (okj_tok_prefix(parser, start, len) == key->prefix))
+    {
+        result = (len <= 8U) ? 1U
+                             : okj_match(start + 8, key->bytes + 8, (uint16_t)(len - 8U));
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(parser) && \valid_read(parser->hash);
+  requires \valid_read(parser->hash->slots + (0 .. parser->hash->capacity - 1));
+  requires key_len > 0 ==> \valid_read(key + (0 .. key_len - 1));
+  assigns \nothing;
+  ensures \result == OKJ_NOT_FOUND || \result < parser->hash->capacity;
+*/
+static OkjSize okj_hash_probe(const OkJsonParser *parser, OkjSize parent, okj_u32 key_hash,
+                              const char *key, uint16_t key_len)
+{
+    /* Linear probing from the home slot of (parent, key), where `key_hash`
+     * is okj_hash_key() of the key.  Returns the slot holding that pair,
+     * else the free slot that ends its probe sequence, else OKJ_NOT_FOUND if
+     * every slot was visited. */
+    const OkjHashIndex *hash = parser->hash;
+    OkjSize mask   = (OkjSize)(hash->capacity - 1U);
+    OkjSize slot   = (OkjSize)(okj_hash_mix(key_hash, parent) & (okj_u32)mask);
+    OkjSize n      = 0U;
+    OkjSize result = OKJ_NOT_FOUND;
+
+    /*@
+      loop invariant 0 <= n <= hash->capacity;
+      loop invariant slot <= mask;
+      loop assigns n, slot, result;
+      loop variant hash->capacity - n;
+    */
+    while ((result == OKJ_NOT_FOUND) && (n < hash->capacity))
+    {
+        const OkjHashSlot *entry = &hash->slots[slot];
+
+        if ((entry->key == 0U) ||
+            ((entry->parent == parent)                         &&
+             (okj_tok_length(parser, entry->key) == key_len)   &&
+             (okj_match(okj_tok_start(parser, entry->key), key, key_len) == 1U)))
+        {
+            result = slot;
+        }
+        else
+        {
+            slot = (OkjSize)((slot + 1U) & mask);
+            n++;
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(parser) && \valid(parser->hash);
+  requires \valid(parser->hash->slots + (0 .. parser->hash->capacity - 1));
+  requires 0 < key < parser->token_count;
+  assigns parser->hash->slots[0 .. parser->hash->capacity - 1], parser->hash->used;
+  ensures \result == 0 || \result == 1;
+*/
+static uint8_t okj_hash_insert(const OkJsonParser *parser, OkjSize parent, OkjSize key)
+{
+    /* Record key token `key` under `parent` unless an equal key is already
+     * there (the earlier token wins).  Returns 0 when the table is full; one
+     * slot is always left free so that probes terminate. */
+    OkjHashIndex *hash   = parser->hash;
+    const char   *start  = okj_tok_start(parser, key);
+    uint16_t      len    = (uint16_t)okj_tok_length(parser, key);
+    OkjSize       slot   = okj_hash_probe(parser, parent, okj_hash_key(start, len), start, len);
+    uint8_t       result = 1U;
+
+    if ((slot == OKJ_NOT_FOUND) || ((OkjSize)(hash->used + 2U) > hash->capacity))
+    {
+        result = 0U;
+    }
+    else if (hash->slots[slot].key == 0U)
+    {
+        hash->slots[slot].parent = parent;
+        hash->slots[slot].key    = key;
+        hash->used++;
+    }
+    else
+    {
+        /* Already present. */
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(parser) && \valid(parser->hash);
+  requires \valid(parser->hash->slots + (0 .. parser->hash->capacity - 1));
+  assigns *parser->hash, parser->hash->slots[0 .. parser->hash->capacity - 1];
+  ensures parser->hash->state == OKJ_HASH_READY || parser->hash->state == OKJ_HASH_FULL;
+*/
+static void okj_hash_build(const OkJsonParser *parser)
+{
+    /* One pass over the tokens.  Every STRING gets a first-occurrence entry
+     * under OKJ_HASH_ANY, and every closed object's direct keys get an entry
+     * under the object's index, found by stepping from key to key as
+     * okj_find_member_index() does. */
+    OkjHashIndex *hash = parser->hash;
+    uint8_t       ok   = 1U;
+    OkjSize       i;
+
+    /*@
+      loop invariant 0 <= i <= hash->capacity;
+      loop assigns i, hash->slots[0 .. hash->capacity - 1];
+      loop variant hash->capacity - i;
+    */
+    for (i = 0U; i < hash->capacity; i++)
+    {
+        hash->slots[i].parent = 0U;
+        hash->slots[i].key    = 0U;
+    }
+
+    hash->used = 0U;
+
+    /*@
+      loop invariant 0 <= i <= parser->token_count;
+      loop invariant ok == 0 || ok == 1;
+      loop assigns i, ok, hash->used, hash->slots[0 .. hash->capacity - 1];
+      loop variant parser->token_count - i;
+    */
+    for (i = 0U; (ok == 1U) && (i < parser->token_count); i++)
+    {
+        OkJsonType type = okj_tok_type(parser, i);
+
+        if ((type == OKJ_STRING) && (i != 0U))
+        {
+            ok = okj_hash_insert(parser, OKJ_HASH_ANY, i);
+        }
+        else if ((type == OKJ_OBJECT) && (okj_tok_end(parser, i) != 0U))
+        {
+            OkjSize stop = okj_tok_end(parser, i);
+            OkjSize k    = (OkjSize)(i + 1U);
+
+            /*@
+              loop invariant i + 1 <= k;
+              loop assigns k, ok, hash->used, hash->slots[0 .. hash->capacity - 1];
+              loop variant stop - k;
+            */
+            while ((ok == 1U) && ((OkjSize)(k + 1U) < stop))
+            {
+                OkjSize    value = (OkjSize)(k + 1U);
+                OkJsonType vtype = okj_tok_type(parser, value);
+
+                ok = okj_hash_insert(parser, i, k);
+
+                if (((vtype == OKJ_OBJECT) || (vtype == OKJ_ARRAY)) &&
+                    (okj_tok_end(parser, value) > value))
+                {
+                    k = okj_tok_end(parser, value);
+                }
+                else
+                {
+                    k = (OkjSize)(value + 1U);
+                }
+            }
+        }
+        else
+        {
+            /* Nothing to index. */
+        }
+    }
+
+    hash->state = (ok == 1U) ? OKJ_HASH_READY : OKJ_HASH_FULL;
+}
+
+/*@
+  requires \valid_read(parser);
+  requires parser->hash != \null ==> \valid(parser->hash);
+  assigns *parser->hash, parser->hash->slots[0 .. parser->hash->capacity - 1];
+  ensures \result == 0 || \result == 1;
+*/
+static uint8_t okj_hash_ready(const OkJsonParser *parser)
+{
+    /* 1 if lookups can use the attached index, building it on first use. */
+    uint8_t result = 0U;
+
+    if (parser->hash != NULL)
+    {
+        if (parser->hash->state == OKJ_HASH_UNBUILT)
+        {
+            okj_hash_build(parser);
+        }
+
+        result = (parser->hash->state == OKJ_HASH_READY) ? 1U : 0U;
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  requires parser == \null || \valid_read(parser);
+  
+  // The search key must be safely readable up to key_len.
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+
+  // The caller must guarantee that the parser state is well-formed.
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+
+  // The caller must guarantee that EVERY token in the parser array that 
+  // has a non-null start pointer is safely readable up to its specified length.
+  // This is the mathematical key that allows okj_match to be proven safe.
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+
+  // An attached hash index, if any, must be valid; it is filled on first use.
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  // 2. Frame Condition
+  // A pure search apart from building the attached hash index.
+  assigns *parser->hash, parser->hash->slots[0 .. parser->hash->capacity - 1];
+
+  // 3. Behaviors
+  behavior invalid_args:
+    assumes parser == \null || key == \null;
+    ensures \result == OKJ_NOT_FOUND;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null;
+    // The result is either OKJ_NOT_FOUND or a valid index (1 to token_count)
+    ensures \result == OKJ_NOT_FOUND || (1 <= \result && \result <= parser->token_count);
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+static OkjSize okj_find_value_index(OkJsonParser *parser, const char *key, uint16_t key_len)
+{
+    /* Scans the token array for a STRING token whose content equals `key`
+    * (of length `key_len` bytes).  The key need not be null-terminated.
+    * Returns the index of the NEXT token (the value), or OKJ_NOT_FOUND if
+    * not found.  Keys longer than OKJ_MAX_STRING_LEN are never found because
+    * the parser enforces that limit on stored tokens.
+    * With a hash index attached, the first-occurrence entry for the key
+    * gives the same answer in one probe. */
+
+    OkjSize result = OKJ_NOT_FOUND;
+
+    if ((parser != NULL) && (key != NULL) && (okj_hash_ready(parser) == 1U))
+    {
+        OkjSize slot = okj_hash_probe(parser, OKJ_HASH_ANY, okj_hash_key(key, key_len),
+                                      key, key_len);
+
+        if ((slot != OKJ_NOT_FOUND) && (parser->hash->slots[slot].key != 0U) &&
+            ((OkjSize)(parser->hash->slots[slot].key + 1U) < parser->token_count))
+        {
+            result = (OkjSize)(parser->hash->slots[slot].key + 1U);
+        }
+    }
+    else if ((parser != NULL) && (key != NULL))
+    {
+        OkjSize i;
+
+        /*@
+          // LOOP INVARIANTS
+          // i will never exceed the token count
+          loop invariant 0 <= i <= parser->token_count;
+          
+          // Result stays at OKJ_NOT_FOUND unless a match is found
+          loop invariant result == OKJ_NOT_FOUND || (1 <= result && result <= parser->token_count);
+          
+          loop assigns i, result;
+          loop variant parser->token_count - i;
+        */
+        for (i = 0U; (i + 1U) < parser->token_count; i++)
+        {
+            if ((okj_tok_type(parser, i)   == OKJ_STRING) &&
+                (okj_tok_length(parser, i) == key_len)    &&
+                (okj_match(okj_tok_start(parser, i), key, key_len)))
+            {
+                result = i + 1U;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(parser) && \valid_read(key);
+  requires parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser->hash != \null ==> \valid(parser->hash);
+
+  assigns *parser->hash, parser->hash->slots[0 .. parser->hash->capacity - 1];
+
+  ensures \result == OKJ_NOT_FOUND || (1 <= \result && \result < parser->token_count);
+*/
+static OkjSize okj_find_key_index(const OkJsonParser *parser, const OkjKey *key)
+{
+    /* okj_find_value_index() for a prepared key: the probe reuses the cached
+     * hash, and the scan compares lengths and prefixes before any bytes. */
+    OkjSize result = OKJ_NOT_FOUND;
+
+    if (okj_hash_ready(parser) == 1U)
+    {
+        OkjSize slot = okj_hash_probe(parser, OKJ_HASH_ANY, key->hash, key->bytes, key->length);
+
+        if ((slot != OKJ_NOT_FOUND) && (parser->hash->slots[slot].key != 0U) &&
+            ((OkjSize)(parser->hash->slots[slot].key + 1U) < parser->token_count))
+        {
+            result = (OkjSize)(parser->hash->slots[slot].key + 1U);
+        }
+    }
+    else
+    {
+        OkjSize i;
+
+        /*@
+          loop invariant 0 <= i <= parser->token_count;
+          loop assigns i, result;
+          loop variant parser->token_count - i;
+        */
+        for (i = 0U; (result == OKJ_NOT_FOUND) && ((OkjSize)(i + 1U) < parser->token_count); i++)
+        {
+            if ((okj_tok_type(parser, i) == OKJ_STRING) &&
+                (okj_key_matches(parser, i, key) == 1U))
+            {
+                result = (OkjSize)(i + 1U);
+            }
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(parser) && \valid_read(key);
+  requires object < parser->token_count;
+  requires parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser->tokens[object].end <= parser->token_count;
+  requires parser->hash != \null ==> \valid(parser->hash);
+
+  assigns *parser->hash, parser->hash->slots[0 .. parser->hash->capacity - 1];
+
+  ensures \result == OKJ_NOT_FOUND ||
+          (object + 2 <= \result && \result < parser->tokens[object].end);
+*/
+static OkjSize okj_find_member_index(const OkJsonParser *parser, OkjSize object,
+                                     const OkjKey *key)
+{
+    /* Like okj_find_key_index(), but only the direct members of the closed
+     * object at token `object` are compared: each step moves from one key to
+     * the next, jumping over a container value via its recorded end.  With a
+     * hash index attached this is a single probe instead.  Returns the
+     * value's token index, or OKJ_NOT_FOUND. */
+    OkjSize result = OKJ_NOT_FOUND;
+
+    if (okj_hash_ready(parser) == 1U)
+    {
+        OkjSize slot = okj_hash_probe(parser, object, key->hash, key->bytes, key->length);
+
+        if ((slot != OKJ_NOT_FOUND) && (parser->hash->slots[slot].key != 0U))
+        {
+            result = (OkjSize)(parser->hash->slots[slot].key + 1U);
+        }
+    }
+    else
+    {
+        OkjSize stop = okj_tok_end(parser, object);
+        OkjSize i    = (OkjSize)(object + 1U);
+
+        /*@
+          loop invariant object + 1 <= i;
+          loop invariant result == OKJ_NOT_FOUND || (object + 2 <= result && result < stop);
+
+          loop assigns i, result;
+          loop variant stop - i;
+        */
+        while ((result == OKJ_NOT_FOUND) && ((OkjSize)(i + 1U) < stop))
+        {
+            OkjSize    value = (OkjSize)(i + 1U);
+            OkJsonType type  = okj_tok_type(parser, value);
+
+            if (okj_key_matches(parser, i, key) == 1U)
+            {
+                result = value;
+            }
+            else if (((type == OKJ_OBJECT) || (type == OKJ_ARRAY)) &&
+                     (okj_tok_end(parser, value) > value))
+            {
+                i = okj_tok_end(parser, value);
+            }
+            else
+            {
+                i = (OkjSize)(value + 1U);
+            }
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(parser);
+  requires array < parser->token_count;
+  requires parser->tokens[array].end <= parser->token_count;
+
+  assigns \nothing;
+
+  ensures \result == OKJ_NOT_FOUND ||
+          (array < \result && \result < parser->tokens[array].end);
+*/
+static OkjSize okj_array_element(const OkJsonParser *parser, OkjSize array, OkjSize n)
+{
+    /* Token index of element `n` of the closed array at token `array`, or
+     * OKJ_NOT_FOUND.  When the array spans exactly one token per element,
+     * none of them is a container and element n is token array + 1 + n.
+     * Otherwise step over one element at a time, jumping over a container
+     * element via its recorded end. */
+    OkjSize stop = okj_tok_end(parser, array);
+    OkjSize i    = (OkjSize)(array + 1U);
+    OkjSize k    = 0U;
+
+    if ((OkjSize)(stop - i) == okj_tok_count(parser, array))
+    {
+        i = (n < okj_tok_count(parser, array)) ? (OkjSize)(i + n) : stop;
+        k = n;
+    }
+
+    /*@
+      loop invariant array + 1 <= i;
+      loop invariant 0 <= k <= n;
+      loop assigns i, k;
+      loop variant n - k;
+    */
+    while ((k < n) && (i < stop))
+    {
+        OkJsonType type = okj_tok_type(parser, i);
+
+        if (((type == OKJ_OBJECT) || (type == OKJ_ARRAY)) && (okj_tok_end(parser, i) > i))
+        {
+            i = okj_tok_end(parser, i);
+        }
+        else
+        {
+            i = (OkjSize)(i + 1U);
+        }
+
+        k++;
+    }
+
+    return (i < stop) ? i : OKJ_NOT_FOUND;
+}
+
+/*@
+  requires len > 0 ==> \valid_read(s + (0 .. len - 1));
+  assigns \nothing;
+*/
+static OkjSize okj_pointer_index(const char *s, uint16_t len)
+{
+    /* The array index a JSON Pointer segment spells: decimal digits with no
+     * leading zero (RFC 6901 section 4), else OKJ_NOT_FOUND.  Values that
+     * cannot be a token index are OKJ_NOT_FOUND as well. */
+    OkjSize  result = OKJ_NOT_FOUND;
+    okj_u32 value  = 0U;
+    uint16_t i;
+
+    if ((len > 0U) && ((len == 1U) || (s[0] != '0')))
+    {
+        result = 0U;
+
+        /*@
+          loop invariant 0 <= i <= len;
+          loop assigns i, value, result;
+          loop variant len - i;
+        */
+        for (i = 0U; (result != OKJ_NOT_FOUND) && (i < len); i++)
+        {
+            okj_u32 digit = (okj_u32)(uint8_t)s[i] - (okj_u32)'0';
+
+            if ((digit > 9U) || (value > (((okj_u32)OKJ_SIZE_MAX - 1U - digit) / 10U)))
+            {
+                result = OKJ_NOT_FOUND;
+            }
+            else
+            {
+                value  = (value * 10U) + digit;
+                result = (OkjSize)value;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires len > 0 ==> \valid_read(s + (0 .. len - 1));
+  assigns \nothing;
+  ensures \result <= len;
+*/
+static uint16_t okj_number_length(const char *s, uint16_t len)
+{
+    /* Length of the JSON number (RFC 8259 section 6) at the start of `s`,
+     * or 0 if `s` does not start with one.  Used on query literals; the
+     * parser validates document numbers itself. */
+    uint16_t i  = 0U;
+    uint8_t  ok = 1U;
+
+    if ((i < len) && (s[i] == '-'))
+    {
+        i++;
+    }
+
+    if ((i < len) && (s[i] == '0'))
+    {
+        i++;
+    }
+    else if ((i < len) && (okj_is_digit(s[i]) != 0U))
+    {
+        while ((i < len) && (okj_is_digit(s[i]) != 0U))
+        {
+            i++;
+        }
+    }
+    else
+    {
+        ok = 0U;
+    }
+
+    if ((ok != 0U) && (i < len) && (s[i] == '.'))
+    {
+        i++;
+        ok = ((i < len) && (okj_is_digit(s[i]) != 0U)) ? 1U : 0U;
+
+        while ((i < len) && (okj_is_digit(s[i]) != 0U))
+        {
+            i++;
+        }
+    }
+
+    if ((ok != 0U) && (i < len) && ((s[i] == 'e') || (s[i] == 'E')))
+    {
+        i++;
+
+        if ((i < len) && ((s[i] == '+') || (s[i] == '-')))
+        {
+            i++;
+        }
+
+        ok = ((i < len) && (okj_is_digit(s[i]) != 0U)) ? 1U : 0U;
+
+        while ((i < len) && (okj_is_digit(s[i]) != 0U))
+        {
+            i++;
+        }
+    }
+
+    return (ok != 0U) ? i : 0U;
+}
+
+/* Outcomes of comparing two query operands. */
+#define OKJ_CMP_LESS      0U
+#define OKJ_CMP_EQUAL     1U
+#define OKJ_CMP_GREATER   2U
+#define OKJ_CMP_UNORDERED 3U
+
+/* Offset that keeps okj_decimal_split() magnitudes unsigned. */
+#define OKJ_MAG_BIAS  0x40000000U
+#define OKJ_MAG_LIMIT 0x00100000U
+
+/*@
+  requires len > 0 && \valid_read(s + (0 .. len - 1));
+  requires \valid(first) && \valid(mant_end) && \valid(mag);
+  assigns *first, *mant_end, *mag;
+  ensures *first <= *mant_end <= len;
+*/
+static void okj_decimal_split(const char *s, OkjSize len,
+                              OkjSize *first, OkjSize *mant_end, okj_u32 *mag)
+{
+    /* Split a valid JSON number into its significant digits and the power
+     * of ten of the leading one, plus OKJ_MAG_BIAS: "-0.0250e3" gives first
+     * at the '2', mant_end at the 'e' and mag bias - 2 + 3.  For zero,
+     * first == mant_end.  Both terms are clamped well past any difference
+     * that matters. */
+    OkjSize  start = (s[0] == '-') ? 1U : 0U;
+    OkjSize  point;
+    OkjSize  k;
+    okj_u32 e     = 0U;
+    uint8_t  e_neg = 0U;
+
+    k = start;
+    while ((k < len) && (s[k] != 'e') && (s[k] != 'E'))
+    {
+        k++;
+    }
+    *mant_end = k;
+
+    point = start;
+    while ((point < *mant_end) && (s[point] != '.'))
+    {
+        point++;
+    }
+
+    k = start;
+    while ((k < *mant_end) && ((s[k] == '0') || (s[k] == '.')))
+    {
+        k++;
+    }
+    *first = k;
+
+    if (*mant_end < len)
+    {
+        k = (OkjSize)(*mant_end + 1U);
+
+        if ((s[k] == '-') || (s[k] == '+'))
+        {
+            e_neg = (s[k] == '-') ? 1U : 0U;
+            k++;
+        }
+
+        /*@
+          loop assigns k, e;
+          loop variant len - k;
+        */
+        while (k < len)
+        {
+            if (e < OKJ_MAG_LIMIT)
+            {
+                e = (e * 10U) + ((okj_u32)(uint8_t)s[k] - (okj_u32)'0');
+            }
+            k++;
+        }
+    }
+
+    if (*first == *mant_end)
+    {
+        *mag = OKJ_MAG_BIAS;
+    }
+    else if (*first < point)
+    {
+        okj_u32 d = (okj_u32)(point - *first) - 1U;
+        *mag = OKJ_MAG_BIAS + ((d < OKJ_MAG_LIMIT) ? d : OKJ_MAG_LIMIT);
+    }
+    else
+    {
+        okj_u32 d = (okj_u32)(*first - point);
+        *mag = OKJ_MAG_BIAS - ((d < OKJ_MAG_LIMIT) ? d : OKJ_MAG_LIMIT);
+    }
+
+    *mag = (e_neg != 0U) ? (*mag - e) : (*mag + e);
+}
+
+/*@
+  requires a_len > 0 && \valid_read(a + (0 .. a_len - 1));
+  requires b_len > 0 && \valid_read(b + (0 .. b_len - 1));
+  assigns \nothing;
+  ensures \result == OKJ_CMP_LESS || \result == OKJ_CMP_EQUAL || \result == OKJ_CMP_GREATER;
+*/
+static uint8_t okj_number_compare(const char *a, OkjSize a_len, const char *b, OkjSize b_len)
+{
+    /* Order two valid JSON numbers by value, exactly and without floating
+     * point: sign, then the power of ten of the leading digit, then the
+     * digits themselves, the shorter one padded with zeros.  -0 equals 0.
+     * Magnitudes are compared first and flipped for two negatives. */
+    uint8_t  result = OKJ_CMP_EQUAL;
+    OkjSize  fa;
+    OkjSize  ea;
+    OkjSize  fb;
+    OkjSize  eb;
+    okj_u32 ma;
+    okj_u32 mb;
+    uint8_t  sa;    /* 0 negative, 1 zero, 2 positive */
+    uint8_t  sb;
+
+    okj_decimal_split(a, a_len, &fa, &ea, &ma);
+    okj_decimal_split(b, b_len, &fb, &eb, &mb);
+
+    sa = (fa == ea) ? 1U : ((a[0] == '-') ? 0U : 2U);
+    sb = (fb == eb) ? 1U : ((b[0] == '-') ? 0U : 2U);
+
+    if (sa != sb)
+    {
+        result = (sa < sb) ? OKJ_CMP_LESS : OKJ_CMP_GREATER;
+    }
+    else if (sa == 1U)
+    {
+        result = OKJ_CMP_EQUAL;
+    }
+    else if (ma != mb)
+    {
+        result = (ma < mb) ? OKJ_CMP_LESS : OKJ_CMP_GREATER;
+    }
+    else
+    {
+        OkjSize i = fa;
+        OkjSize j = fb;
+
+        /*@
+          loop assigns i, j, result;
+          loop variant (ea - i) + (eb - j);
+        */
+        while ((result == OKJ_CMP_EQUAL) && ((i < ea) || (j < eb)))
+        {
+            char da;
+            char db;
+
+            if ((i < ea) && (a[i] == '.'))
+            {
+                i++;
+            }
+            if ((j < eb) && (b[j] == '.'))
+            {
+                j++;
+            }
+
+            da = (i < ea) ? a[i] : '0';
+            db = (j < eb) ? b[j] : '0';
+
+            if (da != db)
+            {
+                result = (da < db) ? OKJ_CMP_LESS : OKJ_CMP_GREATER;
+            }
+
+            if (i < ea)
+            {
+                i++;
+            }
+            if (j < eb)
+            {
+                j++;
+            }
+        }
+    }
+
+    if ((sa == 0U) && (result != OKJ_CMP_EQUAL) && (sb == 0U))
+    {
+        result = (uint8_t)(OKJ_CMP_GREATER - result);
+    }
+
+    return result;
+}
+
+/*@
+  requires a_len > 0 ==> \valid_read(a + (0 .. a_len - 1));
+  requires b_len > 0 ==> \valid_read(b + (0 .. b_len - 1));
+  assigns \nothing;
+  ensures \result == OKJ_CMP_LESS || \result == OKJ_CMP_EQUAL || \result == OKJ_CMP_GREATER;
+*/
+static uint8_t okj_bytes_compare(const char *a, OkjSize a_len, const char *b, OkjSize b_len)
+{
+    /* Byte-wise lexicographic order, shorter first on a common prefix. */
+    uint8_t result = OKJ_CMP_EQUAL;
+    OkjSize n      = (a_len < b_len) ? a_len : b_len;
+    OkjSize k;
+
+    /*@
+      loop invariant 0 <= k <= n;
+      loop assigns k, result;
+      loop variant n - k;
+    */
+    for (k = 0U; (result == OKJ_CMP_EQUAL) && (k < n); k++)
+    {
+        if (a[k] != b[k])
+        {
+            result = ((uint8_t)a[k] < (uint8_t)b[k]) ? OKJ_CMP_LESS : OKJ_CMP_GREATER;
+        }
+    }
+
+    if ((result == OKJ_CMP_EQUAL) && (a_len != b_len))
+    {
+        result = (a_len < b_len) ? OKJ_CMP_LESS : OKJ_CMP_GREATER;
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(text + (0 .. text_len - 1));
+  requires pos <= text_len;
+  assigns \nothing;
+  ensures pos <= \result <= text_len;
+*/
+static uint16_t okj_path_name_end(const char *text, uint16_t text_len, uint16_t pos)
+{
+    /* End of a member name in dot notation: up to the next '.' or '['. */
+    uint16_t i = pos;
+
+    while ((i < text_len) && (text[i] != '.') && (text[i] != '['))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+/*@
+  requires \valid(step) && \valid(pos);
+  requires \valid_read(text + (0 .. text_len - 1));
+  requires *pos <= text_len;
+  assigns *step, *pos;
+  ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_SYNTAX;
+*/
+static OkjError okj_path_filter_compile(OkjPathStep *step, const char *text, uint16_t text_len,
+                                        uint16_t *pos)
+{
+    /* Compile the body of "[?(@.name op literal)]", starting just past
+     * "[?(@." and leaving *pos just past the closing ']'. */
+    OkjError result = OKJ_SUCCESS;
+    uint16_t i      = *pos;
+    uint16_t name   = i;
+
+    while ((i < text_len) && (text[i] != ' ') && (text[i] != ')') &&
+           (text[i] != '=') && (text[i] != '!') && (text[i] != '<') && (text[i] != '>'))
+    {
+        i++;
+    }
+
+    if (i == name)
+    {
+        result = OKJ_ERROR_SYNTAX;
+    }
+    else
+    {
+        okj_key_fill(&step->key, &text[name], (uint16_t)(i - name));
+        step->kind = OKJ_PATH_FILTER;
+        step->op   = OKJ_PATH_EXISTS;
+
+        while ((i < text_len) && (text[i] == ' '))
+        {
+            i++;
+        }
+
+        if ((i < text_len) && (text[i] != ')'))
+        {
+            uint8_t eq = (((uint16_t)(i + 1U) < text_len) && (text[i + 1U] == '=')) ? 1U : 0U;
+
+            if ((text[i] == '=') && (eq != 0U))
+            {
+                step->op = OKJ_PATH_EQ;
+            }
+            else if ((text[i] == '!') && (eq != 0U))
+            {
+                step->op = OKJ_PATH_NE;
+            }
+            else if (text[i] == '<')
+            {
+                step->op = (eq != 0U) ? OKJ_PATH_LE : OKJ_PATH_LT;
+            }
+            else if (text[i] == '>')
+            {
+                step->op = (eq != 0U) ? OKJ_PATH_GE : OKJ_PATH_GT;
+            }
+            else
+            {
+                result = OKJ_ERROR_SYNTAX;
+            }
+
+            i = (uint16_t)(i + 1U + eq);
+
+            while ((i < text_len) && (text[i] == ' '))
+            {
+                i++;
+            }
+
+            if (result != OKJ_SUCCESS)
+            {
+                /* Unknown operator. */
+            }
+            else if ((i < text_len) && ((text[i] == '\'') || (text[i] == '"')))
+            {
+                uint16_t open = i;
+
+                i++;
+                while ((i < text_len) && (text[i] != text[open]))
+                {
+                    i++;
+                }
+
+                if (i < text_len)
+                {
+                    step->literal      = &text[open + 1U];
+                    step->literal_len  = (uint16_t)(i - open - 1U);
+                    step->literal_type = OKJ_STRING;
+                    i++;
+                }
+                else
+                {
+                    result = OKJ_ERROR_SYNTAX;
+                }
+            }
+            else if ((i < text_len) &&
+                     (okj_number_length(&text[i], (uint16_t)(text_len - i)) > 0U))
+            {
+                step->literal      = &text[i];
+                step->literal_len  = okj_number_length(&text[i], (uint16_t)(text_len - i));
+                step->literal_type = OKJ_NUMBER;
+                i = (uint16_t)(i + step->literal_len);
+            }
+            else if (((uint16_t)(text_len - i) >= 4U) && (okj_match(&text[i], "true", 4U) == 1U))
+            {
+                step->literal      = &text[i];
+                step->literal_len  = 4U;
+                step->literal_type = OKJ_BOOLEAN;
+                i = (uint16_t)(i + 4U);
+            }
+            else if (((uint16_t)(text_len - i) >= 5U) && (okj_match(&text[i], "false", 5U) == 1U))
+            {
+                step->literal      = &text[i];
+                step->literal_len  = 5U;
+                step->literal_type = OKJ_BOOLEAN;
+                i = (uint16_t)(i + 5U);
+            }
+            else if (((uint16_t)(text_len - i) >= 4U) && (okj_match(&text[i], "null", 4U) == 1U))
+            {
+                step->literal      = &text[i];
+                step->literal_len  = 4U;
+                step->literal_type = OKJ_NULL;
+                i = (uint16_t)(i + 4U);
+            }
+            else
+            {
+                result = OKJ_ERROR_SYNTAX;
+            }
+
+            while ((i < text_len) && (text[i] == ' '))
+            {
+                i++;
+            }
+        }
+
+        if ((result == OKJ_SUCCESS) && ((uint16_t)(text_len - i) >= 2U) &&
+            (text[i] == ')') && (text[i + 1U] == ']'))
+        {
+            *pos = (uint16_t)(i + 2U);
+        }
+        else
+        {
+            result = OKJ_ERROR_SYNTAX;
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid(step) && \valid(pos);
+  requires \valid_read(text + (0 .. text_len - 1));
+  requires *pos < text_len && text[*pos] == '[';
+  assigns *step, *pos;
+  ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_SYNTAX;
+*/
+static OkjError okj_path_bracket(OkjPathStep *step, const char *text, uint16_t text_len,
+                                 uint16_t *pos)
+{
+    /* Compile one bracketed step, "[*]", "[n]", "['name']" or a filter,
+     * starting at its '[' and leaving *pos just past the ']'. */
+    OkjError result = OKJ_SUCCESS;
+    uint16_t i      = (uint16_t)(*pos + 1U);
+    uint16_t close  = i;
+
+    if ((i < text_len) && ((text[i] == '\'') || (text[i] == '"')))
+    {
+        close = (uint16_t)(i + 1U);
+        while ((close < text_len) && (text[close] != text[i]))
+        {
+            close++;
+        }
+
+        if (((uint16_t)(close + 1U) < text_len) && (text[close + 1U] == ']'))
+        {
+            okj_key_fill(&step->key, &text[i + 1U], (uint16_t)(close - i - 1U));
+            step->kind = OKJ_PATH_CHILD;
+            *pos       = (uint16_t)(close + 2U);
+        }
+        else
+        {
+            result = OKJ_ERROR_SYNTAX;
+        }
+    }
+    else if (((uint16_t)(text_len - i) >= 4U) && (okj_match(&text[i], "?(@.", 4U) == 1U))
+    {
+        *pos   = (uint16_t)(i + 4U);
+        result = okj_path_filter_compile(step, text, text_len, pos);
+    }
+    else
+    {
+        while ((close < text_len) && (text[close] != ']'))
+        {
+            close++;
+        }
+
+        if (close >= text_len)
+        {
+            result = OKJ_ERROR_SYNTAX;
+        }
+        else if (((close - i) == 1U) && (text[i] == '*'))
+        {
+            step->kind = OKJ_PATH_WILDCARD;
+        }
+        else
+        {
+            step->kind  = OKJ_PATH_INDEX;
+            step->index = okj_pointer_index(&text[i], (uint16_t)(close - i));
+
+            if (step->index == OKJ_NOT_FOUND)
+            {
+                result = OKJ_ERROR_SYNTAX;
+            }
+        }
+
+        if (result == OKJ_SUCCESS)
+        {
+            *pos = (uint16_t)(close + 1U);
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(parser) && \valid_read(step);
+  requires node < parser->token_count;
+  requires parser->hash != \null ==> \valid(parser->hash);
+  assigns *parser->hash, parser->hash->slots[0 .. parser->hash->capacity - 1];
+  ensures \result == 0 || \result == 1;
+*/
+static uint8_t okj_path_filter(const OkJsonParser *parser, const OkjPathStep *step, OkjSize node)
+{
+    /* 1 if `node` is an object whose member step->key exists and, unless
+     * the filter is a bare existence test, compares to the literal as the
+     * operator asks.  Values of another type than the literal are unequal
+     * and unordered, so only != holds for them. */
+    uint8_t hit = 0U;
+
+    if ((okj_tok_type(parser, node) == OKJ_OBJECT) && (okj_tok_end(parser, node) > node))
+    {
+        OkjSize m = okj_find_member_index(parser, node, &step->key);
+
+        if ((m != OKJ_NOT_FOUND) && (step->op == OKJ_PATH_EXISTS))
+        {
+            hit = 1U;
+        }
+        else if (m != OKJ_NOT_FOUND)
+        {
+            OkJsonType  type = okj_tok_type(parser, m);
+            const char *v    = okj_tok_start(parser, m);
+            OkjSize     len  = okj_tok_length(parser, m);
+            uint8_t     cmp  = OKJ_CMP_UNORDERED;
+
+            if (type != step->literal_type)
+            {
+                /* Type mismatch. */
+            }
+            else if (type == OKJ_NUMBER)
+            {
+                cmp = okj_number_compare(v, len, step->literal, step->literal_len);
+            }
+            else if (type == OKJ_STRING)
+            {
+                cmp = okj_bytes_compare(v, len, step->literal, step->literal_len);
+            }
+            else if ((len == step->literal_len) &&
+                     (okj_match(v, step->literal, step->literal_len) == 1U))
+            {
+                cmp = OKJ_CMP_EQUAL;
+            }
+            else
+            {
+                /* true against false: unequal, unordered. */
+            }
+
+            switch (step->op)
+            {
+                case OKJ_PATH_EQ:
+                    hit = (cmp == OKJ_CMP_EQUAL) ? 1U : 0U;
+                    break;
+                case OKJ_PATH_NE:
+                    hit = (cmp != OKJ_CMP_EQUAL) ? 1U : 0U;
+                    break;
+                case OKJ_PATH_LT:
+                    hit = (cmp == OKJ_CMP_LESS) ? 1U : 0U;
+                    break;
+                case OKJ_PATH_LE:
+                    hit = ((cmp == OKJ_CMP_LESS) || (cmp == OKJ_CMP_EQUAL)) ? 1U : 0U;
+                    break;
+                case OKJ_PATH_GT:
+                    hit = (cmp == OKJ_CMP_GREATER) ? 1U : 0U;
+                    break;
+                case OKJ_PATH_GE:
+                    hit = ((cmp == OKJ_CMP_GREATER) || (cmp == OKJ_CMP_EQUAL)) ? 1U : 0U;
+                    break;
+                case OKJ_PATH_EXISTS:
+                default:
+                    hit = 0U;
+                    break;
+            }
+        }
+        else
+        {
+            /* No such member. */
+        }
+    }
+
+    return hit;
+}
+
+/* OkjDocIter states: where `pos` stands within the container. */
+#define OKJ_DOC_FIRST   0U   /* Just inside the opening bracket          */
+#define OKJ_DOC_AFTER   1U   /* Past the value of the last child          */
+#define OKJ_DOC_PENDING 2U   /* On a container child not yet stepped over */
+#define OKJ_DOC_DONE    3U   /* Past the closing bracket, or stopped      */
+
+/*@
+  requires \valid_read(doc) && \valid_read(doc->json + (0 .. doc->json_len - 1));
+  requires \valid(pos) && *pos <= doc->json_len;
+  requires \valid(out);
+  assigns *pos, *out;
+  ensures *pos <= doc->json_len;
+*/
+static OkjError okj_doc_value(const OkjDoc *doc, OkjSize *pos, OkJsonToken *out)
+{
+    /* Read the value at *pos into `out`, checked as okj_parse() would check
+     * it.  Scalars leave *pos one past their last byte; objects and arrays
+     * leave it on the opening bracket, unscanned. */
+
+    OkjError   result = OKJ_SUCCESS;
+    OkjSize    start  = *pos;
+    OkjSize    length = 1U;
+    OkJsonType type   = OKJ_UNDEFINED;
+
+    if (start >= doc->json_len)
+    {
+        result = OKJ_ERROR_UNEXPECTED_END;
+    }
+    else
+    {
+        switch (okj_char_class[(uint8_t)doc->json[start]])
+        {
+            case OKJ_CC_LBRACE:
+                type = OKJ_OBJECT;
+                break;
+
+            case OKJ_CC_LBRACKET:
+                type = OKJ_ARRAY;
+                break;
+
+            case OKJ_CC_QUOTE:
+                result = okj_scan_string(doc->json, doc->json_len, pos);
+
+                if (result == OKJ_SUCCESS)
+                {
+                    type   = OKJ_STRING;
+                    start++;
+                    length = (OkjSize)(*pos - start);
+                    (*pos)++;   /* closing '"' */
+                }
+                break;
+
+            case OKJ_CC_NUMBER:
+                if (okj_scan_number(doc->json, doc->json_len, pos) == 1U)
+                {
+                    type   = OKJ_NUMBER;
+                    length = (OkjSize)(*pos - start);
+                }
+                else
+                {
+                    result = OKJ_ERROR_BAD_NUMBER;
+                }
+                break;
+
+            case OKJ_CC_TRUE:
+                result = okj_scan_literal(doc->json, doc->json_len, pos, "true", 4U);
+                type   = OKJ_BOOLEAN;
+                length = 4U;
+                break;
+
+            case OKJ_CC_FALSE:
+                result = okj_scan_literal(doc->json, doc->json_len, pos, "false", 5U);
+                type   = OKJ_BOOLEAN;
+                length = 5U;
+                break;
+
+            case OKJ_CC_NULL:
+                result = okj_scan_literal(doc->json, doc->json_len, pos, "null", 4U);
+                type   = OKJ_NULL;
+                length = 4U;
+                break;
+
+            default:
+                result = OKJ_ERROR_SYNTAX;
+                break;
+        }
+    }
+
+    if (result == OKJ_SUCCESS)
+    {
+        out->type   = type;
+        out->start  = &doc->json[start];
+        out->length = length;
+        out->end    = 0U;
+        out->count  = 0U;
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(doc) && \valid_read(doc->json + (0 .. doc->json_len - 1));
+  requires \valid(pos) && *pos <= doc->json_len;
+  assigns *pos;
+  ensures \old(*pos) <= *pos <= doc->json_len;
+*/
+static OkjError okj_doc_skip(const OkjDoc *doc, OkjSize *pos)
+{
+    /* Step over the value at *pos without checking it: strings and
+     * containers are delimited as okj_get_object_raw() delimits them, other
+     * scalars run to the next value terminator.  Malformed text inside is
+     * not noticed; a value that never ends leaves *pos at the end. */
+
+    OkjError    result = OKJ_SUCCESS;
+    const char *end    = &doc->json[doc->json_len];
+
+    if (*pos >= doc->json_len)
+    {
+        result = OKJ_ERROR_UNEXPECTED_END;
+    }
+    else
+    {
+        switch (okj_char_class[(uint8_t)doc->json[*pos]])
+        {
+            case OKJ_CC_QUOTE:
+                *pos = (OkjSize)(okj_skip_string(&doc->json[*pos], end) - doc->json);
+                break;
+
+            case OKJ_CC_LBRACE:
+            case OKJ_CC_LBRACKET:
+                *pos += okj_measure_container(&doc->json[*pos], end);
+                break;
+
+            case OKJ_CC_NUMBER:
+            case OKJ_CC_TRUE:
+            case OKJ_CC_FALSE:
+            case OKJ_CC_NULL:
+                /*@
+                  loop assigns *pos;
+                  loop variant doc->json_len - *pos;
+                */
+                while ((*pos < doc->json_len) &&
+                       (okj_is_value_terminator(doc->json[*pos]) == 0U))
+                {
+                    (*pos)++;
+                }
+                break;
+
+            default:
+                result = OKJ_ERROR_SYNTAX;
+                break;
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid(it) && \valid_read(it->doc);
+  requires \valid_read(it->doc->json + (0 .. it->doc->json_len - 1));
+  requires it->pos <= it->doc->json_len;
+  requires \valid(key_start) && \valid(key_len);
+  assigns *it, *key_start, *key_len;
+  ensures \result == 0 || \result == 1;
+*/
+static uint8_t okj_doc_advance(OkjDocIter *it, OkjSize *key_start, OkjSize *key_len)
+{
+    /* Move `it` onto the next child's value: step over a pending container,
+     * then read the ',' (or the closing bracket) and, in objects, the key
+     * and ':'.  Returns 1 with it->pos on the value; 0 at the closing
+     * bracket or on malformed input, which is left in it->status. */
+
+    const OkjDoc *doc    = it->doc;
+    OkjError      result = OKJ_SUCCESS;
+    uint8_t       found  = 0U;
+    char          close  = (it->type == OKJ_OBJECT) ? '}' : ']';
+
+    if (it->state == OKJ_DOC_PENDING)
+    {
+        result    = okj_doc_skip(doc, &it->pos);
+        it->state = OKJ_DOC_AFTER;
+    }
+
+    if ((result == OKJ_SUCCESS) && (it->state != OKJ_DOC_DONE))
+    {
+        it->pos = okj_space_end(doc->json, doc->json_len, it->pos);
+
+        if (it->pos >= doc->json_len)
+        {
+            result = OKJ_ERROR_UNEXPECTED_END;
+        }
+        else if (doc->json[it->pos] == close)
+        {
+            it->pos++;
+            it->state = OKJ_DOC_DONE;
+        }
+        else if (it->state == OKJ_DOC_FIRST)
+        {
+            found = 1U;
+        }
+        else if (doc->json[it->pos] == ',')
+        {
+            /* A ',' straight before the bracket is caught as a bad value or key. */
+            it->pos = okj_space_end(doc->json, doc->json_len, (OkjSize)(it->pos + 1U));
+            found   = 1U;
+        }
+        else
+        {
+            result = OKJ_ERROR_SYNTAX;
+        }
+    }
+
+    if ((found == 1U) && (it->type == OKJ_OBJECT))
+    {
+        if (it->pos >= doc->json_len)
+        {
+            result = OKJ_ERROR_UNEXPECTED_END;
+        }
+        else if (doc->json[it->pos] != '"')
+        {
+            result = OKJ_ERROR_SYNTAX;
+        }
+        else
+        {
+            *key_start = (OkjSize)(it->pos + 1U);
+            result     = okj_scan_string(doc->json, doc->json_len, &it->pos);
+        }
+
+        if (result == OKJ_SUCCESS)
+        {
+            *key_len = (OkjSize)(it->pos - *key_start);
+            it->pos  = okj_space_end(doc->json, doc->json_len, (OkjSize)(it->pos + 1U));
+
+            if (it->pos >= doc->json_len)
+            {
+                result = OKJ_ERROR_UNEXPECTED_END;
+            }
+            else if (doc->json[it->pos] != ':')
+            {
+                result = OKJ_ERROR_SYNTAX;
+            }
+            else
+            {
+                it->pos = okj_space_end(doc->json, doc->json_len, (OkjSize)(it->pos + 1U));
+            }
+        }
+    }
+
+    if (result != OKJ_SUCCESS)
+    {
+        it->status = result;
+        it->state  = OKJ_DOC_DONE;
+        found      = 0U;
+    }
+
+    return found;
+}
+
+/*@
+  requires \valid(it) && \valid_read(it->doc);
+  requires \valid_read(it->doc->json + (0 .. it->doc->json_len - 1));
+  requires it->pos <= it->doc->json_len;
+  requires \valid(out);
+  assigns *it, *out;
+*/
+static OkjError okj_doc_take(OkjDocIter *it, OkJsonToken *out)
+{
+    /* Read the child value okj_doc_advance() stopped on. */
+
+    OkjError result = okj_doc_value(it->doc, &it->pos, out);
+
+    if (result != OKJ_SUCCESS)
+    {
+        it->status = result;
+        it->state  = OKJ_DOC_DONE;
+    }
+    else if ((out->type == OKJ_OBJECT) || (out->type == OKJ_ARRAY))
+    {
+        it->state = OKJ_DOC_PENDING;
+    }
+    else
+    {
+        it->state = OKJ_DOC_AFTER;
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid(parser);
+  requires parser->hash == \null || \valid(parser->hash);
+  requires parser->key_set == \null ||
+           \valid(parser->key_set->first + (0 .. parser->key_set->n_keys - 1));
+  assigns parser->hash->state, parser->key_set->first[0 .. parser->key_set->n_keys - 1];
+*/
+static void okj_parse_begin(OkJsonParser *parser)
+{
+    /* Forget what attachments learned from a previous parse. */
+
+    if (parser->hash != NULL)
+    {
+        /* Tokens are about to change; a previous table is stale. */
+        parser->hash->state = OKJ_HASH_UNBUILT;
+    }
+
+    if (parser->key_set != NULL)
+    {
+        uint8_t id;
+
+        /*@
+          loop invariant 0 <= id <= parser->key_set->n_keys;
+          loop assigns id, parser->key_set->first[0 .. parser->key_set->n_keys - 1];
+          loop variant parser->key_set->n_keys - id;
+        */
+        for (id = 0U; id < parser->key_set->n_keys; id++)
+        {
+            parser->key_set->first[id] = 0U;
+        }
+    }
+}
+
+/*@
+  requires \valid(parser) && \valid(complete);
+  requires \valid_read(parser->json + (0 .. parser->json_len - 1));
+  requires parser->position <= parser->json_len;
+  assigns *parser, *complete;
+*/
+static OkjError okj_parse_tokens(OkJsonParser *parser, uint8_t partial, uint8_t *complete)
+{
+    /* The token loop of okj_parse() and okj_feed(): parse values until the
+     * top-level one ends, the input or the token buffer runs out, or an
+     * error.  With `partial` set the bytes below json_len are only a prefix
+     * of the text, and a token the next bytes could still change is left
+     * for a later call.  Sets *complete once the top-level value ends. */
+
+    OkjError result   = OKJ_SUCCESS;
+    uint8_t  stop     = 0U;
+    OkjSize  last_end = parser->json_len;
+    OkjSize  safe     = parser->json_len;
+
+    if (partial != 0U)
+    {
+        /* Every token that starts below `safe` is complete, so only those
+         * near the end of the bytes received need okj_token_complete().
+         * `last_end` is the last byte that can end a number or literal
+         * (parser->position when there is none); strings are complete once
+         * the OKJ_MAX_STRING_LEN check can fire.  Trailing whitespace is
+         * excluded so a token after it is checked too. */
+
+        /*@
+          loop assigns last_end;
+          loop variant last_end;
+        */
+        while ((last_end > parser->position) &&
+               (okj_is_value_terminator(parser->json[last_end - 1U]) == 0U))
+        {
+            last_end--;
+        }
+
+        if (last_end > parser->position)
+        {
+            last_end--;
+        }
+
+        safe = last_end;
+
+        if ((OkjSize)(parser->json_len - parser->position) <= (OkjSize)(OKJ_MAX_STRING_LEN + 8U))
+        {
+            safe = parser->position;
+        }
+        else if (safe > (OkjSize)(parser->json_len - (OKJ_MAX_STRING_LEN + 8U)))
+        {
+            safe = (OkjSize)(parser->json_len - (OKJ_MAX_STRING_LEN + 8U));
+        }
+        else
+        {
+            /* The last terminator is the tighter bound. */
+        }
+
+        /*@
+          loop assigns safe;
+          loop variant safe;
+        */
+        while ((safe > parser->position) &&
+               (okj_is_whitespace(parser->json[safe - 1U]) == 1U))
+        {
+            safe--;
+        }
+    }
+
+    /*@
+      loop assigns result, stop, *parser, *complete;
+    */
+    while ((parser->position < parser->json_len)         &&
+           (parser->token_count < parser->token_capacity) &&
+           (stop == 0U))
+    {
+        OkjSize  prev_tokens = parser->token_count;
+        uint16_t prev_depth  = parser->depth;
+
+        if (parser->position >= safe)
+        {
+            okj_skip_whitespace(parser);
+
+            if ((parser->position >= parser->json_len) ||
+                (okj_token_complete(parser->json, parser->json_len,
+                                    parser->position, last_end) == 0U))
+            {
+                stop = 1U;
+            }
+        }
+
+        if (stop == 0U)
+        {
+            result = okj_parse_value(parser);
+
+            if (result != OKJ_SUCCESS)
+            {
+                stop = 1U;
+            }
+            else
+            {
+                /* Detect completion of the single top-level value:
+                *  - A primitive was emitted at depth 0 (depth stayed 0, new token added), or
+                *  - A container was fully closed back to depth 0 (depth dropped from > 0).
+                * RFC 8259 §2 permits exactly one top-level value; anything other than
+                * optional whitespace that follows it is a syntax error. */
+                if ((parser->depth == 0U) &&
+                    ((prev_depth > 0U) || (parser->token_count > prev_tokens)))
+                {
+                    *complete = 1U;
+                    stop      = 1U;
+
+                    okj_skip_whitespace(parser);
+
+                    if (parser->position < parser->json_len)
+                    {
+                        result = OKJ_ERROR_SYNTAX;
+                    }
+                }
+            }
+        }
+    }
+
+    if ((result == OKJ_SUCCESS)                         &&
+        (parser->token_count >= parser->token_capacity) &&
+        (parser->position < parser->json_len))
+    {
+        result = OKJ_ERROR_MAX_TOKENS_EXCEEDED;
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid(parser) && \valid(parser->feed);
+  requires \valid_read(parser->json + (0 .. parser->json_len - 1));
+  requires parser->position <= parser->json_len;
+  assigns *parser, *parser->feed;
+*/
+static OkjError okj_feed_run(OkJsonParser *parser, uint8_t final)
+{
+    /* Tokenize what okj_feed() has received so far; `final` is set once no
+     * more bytes will come. */
+
+    OkjFeed *feed   = parser->feed;
+    OkjError result = OKJ_SUCCESS;
+
+    if (feed->complete == 1U)
+    {
+        /* RFC 8259 §2: only whitespace may follow the top-level value. */
+        okj_skip_whitespace(parser);
+
+        if (parser->position < parser->json_len)
+        {
+            result = OKJ_ERROR_SYNTAX;
+        }
+    }
+    else
+    {
+        result = okj_parse_tokens(parser, (final == 0U) ? 1U : 0U, &feed->complete);
+
+        if ((result == OKJ_SUCCESS) && (feed->complete == 1U) && (parser->hash != NULL))
+        {
+            okj_hash_build(parser);
+        }
+    }
+
+    if (result != OKJ_SUCCESS)
+    {
+        /* Malformed input: reported whatever comes next. */
+    }
+    else if (feed->complete == 1U)
+    {
+        /* Done; later chunks may only add whitespace. */
+    }
+    else if (final == 0U)
+    {
+        result = OKJ_NEED_MORE_DATA;
+    }
+    else
+    {
+        /* Open containers, or no value at all. */
+        result = OKJ_ERROR_UNEXPECTED_END;
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  // The parser can be NULL, or it must be a valid pointer to the struct.
+  requires parser == \null || \valid(parser);
+
+  // 2. Behaviors
+  behavior null_ptrs:
+    assumes parser == \null || json_string == \null;
+    assigns \nothing;
+
+  behavior valid_ptrs:
+    assumes parser != \null && json_string != \null;
+    
+    // We are modifying the entire parser struct
+    assigns *parser;
+    
+    // Verify standard field initializations
+    ensures parser->json == json_string;
+    ensures parser->json_len == json_len;
+    ensures parser->position == 0;
+    ensures parser->token_count == 0;
+    ensures parser->depth == 0;
+    ensures parser->context == OKJ_CTX_WANT_VALUE;
+    ensures parser->token_buf == \null && parser->token_capacity == OKJ_MAX_TOKENS;
+    ensures parser->depth_buf == \null && parser->depth_capacity == OKJ_MAX_DEPTH;
+    ensures parser->select == \null;
+    ensures parser->feed == \null;
+    
+    // Verify array initializations using universal quantification
+    ensures \forall integer k; 0 <= k < OKJ_MAX_TOKENS ==> parser->tokens[k].type == OKJ_UNDEFINED;
+    ensures \forall integer k; 0 <= k < OKJ_MAX_TOKENS ==> parser->tokens[k].start == \null;
+    ensures \forall integer k; 0 <= k < OKJ_MAX_TOKENS ==> parser->tokens[k].length == 0;
+    ensures \forall integer k; 0 <= k < OKJ_MAX_TOKENS ==> parser->tokens[k].end == 0;
+    ensures \forall integer k; 0 <= k < OKJ_MAX_TOKENS ==> parser->tokens[k].count == 0;
+    ensures \forall integer k; 0 <= k < OKJ_MAX_DEPTH ==> parser->depth_stack[k].type == OKJ_UNDEFINED;
+    ensures \forall integer k; 0 <= k < OKJ_MAX_DEPTH ==> parser->depth_stack[k].token == 0;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+void okj_init(OkJsonParser *parser, char *json_string, OkjSize json_len)
+{
+    if ((parser != NULL) && (json_string != NULL))
+    {
+        uint16_t i;
+
+        /*@
+          loop invariant 0 <= i <= OKJ_MAX_TOKENS;
+          
+          // Prove that all elements BEFORE the current index 'i' are correctly initialized
+          loop invariant \forall integer k; 0 <= k < i ==> parser->tokens[k].type == OKJ_UNDEFINED;
+          loop invariant \forall integer k; 0 <= k < i ==> parser->tokens[k].start == \null;
+          loop invariant \forall integer k; 0 <= k < i ==> parser->tokens[k].length == 0;
+          loop invariant \forall integer k; 0 <= k < i ==> parser->tokens[k].end == 0;
+          loop invariant \forall integer k; 0 <= k < i ==> parser->tokens[k].count == 0;
+          
+          // Explicitly state which part of the array this loop is allowed to modify
+          loop assigns i, parser->tokens[0 .. OKJ_MAX_TOKENS - 1];
+          loop variant OKJ_MAX_TOKENS - i;
+        */
+        for (i = 0U; i < OKJ_MAX_TOKENS; i++)
+        {
+#ifdef OK_JSON_COMPACT_TOKENS
+            parser->tape.type[i]   = (uint8_t)OKJ_UNDEFINED;
+            parser->tape.offset[i] = 0U;
+            parser->tape.length[i] = 0U;
+            parser->tape.end[i]    = 0U;
+            parser->tape.count[i]  = 0U;
+#else
+            parser->tokens[i].type   = OKJ_UNDEFINED;
+            parser->tokens[i].start  = NULL;
+            parser->tokens[i].length = 0U;
+            parser->tokens[i].end    = 0U;
+            parser->tokens[i].count  = 0U;
+#endif
+        }
+
+        /*@
+          loop invariant 0 <= i <= OKJ_MAX_DEPTH;
+          loop invariant \forall integer k; 0 <= k < i ==> parser->depth_stack[k].type == OKJ_UNDEFINED;
+          loop invariant \forall integer k; 0 <= k < i ==> parser->depth_stack[k].token == 0;
+          loop assigns i, parser->depth_stack[0 .. OKJ_MAX_DEPTH - 1];
+          loop variant OKJ_MAX_DEPTH - i;
+        */
+        for (i = 0U; i < (uint16_t)OKJ_MAX_DEPTH; i++)
+        {
+            parser->depth_stack[i].type  = OKJ_UNDEFINED;
+            parser->depth_stack[i].token = 0U;
+            parser->depth_stack[i].live  = 0U;
+            parser->depth_stack[i].elem  = 0U;
+        }
+
+        parser->json           = json_string;
+        parser->json_len       = json_len;
+        parser->position       = 0U;
+        parser->token_count    = 0U;
+        parser->depth          = 0U;
+        parser->context        = OKJ_CTX_WANT_VALUE;
+        parser->token_buf      = NULL;
+        parser->depth_buf      = NULL;
+        parser->token_capacity = OKJ_MAX_TOKENS;
+        parser->depth_capacity = OKJ_MAX_DEPTH;
+        parser->hash           = NULL;
+        parser->key_set        = NULL;
+        parser->select         = NULL;
+        parser->feed           = NULL;
+    }
+}
+
+/*@
+  requires parser == \null || \valid(parser);
+  requires tokens == \null || \valid(tokens + (0 .. token_capacity - 1));
+  requires depth_stack == \null || \valid(depth_stack + (0 .. depth_capacity - 1));
+
+  behavior null_ptrs:
+    assumes parser == \null || json_string == \null || tokens == \null || depth_stack == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior no_space:
+    assumes parser != \null && json_string != \null && tokens != \null && depth_stack != \null;
+    assumes token_capacity == 0 || depth_capacity == 0;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_NO_FREE_SPACE;
+
+  behavior valid_args:
+    assumes parser != \null && json_string != \null && tokens != \null && depth_stack != \null;
+    assumes token_capacity > 0 && depth_capacity > 0;
+    assigns *parser;
+    ensures \result == OKJ_SUCCESS;
+    ensures parser->json == json_string && parser->json_len == json_len;
+    ensures parser->token_buf == tokens && parser->token_capacity == token_capacity;
+    ensures parser->depth_buf == depth_stack && parser->depth_capacity == depth_capacity;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_init_ex(OkJsonParser *parser, char *json_string, OkjSize json_len,
+                     OkJsonToken *tokens, OkjSize token_capacity,
+                     OkjDepthFrame *depth_stack, uint16_t depth_capacity)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (json_string == NULL) || (tokens == NULL) || (depth_stack == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if ((token_capacity == 0U) || (depth_capacity == 0U))
+    {
+        result = OKJ_ERROR_NO_FREE_SPACE;
+    }
+    else
+    {
+        okj_init(parser, json_string, json_len);
+
+        parser->token_buf      = tokens;
+        parser->depth_buf      = depth_stack;
+        parser->token_capacity = token_capacity;
+        parser->depth_capacity = depth_capacity;
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid(parser);
+
+  behavior null_ptrs:
+    assumes parser == \null || json_string == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && json_string != \null;
+    assigns parser->json, parser->json_len, parser->position,
+            parser->token_count, parser->depth, parser->context,
+            parser->feed;
+    ensures \result == OKJ_SUCCESS;
+    ensures parser->json == json_string && parser->json_len == json_len;
+    ensures parser->position == 0 && parser->token_count == 0 && parser->depth == 0;
+    ensures parser->feed == \null;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_reset(OkJsonParser *parser, char *json_string, OkjSize json_len)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (json_string == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        /* okj_init() without the token and depth clearing loops: a parse
+         * writes every field of each token it emits and of each frame it
+         * pushes, and nothing reads past token_count or depth. */
+        parser->json        = json_string;
+        parser->json_len    = json_len;
+        parser->position    = 0U;
+        parser->token_count = 0U;
+        parser->depth       = 0U;
+        parser->context     = OKJ_CTX_WANT_VALUE;
+        parser->feed        = NULL;
+    }
+
+    return result;
+}
+
+/*@
+  // Same buffer-readability precondition as okj_parse_value: without it,
+  // the subordinate reads inside the main dispatch are UB.  This is the
+  // contract the public API documents to callers via okj_init's length
+  // parameter.
+  requires parser == \null || \valid(parser);
+  requires parser != \null ==>
+             \valid_read(parser->json + (0 .. parser->json_len - 1));
+  requires parser != \null ==>
+             \valid(parser->tokens + (0 .. OKJ_MAX_TOKENS - 1));
+
+  behavior null_parser:
+    assumes parser == \null;
+    assigns \nothing;
+
+  behavior valid_parser:
+    assumes parser != \null;
+    assigns *parser;
+
+  complete behaviors;
+  disjoint behaviors;
+
+  // NOTE: This function is not yet in the -wp-fct list because fully
+  // discharging its WP goals requires loop invariants matching those in
+  // okj_parse_value.  Issue #69's OOB reads are prevented at the source
+  // level (inside okj_parse_value) and guarded by ASan-instrumented
+  // regression tests + the updated libFuzzer harness.
+ */
+OkjError okj_parse(OkJsonParser *parser)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if (parser == NULL)
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        okj_parse_begin(parser);
+
+        if (parser->json_len > OKJ_MAX_JSON_LEN)
+        {
+            result = OKJ_ERROR_MAX_JSON_LEN_EXCEEDED;
+        }
+
+        if (result != OKJ_ERROR_MAX_JSON_LEN_EXCEEDED)
+        {
+            uint8_t complete = 0U;
+
+            result = okj_parse_tokens(parser, 0U, &complete);
+
+            /* Any containers still open at end-of-input indicate truncated input. */
+            if ((result == OKJ_SUCCESS) && (parser->depth != 0U))
+            {
+                result = OKJ_ERROR_UNEXPECTED_END;
+            }
+
+            /* RFC 8259 §2: a JSON text must contain exactly one value.  An empty
+            * or whitespace-only input has no value and is therefore invalid. */
+            if ((result == OKJ_SUCCESS) && (parser->token_count == 0U))
+            {
+                result = OKJ_ERROR_UNEXPECTED_END;
+            }
+
+            /* Opt-in: a hash index attached before the parse is filled now
+             * rather than on the first lookup. */
+            if ((result == OKJ_SUCCESS) && (parser->hash != NULL))
+            {
+                okj_hash_build(parser);
+            }
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(json + (0 .. json_len - 1));
+  requires json_len <= OKJ_MAX_JSON_LEN;
+  requires on_event == \null || \valid_function(on_event);
+
+  behavior no_listener:
+    assumes on_event == \null;
+    assigns \nothing;
+    ensures \result != OKJ_ERROR_BAD_POINTER;
+    ensures \result != OKJ_ERROR_MAX_TOKENS_EXCEEDED;
+*/
+static OkjError okj_walk(const char *json, OkjSize json_len, OkjEventFn on_event, void *user)
+{
+    /* The whole of `json` as exactly one value: okj_validate() and
+     * okj_parse_events(). */
+
+    OkjSize  pos    = 0U;
+    OkjError result = okj_walk_value(json, json_len, &pos, (uint16_t)OKJ_MAX_DEPTH, on_event, user);
+
+    /* RFC 8259 §2: only whitespace may follow the top-level value. */
+    if ((result == OKJ_SUCCESS) && (okj_space_end(json, json_len, pos) < json_len))
+    {
+        result = OKJ_ERROR_SYNTAX;
+    }
+
+    return result;
+}
+/*@
+  requires json == \null || \valid_read(json + (0 .. json_len - 1));
+
+  behavior null_json:
+    assumes json == \null;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_json:
+    assumes json != \null;
+    ensures \result != OKJ_ERROR_BAD_POINTER;
+    ensures \result != OKJ_ERROR_MAX_TOKENS_EXCEEDED;
+
+  assigns \nothing;
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_validate(const char *json, OkjSize json_len)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if (json == NULL)
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if (json_len > OKJ_MAX_JSON_LEN)
+    {
+        result = OKJ_ERROR_MAX_JSON_LEN_EXCEEDED;
+    }
+    else
+    {
+        result = okj_walk(json, json_len, NULL, NULL);
+    }
+
+    return result;
+}
+
+/*@
+  requires json == \null || \valid_read(json + (0 .. json_len - 1));
+
+  behavior null_args:
+    assumes json == \null || on_event == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes json != \null && on_event != \null;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_parse_events(const char *json, OkjSize json_len, OkjEventFn on_event, void *user)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((json == NULL) || (on_event == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if (json_len > OKJ_MAX_JSON_LEN)
+    {
+        result = OKJ_ERROR_MAX_JSON_LEN_EXCEEDED;
+    }
+    else
+    {
+        result = okj_walk(json, json_len, on_event, user);
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid(parser);
+  requires feed == \null || \valid(feed);
+
+  behavior null_ptrs:
+    assumes parser == \null || feed == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior too_small:
+    assumes parser != \null && feed != \null && capacity < parser->json_len;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_NO_FREE_SPACE;
+
+  behavior valid_args:
+    assumes parser != \null && feed != \null && capacity >= parser->json_len;
+    assigns *parser, *feed;
+    ensures \result == OKJ_SUCCESS;
+    ensures parser->feed == feed && feed->capacity == capacity;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_feed_attach(OkJsonParser *parser, OkjFeed *feed, OkjSize capacity)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (feed == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if (capacity < parser->json_len)
+    {
+        result = OKJ_ERROR_NO_FREE_SPACE;
+    }
+    else
+    {
+        okj_parse_begin(parser);
+
+        feed->capacity = capacity;
+        feed->status   = OKJ_NEED_MORE_DATA;
+        feed->complete = 0U;
+        feed->ended    = 0U;
+        parser->feed   = feed;
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid(parser);
+  requires parser != \null && parser->feed != \null ==>
+             \valid(parser->feed) &&
+             \valid(parser->json + (0 .. parser->feed->capacity - 1));
+  requires chunk == \null || \valid_read(chunk + (0 .. len - 1));
+  assigns *parser, *parser->feed,
+          parser->json[parser->json_len .. parser->feed->capacity - 1];
+*/
+OkjError okj_feed(OkJsonParser *parser, const char *chunk, OkjSize len)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (parser->feed == NULL) || ((chunk == NULL) && (len > 0U)))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjFeed *feed = parser->feed;
+
+        if ((feed->ended == 1U) ||
+            ((feed->status != OKJ_SUCCESS) && (feed->status != OKJ_NEED_MORE_DATA)))
+        {
+            /* Finished: repeat the result. */
+            result = feed->status;
+        }
+        else if (len > (OkjSize)(feed->capacity - parser->json_len))
+        {
+            result = OKJ_ERROR_NO_FREE_SPACE;
+        }
+        else if (len > (OkjSize)(OKJ_MAX_JSON_LEN - parser->json_len))
+        {
+            result = OKJ_ERROR_MAX_JSON_LEN_EXCEEDED;
+        }
+        else
+        {
+            char   *tail = &parser->json[parser->json_len];
+            OkjSize i;
+
+            if (chunk != tail)
+            {
+                /*@
+                  loop invariant 0 <= i <= len;
+                  loop assigns i, tail[0 .. len - 1];
+                  loop variant len - i;
+                */
+                for (i = 0U; i < len; i++)
+                {
+                    tail[i] = chunk[i];
+                }
+            }
+
+            parser->json_len = (OkjSize)(parser->json_len + len);
+
+            if (len == 0U)
+            {
+                feed->ended = 1U;
+            }
+
+            result = okj_feed_run(parser, feed->ended);
+        }
+
+        feed->status = result;
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(buf + (0 .. len - 1));
+  requires start <= len;
+  assigns \nothing;
+  ensures start <= \result <= len;
+*/
+static OkjSize okj_line_end(const char *buf, OkjSize len, OkjSize start)
+{
+    /* Index of the first line feed at or after `start`, or `len`.  A JSON
+     * string cannot hold a raw line feed, so one always ends a record.
+     * Eight bytes are compared per step while a whole word remains. */
+
+    const okj_u64 ones  = 0x0101010101010101ULL;
+    const okj_u64 highs = 0x8080808080808080ULL;
+    OkjSize        pos   = start;
+    uint8_t        found = 0U;
+
+    /*@
+      loop invariant start <= pos <= len;
+      loop assigns pos, found;
+      loop variant len - pos + (1 - found);
+    */
+    while ((found == 0U) && ((OkjSize)(len - pos) >= 8U))
+    {
+        okj_u64 hits = ~okj_swar_nonzero_bytes(okj_load_word(&buf[pos]) ^ (ones * 0x0AU)) & highs;
+
+        if (hits == 0U)
+        {
+            pos += 8U;
+        }
+        else
+        {
+            pos += okj_swar_first_byte(hits);
+            found = 1U;
+        }
+    }
+
+    /*@
+      loop invariant start <= pos <= len;
+      loop assigns pos, found;
+      loop variant len - pos + (1 - found);
+    */
+    while ((found == 0U) && (pos < len))
+    {
+        if (buf[pos] == '\n')
+        {
+            found = 1U;
+        }
+        else
+        {
+            pos++;
+        }
+    }
+
+    return pos;
+}
+
+/*@
+  requires lines == \null || \valid(lines);
+
+  behavior null_ptrs:
+    assumes lines == \null || buf == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes lines != \null && buf != \null;
+    assigns *lines;
+    ensures \result == OKJ_SUCCESS;
+    ensures lines->buf == buf && lines->len == len && lines->pos == 0;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_lines_init(OkjLines *lines, char *buf, OkjSize len)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((lines == NULL) || (buf == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        lines->buf = buf;
+        lines->len = len;
+        lines->pos = 0U;
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid(parser);
+  requires lines == \null || \valid(lines);
+  requires out == \null || \valid(out);
+  requires lines != \null && lines->buf != \null ==>
+             \valid(lines->buf + (0 .. lines->len - 1));
+  requires lines != \null ==> lines->pos <= lines->len;
+  assigns *parser, *lines, *out;
+  ensures \result == 0 || \result == 1;
+*/
+uint8_t okj_lines_next(OkJsonParser *parser, OkjLines *lines, OkjRecord *out)
+{
+    uint8_t found = 0U;
+
+    if ((parser != NULL) && (lines != NULL) && (out != NULL) && (lines->buf != NULL))
+    {
+        /*@
+          loop assigns found, *parser, *lines, *out;
+          loop variant lines->len - lines->pos + (1 - found);
+        */
+        while ((found == 0U) && (lines->pos < lines->len))
+        {
+            OkjSize start = lines->pos;
+            OkjSize stop  = okj_line_end(lines->buf, lines->len, start);
+
+            lines->pos = (stop < lines->len) ? (OkjSize)(stop + 1U) : stop;
+
+            if ((stop > start) && (lines->buf[stop - 1U] == '\r'))
+            {
+                stop--;
+            }
+
+            /* Blank lines carry no record. */
+            if (okj_space_end(lines->buf, stop, start) < stop)
+            {
+                out->offset = start;
+                out->length = (OkjSize)(stop - start);
+
+                (void)okj_reset(parser, &lines->buf[start], out->length);
+                out->status = okj_parse(parser);
+
+                found = 1U;
+            }
+        }
+    }
+
+    return found;
+}
+
+/*@
+  requires parser == \null || \valid(parser);
+  requires buf == \null || \valid(buf + (0 .. len - 1));
+  requires records == \null || \valid(records + (0 .. capacity - 1));
+  requires out_count == \null || \valid(out_count);
+
+  behavior null_ptrs:
+    assumes parser == \null || buf == \null || records == \null || out_count == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && buf != \null && records != \null && out_count != \null;
+    assigns *parser, records[0 .. capacity - 1], *out_count;
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_NO_FREE_SPACE;
+    ensures *out_count <= capacity;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_parse_lines(OkJsonParser *parser, char *buf, OkjSize len,
+                         OkjRecord *records, OkjSize capacity, OkjSize *out_count)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (buf == NULL) || (records == NULL) || (out_count == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjLines  lines;
+        OkjRecord spare;
+        OkjSize   count = 0U;
+        uint8_t   more  = 1U;
+
+        (void)okj_lines_init(&lines, buf, len);
+
+        /*@
+          loop invariant count <= capacity;
+          loop assigns result, count, more, lines, spare, *parser,
+                       records[0 .. capacity - 1];
+        */
+        while (more == 1U)
+        {
+            /* Records are written in place; one past capacity only shows
+             * that there was no room for it. */
+            OkjRecord *slot = (count < capacity) ? &records[count] : &spare;
+
+            if (okj_lines_next(parser, &lines, slot) == 0U)
+            {
+                more = 0U;
+            }
+            else if (count < capacity)
+            {
+                count++;
+            }
+            else
+            {
+                result = OKJ_ERROR_NO_FREE_SPACE;
+                more   = 0U;
+            }
+        }
+
+        *out_count = count;
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  // Pointers can be null (we handle that gracefully), but if they aren't, 
+  // they must be valid for reading/writing.
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_str == \null || \valid(out_str);
+
+  // Inherit the token validity requirements so okj_find_value_index is satisfied
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+
+  // An attached hash index, if any, must be valid; it is filled on first use.
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  // 2. Behaviors
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_str == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_str != \null;
+    // Only the output struct, and the attached hash index on first use
+    assigns *out_str, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_STRING;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_string(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonString *out_str)
+{
+    /* Every key getter delegates to its OkjKey form with a key prepared
+     * here, so the lookup itself lives in one place. */
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    if (key != NULL)
+    {
+        OkjKey prepared;
+
+        okj_key_fill(&prepared, key, key_len);
+        result = okj_get_string_key(parser, &prepared, out_str);
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  // Pointers can be null (we handle that gracefully), but if they aren't, 
+  // they must be valid for reading/writing.
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_num == \null || \valid(out_num);
+
+  // Inherit the token validity requirements so okj_find_value_index is satisfied
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+
+  // An attached hash index, if any, must be valid; it is filled on first use.
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  // 2. Behaviors
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_num == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_num != \null;
+    // Only the output struct, and the attached hash index on first use
+    assigns *out_num, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_NUMBER;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_number(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonNumber *out_num)
+{
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    if (key != NULL)
+    {
+        OkjKey prepared;
+
+        okj_key_fill(&prepared, key, key_len);
+        result = okj_get_number_key(parser, &prepared, out_num);
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_bool == \null || \valid(out_bool);
+
+  // Timeout fix: Guarantee the output pointer doesn't alias the inputs!
+  requires \separated(out_bool, parser, key + (0 .. key_len - 1));
+
+  // Inherit the token validity requirements
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+
+  // An attached hash index, if any, must be valid; it is filled on first use.
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  // 2. Behaviors
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_bool == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_bool != \null;
+    assigns *out_bool, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_BOOLEAN;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_boolean(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonBoolean *out_bool)
+{
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    if (key != NULL)
+    {
+        OkjKey prepared;
+
+        okj_key_fill(&prepared, key, key_len);
+        result = okj_get_boolean_key(parser, &prepared, out_bool);
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_arr == \null || \valid(out_arr);
+  requires \separated(out_arr, parser, key + (0 .. key_len - 1));
+
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
+
+  // The valid_read requirement needed by okj_find_value_index
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+
+  // The base_addr requirement needed by the container helpers
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \base_addr(parser->tokens[k].start) == \base_addr(parser->json) &&
+        parser->tokens[k].start >= parser->json &&
+        parser->tokens[k].start < parser->json + parser->json_len);
+
+  // An attached hash index, if any, must be valid; it is filled on first use.
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  // 2. Behaviors
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_arr == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_arr != \null;
+    assigns *out_arr, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_ARRAY;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_array(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonArray *out_arr)
+{
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    if (key != NULL)
+    {
+        OkjKey prepared;
+
+        okj_key_fill(&prepared, key, key_len);
+        result = okj_get_array_key(parser, &prepared, out_arr);
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_obj == \null || \valid(out_obj);
+  
+  requires \separated(out_obj, parser, key + (0 .. key_len - 1));
+
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
+
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \base_addr(parser->tokens[k].start) == \base_addr(parser->json) &&
+        parser->tokens[k].start >= parser->json &&
+        parser->tokens[k].start < parser->json + parser->json_len);
+
+  // An attached hash index, if any, must be valid; it is filled on first use.
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  // 2. Behaviors
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_obj == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_obj != \null;
+    assigns *out_obj, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_object(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonObject *out_obj)
+{
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    if (key != NULL)
+    {
+        OkjKey prepared;
+
+        okj_key_fill(&prepared, key, key_len);
+        result = okj_get_object_key(parser, &prepared, out_obj);
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  // Pointers can be null (we handle that gracefully), but if they aren't, 
+  // they must be valid for reading/writing.
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_tok == \null || \valid(out_tok);
+
+  // Inherit the token validity requirements so okj_find_value_index is satisfied
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+
+  // An attached hash index, if any, must be valid; it is filled on first use.
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  // 2. Behaviors
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_tok == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_tok != \null;
+    // Only the output struct, and the attached hash index on first use
+    assigns *out_tok, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_token(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonToken *out_tok)
+{
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    if (key != NULL)
+    {
+        OkjKey prepared;
+
+        okj_key_fill(&prepared, key, key_len);
+        result = okj_get_token_key(parser, &prepared, out_tok);
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires out_tok == \null || \valid(out_tok);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+
+  behavior invalid_args:
+    assumes parser == \null || out_tok == \null || idx >= parser->token_count;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && out_tok != \null && idx < parser->token_count;
+    assigns *out_tok;
+    ensures \result == OKJ_SUCCESS;
+    ensures out_tok->type   == parser->tokens[idx].type;
+    ensures out_tok->start  == parser->tokens[idx].start;
+    ensures out_tok->length == parser->tokens[idx].length;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_token_at(const OkJsonParser *parser, OkjSize idx, OkJsonToken *out_tok)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (out_tok == NULL) || (idx >= parser->token_count))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        out_tok->type   = okj_tok_type(parser, idx);
+        out_tok->start  = okj_tok_start(parser, idx);
+        out_tok->length = okj_tok_length(parser, idx);
+        out_tok->end    = okj_tok_end(parser, idx);
+        out_tok->count  = okj_tok_count(parser, idx);
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_index == \null || \valid(out_index);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_index == \null ||
+            object >= parser->token_count;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_index != \null &&
+            object < parser->token_count;
+    assigns *out_index, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT ||
+            \result == OKJ_ERROR_BAD_POINTER;
+    ensures \result == OKJ_SUCCESS ==>
+            object < *out_index && *out_index < parser->token_count;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_find_member(const OkJsonParser *parser, OkjSize object,
+                         const char *key, uint16_t key_len, OkjSize *out_index)
+{
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    if (key != NULL)
+    {
+        OkjKey prepared;
+
+        okj_key_fill(&prepared, key, key_len);
+        result = okj_find_member_key(parser, object, &prepared, out_index);
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_tok == \null || \valid(out_tok);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_tok == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_tok != \null;
+    assigns *out_tok, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT ||
+            \result == OKJ_ERROR_BAD_POINTER;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_member(const OkJsonParser *parser, OkjSize object,
+                        const char *key, uint16_t key_len, OkJsonToken *out_tok)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_tok == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = 0U;
+
+        result = okj_find_member(parser, object, key, key_len, &idx);
+
+        if (result == OKJ_SUCCESS)
+        {
+            result = okj_token_at(parser, idx, out_tok);
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid(parser);
+  requires hash == \null || \valid(hash);
+  requires slots != \null ==> \valid(slots + (0 .. capacity - 1));
+
+  behavior invalid_args:
+    assumes parser == \null || hash == \null || slots == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior bad_capacity:
+    assumes parser != \null && hash != \null && slots != \null &&
+            (capacity < 2 || (capacity & (capacity - 1)) != 0);
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_NO_FREE_SPACE;
+
+  behavior valid_args:
+    assumes parser != \null && hash != \null && slots != \null &&
+            capacity >= 2 && (capacity & (capacity - 1)) == 0;
+    assigns *hash, parser->hash;
+    ensures \result == OKJ_SUCCESS;
+    ensures parser->hash == hash && hash->slots == slots;
+    ensures hash->capacity == capacity && hash->state == OKJ_HASH_UNBUILT;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_hash_attach(OkJsonParser *parser, OkjHashIndex *hash,
+                         OkjHashSlot *slots, OkjSize capacity)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (hash == NULL) || (slots == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if ((capacity < 2U) || ((capacity & (OkjSize)(capacity - 1U)) != 0U))
+    {
+        /* Probing wraps with a mask, so the size must be a power of two. */
+        result = OKJ_ERROR_NO_FREE_SPACE;
+    }
+    else
+    {
+        hash->slots    = slots;
+        hash->capacity = capacity;
+        hash->used     = 0U;
+        hash->state    = OKJ_HASH_UNBUILT;
+        parser->hash   = hash;
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_arr == \null || \valid(out_arr);
+  
+  requires \separated(out_arr, parser, key + (0 .. key_len - 1));
+
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
+
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \base_addr(parser->tokens[k].start) == \base_addr(parser->json) &&
+        parser->tokens[k].start >= parser->json &&
+        parser->tokens[k].start < parser->json + parser->json_len);
+
+  // An attached hash index, if any, must be valid; it is filled on first use.
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  // 2. Behaviors
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_arr == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_arr != \null;
+    assigns *out_arr, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_ARRAY;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_array_raw(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonArray *out_arr)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_arr == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = okj_find_value_index(parser, key, key_len);
+
+        if ((idx == OKJ_NOT_FOUND) || 
+            (idx >= parser->token_count) ||
+            (okj_tok_type(parser, idx) != OKJ_ARRAY) ||
+            (okj_tok_start(parser, idx) == NULL))
+        {
+            result = OKJ_ERROR_BAD_ARRAY;
+        }
+        else
+        {
+            /*@ assert \base_addr(parser->tokens[idx].start) == \base_addr(parser->json); */
+            /*@ assert parser->tokens[idx].start >= parser->json; */
+            /*@ assert parser->tokens[idx].start < parser->json + parser->json_len; */
+
+            out_arr->start = okj_tok_start(parser, idx);
+            okj_container_extent(parser, idx, &out_arr->count, &out_arr->length);
+        }
+    }
+
+    return result;
+}
+
+/*@
+  // 1. Preconditions
+  requires parser == \null || \valid_read(parser);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+  requires out_obj == \null || \valid(out_obj);
+  
+  requires \separated(out_obj, parser, key + (0 .. key_len - 1));
+
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
+
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+
+  requires parser != \null ==> 
+    (\forall integer k; 0 <= k < parser->token_count ==> 
+      parser->tokens[k].start != \null ==> 
+        \base_addr(parser->tokens[k].start) == \base_addr(parser->json) &&
+        parser->tokens[k].start >= parser->json &&
+        parser->tokens[k].start < parser->json + parser->json_len);
+
+  // An attached hash index, if any, must be valid; it is filled on first use.
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  // 2. Behaviors
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_obj == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_obj != \null;
+    assigns *out_obj, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_object_raw(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonObject *out_obj)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_obj == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = okj_find_value_index(parser, key, key_len);
+
+        if ((idx == OKJ_NOT_FOUND) || 
+            (idx >= parser->token_count) ||
+            (okj_tok_type(parser, idx) != OKJ_OBJECT) ||
+            (okj_tok_start(parser, idx) == NULL))
+        {
+            result = OKJ_ERROR_BAD_OBJECT;
+        }
+        else
+        {
+            /*@ assert \base_addr(parser->tokens[idx].start) == \base_addr(parser->json); */
+            /*@ assert parser->tokens[idx].start >= parser->json; */
+            /*@ assert parser->tokens[idx].start < parser->json + parser->json_len; */
+
+            out_obj->start = okj_tok_start(parser, idx);
+            okj_container_extent(parser, idx, &out_obj->count, &out_obj->length);
+        }
+    }
+
+    return result;
+}
+
+/* okj_get_many() status of a request not yet matched.  okj_resolve_request()
+ * never produces this code, so it cannot be mistaken for a result. */
+#define OKJ_REQUEST_PENDING OKJ_ERROR_PARSING_FAILED
+
+/*@
+  assigns \nothing;
+*/
+static OkjError okj_type_error(OkJsonType type)
+{
+    /* The code a single-key getter for `type` returns for a missing key or
+     * a value of another type. */
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    switch (type)
+    {
+        case OKJ_STRING:
+            result = OKJ_ERROR_BAD_STRING;
+            break;
+        case OKJ_NUMBER:
+            result = OKJ_ERROR_BAD_NUMBER;
+            break;
+        case OKJ_BOOLEAN:
+            result = OKJ_ERROR_BAD_BOOLEAN;
+            break;
+        case OKJ_ARRAY:
+            result = OKJ_ERROR_BAD_ARRAY;
+            break;
+        case OKJ_OBJECT:
+            result = OKJ_ERROR_BAD_OBJECT;
+            break;
+        case OKJ_UNDEFINED:
+        case OKJ_NULL:
+        default:
+            /* okj_get_token() semantics; a null value has no getter. */
+            break;
+    }
+
+    return result;
+}
+
+/*@
+  requires \valid_read(parser) && \valid(request);
+  requires idx < parser->token_count;
+  assigns request->value, request->status;
+*/
+static void okj_resolve_request(const OkJsonParser *parser, OkjSize idx, OkjGetRequest *request)
+{
+    /* Fill one okj_get_many() request from value token `idx`. */
+    OkJsonType type = okj_tok_type(parser, idx);
+
+    if ((request->type != OKJ_UNDEFINED) && (request->type != type))
+    {
+        request->status = okj_type_error(request->type);
+    }
+    else
+    {
+        request->status = okj_token_at(parser, idx, &request->value);
+
+        if ((request->status == OKJ_SUCCESS) &&
+            ((type == OKJ_OBJECT) || (type == OKJ_ARRAY)))
+        {
+            okj_container_extent(parser, idx, &request->value.count, &request->value.length);
+        }
+    }
+}
+
+/* okj_many_pass() table: OKJ_MANY_SLOTS open-addressed slots holding
+ * request numbers keyed by okj_hash_key(), filled at most half full so every
+ * probe chain ends at an OKJ_MANY_EMPTY slot. */
+#define OKJ_MANY_SLOTS 64U
+#define OKJ_MANY_BATCH (OKJ_MANY_SLOTS / 2U)
+#define OKJ_MANY_EMPTY 0xFFFFU
+
+/*@
+  requires \valid_read(parser) && \valid(next);
+  requires \valid(requests + (0 .. n_requests - 1));
+  requires *next <= n_requests;
+  requires parser->token_count <= OKJ_MAX_TOKENS;
+  assigns *next, requests[*next .. n_requests - 1].value,
+          requests[*next .. n_requests - 1].status;
+  ensures \old(*next) <= *next <= n_requests;
+*/
+static uint16_t okj_many_pass(const OkJsonParser *parser, OkjGetRequest *requests,
+                              uint16_t n_requests, uint16_t *next)
+{
+    /* Loads up to OKJ_MANY_BATCH pending requests from *next on into a hash
+     * table, then settles them in one walk over the tokens: each STRING token
+     * costs one okj_hash_key() and a short probe however many keys are
+     * asked for.  Advances *next past the loaded requests and returns how
+     * many were loaded; those left pending were not found. */
+    uint16_t slot_req[OKJ_MANY_SLOTS];
+    okj_u32  slot_hash[OKJ_MANY_SLOTS];
+    uint16_t loaded = 0U;
+    uint16_t left;
+    uint16_t r      = *next;
+    uint16_t s;
+    OkjSize  i;
+
+    /*@
+      loop invariant 0 <= s <= OKJ_MANY_SLOTS;
+      loop assigns s, slot_req[0 .. OKJ_MANY_SLOTS - 1], slot_hash[0 .. OKJ_MANY_SLOTS - 1];
+      loop variant OKJ_MANY_SLOTS - s;
+    */
+    for (s = 0U; s < OKJ_MANY_SLOTS; s++)
+    {
+        slot_req[s]  = (uint16_t)OKJ_MANY_EMPTY;
+        slot_hash[s] = 0U;
+    }
+
+    /*@
+      loop invariant *next <= r <= n_requests && loaded <= OKJ_MANY_BATCH;
+      loop assigns r, s, loaded, slot_req[0 .. OKJ_MANY_SLOTS - 1],
+                   slot_hash[0 .. OKJ_MANY_SLOTS - 1];
+      loop variant n_requests - r;
+    */
+    while ((loaded < OKJ_MANY_BATCH) && (r < n_requests))
+    {
+        if (requests[r].status == OKJ_REQUEST_PENDING)
+        {
+            okj_u32 h = okj_hash_key(requests[r].key, requests[r].key_len);
+
+            s = (uint16_t)(h & (OKJ_MANY_SLOTS - 1U));
+
+            /*@ loop assigns s; */
+            while (slot_req[s] != OKJ_MANY_EMPTY)
+            {
+                s = (uint16_t)((s + 1U) & (OKJ_MANY_SLOTS - 1U));
+            }
+
+            slot_req[s]  = r;
+            slot_hash[s] = h;
+            loaded++;
+        }
+
+        r++;
+    }
+
+    *next = r;
+    left  = loaded;
+
+    /*@
+      loop invariant 0 <= i <= parser->token_count;
+      loop assigns i, s, left, requests[0 .. n_requests - 1].value,
+                   requests[0 .. n_requests - 1].status;
+      loop variant parser->token_count - i;
+    */
+    for (i = 0U; (left != 0U) && ((OkjSize)(i + 1U) < parser->token_count); i++)
+    {
+        if (okj_tok_type(parser, i) == OKJ_STRING)
+        {
+            const char *start  = okj_tok_start(parser, i);
+            OkjSize     length = okj_tok_length(parser, i);
+            okj_u32     h      = okj_hash_key(start, (uint16_t)length);
+
+            s = (uint16_t)(h & (OKJ_MANY_SLOTS - 1U));
+
+            /* Equal keys share a chain, so one token settles every request
+             * it is the first match for. */
+            /*@ loop assigns s, left, requests[0 .. n_requests - 1].value,
+                             requests[0 .. n_requests - 1].status; */
+            while (slot_req[s] != OKJ_MANY_EMPTY)
+            {
+                OkjGetRequest *request = &requests[slot_req[s]];
+
+                if ((slot_hash[s]     == h)                   &&
+                    (request->status  == OKJ_REQUEST_PENDING) &&
+                    (request->key_len == length)              &&
+                    (okj_match(start, request->key, request->key_len) == 1U))
+                {
+                    okj_resolve_request(parser, (OkjSize)(i + 1U), request);
+                    left--;
+                }
+
+                s = (uint16_t)((s + 1U) & (OKJ_MANY_SLOTS - 1U));
+            }
+        }
+    }
+
+    return loaded;
+}
+
+/*@
+  requires parser == \null || \valid(parser);
+  requires requests == \null || \valid(requests + (0 .. n_requests - 1));
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || requests == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && requests != \null;
+    assigns requests[0 .. n_requests - 1].value, requests[0 .. n_requests - 1].status,
+            *parser->hash, parser->hash->slots[0 .. parser->hash->capacity - 1];
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_many(OkJsonParser *parser, OkjGetRequest *requests, uint16_t n_requests)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (requests == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        uint16_t pending = 0U;
+        uint16_t r;
+
+        /*@
+          loop invariant 0 <= r <= n_requests && pending <= r;
+          loop assigns r, pending, requests[0 .. n_requests - 1].status;
+          loop variant n_requests - r;
+        */
+        for (r = 0U; r < n_requests; r++)
+        {
+            if (requests[r].key == NULL)
+            {
+                requests[r].status = OKJ_ERROR_BAD_POINTER;
+            }
+            else
+            {
+                requests[r].status = OKJ_REQUEST_PENDING;
+                pending++;
+            }
+        }
+
+        if (okj_hash_ready(parser) == 1U)
+        {
+            /* One probe per request. */
+            for (r = 0U; r < n_requests; r++)
+            {
+                if (requests[r].status == OKJ_REQUEST_PENDING)
+                {
+                    OkjSize idx = okj_find_value_index(parser, requests[r].key, requests[r].key_len);
+
+                    if (idx != OKJ_NOT_FOUND)
+                    {
+                        okj_resolve_request(parser, idx, &requests[r]);
+                    }
+                }
+            }
+        }
+        else
+        {
+            /* One walk per OKJ_MANY_BATCH pending requests. */
+            uint16_t next = 0U;
+
+            /*@
+              loop invariant 0 <= next <= n_requests;
+              loop assigns next, pending, requests[0 .. n_requests - 1].value,
+                           requests[0 .. n_requests - 1].status;
+              loop variant n_requests - next;
+            */
+            while (pending != 0U)
+            {
+                pending = (uint16_t)(pending - okj_many_pass(parser, requests, n_requests, &next));
+            }
+        }
+
+        /* Whatever is still pending was not found. */
+        for (r = 0U; r < n_requests; r++)
+        {
+            if (requests[r].status == OKJ_REQUEST_PENDING)
+            {
+                requests[r].status = okj_type_error(requests[r].type);
+            }
+
+            if (result == OKJ_SUCCESS)
+            {
+                result = requests[r].status;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires out_key == \null || \valid(out_key);
+  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
+
+  behavior invalid_args:
+    assumes out_key == \null || key == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior too_long:
+    assumes out_key != \null && key != \null && key_len > OKJ_MAX_STRING_LEN;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_MAX_STR_LEN_EXCEEDED;
+
+  behavior valid_args:
+    assumes out_key != \null && key != \null && key_len <= OKJ_MAX_STRING_LEN;
+    assigns *out_key;
+    ensures \result == OKJ_SUCCESS;
+    ensures out_key->bytes == key && out_key->length == key_len;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_key_init(OkjKey *out_key, const char *key, uint16_t key_len)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((out_key == NULL) || (key == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if (key_len > OKJ_MAX_STRING_LEN)
+    {
+        /* Longer than any stored token, so it could never match. */
+        result = OKJ_ERROR_MAX_STR_LEN_EXCEEDED;
+    }
+    else
+    {
+        okj_key_fill(out_key, key, key_len);
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires key == \null || \valid_read(key);
+  requires out_str == \null || \valid(out_str);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_str == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_str != \null;
+    assigns *out_str, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_STRING;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_string_key(OkJsonParser *parser, const OkjKey *key, OkJsonString *out_str)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_str == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = okj_find_key_index(parser, key);
+
+        if ((idx == OKJ_NOT_FOUND) || (okj_tok_type(parser, idx) != OKJ_STRING))
+        {
+            result = OKJ_ERROR_BAD_STRING;
+        }
+        else
+        {
+            out_str->start  = okj_tok_start(parser, idx);
+            out_str->length = okj_tok_length(parser, idx);
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires key == \null || \valid_read(key);
+  requires out_num == \null || \valid(out_num);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_num == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_num != \null;
+    assigns *out_num, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_NUMBER;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_number_key(OkJsonParser *parser, const OkjKey *key, OkJsonNumber *out_num)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_num == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = okj_find_key_index(parser, key);
+
+        if ((idx == OKJ_NOT_FOUND) || (okj_tok_type(parser, idx) != OKJ_NUMBER))
+        {
+            result = OKJ_ERROR_BAD_NUMBER;
+        }
+        else
+        {
+            out_num->start  = okj_tok_start(parser, idx);
+            out_num->length = okj_tok_length(parser, idx);
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires key == \null || \valid_read(key);
+  requires out_bool == \null || \valid(out_bool);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_bool == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_bool != \null;
+    assigns *out_bool, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_BOOLEAN;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_boolean_key(OkJsonParser *parser, const OkjKey *key, OkJsonBoolean *out_bool)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_bool == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = okj_find_key_index(parser, key);
+
+        if ((idx == OKJ_NOT_FOUND) || (okj_tok_type(parser, idx) != OKJ_BOOLEAN))
+        {
+            result = OKJ_ERROR_BAD_BOOLEAN;
+        }
+        else
+        {
+            out_bool->start  = okj_tok_start(parser, idx);
+            out_bool->length = okj_tok_length(parser, idx);
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires key == \null || \valid_read(key);
+  requires out_arr == \null || \valid(out_arr);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_arr == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_arr != \null;
+    assigns *out_arr, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_ARRAY;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_array_key(OkJsonParser *parser, const OkjKey *key, OkJsonArray *out_arr)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_arr == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = okj_find_key_index(parser, key);
+
+        if ((idx == OKJ_NOT_FOUND)                    ||
+            (okj_tok_type(parser, idx) != OKJ_ARRAY)  ||
+            (okj_tok_start(parser, idx) == NULL))
+        {
+            result = OKJ_ERROR_BAD_ARRAY;
+        }
+        else
+        {
+            out_arr->start = okj_tok_start(parser, idx);
+            okj_container_extent(parser, idx, &out_arr->count, &out_arr->length);
+
+            if (out_arr->count > OKJ_MAX_ARRAY_SIZE)
+            {
+                result = OKJ_ERROR_BAD_ARRAY;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires key == \null || \valid_read(key);
+  requires out_obj == \null || \valid(out_obj);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_obj == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_obj != \null;
+    assigns *out_obj, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_object_key(OkJsonParser *parser, const OkjKey *key, OkJsonObject *out_obj)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_obj == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = okj_find_key_index(parser, key);
+
+        if ((idx == OKJ_NOT_FOUND)                    ||
+            (okj_tok_type(parser, idx) != OKJ_OBJECT) ||
+            (okj_tok_start(parser, idx) == NULL))
+        {
+            result = OKJ_ERROR_BAD_OBJECT;
+        }
+        else
+        {
+            out_obj->start = okj_tok_start(parser, idx);
+            okj_container_extent(parser, idx, &out_obj->count, &out_obj->length);
+
+            if (out_obj->count > OKJ_MAX_OBJECT_SIZE)
+            {
+                result = OKJ_ERROR_BAD_OBJECT;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires key == \null || \valid_read(key);
+  requires out_tok == \null || \valid(out_tok);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_tok == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_tok != \null;
+    assigns *out_tok, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_token_key(OkJsonParser *parser, const OkjKey *key, OkJsonToken *out_tok)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_tok == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = okj_find_key_index(parser, key);
+
+        if (idx == OKJ_NOT_FOUND)
+        {
+            result = OKJ_ERROR_BAD_POINTER;
+        }
+        else
+        {
+            result = okj_token_at(parser, idx, out_tok);
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires key == \null || \valid_read(key);
+  requires out_index == \null || \valid(out_index);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || key == \null || out_index == \null ||
+            object >= parser->token_count;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && key != \null && out_index != \null &&
+            object < parser->token_count;
+    assigns *out_index, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT ||
+            \result == OKJ_ERROR_BAD_POINTER;
+    ensures \result == OKJ_SUCCESS ==>
+            object < *out_index && *out_index < parser->token_count;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_find_member_key(const OkJsonParser *parser, OkjSize object,
+                             const OkjKey *key, OkjSize *out_index)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (key == NULL) || (out_index == NULL) ||
+        (object >= parser->token_count))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if ((okj_tok_type(parser, object) != OKJ_OBJECT) ||
+             (okj_tok_end(parser, object) == 0U))
+    {
+        /* Not an object, or one left open by a failed parse. */
+        result = OKJ_ERROR_BAD_OBJECT;
+    }
+    else
+    {
+        OkjSize idx = okj_find_member_index(parser, object, key);
+
+        if (idx == OKJ_NOT_FOUND)
+        {
+            result = OKJ_ERROR_BAD_POINTER;
+        }
+        else
+        {
+            *out_index = idx;
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid(parser);
+  requires set == \null || \valid(set);
+  requires keys != \null ==> \valid_read(keys + (0 .. n_keys - 1));
+  requires first != \null ==> \valid(first + (0 .. n_keys - 1));
+
+  behavior invalid_args:
+    assumes parser == \null || set == \null || keys == \null ||
+            ids == \null || first == \null || n_keys == 0;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && set != \null && keys != \null &&
+            ids != \null && first != \null && n_keys > 0;
+    assigns *set, parser->key_set, first[0 .. n_keys - 1];
+    ensures \result == OKJ_SUCCESS;
+    ensures parser->key_set == set && set->n_keys == n_keys;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_keys_attach(OkJsonParser *parser, OkjKeySet *set, const OkjKey *keys,
+                         uint8_t n_keys, uint8_t *ids, OkjSize *first)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (set == NULL) || (keys == NULL) ||
+        (ids == NULL) || (first == NULL) || (n_keys == 0U))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        uint8_t id;
+
+        /*@
+          loop invariant 0 <= id <= n_keys;
+          loop assigns id, first[0 .. n_keys - 1];
+          loop variant n_keys - id;
+        */
+        for (id = 0U; id < n_keys; id++)
+        {
+            first[id] = 0U;
+        }
+
+        set->keys       = keys;
+        set->ids        = ids;
+        set->first      = first;
+        set->n_keys     = n_keys;
+        parser->key_set = set;
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires out_index == \null || \valid(out_index);
+
+  behavior invalid_args:
+    assumes parser == \null || out_index == \null || parser->key_set == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && out_index != \null && parser->key_set != \null;
+    assigns *out_index;
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER;
+    ensures \result == OKJ_SUCCESS ==> 0 < *out_index < parser->token_count;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_find_by_id(const OkJsonParser *parser, uint8_t id, OkjSize *out_index)
+{
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    if ((parser != NULL) && (out_index != NULL) && (parser->key_set != NULL) &&
+        (id < parser->key_set->n_keys))
+    {
+        OkjSize idx = parser->key_set->first[id];
+
+        /* 0 means never seen; a key that ended a failed parse has no value. */
+        if ((idx != 0U) && (idx < parser->token_count))
+        {
+            *out_index = idx;
+            result     = OKJ_SUCCESS;
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires out_tok == \null || \valid(out_tok);
+
+  behavior invalid_args:
+    assumes parser == \null || out_tok == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && out_tok != \null;
+    assigns *out_tok;
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_get_by_id(const OkJsonParser *parser, uint8_t id, OkJsonToken *out_tok)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (out_tok == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = 0U;
+
+        result = okj_find_by_id(parser, id, &idx);
+
+        if (result == OKJ_SUCCESS)
+        {
+            result = okj_token_at(parser, idx, out_tok);
+        }
+    }
+
+    return result;
+}
+
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires out_index == \null || \valid(out_index);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || out_index == \null || parser->key_set == \null ||
+            object >= parser->token_count;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && out_index != \null && parser->key_set != \null &&
+            object < parser->token_count;
+    assigns *out_index, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT ||
+            \result == OKJ_ERROR_BAD_POINTER;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_find_member_by_id(const OkJsonParser *parser, OkjSize object,
+                               uint8_t id, OkjSize *out_index)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (out_index == NULL) || (parser->key_set == NULL) ||
+        (id >= parser->key_set->n_keys) || (object >= parser->token_count))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if ((okj_tok_type(parser, object) != OKJ_OBJECT) ||
+             (okj_tok_end(parser, object) == 0U))
+    {
+        result = OKJ_ERROR_BAD_OBJECT;
+    }
+    else
+    {
+        /* The okj_find_member_index() walk, comparing IDs instead of bytes. */
+        const uint8_t *ids  = parser->key_set->ids;
+        OkjSize        stop = okj_tok_end(parser, object);
+        OkjSize        i    = (OkjSize)(object + 1U);
+
+        result = OKJ_ERROR_BAD_POINTER;
+
+        /*@
+          loop invariant object + 1 <= i;
+          loop assigns i, result, *out_index;
+          loop variant stop - i;
+        */
+        while ((result != OKJ_SUCCESS) && ((OkjSize)(i + 1U) < stop))
         {
-            uint8_t is_key = 0U;    /* 1 when this string is an object key */
+            OkjSize    value = (OkjSize)(i + 1U);
+            OkJsonType type  = okj_tok_type(parser, value);
 
-            /* A string is valid as an object key or as a value. */
-            if ((parser->context == OKJ_CTX_WANT_KEY) ||
-                (parser->context == OKJ_CTX_WANT_KEY_OR_CLOSE))
+            if (ids[i] == id)
             {
-                is_key = 1U;
+                *out_index = value;
+                result     = OKJ_SUCCESS;
             }
-            else if ((parser->context != OKJ_CTX_WANT_VALUE) &&
-                    (parser->context != OKJ_CTX_WANT_VALUE_OR_CLOSE))
+            else if (((type == OKJ_OBJECT) || (type == OKJ_ARRAY)) &&
+                     (okj_tok_end(parser, value) > value))
             {
-                result = OKJ_ERROR_SYNTAX;
+                i = okj_tok_end(parser, value);
             }
             else
             {
-                /* is_key stays 0 — string is a value */
+                i = (OkjSize)(value + 1U);
             }
+        }
+    }
 
-            if (result == OKJ_SUCCESS)
-            {
-                tok        = &parser->tokens[parser->token_count];
-                tok->type  = OKJ_STRING;
-                tok->start = &parser->json[parser->position + 1U];  /* skip opening '"' */
-
-                uint16_t start_pos  = parser->position + 1U;
+    return result;
+}
 
-                parser->position++;
+/*@
+  requires out_ptr == \null || \valid(out_ptr);
+  requires text != \null ==> \valid_read(text + (0 .. text_len - 1));
+  requires segments != \null ==> \valid(segments + (0 .. max_segments - 1));
+  requires buf != \null ==> \valid(buf + (0 .. text_len - 1));
 
-                uint8_t loop_break = 0U;
+  behavior invalid_args:
+    assumes out_ptr == \null || text == \null || segments == \null || buf == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
 
-                while ((parser->position < parser->json_len)    &&
-                       (parser->json[parser->position] != '"')  &&
-                       (loop_break != 1U))
-                {
-                    if ((parser->position - start_pos) >= (uint16_t)OKJ_MAX_STRING_LEN)
-                    {
-                        loop_break = 1U;
-                    }
-                    else
-                    {
-                        if (parser->json[parser->position] == '\\')
-                        {
-                            parser->position++;     /* consume backslash */
+  behavior valid_args:
+    assumes out_ptr != \null && text != \null && segments != \null && buf != \null;
+    assigns *out_ptr, segments[0 .. max_segments - 1], buf[0 .. text_len - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_SYNTAX ||
+            \result == OKJ_ERROR_NO_FREE_SPACE;
+    ensures \result == OKJ_SUCCESS ==> out_ptr->n_segments <= max_segments;
 
-                            if (parser->position >= parser->json_len)
-                            {
-                                loop_break = 1U;  /* truncated input: backslash at end of stream */
-                            }
-                            else
-                            {
-                                char esc_char = parser->json[parser->position];
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_pointer_compile(OkjPointer *out_ptr, const char *text, uint16_t text_len,
+                             OkjPointerSegment *segments, uint16_t max_segments, char *buf)
+{
+    OkjError result = OKJ_SUCCESS;
 
-                                if ((esc_char == '"')  || (esc_char == '\\') ||
-                                    (esc_char == '/')  || (esc_char == 'b')  ||
-                                    (esc_char == 'f')  || (esc_char == 'n')  ||
-                                    (esc_char == 'r')  || (esc_char == 't'))
-                                {
-                                    parser->position++;     /* consume the escape character */
-                                }
-                                else if (esc_char == 'u')
-                                {
-                                    parser->position++;     /* consume 'u' */
-
-                                    uint16_t h;
-
-                                    /* RFC 8259 §7: \u escape MUST be followed by exactly 4
-                                     * hex digits.  Each digit read requires a bounds check —
-                                     * the outer while loop only guards entry into the string
-                                     * body, not individual reads inside this inner for loop.
-                                     * Without the check, truncated input such as
-                                     * {"a":"\uAB (10 bytes, no NUL terminator) causes a
-                                     * heap-buffer-overread past parser->json[parser->json_len-1].
-                                     *
-                                     * We also gate every iteration on loop_break so that once
-                                     * an error is detected, parser->position does not continue
-                                     * to advance past the error point. */
-                                    for (h = 0U; h < 4U; h++)
-                                    {
-                                        if (loop_break == 0U)
-                                        {
-                                            if (parser->position >= parser->json_len)
-                                            {
-                                                result = OKJ_ERROR_BAD_STRING;
-                                                loop_break = 1U;
-                                            }
-                                            else if (okj_is_hex_digit(parser->json[parser->position]) == 0U)
-                                            {
-                                                result = OKJ_ERROR_BAD_STRING;
-                                                loop_break = 1U;
-                                            }
-                                            else
-                                            {
-                                                parser->position++;
-                                            }
-                                        }
-                                    }
-                                }
-                                else
-                                {
-                                    result = OKJ_ERROR_BAD_STRING;
-                                }
-                            }
+    if ((out_ptr == NULL) || (text == NULL) || (segments == NULL) || (buf == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if ((text_len > 0U) && (text[0] != '/'))
+    {
+        result = OKJ_ERROR_SYNTAX;
+    }
+    else
+    {
+        /* Each pass consumes one '/' and the segment after it.  Unescaping
+         * only ever shortens the text, so it fits in text_len bytes. */
+        uint16_t pos = 0U;
+        uint16_t out = 0U;
+        uint16_t n   = 0U;
 
-                            if (result != OKJ_SUCCESS)
-                            {
-                                loop_break = 1U;
-                            }
-                        }
-                        else
-                        {
-                            uint16_t utf8_advance = 0U;
+        /*@
+          loop invariant 0 <= out <= pos <= text_len;
+          loop invariant 0 <= n <= max_segments;
+          loop assigns pos, out, n, result, buf[0 .. text_len - 1],
+                       segments[0 .. max_segments - 1];
+          loop variant text_len - pos;
+        */
+        while ((result == OKJ_SUCCESS) && (pos < text_len))
+        {
+            uint16_t seg_start = out;
 
-                            /* RFC 8259 §7: bare control characters (U+0000–U+001F) are
-                            * forbidden inside strings; they must be represented as
-                            * escape sequences (e.g. \n, \t, \uXXXX). */
-                            if ((unsigned char)parser->json[parser->position] < 0x20U)
-                            {
-                                result = OKJ_ERROR_BAD_STRING;
-                                loop_break = 1U;
-                            }
-                            else
-                            {
-                                /* okj_validate_utf8_sequence now takes the buffer length
-                                 * and performs its own bounds checks before each
-                                 * continuation-byte read (see contract at its definition).
-                                 * Truncated input like {"a":"\xC2 (multi-byte lead at
-                                 * end of buffer) or fuzzer-found inputs with invalid
-                                 * lead bytes in 0x80..0xC1 / 0xF0..0xFF at EOF are
-                                 * rejected as invalid without a heap-buffer-overread. */
-                                if (okj_validate_utf8_sequence(parser->json,
-                                                            parser->position,
-                                                            parser->json_len,
-                                                            &utf8_advance) == 0U)
-                                {
-                                    result = OKJ_ERROR_BAD_STRING;
-                                    loop_break = 1U;
-                                }
-                                else
-                                {
-                                    parser->position += utf8_advance;
-                                }
-                            }
-                        }
-                    }
-                }
+            pos++;   /* the '/' */
 
-                if (result != OKJ_SUCCESS)
-                {
-                    /* Error set inside loop (e.g. invalid escape sequence). */
-                }
-                else if (parser->position >= parser->json_len)
+            /*@
+              loop invariant out <= pos <= text_len;
+              loop assigns pos, out, result, buf[0 .. text_len - 1];
+              loop variant text_len - pos;
+            */
+            while ((result == OKJ_SUCCESS) && (pos < text_len) && (text[pos] != '/'))
+            {
+                if (text[pos] != '~')
                 {
-                    /* Reached end of input before the closing quote. */
-                    result = OKJ_ERROR_UNEXPECTED_END;
+                    buf[out] = text[pos];
+                    pos++;
                 }
-                else if (parser->json[parser->position] != '"')
+                else if (((uint16_t)(pos + 1U) < text_len) && (text[pos + 1U] == '0'))
                 {
-                    /* Loop exited due to the length limit, not a closing quote. */
-                    result = OKJ_ERROR_MAX_STR_LEN_EXCEEDED;
+                    buf[out] = '~';
+                    pos = (uint16_t)(pos + 2U);
                 }
-                else if ((parser->position - start_pos) > (uint16_t)OKJ_MAX_STRING_LEN)
+                else if (((uint16_t)(pos + 1U) < text_len) && (text[pos + 1U] == '1'))
                 {
-                    /* An escape sequence whose first byte landed just below the
-                    * OKJ_MAX_STRING_LEN ceiling advanced position one past the
-                    * limit in a single loop iteration before the top-of-loop
-                    * length check could fire.  The raw string content therefore
-                    * exceeds the declared maximum; reject it. */
-                    result = OKJ_ERROR_MAX_STR_LEN_EXCEEDED;
+                    buf[out] = '/';
+                    pos = (uint16_t)(pos + 2U);
                 }
                 else
                 {
-                    tok->length = parser->position - start_pos;
-
-                    parser->position++;   /* advance past closing '"' */
-                    parser->token_count++;
+                    result = OKJ_ERROR_SYNTAX;
+                }
 
-                    /* Update grammar context based on whether this string was a key
-                    * (next: colon) or a value (next: separator or closing bracket). */
-                    if (is_key != 0U)
-                    {
-                        parser->context = OKJ_CTX_WANT_COLON;
-                    }
-                    else if (parser->depth > 0U)
-                    {
-                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
-                    }
-                    else
-                    {
-                        /* Top-level string value: the main loop handles the exit. */
-                    }
+                if (result == OKJ_SUCCESS)
+                {
+                    out++;
                 }
             }
-        }
-        else if ((okj_is_digit(c)) || (c == '-'))
-        {
-            /* Numbers are only valid in value positions, never as object keys. */
-            if ((parser->context != OKJ_CTX_WANT_VALUE) &&
-                (parser->context != OKJ_CTX_WANT_VALUE_OR_CLOSE))
+
+            if (result != OKJ_SUCCESS)
             {
-                result = OKJ_ERROR_SYNTAX;
+                /* Bad escape. */
+            }
+            else if (n >= max_segments)
+            {
+                result = OKJ_ERROR_NO_FREE_SPACE;
             }
             else
             {
-                tok        = &parser->tokens[parser->token_count];
-                tok->type  = OKJ_NUMBER;
-                tok->start = &parser->json[parser->position];
-
-                uint16_t start_pos  = parser->position;
-
-                uint8_t number_ok = 1U;
-
-                /* Step 1: optional leading minus */
-                if (c == '-')
-                {
-                    parser->position++;     /* consume '-' */
-
-                    if ((parser->position >= parser->json_len) ||
-                        (okj_is_digit(parser->json[parser->position]) == 0U))
-                    {
-                        number_ok = 0U;     /* bare minus is not a valid number */
-                    }
-                }
-
-                /* Step 2: integer part — zero OR digit1-9 *DIGIT */
-                if (number_ok != 0U)
-                {
-                    if ((parser->position < parser->json_len) &&
-                        (parser->json[parser->position] == '0'))
-                    {
-                        parser->position++;     /* consume '0' */
+                uint16_t len = (uint16_t)(out - seg_start);
 
-                        if ((parser->position < parser->json_len) &&
-                            (okj_is_digit(parser->json[parser->position]) != 0U))
-                        {
-                            number_ok = 0U;     /* leading zero: "012" is invalid */
-                        }
-                    }
-                    else
-                    {
-                        while ((parser->position < parser->json_len) &&
-                               (okj_is_digit(parser->json[parser->position]) != 0U))
-                        {
-                            parser->position++;
-                        }
-                    }
-                }
+                okj_key_fill(&segments[n].key, &buf[seg_start], len);
+                segments[n].index = okj_pointer_index(&buf[seg_start], len);
+                n++;
+            }
+        }
 
-                /* Step 3: optional fractional part — '.' 1*DIGIT */
-                if ((number_ok != 0U) &&
-                    (parser->position < parser->json_len) &&
-                    (parser->json[parser->position] == '.'))
-                {
-                    parser->position++;     /* consume '.' */
+        if (result == OKJ_SUCCESS)
+        {
+            out_ptr->segments   = segments;
+            out_ptr->n_segments = n;
+        }
+    }
 
-                    if ((parser->position >= parser->json_len) ||
-                        (okj_is_digit(parser->json[parser->position]) == 0U))
-                    {
-                        number_ok = 0U;     /* decimal point must be followed by a digit */
-                    }
-                    else
-                    {
-                        while ((parser->position < parser->json_len) &&
-                               (okj_is_digit(parser->json[parser->position]) != 0U))
-                        {
-                            parser->position++;
-                        }
-                    }
-                }
+    return result;
+}
 
-                /* Step 4: optional exponent part — ('e'/'E') [sign] 1*DIGIT */
-                if ((number_ok != 0U) &&
-                    (parser->position < parser->json_len) &&
-                    ((parser->json[parser->position] == 'e') ||
-                     (parser->json[parser->position] == 'E')))
-                {
-                    parser->position++;     /* consume 'e' or 'E' */
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires ptr == \null || \valid_read(ptr);
+  requires out_index == \null || \valid(out_index);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
 
-                    if ((parser->position < parser->json_len) &&
-                        ((parser->json[parser->position] == '+') ||
-                         (parser->json[parser->position] == '-')))
-                    {
-                        parser->position++;     /* consume optional sign */
-                    }
+  behavior invalid_args:
+    assumes parser == \null || ptr == \null || out_index == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
 
-                    if ((parser->position >= parser->json_len) ||
-                        (okj_is_digit(parser->json[parser->position]) == 0U))
-                    {
-                        number_ok = 0U;     /* exponent requires at least one digit */
-                    }
-                    else
-                    {
-                        while ((parser->position < parser->json_len) &&
-                               (okj_is_digit(parser->json[parser->position]) != 0U))
-                        {
-                            parser->position++;
-                        }
-                    }
-                }
+  behavior valid_args:
+    assumes parser != \null && ptr != \null && out_index != \null;
+    assigns *out_index, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER;
+    ensures \result == OKJ_SUCCESS ==> *out_index < parser->token_count;
 
-                if (number_ok != 0U)
-                {
-                    tok->length = parser->position - start_pos;
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_pointer_find(const OkJsonParser *parser, const OkjPointer *ptr, OkjSize *out_index)
+{
+    OkjError result = OKJ_SUCCESS;
 
-                    parser->token_count++;
+    if ((parser == NULL) || (ptr == NULL) || (out_index == NULL) ||
+        (parser->token_count == 0U))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize  cur = 0U;
+        uint16_t s;
 
-                    if (parser->depth > 0U)
-                    {
-                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
-                    }
-                }
-                else
-                {
-                    result = OKJ_ERROR_BAD_NUMBER;
-                }
-            }
-        }
-        else if (((uint16_t)(parser->json_len - parser->position) >= 4U) &&
-                 (okj_match(&parser->json[parser->position], "true", 4U) == 1U))
+        /*@
+          loop invariant 0 <= s <= ptr->n_segments;
+          loop invariant cur == OKJ_NOT_FOUND || cur < parser->token_count;
+          loop assigns s, cur, *parser->hash,
+                       parser->hash->slots[0 .. parser->hash->capacity - 1];
+          loop variant ptr->n_segments - s;
+        */
+        for (s = 0U; (cur != OKJ_NOT_FOUND) && (s < ptr->n_segments); s++)
         {
-            /* Keyword literals are only valid in value positions. */
-            if ((parser->context != OKJ_CTX_WANT_VALUE) &&
-                (parser->context != OKJ_CTX_WANT_VALUE_OR_CLOSE))
+            const OkjPointerSegment *seg  = &ptr->segments[s];
+            OkJsonType               type = okj_tok_type(parser, cur);
+
+            if (okj_tok_end(parser, cur) == 0U)
             {
-                result = OKJ_ERROR_SYNTAX;
+                /* A primitive, or a container a failed parse left open. */
+                cur = OKJ_NOT_FOUND;
             }
-            else
+            else if (type == OKJ_OBJECT)
             {
-                tok         = &parser->tokens[parser->token_count];
-                tok->type   = OKJ_BOOLEAN;
-                tok->start  = &parser->json[parser->position];
-                tok->length = 4U;
-
-                parser->position += 4U;
-
-                /* RFC 8259: keyword must end at a value boundary (no "truetrue").
-                 * End of input is always a valid boundary. */
-                if ((parser->position < parser->json_len) &&
-                    (okj_is_value_terminator(parser->json[parser->position]) == 0U))
-                {
-                    result = OKJ_ERROR_SYNTAX;
-                }
-                else
-                {
-                    parser->token_count++;
-
-                    if (parser->depth > 0U)
-                    {
-                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
-                    }
-                }
+                cur = okj_find_member_index(parser, cur, &seg->key);
             }
-        }
-        else if (((uint16_t)(parser->json_len - parser->position) >= 5U) &&
-                 (okj_match(&parser->json[parser->position], "false", 5U) == 1U))
-        {
-            if ((parser->context != OKJ_CTX_WANT_VALUE) &&
-                (parser->context != OKJ_CTX_WANT_VALUE_OR_CLOSE))
+            else if ((type == OKJ_ARRAY) && (seg->index != OKJ_NOT_FOUND))
             {
-                result = OKJ_ERROR_SYNTAX;
+                cur = okj_array_element(parser, cur, seg->index);
             }
             else
             {
-                tok         = &parser->tokens[parser->token_count];
-                tok->type   = OKJ_BOOLEAN;
-                tok->start  = &parser->json[parser->position];
-                tok->length = 5U;
+                cur = OKJ_NOT_FOUND;
+            }
+        }
 
-                parser->position += 5U;
+        if (cur == OKJ_NOT_FOUND)
+        {
+            result = OKJ_ERROR_BAD_POINTER;
+        }
+        else
+        {
+            *out_index = cur;
+        }
+    }
 
-                if ((parser->position < parser->json_len) &&
-                    (okj_is_value_terminator(parser->json[parser->position]) == 0U))
-                {
-                    result = OKJ_ERROR_SYNTAX;
-                }
-                else
-                {
-                    parser->token_count++;
+    return result;
+}
 
-                    if (parser->depth > 0U)
-                    {
-                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
-                    }
-                }
-            }
-        }
-        else if (((uint16_t)(parser->json_len - parser->position) >= 4U) &&
-                 (okj_match(&parser->json[parser->position], "null", 4U) == 1U))
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires ptr == \null || \valid_read(ptr);
+  requires out_tok == \null || \valid(out_tok);
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
+
+  behavior invalid_args:
+    assumes parser == \null || ptr == \null || out_tok == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && ptr != \null && out_tok != \null;
+    assigns *out_tok, *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_pointer_get(const OkJsonParser *parser, const OkjPointer *ptr, OkJsonToken *out_tok)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (ptr == NULL) || (out_tok == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = 0U;
+
+        result = okj_pointer_find(parser, ptr, &idx);
+
+        if (result == OKJ_SUCCESS)
         {
-            if ((parser->context != OKJ_CTX_WANT_VALUE) &&
-                (parser->context != OKJ_CTX_WANT_VALUE_OR_CLOSE))
-            {
-                result = OKJ_ERROR_SYNTAX;
-            }
-            else
-            {
-                tok         = &parser->tokens[parser->token_count];
-                tok->type   = OKJ_NULL;
-                tok->start  = &parser->json[parser->position];
-                tok->length = 4U;
+            result = okj_token_at(parser, idx, out_tok);
+        }
+    }
+
+    return result;
+}
 
-                parser->position += 4U;
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires out_index == \null || \valid(out_index);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
 
-                if ((parser->position < parser->json_len) &&
-                    (okj_is_value_terminator(parser->json[parser->position]) == 0U))
-                {
-                    result = OKJ_ERROR_SYNTAX;
-                }
-                else
-                {
-                    parser->token_count++;
+  behavior invalid_args:
+    assumes parser == \null || out_index == \null || array >= parser->token_count;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
 
-                    if (parser->depth > 0U)
-                    {
-                        parser->context = OKJ_CTX_WANT_SEP_OR_CLOSE;
-                    }
-                }
-            }
+  behavior valid_args:
+    assumes parser != \null && out_index != \null && array < parser->token_count;
+    assigns *out_index;
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_ARRAY ||
+            \result == OKJ_ERROR_BAD_POINTER;
+    ensures \result == OKJ_SUCCESS ==>
+            array < *out_index && *out_index < parser->token_count;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_array_find(const OkJsonParser *parser, OkjSize array, OkjSize n, OkjSize *out_index)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (out_index == NULL) || (array >= parser->token_count))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if ((okj_tok_type(parser, array) != OKJ_ARRAY) ||
+             (okj_tok_end(parser, array) == 0U))
+    {
+        /* Not an array, or one left open by a failed parse. */
+        result = OKJ_ERROR_BAD_ARRAY;
+    }
+    else
+    {
+        OkjSize idx = okj_array_element(parser, array, n);
+
+        if (idx == OKJ_NOT_FOUND)
+        {
+            result = OKJ_ERROR_BAD_POINTER;
         }
         else
         {
-            result = OKJ_ERROR_SYNTAX;
+            *out_index = idx;
         }
-
-        } /* end else (position < json_len) */
     }
 
     return result;
 }
 
 /*@
-  // 1. Preconditions
   requires parser == \null || \valid_read(parser);
-  
-  // The search key must be safely readable up to key_len.
-  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
-
-  // The caller must guarantee that the parser state is well-formed.
+  requires out_tok == \null || \valid(out_tok);
   requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
 
-  // The caller must guarantee that EVERY token in the parser array that 
-  // has a non-null start pointer is safely readable up to its specified length.
-  // This is the mathematical key that allows okj_match to be proven safe.
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
-
-  // 2. Frame Condition
-  // This is a pure search function; it modifies absolutely nothing.
-  assigns \nothing;
-
-  // 3. Behaviors
   behavior invalid_args:
-    assumes parser == \null || key == \null;
-    ensures \result == OKJ_MAX_TOKENS;
+    assumes parser == \null || out_tok == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
 
   behavior valid_args:
-    assumes parser != \null && key != \null;
-    // The result is either OKJ_MAX_TOKENS (not found) or a valid index (1 to token_count)
-    ensures \result == OKJ_MAX_TOKENS || (1 <= \result && \result <= parser->token_count);
+    assumes parser != \null && out_tok != \null;
+    assigns *out_tok;
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_ARRAY ||
+            \result == OKJ_ERROR_BAD_POINTER;
 
   complete behaviors;
   disjoint behaviors;
 */
-static uint16_t okj_find_value_index(OkJsonParser *parser, const char *key, uint16_t key_len)
+OkjError okj_array_at(const OkJsonParser *parser, OkjSize array, OkjSize n, OkJsonToken *out_tok)
 {
-    /* Scans the token array for a STRING token whose content equals `key`
-    * (of length `key_len` bytes).  The key need not be null-terminated.
-    * Returns the index of the NEXT token (the value), or OKJ_MAX_TOKENS if
-    * not found.  Keys longer than OKJ_MAX_STRING_LEN are never found because
-    * the parser enforces that limit on stored tokens. */
-
-    uint16_t result = OKJ_MAX_TOKENS;
+    OkjError result = OKJ_SUCCESS;
 
-    if ((parser != NULL) && (key != NULL))
+    if ((parser == NULL) || (out_tok == NULL))
     {
-        uint16_t i;
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize idx = 0U;
 
-        /*@
-          // LOOP INVARIANTS
-          // i will never exceed the token count
-          loop invariant 0 <= i <= parser->token_count;
-          
-          // Result stays at OKJ_MAX_TOKENS unless a match is found
-          loop invariant result == OKJ_MAX_TOKENS || (1 <= result && result <= parser->token_count);
-          
-          loop assigns i, result;
-          loop variant parser->token_count - i;
-        */
-        for (i = 0U; (i + 1U) < parser->token_count; i++)
-        {
-            const OkJsonToken *t = &parser->tokens[i];
+        result = okj_array_find(parser, array, n, &idx);
 
-            if ((t->type   == OKJ_STRING) &&
-                (t->length == key_len)    &&
-                (okj_match(t->start, key, key_len)))
-            {
-                result = i + 1U;
-                break;
-            }
+        if (result == OKJ_SUCCESS)
+        {
+            result = okj_token_at(parser, idx, out_tok);
         }
     }
 
@@ -1624,186 +7401,182 @@ static uint16_t okj_find_value_index(OkJsonParser *parser, const char *key, uint
 }
 
 /*@
-  // 1. Preconditions
-  // The parser can be NULL, or it must be a valid pointer to the struct.
-  requires parser == \null || \valid(parser);
+  requires parser == \null || \valid_read(parser);
+  requires offsets != \null ==> \valid(offsets + (0 .. capacity - 1));
+  requires out_count == \null || \valid(out_count);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
 
-  // 2. Behaviors
-  behavior null_ptrs:
-    assumes parser == \null || json_string == \null;
+  behavior invalid_args:
+    assumes parser == \null || offsets == \null || out_count == \null ||
+            array >= parser->token_count;
     assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
 
-  behavior valid_ptrs:
-    assumes parser != \null && json_string != \null;
-    
-    // We are modifying the entire parser struct
-    assigns *parser;
-    
-    // Verify standard field initializations
-    ensures parser->json == json_string;
-    ensures parser->json_len == json_len;
-    ensures parser->position == 0;
-    ensures parser->token_count == 0;
-    ensures parser->depth == 0;
-    ensures parser->context == OKJ_CTX_WANT_VALUE;
-    
-    // Verify array initializations using universal quantification
-    ensures \forall integer k; 0 <= k < OKJ_MAX_TOKENS ==> parser->tokens[k].type == OKJ_UNDEFINED;
-    ensures \forall integer k; 0 <= k < OKJ_MAX_TOKENS ==> parser->tokens[k].start == \null;
-    ensures \forall integer k; 0 <= k < OKJ_MAX_TOKENS ==> parser->tokens[k].length == 0;
-    ensures \forall integer k; 0 <= k < OKJ_MAX_DEPTH ==> parser->depth_stack[k] == OKJ_UNDEFINED;
+  behavior valid_args:
+    assumes parser != \null && offsets != \null && out_count != \null &&
+            array < parser->token_count;
+    assigns offsets[0 .. capacity - 1], *out_count;
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_ARRAY ||
+            \result == OKJ_ERROR_NO_FREE_SPACE;
+    ensures \result == OKJ_SUCCESS ==> *out_count <= capacity;
 
   complete behaviors;
   disjoint behaviors;
 */
-void okj_init(OkJsonParser *parser, char *json_string, uint16_t json_len)
+OkjError okj_array_offsets(const OkJsonParser *parser, OkjSize array,
+                           OkjSize *offsets, OkjSize capacity, OkjSize *out_count)
 {
-    if ((parser != NULL) && (json_string != NULL))
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (offsets == NULL) || (out_count == NULL) ||
+        (array >= parser->token_count))
     {
-        uint16_t i;
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else if ((okj_tok_type(parser, array) != OKJ_ARRAY) ||
+             (okj_tok_end(parser, array) == 0U))
+    {
+        result = OKJ_ERROR_BAD_ARRAY;
+    }
+    else if (okj_tok_count(parser, array) > capacity)
+    {
+        result = OKJ_ERROR_NO_FREE_SPACE;
+    }
+    else
+    {
+        /* One okj_array_element() walk, recording where each element starts. */
+        OkjSize stop = okj_tok_end(parser, array);
+        OkjSize i    = (OkjSize)(array + 1U);
+        OkjSize k    = 0U;
 
         /*@
-          loop invariant 0 <= i <= OKJ_MAX_TOKENS;
-          
-          // Prove that all elements BEFORE the current index 'i' are correctly initialized
-          loop invariant \forall integer k; 0 <= k < i ==> parser->tokens[k].type == OKJ_UNDEFINED;
-          loop invariant \forall integer k; 0 <= k < i ==> parser->tokens[k].start == \null;
-          loop invariant \forall integer k; 0 <= k < i ==> parser->tokens[k].length == 0;
-          
-          // Explicitly state which part of the array this loop is allowed to modify
-          loop assigns i, parser->tokens[0 .. OKJ_MAX_TOKENS - 1];
-          loop variant OKJ_MAX_TOKENS - i;
+          loop invariant array + 1 <= i;
+          loop invariant 0 <= k <= capacity;
+          loop assigns i, k, offsets[0 .. capacity - 1];
+          loop variant stop - i;
         */
-        for (i = 0U; i < OKJ_MAX_TOKENS; i++)
+        while (i < stop)
         {
-            parser->tokens[i].type   = OKJ_UNDEFINED;
-            parser->tokens[i].start  = NULL;
-            parser->tokens[i].length = 0U;
-        }
+            OkJsonType type = okj_tok_type(parser, i);
 
-        /*@
-          loop invariant 0 <= i <= OKJ_MAX_DEPTH;
-          loop invariant \forall integer k; 0 <= k < i ==> parser->depth_stack[k] == OKJ_UNDEFINED;
-          loop assigns i, parser->depth_stack[0 .. OKJ_MAX_DEPTH - 1];
-          loop variant OKJ_MAX_DEPTH - i;
-        */
-        for (i = 0U; i < (uint16_t)OKJ_MAX_DEPTH; i++)
-        {
-            parser->depth_stack[i] = OKJ_UNDEFINED;
+            offsets[k] = i;
+            k++;
+
+            if (((type == OKJ_OBJECT) || (type == OKJ_ARRAY)) && (okj_tok_end(parser, i) > i))
+            {
+                i = okj_tok_end(parser, i);
+            }
+            else
+            {
+                i = (OkjSize)(i + 1U);
+            }
         }
 
-        parser->json        = json_string;
-        parser->json_len    = json_len;
-        parser->position    = 0U;
-        parser->token_count = 0U;
-        parser->depth       = 0U;
-        parser->context     = OKJ_CTX_WANT_VALUE;
+        *out_count = k;
     }
+
+    return result;
 }
 
 /*@
-  // Same buffer-readability precondition as okj_parse_value: without it,
-  // the subordinate reads inside the main dispatch are UB.  This is the
-  // contract the public API documents to callers via okj_init's length
-  // parameter.
-  requires parser == \null || \valid(parser);
-  requires parser != \null ==>
-             \valid_read(parser->json + (0 .. parser->json_len - 1));
-  requires parser != \null ==>
-             \valid(parser->tokens + (0 .. OKJ_MAX_TOKENS - 1));
+  requires parser == \null || \valid_read(parser);
+  requires out_it == \null || \valid(out_it);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
 
-  behavior null_parser:
-    assumes parser == \null;
+  behavior invalid_args:
+    assumes parser == \null || out_it == \null || container >= parser->token_count;
     assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
 
-  behavior valid_parser:
-    assumes parser != \null;
-    assigns *parser;
+  behavior valid_args:
+    assumes parser != \null && out_it != \null && container < parser->token_count;
+    assigns *out_it;
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT;
+    ensures \result == OKJ_SUCCESS ==> out_it->stop <= parser->token_count;
 
   complete behaviors;
   disjoint behaviors;
-
-  // NOTE: This function is not yet in the -wp-fct list because fully
-  // discharging its WP goals requires loop invariants matching those in
-  // okj_parse_value.  Issue #69's OOB reads are prevented at the source
-  // level (inside okj_parse_value) and guarded by ASan-instrumented
-  // regression tests + the updated libFuzzer harness.
- */
-OkjError okj_parse(OkJsonParser *parser)
+*/
+OkjError okj_iter_init(const OkJsonParser *parser, OkjSize container, OkjIter *out_it)
 {
     OkjError result = OKJ_SUCCESS;
 
-    if (parser == NULL)
+    if ((parser == NULL) || (out_it == NULL) || (container >= parser->token_count))
     {
         result = OKJ_ERROR_BAD_POINTER;
     }
+    else if (((okj_tok_type(parser, container) != OKJ_OBJECT) &&
+              (okj_tok_type(parser, container) != OKJ_ARRAY))  ||
+             (okj_tok_end(parser, container) == 0U))
+    {
+        /* Not a container, or one left open by a failed parse. */
+        result = OKJ_ERROR_BAD_OBJECT;
+    }
     else
     {
-        if (parser->json_len > OKJ_MAX_JSON_LEN)
-        {
-            result = OKJ_ERROR_MAX_JSON_LEN_EXCEEDED;
-        }
+        out_it->parser = parser;
+        out_it->type   = okj_tok_type(parser, container);
+        out_it->next   = (OkjSize)(container + 1U);
+        out_it->stop   = okj_tok_end(parser, container);
+        out_it->value  = OKJ_NOT_FOUND;
+    }
 
-        if (result != OKJ_ERROR_MAX_JSON_LEN_EXCEEDED)
-        {
-            uint8_t not_success = 0U;
+    return result;
+}
 
-            while ((parser->position < parser->json_len)  &&
-                   (parser->token_count < OKJ_MAX_TOKENS) &&
-                   (not_success == 0U))
-            {
-                uint16_t prev_tokens = parser->token_count;
-                uint16_t prev_depth  = parser->depth;
+/*@
+  requires it == \null || \valid(it);
+  requires key_tok == \null || \valid(key_tok);
+  requires val_tok == \null || \valid(val_tok);
 
-                result = okj_parse_value(parser);
+  assigns *it, *key_tok, *val_tok;
 
-                if (result != OKJ_SUCCESS)
-                {
-                    not_success = 1U;
-                }
-                else
-                {
-                    /* Detect completion of the single top-level value:
-                    *  - A primitive was emitted at depth 0 (depth stayed 0, new token added), or
-                    *  - A container was fully closed back to depth 0 (depth dropped from > 0).
-                    * RFC 8259 §2 permits exactly one top-level value; anything other than
-                    * optional whitespace that follows it is a syntax error. */
-                    if (parser->depth == 0U)
-                    {
-                        if ((prev_depth > 0U) || (parser->token_count > prev_tokens))
-                        {
-                            okj_skip_whitespace(parser);
+  ensures \result == 0 || \result == 1;
+*/
+uint8_t okj_iter_next(OkjIter *it, OkJsonToken *key_tok, OkJsonToken *val_tok)
+{
+    uint8_t result = 0U;
 
-                            if (parser->position < parser->json_len)
-                            {
-                                result = OKJ_ERROR_SYNTAX;
-                            }
+    if (it != NULL)
+    {
+        /* An object child is a key and its value; an array child is just
+         * the value. */
+        OkjSize key   = it->next;
+        OkjSize value = (it->type == OKJ_OBJECT) ? (OkjSize)(key + 1U) : key;
 
-                            break;
-                        }
-                    }
-                }
-            }
+        if (value < it->stop)
+        {
+            const OkJsonParser *parser = it->parser;
+            OkJsonType          vtype  = okj_tok_type(parser, value);
 
-            if ((result == OKJ_SUCCESS)                      &&
-                (parser->token_count >= OKJ_MAX_TOKENS)      &&
-                (parser->position < parser->json_len))
+            if (key_tok == NULL)
             {
-                result = OKJ_ERROR_MAX_TOKENS_EXCEEDED;
+                /* Caller only wants values. */
             }
-
-            /* Any containers still open at end-of-input indicate truncated input. */
-            if ((result == OKJ_SUCCESS) && (parser->depth != 0U))
+            else if (it->type == OKJ_OBJECT)
             {
-                result = OKJ_ERROR_UNEXPECTED_END;
+                (void)okj_token_at(parser, key, key_tok);
+            }
+            else
+            {
+                key_tok->type   = OKJ_UNDEFINED;
+                key_tok->start  = NULL;
+                key_tok->length = 0U;
+                key_tok->end    = 0U;
+                key_tok->count  = 0U;
             }
 
-            /* RFC 8259 §2: a JSON text must contain exactly one value.  An empty
-            * or whitespace-only input has no value and is therefore invalid. */
-            if ((result == OKJ_SUCCESS) && (parser->token_count == 0U))
+            if (val_tok != NULL)
             {
-                result = OKJ_ERROR_UNEXPECTED_END;
+                (void)okj_token_at(parser, value, val_tok);
             }
+
+            it->value = value;
+            it->next  = (((vtype == OKJ_OBJECT) || (vtype == OKJ_ARRAY)) &&
+                         (okj_tok_end(parser, value) > value))
+                        ? okj_tok_end(parser, value)
+                        : (OkjSize)(value + 1U);
+            result    = 1U;
         }
     }
 
@@ -1811,55 +7584,108 @@ OkjError okj_parse(OkJsonParser *parser)
 }
 
 /*@
-  // 1. Preconditions
-  // Pointers can be null (we handle that gracefully), but if they aren't, 
-  // they must be valid for reading/writing.
-  requires parser == \null || \valid_read(parser);
+  requires parser == \null || \valid_read(parser);
+  requires out_cursor == \null || \valid(out_cursor);
+
+  behavior invalid_args:
+    assumes parser == \null || out_cursor == \null;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_BAD_POINTER;
+
+  behavior valid_args:
+    assumes parser != \null && out_cursor != \null;
+    assigns *out_cursor;
+    ensures \result == OKJ_SUCCESS;
+    ensures out_cursor->parser == parser && out_cursor->next == 0;
+
+  complete behaviors;
+  disjoint behaviors;
+*/
+OkjError okj_cursor_init(const OkJsonParser *parser, OkjCursor *out_cursor)
+{
+    OkjError result = OKJ_SUCCESS;
+
+    if ((parser == NULL) || (out_cursor == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        out_cursor->parser = parser;
+        out_cursor->next   = 0U;
+    }
+
+    return result;
+}
+
+/*@
+  requires cursor == \null || (\valid(cursor) && \valid_read(cursor->parser));
   requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
-  requires out_str == \null || \valid(out_str);
-
-  // Inherit the token validity requirements so okj_find_value_index is satisfied
-  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+  requires out_index == \null || \valid(out_index);
+  requires cursor != \null && cursor->parser->hash != \null ==> \valid(cursor->parser->hash);
 
-  // 2. Behaviors
   behavior invalid_args:
-    assumes parser == \null || key == \null || out_str == \null;
+    assumes cursor == \null || key == \null || out_index == \null;
     assigns \nothing;
     ensures \result == OKJ_ERROR_BAD_POINTER;
 
   behavior valid_args:
-    assumes parser != \null && key != \null && out_str != \null;
-    // We are only allowed to modify the output struct
-    assigns *out_str;
-    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_STRING;
+    assumes cursor != \null && key != \null && out_index != \null;
+    assigns cursor->next, *out_index, *cursor->parser->hash,
+            cursor->parser->hash->slots[0 .. cursor->parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER;
+    ensures \result == OKJ_SUCCESS ==>
+            0 < *out_index < cursor->parser->token_count;
 
   complete behaviors;
   disjoint behaviors;
 */
-OkjError okj_get_string(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonString *out_str)
+OkjError okj_cursor_find(OkjCursor *cursor, const char *key, uint16_t key_len, OkjSize *out_index)
 {
-    OkjError result = OKJ_SUCCESS;
+    OkjError result = OKJ_ERROR_BAD_POINTER;
 
-    if ((parser == NULL) || (key == NULL) || (out_str == NULL))
-    {
-        result = OKJ_ERROR_BAD_POINTER;
-    }
-    else
+    if ((cursor != NULL) && (key != NULL) && (out_index != NULL))
     {
-        uint16_t idx = okj_find_value_index(parser, key, key_len);
+        /* okj_find_value_index()'s scan, over the rotated token range
+         * next, next + 1, ..., token_count - 1, 0, ..., next - 1.  Length
+         * and last byte reject most other keys before okj_match(). */
+        const OkJsonParser *parser = cursor->parser;
+        OkjSize n = parser->token_count;
+        OkjSize i = (cursor->next < n) ? cursor->next : 0U;
+        OkjSize k;
 
-        if ((idx == OKJ_MAX_TOKENS) || (parser->tokens[idx].type != OKJ_STRING))
-        {
-            result = OKJ_ERROR_BAD_STRING;
-        }
-        else
+        /*@
+          loop invariant 0 <= k <= n;
+          loop invariant i < n || n == 0;
+          loop assigns k, i, result, *out_index, cursor->next;
+          loop variant n - k;
+        */
+        for (k = 0U; (result != OKJ_SUCCESS) && (k < n); k++)
         {
-            out_str->start  = parser->tokens[idx].start;
-            out_str->length = parser->tokens[idx].length;
+            OkjSize value = (OkjSize)(i + 1U);
+
+            if ((value < n)                                  &&
+                (okj_tok_type(parser, i) == OKJ_STRING)      &&
+                (okj_tok_length(parser, i) == key_len)       &&
+                ((key_len == 0U) ||
+                 (okj_tok_start(parser, i)[key_len - 1U] == key[key_len - 1U])) &&
+                (okj_match(okj_tok_start(parser, i), key, key_len) == 1U))
+            {
+                OkJsonType vtype = okj_tok_type(parser, value);
+
+                *out_index = value;
+                result     = OKJ_SUCCESS;
+
+                /* Resume after the value, past its subtree if it has one. */
+                cursor->next = (((vtype == OKJ_OBJECT) || (vtype == OKJ_ARRAY)) &&
+                                (okj_tok_end(parser, value) > value))
+                               ? okj_tok_end(parser, value)
+                               : (OkjSize)(value + 1U);
+            }
+            else
+            {
+                i = (value < n) ? value : 0U;
+            }
         }
     }
 
@@ -1867,55 +7693,42 @@ OkjError okj_get_string(OkJsonParser *parser, const char *key, uint16_t key_len,
 }
 
 /*@
-  // 1. Preconditions
-  // Pointers can be null (we handle that gracefully), but if they aren't, 
-  // they must be valid for reading/writing.
-  requires parser == \null || \valid_read(parser);
+  requires cursor == \null || (\valid(cursor) && \valid_read(cursor->parser));
   requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
-  requires out_num == \null || \valid(out_num);
-
-  // Inherit the token validity requirements so okj_find_value_index is satisfied
-  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+  requires out_tok == \null || \valid(out_tok);
+  requires cursor != \null && cursor->parser->hash != \null ==> \valid(cursor->parser->hash);
 
-  // 2. Behaviors
   behavior invalid_args:
-    assumes parser == \null || key == \null || out_num == \null;
+    assumes cursor == \null || key == \null || out_tok == \null;
     assigns \nothing;
     ensures \result == OKJ_ERROR_BAD_POINTER;
 
   behavior valid_args:
-    assumes parser != \null && key != \null && out_num != \null;
-    // We are only allowed to modify the output struct
-    assigns *out_num;
-    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_NUMBER;
+    assumes cursor != \null && key != \null && out_tok != \null;
+    assigns cursor->next, *out_tok, *cursor->parser->hash,
+            cursor->parser->hash->slots[0 .. cursor->parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER;
 
   complete behaviors;
   disjoint behaviors;
 */
-OkjError okj_get_number(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonNumber *out_num)
+OkjError okj_cursor_get(OkjCursor *cursor, const char *key, uint16_t key_len, OkJsonToken *out_tok)
 {
     OkjError result = OKJ_SUCCESS;
 
-    if ((parser == NULL) || (key == NULL) || (out_num == NULL))
+    if ((cursor == NULL) || (key == NULL) || (out_tok == NULL))
     {
         result = OKJ_ERROR_BAD_POINTER;
     }
     else
     {
-        uint16_t idx = okj_find_value_index(parser, key, key_len);
+        OkjSize idx = 0U;
 
-        if ((idx == OKJ_MAX_TOKENS) || (parser->tokens[idx].type != OKJ_NUMBER))
-        {
-            result = OKJ_ERROR_BAD_NUMBER;
-        }
-        else
+        result = okj_cursor_find(cursor, key, key_len, &idx);
+
+        if (result == OKJ_SUCCESS)
         {
-            out_num->start  = parser->tokens[idx].start;
-            out_num->length = parser->tokens[idx].length;
+            result = okj_token_at(cursor->parser, idx, out_tok);
         }
     }
 
@@ -1923,55 +7736,135 @@ OkjError okj_get_number(OkJsonParser *parser, const char *key, uint16_t key_len,
 }
 
 /*@
-  // 1. Preconditions
-  requires parser == \null || \valid_read(parser);
-  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
-  requires out_bool == \null || \valid(out_bool);
-
-  // Timeout fix: Guarantee the output pointer doesn't alias the inputs!
-  requires \separated(out_bool, parser, key + (0 .. key_len - 1));
-
-  // Inherit the token validity requirements
-  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+  requires out_path == \null || \valid(out_path);
+  requires text != \null ==> \valid_read(text + (0 .. text_len - 1));
+  requires steps != \null ==> \valid(steps + (0 .. max_steps - 1));
 
-  // 2. Behaviors
   behavior invalid_args:
-    assumes parser == \null || key == \null || out_bool == \null;
+    assumes out_path == \null || text == \null || steps == \null;
     assigns \nothing;
     ensures \result == OKJ_ERROR_BAD_POINTER;
 
   behavior valid_args:
-    assumes parser != \null && key != \null && out_bool != \null;
-    assigns *out_bool;
-    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_BOOLEAN;
+    assumes out_path != \null && text != \null && steps != \null;
+    assigns *out_path, steps[0 .. max_steps - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_SYNTAX ||
+            \result == OKJ_ERROR_NO_FREE_SPACE;
+    ensures \result == OKJ_SUCCESS ==>
+            out_path->n_steps <= max_steps && out_path->n_steps <= OKJ_PATH_MAX_STEPS;
 
   complete behaviors;
   disjoint behaviors;
 */
-OkjError okj_get_boolean(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonBoolean *out_bool)
+OkjError okj_path_compile(OkjPath *out_path, const char *text, uint16_t text_len,
+                          OkjPathStep *steps, uint16_t max_steps)
 {
     OkjError result = OKJ_SUCCESS;
 
-    if ((parser == NULL) || (key == NULL) || (out_bool == NULL))
+    if ((out_path == NULL) || (text == NULL) || (steps == NULL))
     {
         result = OKJ_ERROR_BAD_POINTER;
     }
+    else if ((text_len == 0U) || (text[0] != '$'))
+    {
+        result = OKJ_ERROR_SYNTAX;
+    }
     else
     {
-        uint16_t idx = okj_find_value_index(parser, key, key_len);
+        /* Each pass compiles one step: ".name", ".*", a bracketed step, or
+         * any of those after "..". */
+        uint16_t pos = 1U;
+        uint16_t n   = 0U;
 
-        if ((idx == OKJ_MAX_TOKENS) || (parser->tokens[idx].type != OKJ_BOOLEAN))
+        /*@
+          loop invariant 1 <= pos <= text_len;
+          loop invariant 0 <= n <= max_steps;
+          loop assigns pos, n, result, steps[0 .. max_steps - 1];
+          loop variant text_len - pos;
+        */
+        while ((result == OKJ_SUCCESS) && (pos < text_len))
         {
-            result = OKJ_ERROR_BAD_BOOLEAN;
+            OkjPathStep step;
+            uint8_t     dotted = 0U;
+
+            okj_key_fill(&step.key, text, 0U);
+            step.literal      = NULL;
+            step.literal_len  = 0U;
+            step.literal_type = OKJ_UNDEFINED;
+            step.index        = 0U;
+            step.kind         = OKJ_PATH_WILDCARD;
+            step.op           = OKJ_PATH_EXISTS;
+            step.recursive    = 0U;
+
+            if ((text[pos] == '.') && ((uint16_t)(pos + 1U) < text_len) &&
+                (text[pos + 1U] == '.'))
+            {
+                step.recursive = 1U;
+                pos = (uint16_t)(pos + 2U);
+
+                if ((pos >= text_len) || (text[pos] != '['))
+                {
+                    dotted = 1U;
+                }
+            }
+            else if (text[pos] == '.')
+            {
+                pos++;
+                dotted = 1U;
+            }
+            else
+            {
+                /* Bracketed step. */
+            }
+
+            if (dotted != 0U)
+            {
+                uint16_t end = okj_path_name_end(text, text_len, pos);
+
+                if (end == pos)
+                {
+                    result = OKJ_ERROR_SYNTAX;
+                }
+                else if (((end - pos) == 1U) && (text[pos] == '*'))
+                {
+                    step.kind = OKJ_PATH_WILDCARD;
+                }
+                else
+                {
+                    step.kind = OKJ_PATH_CHILD;
+                    okj_key_fill(&step.key, &text[pos], (uint16_t)(end - pos));
+                }
+
+                pos = end;
+            }
+            else if ((pos < text_len) && (text[pos] == '['))
+            {
+                result = okj_path_bracket(&step, text, text_len, &pos);
+            }
+            else
+            {
+                result = OKJ_ERROR_SYNTAX;
+            }
+
+            if (result != OKJ_SUCCESS)
+            {
+                /* Malformed step. */
+            }
+            else if ((n >= max_steps) || (n >= OKJ_PATH_MAX_STEPS))
+            {
+                result = OKJ_ERROR_NO_FREE_SPACE;
+            }
+            else
+            {
+                steps[n] = step;
+                n++;
+            }
         }
-        else
+
+        if (result == OKJ_SUCCESS)
         {
-            out_bool->start  = parser->tokens[idx].start;
-            out_bool->length = parser->tokens[idx].length;
+            out_path->steps   = steps;
+            out_path->n_steps = n;
         }
     }
 
@@ -1979,78 +7872,217 @@ OkjError okj_get_boolean(OkJsonParser *parser, const char *key, uint16_t key_len
 }
 
 /*@
-  // 1. Preconditions
-  requires parser == \null || \valid_read(parser);
-  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
-  requires out_arr == \null || \valid(out_arr);
-  requires \separated(out_arr, parser, key + (0 .. key_len - 1));
+  requires \valid_read(path) && \valid_read(path->steps + (0 .. path->n_steps - 1));
+  assigns \nothing;
+  ensures \result == 0 || \result == 1;
+*/
+static uint8_t okj_path_positional(const OkjPath *path)
+{
+    /* 1 if any step of `path` picks an array element by position. */
+    uint8_t  result = 0U;
+    uint16_t s;
 
-  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
-  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
+    /*@
+      loop invariant 0 <= s <= path->n_steps;
+      loop assigns s, result;
+      loop variant path->n_steps - s;
+    */
+    for (s = 0U; s < path->n_steps; s++)
+    {
+        if (path->steps[s].kind == OKJ_PATH_INDEX)
+        {
+            result = 1U;
+        }
+    }
 
-  // The valid_read requirement needed by okj_find_value_index
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+    return result;
+}
 
-  // The base_addr requirement needed by the container helpers
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \base_addr(parser->tokens[k].start) == \base_addr(parser->json) &&
-        parser->tokens[k].start >= parser->json &&
-        parser->tokens[k].start < parser->json + parser->json_len);
+/*@
+  requires parser == \null || \valid_read(parser);
+  requires path == \null || \valid_read(path);
+  requires out == \null || \valid(out + (0 .. capacity - 1));
+  requires out_count == \null || \valid(out_count);
+  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
+  requires parser != \null && parser->hash != \null ==> \valid(parser->hash);
 
-  // 2. Behaviors
   behavior invalid_args:
-    assumes parser == \null || key == \null || out_arr == \null;
+    assumes parser == \null || path == \null || out == \null || out_count == \null;
     assigns \nothing;
     ensures \result == OKJ_ERROR_BAD_POINTER;
 
   behavior valid_args:
-    assumes parser != \null && key != \null && out_arr != \null;
-    assigns *out_arr;
-    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_ARRAY;
+    assumes parser != \null && path != \null && out != \null && out_count != \null;
+    assigns *out_count, out[0 .. capacity - 1], *parser->hash,
+            parser->hash->slots[0 .. parser->hash->capacity - 1];
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER ||
+            \result == OKJ_ERROR_BAD_OBJECT || \result == OKJ_ERROR_NO_FREE_SPACE ||
+            \result == OKJ_ERROR_MAX_DEPTH_EXCEEDED || \result == OKJ_ERROR_SYNTAX;
+    ensures \result == OKJ_SUCCESS ==> *out_count <= capacity;
 
   complete behaviors;
   disjoint behaviors;
 */
-OkjError okj_get_array(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonArray *out_arr)
+OkjError okj_path_eval(const OkJsonParser *parser, const OkjPath *path,
+                       OkjSize *out, OkjSize capacity, OkjSize *out_count)
 {
     OkjError result = OKJ_SUCCESS;
 
-    if ((parser == NULL) || (key == NULL) || (out_arr == NULL))
+    if ((parser == NULL) || (path == NULL) || (out == NULL) || (out_count == NULL) ||
+        (parser->token_count == 0U) || (path->n_steps > OKJ_PATH_MAX_STEPS))
     {
         result = OKJ_ERROR_BAD_POINTER;
     }
+    else if (((okj_tok_type(parser, 0U) == OKJ_OBJECT) || (okj_tok_type(parser, 0U) == OKJ_ARRAY)) &&
+             (okj_tok_end(parser, 0U) == 0U))
+    {
+        result = OKJ_ERROR_BAD_OBJECT;
+    }
+    else if ((parser->select != NULL) && (okj_path_positional(path) == 1U))
+    {
+        /* A pruned array keeps only its selected elements, renumbered from
+         * 0, so an [n] step would count the wrong ones. */
+        result = OKJ_ERROR_SYNTAX;
+    }
     else
     {
-        uint16_t idx = okj_find_value_index(parser, key, key_len);
+        /* A state is a step number s: the node's ancestors matched steps
+         * 0 .. s-1, and its children are candidates for step s.  Every open
+         * container on the walk keeps its set of live states as a bit mask;
+         * bit n_steps marks a completed match.  A recursive step stays live
+         * below the node it was live at. */
+        OkjSize  frame_tok[OKJ_MAX_DEPTH];
+        OkjSize  frame_elem[OKJ_MAX_DEPTH];
+        okj_u32 frame_live[OKJ_MAX_DEPTH];
+        okj_u32 done  = (okj_u32)1U << path->n_steps;
+        uint16_t depth = 0U;
+        OkjSize  found = 0U;
+        OkjSize  i     = 1U;
 
-        if ((idx == OKJ_MAX_TOKENS)                  ||
-            (idx >= parser->token_count)             ||
-            (parser->tokens[idx].type != OKJ_ARRAY)  ||
-            (parser->tokens[idx].start == NULL))
+        if (path->n_steps == 0U)
         {
-            result = OKJ_ERROR_BAD_ARRAY;
+            if (capacity > 0U)
+            {
+                out[0] = 0U;
+            }
+            found = 1U;
+        }
+        else if (okj_tok_end(parser, 0U) > 0U)
+        {
+            frame_tok[0]  = 0U;
+            frame_elem[0] = 0U;
+            frame_live[0] = 1U;
+            depth = 1U;
         }
         else
         {
-            const char *end = parser->json + parser->json_len;
+            /* A primitive document has no children to match. */
+        }
 
-            /* Explicitly instantiate the \forall quantifier for this specific index */
-            /*@ assert \base_addr(parser->tokens[idx].start) == \base_addr(parser->json); */
-            /*@ assert parser->tokens[idx].start >= parser->json; */
-            /*@ assert parser->tokens[idx].start < end; */
+        /*@
+          loop invariant 0 <= depth <= OKJ_MAX_DEPTH;
+          loop assigns depth, i, found, result, frame_tok[0 .. OKJ_MAX_DEPTH - 1],
+                       frame_elem[0 .. OKJ_MAX_DEPTH - 1], frame_live[0 .. OKJ_MAX_DEPTH - 1],
+                       out[0 .. capacity - 1], *parser->hash,
+                       parser->hash->slots[0 .. parser->hash->capacity - 1];
+        */
+        while ((result == OKJ_SUCCESS) && (depth > 0U))
+        {
+            uint16_t top = (uint16_t)(depth - 1U);
+
+            if (i >= okj_tok_end(parser, frame_tok[top]))
+            {
+                depth = top;
+            }
+            else
+            {
+                uint8_t    is_member = (okj_tok_type(parser, frame_tok[top]) == OKJ_OBJECT) ? 1U : 0U;
+                OkjSize    child     = (is_member != 0U) ? (OkjSize)(i + 1U) : i;
+                OkjSize    elem      = frame_elem[top];
+                okj_u32    live      = frame_live[top];
+                okj_u32    filters   = 0U;
+                okj_u32    next;
+                OkJsonType type      = okj_tok_type(parser, child);
+                uint16_t   s;
 
-            out_arr->start  = parser->tokens[idx].start;
-            out_arr->count  = okj_count_array_elements(parser->tokens[idx].start, end);
-            out_arr->length = okj_measure_container(parser->tokens[idx].start, end);
+                frame_elem[top] = (OkjSize)(elem + 1U);
 
-            if (out_arr->count > OKJ_MAX_ARRAY_SIZE)
+                /*@
+                  loop invariant 0 <= s <= path->n_steps;
+                  loop assigns s, filters, *parser->hash,
+                               parser->hash->slots[0 .. parser->hash->capacity - 1];
+                  loop variant path->n_steps - s;
+                */
+                for (s = 0U; s < path->n_steps; s++)
+                {
+                    if (((live & ((okj_u32)1U << s)) != 0U) &&
+                        (path->steps[s].kind == OKJ_PATH_FILTER) &&
+                        (okj_path_filter(parser, &path->steps[s], child) == 1U))
+                    {
+                        filters |= (okj_u32)1U << s;
+                    }
+                }
+
+                if (is_member != 0U)
+                {
+                    OkjKey member;
+
+                    member.bytes  = okj_tok_start(parser, i);
+                    member.length = (uint16_t)okj_tok_length(parser, i);
+                    member.prefix = okj_key_prefix(member.bytes, member.length);
+                    member.hash   = 0U;
+                    next = okj_path_next(path, live, &member, elem, filters);
+                }
+                else
+                {
+                    next = okj_path_next(path, live, NULL, elem, filters);
+                }
+
+                if ((next & done) != 0U)
+                {
+                    if (found < capacity)
+                    {
+                        out[found] = child;
+                    }
+                    found++;
+                    next &= ~done;
+                }
+
+                if (((type == OKJ_OBJECT) || (type == OKJ_ARRAY)) &&
+                    (okj_tok_end(parser, child) > child))
+                {
+                    if (next == 0U)
+                    {
+                        /* No step can match inside: skip the subtree. */
+                        i = okj_tok_end(parser, child);
+                    }
+                    else if (depth >= OKJ_MAX_DEPTH)
+                    {
+                        result = OKJ_ERROR_MAX_DEPTH_EXCEEDED;
+                    }
+                    else
+                    {
+                        frame_tok[depth]  = child;
+                        frame_elem[depth] = 0U;
+                        frame_live[depth] = next;
+                        depth++;
+                        i = (OkjSize)(child + 1U);
+                    }
+                }
+                else
+                {
+                    i = (OkjSize)(child + 1U);
+                }
+            }
+        }
+
+        if (result == OKJ_SUCCESS)
+        {
+            *out_count = found;
+
+            if (found > capacity)
             {
-                result = OKJ_ERROR_BAD_ARRAY;
+                result = OKJ_ERROR_NO_FREE_SPACE;
             }
         }
     }
@@ -2059,207 +8091,309 @@ OkjError okj_get_array(OkJsonParser *parser, const char *key, uint16_t key_len,
 }
 
 /*@
-  // 1. Preconditions
-  requires parser == \null || \valid_read(parser);
-  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
-  requires out_obj == \null || \valid(out_obj);
-  
-  requires \separated(out_obj, parser, key + (0 .. key_len - 1));
-
-  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
-  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
-
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
-
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \base_addr(parser->tokens[k].start) == \base_addr(parser->json) &&
-        parser->tokens[k].start >= parser->json &&
-        parser->tokens[k].start < parser->json + parser->json_len);
+  requires parser == \null || \valid(parser);
+  requires sel == \null || \valid(sel);
+  requires paths != \null ==> \valid_read(paths + (0 .. n_paths - 1));
 
-  // 2. Behaviors
   behavior invalid_args:
-    assumes parser == \null || key == \null || out_obj == \null;
+    assumes parser == \null || sel == \null || paths == \null || n_paths == 0;
     assigns \nothing;
     ensures \result == OKJ_ERROR_BAD_POINTER;
 
   behavior valid_args:
-    assumes parser != \null && key != \null && out_obj != \null;
-    assigns *out_obj;
-    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT;
+    assumes parser != \null && sel != \null && paths != \null && n_paths > 0;
+    assigns *sel, parser->select;
+    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_SYNTAX ||
+            \result == OKJ_ERROR_NO_FREE_SPACE;
+    ensures \result == OKJ_SUCCESS ==> parser->select == sel;
 
   complete behaviors;
   disjoint behaviors;
 */
-OkjError okj_get_object(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonObject *out_obj)
+OkjError okj_select_attach(OkJsonParser *parser, OkjSelect *sel,
+                           const OkjPath *paths, uint8_t n_paths)
 {
     OkjError result = OKJ_SUCCESS;
 
-    if ((parser == NULL) || (key == NULL) || (out_obj == NULL))
+    if ((parser == NULL) || (sel == NULL) || (paths == NULL) || (n_paths == 0U))
     {
         result = OKJ_ERROR_BAD_POINTER;
     }
     else
     {
-        uint16_t idx = okj_find_value_index(parser, key, key_len);
+        /* Query p owns bits off .. off + n_steps of one combined state set:
+         * bit off is its start, the top one its completed match.  Bit 31 is
+         * left for OKJ_SELECT_ALL. */
+        okj_u32 start = 0U;
+        okj_u32 done  = 0U;
+        okj_u32 off   = 0U;
+        uint8_t  p;
 
-        if ((idx == OKJ_MAX_TOKENS) || 
-            (idx >= parser->token_count) ||
-            (parser->tokens[idx].type != OKJ_OBJECT) ||
-            (parser->tokens[idx].start == NULL))
-        {
-            result = OKJ_ERROR_BAD_OBJECT;
-        }
-        else
+        /*@
+          loop invariant 0 <= p <= n_paths;
+          loop assigns p, off, start, done, result;
+          loop variant n_paths - p;
+        */
+        for (p = 0U; (result == OKJ_SUCCESS) && (p < n_paths); p++)
         {
-            const char *end = parser->json + parser->json_len;
-
-            /*@ assert \base_addr(parser->tokens[idx].start) == \base_addr(parser->json); */
-            /*@ assert parser->tokens[idx].start >= parser->json; */
-            /*@ assert parser->tokens[idx].start < end; */
+            uint16_t s;
 
-            out_obj->start  = parser->tokens[idx].start;
-            out_obj->count  = okj_count_object_members(parser->tokens[idx].start, end);
-            out_obj->length = okj_measure_container(parser->tokens[idx].start, end);
-
-            if (out_obj->count > OKJ_MAX_OBJECT_SIZE)
+            if ((off + (okj_u32)paths[p].n_steps) >= 31U)
             {
-                result = OKJ_ERROR_BAD_OBJECT;
+                result = OKJ_ERROR_NO_FREE_SPACE;
+            }
+            else
+            {
+                /*@
+                  loop invariant 0 <= s <= paths[p].n_steps;
+                  loop assigns s, result;
+                  loop variant paths[p].n_steps - s;
+                */
+                for (s = 0U; s < paths[p].n_steps; s++)
+                {
+                    if (paths[p].steps[s].kind == OKJ_PATH_FILTER)
+                    {
+                        result = OKJ_ERROR_SYNTAX;
+                    }
+                }
+
+                start |= (okj_u32)1U << off;
+                done  |= (okj_u32)1U << (off + (okj_u32)paths[p].n_steps);
+                off   += (okj_u32)paths[p].n_steps + 1U;
             }
         }
+
+        if (result == OKJ_SUCCESS)
+        {
+            sel->paths      = paths;
+            sel->n_paths    = n_paths;
+            sel->start      = start;
+            sel->done       = done;
+            sel->key_start  = 0U;
+            sel->key_len    = 0U;
+            parser->select  = sel;
+        }
     }
 
     return result;
 }
 
 /*@
-  // 1. Preconditions
-  // Pointers can be null (we handle that gracefully), but if they aren't, 
-  // they must be valid for reading/writing.
-  requires parser == \null || \valid_read(parser);
-  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
-  requires out_tok == \null || \valid(out_tok);
-
-  // Inherit the token validity requirements so okj_find_value_index is satisfied
-  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+  requires doc == \null || \valid(doc);
 
-  // 2. Behaviors
-  behavior invalid_args:
-    assumes parser == \null || key == \null || out_tok == \null;
+  behavior null_ptrs:
+    assumes doc == \null || json == \null;
     assigns \nothing;
     ensures \result == OKJ_ERROR_BAD_POINTER;
 
+  behavior too_long:
+    assumes doc != \null && json != \null && json_len > OKJ_MAX_JSON_LEN;
+    assigns \nothing;
+    ensures \result == OKJ_ERROR_MAX_JSON_LEN_EXCEEDED;
+
   behavior valid_args:
-    assumes parser != \null && key != \null && out_tok != \null;
-    // We are only allowed to modify the output struct
-    assigns *out_tok;
-    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_POINTER;
+    assumes doc != \null && json != \null && json_len <= OKJ_MAX_JSON_LEN;
+    assigns *doc;
+    ensures \result == OKJ_SUCCESS;
+    ensures doc->json == json && doc->json_len == json_len;
 
   complete behaviors;
   disjoint behaviors;
 */
-OkjError okj_get_token(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonToken *out_tok)
+OkjError okj_doc_init(OkjDoc *doc, char *json, OkjSize json_len)
 {
     OkjError result = OKJ_SUCCESS;
 
-    if ((parser == NULL) || (key == NULL) || (out_tok == NULL))
+    if ((doc == NULL) || (json == NULL))
     {
         result = OKJ_ERROR_BAD_POINTER;
     }
+    else if (json_len > OKJ_MAX_JSON_LEN)
+    {
+        result = OKJ_ERROR_MAX_JSON_LEN_EXCEEDED;
+    }
     else
     {
-        uint16_t idx = okj_find_value_index(parser, key, key_len);
-
-        if (idx == OKJ_MAX_TOKENS)
-        {
-            result = OKJ_ERROR_BAD_POINTER;
-        }
-        else
-        {
-            out_tok->type   = parser->tokens[idx].type;
-            out_tok->start  = parser->tokens[idx].start;
-            out_tok->length = parser->tokens[idx].length;
-        }
+        doc->json     = json;
+        doc->json_len = json_len;
     }
 
     return result;
 }
 
 /*@
-  // 1. Preconditions
-  requires parser == \null || \valid_read(parser);
-  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
-  requires out_arr == \null || \valid(out_arr);
-  
-  requires \separated(out_arr, parser, key + (0 .. key_len - 1));
-
-  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
-  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
-
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+  requires doc == \null || (\valid_read(doc) &&
+                            \valid_read(doc->json + (0 .. doc->json_len - 1)));
+  requires out_tok == \null || \valid(out_tok);
+  assigns *out_tok;
+*/
+OkjError okj_doc_root(const OkjDoc *doc, OkJsonToken *out_tok)
+{
+    OkjError result = OKJ_SUCCESS;
 
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \base_addr(parser->tokens[k].start) == \base_addr(parser->json) &&
-        parser->tokens[k].start >= parser->json &&
-        parser->tokens[k].start < parser->json + parser->json_len);
+    if ((doc == NULL) || (doc->json == NULL) || (out_tok == NULL))
+    {
+        result = OKJ_ERROR_BAD_POINTER;
+    }
+    else
+    {
+        OkjSize pos = okj_space_end(doc->json, doc->json_len, 0U);
 
-  // 2. Behaviors
-  behavior invalid_args:
-    assumes parser == \null || key == \null || out_arr == \null;
-    assigns \nothing;
-    ensures \result == OKJ_ERROR_BAD_POINTER;
+        result = okj_doc_value(doc, &pos, out_tok);
+    }
 
-  behavior valid_args:
-    assumes parser != \null && key != \null && out_arr != \null;
-    assigns *out_arr;
-    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_ARRAY;
+    return result;
+}
 
-  complete behaviors;
-  disjoint behaviors;
+/*@
+  requires doc == \null || (\valid_read(doc) &&
+                            \valid_read(doc->json + (0 .. doc->json_len - 1)));
+  requires container == \null || \valid_read(container);
+  requires out_it == \null || \valid(out_it);
+  assigns *out_it;
 */
-OkjError okj_get_array_raw(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonArray *out_arr)
+OkjError okj_doc_iter(const OkjDoc *doc, const OkJsonToken *container, OkjDocIter *out_it)
 {
     OkjError result = OKJ_SUCCESS;
 
-    if ((parser == NULL) || (key == NULL) || (out_arr == NULL))
+    if ((doc == NULL) || (doc->json == NULL) || (container == NULL) || (out_it == NULL))
     {
         result = OKJ_ERROR_BAD_POINTER;
     }
+    else if (((container->type != OKJ_OBJECT) && (container->type != OKJ_ARRAY)) ||
+             (container->start < doc->json) ||
+             (container->start >= &doc->json[doc->json_len]))
+    {
+        result = OKJ_ERROR_BAD_OBJECT;
+    }
+    else if (*container->start != ((container->type == OKJ_OBJECT) ? '{' : '['))
+    {
+        result = OKJ_ERROR_BAD_OBJECT;
+    }
     else
     {
-        uint16_t idx = okj_find_value_index(parser, key, key_len);
+        out_it->doc    = doc;
+        out_it->pos    = (OkjSize)((container->start - doc->json) + 1);
+        out_it->type   = container->type;
+        out_it->state  = OKJ_DOC_FIRST;
+        out_it->status = OKJ_SUCCESS;
+    }
 
-        if ((idx == OKJ_MAX_TOKENS) || 
-            (idx >= parser->token_count) ||
-            (parser->tokens[idx].type != OKJ_ARRAY) ||
-            (parser->tokens[idx].start == NULL))
+    return result;
+}
+
+/*@
+  requires it == \null || (\valid(it) && \valid_read(it->doc) &&
+                           \valid_read(it->doc->json + (0 .. it->doc->json_len - 1)));
+  requires key_tok == \null || \valid(key_tok);
+  requires val_tok == \null || \valid(val_tok);
+  assigns *it, *key_tok, *val_tok;
+  ensures \result == 0 || \result == 1;
+*/
+uint8_t okj_doc_next(OkjDocIter *it, OkJsonToken *key_tok, OkJsonToken *val_tok)
+{
+    uint8_t produced = 0U;
+
+    if ((it != NULL) && (it->state != OKJ_DOC_DONE))
+    {
+        OkjSize     key_start = 0U;
+        OkjSize     key_len   = 0U;
+        OkJsonToken value;
+
+        if ((okj_doc_advance(it, &key_start, &key_len) == 1U) &&
+            (okj_doc_take(it, &value) == OKJ_SUCCESS))
         {
-            result = OKJ_ERROR_BAD_ARRAY;
+            produced = 1U;
+
+            if (key_tok != NULL)
+            {
+                if (it->type == OKJ_OBJECT)
+                {
+                    key_tok->type   = OKJ_STRING;
+                    key_tok->start  = &it->doc->json[key_start];
+                    key_tok->length = key_len;
+                }
+                else
+                {
+                    key_tok->type   = OKJ_UNDEFINED;
+                    key_tok->start  = NULL;
+                    key_tok->length = 0U;
+                }
+
+                key_tok->end   = 0U;
+                key_tok->count = 0U;
+            }
+
+            if (val_tok != NULL)
+            {
+                *val_tok = value;
+            }
         }
-        else
+    }
+
+    return produced;
+}
+
+/*@
+  requires it == \null || (\valid(it) && \valid_read(it->doc) &&
+                           \valid_read(it->doc->json + (0 .. it->doc->json_len - 1)));
+  requires key == \null || \valid_read(key + (0 .. key_len - 1));
+  requires out_tok == \null || \valid(out_tok);
+  assigns *it, *out_tok;
+*/
+OkjError okj_doc_find(OkjDocIter *it, const char *key, uint16_t key_len, OkJsonToken *out_tok)
+{
+    OkjError result = OKJ_ERROR_BAD_POINTER;
+
+    if ((it == NULL) || (key == NULL) || (out_tok == NULL))
+    {
+        /* result stays OKJ_ERROR_BAD_POINTER */
+    }
+    else if (it->type != OKJ_OBJECT)
+    {
+        result = OKJ_ERROR_BAD_OBJECT;
+    }
+    else
+    {
+        uint8_t searching = 1U;
+
+        /*@
+          loop assigns searching, result, *it, *out_tok;
+        */
+        while ((searching == 1U) && (it->state != OKJ_DOC_DONE))
         {
-            const char *end = parser->json + parser->json_len;
+            OkjSize key_start = 0U;
+            OkjSize len       = 0U;
 
-            /*@ assert \base_addr(parser->tokens[idx].start) == \base_addr(parser->json); */
-            /*@ assert parser->tokens[idx].start >= parser->json; */
-            /*@ assert parser->tokens[idx].start < end; */
+            if (okj_doc_advance(it, &key_start, &len) == 0U)
+            {
+                searching = 0U;
+            }
+            else if ((len == (OkjSize)key_len) &&
+                     (okj_match(&it->doc->json[key_start], key, key_len) == 1U))
+            {
+                result    = okj_doc_take(it, out_tok);
+                searching = 0U;
+            }
+            else
+            {
+                OkjError skip = okj_doc_skip(it->doc, &it->pos);
+
+                if (skip == OKJ_SUCCESS)
+                {
+                    it->state = OKJ_DOC_AFTER;
+                }
+                else
+                {
+                    it->status = skip;
+                    it->state  = OKJ_DOC_DONE;
+                }
+            }
+        }
 
-            out_arr->start  = parser->tokens[idx].start;
-            out_arr->count  = okj_count_array_elements(parser->tokens[idx].start, end);
-            out_arr->length = okj_measure_container(parser->tokens[idx].start, end);
+        if ((result == OKJ_ERROR_BAD_POINTER) && (it->status != OKJ_SUCCESS))
+        {
+            result = it->status;
         }
     }
 
@@ -2267,72 +8401,108 @@ OkjError okj_get_array_raw(OkJsonParser *parser, const char *key, uint16_t key_l
 }
 
 /*@
-  // 1. Preconditions
-  requires parser == \null || \valid_read(parser);
-  requires key != \null ==> \valid_read(key + (0 .. key_len - 1));
-  requires out_obj == \null || \valid(out_obj);
-  
-  requires \separated(out_obj, parser, key + (0 .. key_len - 1));
-
-  requires parser != \null ==> parser->token_count <= OKJ_MAX_TOKENS;
-  requires parser != \null ==> \valid_read(parser->json + (0 .. parser->json_len - 1));
-
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \valid_read(parser->tokens[k].start + (0 .. parser->tokens[k].length - 1)));
+  requires doc == \null || (\valid_read(doc) &&
+                            \valid_read(doc->json + (0 .. doc->json_len - 1)));
+  requires object == \null || \valid_read(object);
+  requires key == \null || \valid_read(key + (0 .. key_len - 1));
+  requires out_tok == \null || \valid(out_tok);
+  assigns *out_tok;
+*/
+OkjError okj_doc_field(const OkjDoc *doc, const OkJsonToken *object,
+                       const char *key, uint16_t key_len, OkJsonToken *out_tok)
+{
+    OkjError   result = OKJ_SUCCESS;
+    OkjDocIter it;
 
-  requires parser != \null ==> 
-    (\forall integer k; 0 <= k < parser->token_count ==> 
-      parser->tokens[k].start != \null ==> 
-        \base_addr(parser->tokens[k].start) == \base_addr(parser->json) &&
-        parser->tokens[k].start >= parser->json &&
-        parser->tokens[k].start < parser->json + parser->json_len);
+    if ((object != NULL) && (object->type != OKJ_OBJECT))
+    {
+        result = OKJ_ERROR_BAD_OBJECT;
+    }
+    else
+    {
+        result = okj_doc_iter(doc, object, &it);
+    }
 
-  // 2. Behaviors
-  behavior invalid_args:
-    assumes parser == \null || key == \null || out_obj == \null;
-    assigns \nothing;
-    ensures \result == OKJ_ERROR_BAD_POINTER;
+    if (result == OKJ_SUCCESS)
+    {
+        result = okj_doc_find(&it, key, key_len, out_tok);
+    }
 
-  behavior valid_args:
-    assumes parser != \null && key != \null && out_obj != \null;
-    assigns *out_obj;
-    ensures \result == OKJ_SUCCESS || \result == OKJ_ERROR_BAD_OBJECT;
+    return result;
+}
 
-  complete behaviors;
-  disjoint behaviors;
+/*@
+  requires doc == \null || (\valid_read(doc) &&
+                            \valid_read(doc->json + (0 .. doc->json_len - 1)));
+  requires array == \null || \valid_read(array);
+  requires out_tok == \null || \valid(out_tok);
+  assigns *out_tok;
 */
-OkjError okj_get_object_raw(OkJsonParser *parser, const char *key, uint16_t key_len, OkJsonObject *out_obj)
+OkjError okj_doc_at(const OkjDoc *doc, const OkJsonToken *array, OkjSize n, OkJsonToken *out_tok)
 {
-    OkjError result = OKJ_SUCCESS;
+    OkjError   result = OKJ_SUCCESS;
+    OkjDocIter it;
 
-    if ((parser == NULL) || (key == NULL) || (out_obj == NULL))
+    if (out_tok == NULL)
     {
         result = OKJ_ERROR_BAD_POINTER;
     }
+    else if ((array != NULL) && (array->type != OKJ_ARRAY))
+    {
+        result = OKJ_ERROR_BAD_ARRAY;
+    }
     else
     {
-        uint16_t idx = okj_find_value_index(parser, key, key_len);
+        result = okj_doc_iter(doc, array, &it);
 
-        if ((idx == OKJ_MAX_TOKENS) || 
-            (idx >= parser->token_count) ||
-            (parser->tokens[idx].type != OKJ_OBJECT) ||
-            (parser->tokens[idx].start == NULL))
+        if (result == OKJ_ERROR_BAD_OBJECT)
         {
-            result = OKJ_ERROR_BAD_OBJECT;
+            result = OKJ_ERROR_BAD_ARRAY;
         }
-        else
+    }
+
+    if (result == OKJ_SUCCESS)
+    {
+        OkjSize i      = 0U;
+        OkjSize unused = 0U;
+        uint8_t found  = okj_doc_advance(&it, &unused, &unused);
+
+        /* Elements before n are stepped over unchecked. */
+
+        /*@
+          loop invariant 0 <= i <= n;
+          loop assigns i, found, it;
+          loop variant n - i;
+        */
+        while ((found == 1U) && (i < n))
         {
-            const char *end = parser->json + parser->json_len;
+            OkjError skip = okj_doc_skip(doc, &it.pos);
 
-            /*@ assert \base_addr(parser->tokens[idx].start) == \base_addr(parser->json); */
-            /*@ assert parser->tokens[idx].start >= parser->json; */
-            /*@ assert parser->tokens[idx].start < end; */
+            if (skip == OKJ_SUCCESS)
+            {
+                it.state = OKJ_DOC_AFTER;
+                found    = okj_doc_advance(&it, &unused, &unused);
+            }
+            else
+            {
+                it.status = skip;
+                found     = 0U;
+            }
+
+            i++;
+        }
 
-            out_obj->start  = parser->tokens[idx].start;
-            out_obj->count  = okj_count_object_members(parser->tokens[idx].start, end);
-            out_obj->length = okj_measure_container(parser->tokens[idx].start, end);
+        if (found == 1U)
+        {
+            result = okj_doc_take(&it, out_tok);
+        }
+        else if (it.status != OKJ_SUCCESS)
+        {
+            result = it.status;
+        }
+        else
+        {
+            result = OKJ_ERROR_BAD_POINTER;   /* fewer than n + 1 elements */
         }
     }
 
@@ -2377,12 +8547,14 @@ uint16_t okj_copy_string(const OkJsonString *str, char *buf, uint16_t buf_size)
     if ((str != NULL) && (buf != NULL) && (buf_size != 0U))
     {
         /* Copy at most (buf_size - 1) bytes to leave room for the null terminator. */
-        copy_len = str->length;
-
-        if (copy_len >= buf_size)
+        if (str->length >= buf_size)
         {
             copy_len = (uint16_t)(buf_size - 1U);
         }
+        else
+        {
+            copy_len = (uint16_t)str->length;
+        }
 
         uint16_t i;
 
@@ -2428,13 +8600,13 @@ uint16_t okj_copy_string(const OkJsonString *str, char *buf, uint16_t buf_size)
   complete behaviors;
   disjoint behaviors;
 */
-uint16_t okj_count_objects(const OkJsonParser *parser)
+OkjSize okj_count_objects(const OkJsonParser *parser)
 {
-    uint16_t count = 0U;
+    OkjSize count = 0U;
 
     if (parser != NULL)
     {
-        uint16_t i;
+        OkjSize i;
 
         /*@
           loop invariant 0 <= i <= parser->token_count;
@@ -2447,7 +8619,7 @@ uint16_t okj_count_objects(const OkJsonParser *parser)
         */
         for (i = 0U; i < parser->token_count; i++)
         {
-            if (parser->tokens[i].type == OKJ_OBJECT)
+            if (okj_tok_type(parser, i) == OKJ_OBJECT)
             {
                 count++;
             }
@@ -2477,13 +8649,13 @@ uint16_t okj_count_objects(const OkJsonParser *parser)
   complete behaviors;
   disjoint behaviors;
 */
-uint16_t okj_count_arrays(const OkJsonParser *parser)
+OkjSize okj_count_arrays(const OkJsonParser *parser)
 {
-    uint16_t count = 0U;
+    OkjSize count = 0U;
 
     if (parser != NULL)
     {
-        uint16_t i;
+        OkjSize i;
 
         /*@
           loop invariant 0 <= i <= parser->token_count;
@@ -2494,7 +8666,7 @@ uint16_t okj_count_arrays(const OkJsonParser *parser)
         */
         for (i = 0U; i < parser->token_count; i++)
         {
-            if (parser->tokens[i].type == OKJ_ARRAY)
+            if (okj_tok_type(parser, i) == OKJ_ARRAY)
             {
                 count++;
             }
@@ -2523,9 +8695,9 @@ uint16_t okj_count_arrays(const OkJsonParser *parser)
   complete behaviors;
   disjoint behaviors;
 */
-uint16_t okj_count_elements(const OkJsonParser *parser)
+OkjSize okj_count_elements(const OkJsonParser *parser)
 {
-    uint16_t result = 0U;
+    OkjSize result = 0U;
 
     if (parser != NULL)
     {
@@ -2587,38 +8759,39 @@ void okj_debug_print(OkJsonParser *parser)
         (void)printf("=== OK_JSON Debug Dump: %u token(s) ===\n",
                     (unsigned int)parser->token_count);
 
-        uint16_t i;
+        OkjSize i;
 
         for (i = 0U; i < parser->token_count; i++)
         {
-            const OkJsonToken *t = &parser->tokens[i];
+            OkJsonToken t;
 
-            if (t != NULL)
+            if (okj_token_at(parser, i, &t) == OKJ_SUCCESS)
             {
-                uint16_t dlen = t->length;
+                OkjSize dlen = t.length;
 
-                if ((t->type == OKJ_OBJECT) || (t->type == OKJ_ARRAY))
+                if (((t.type == OKJ_OBJECT) || (t.type == OKJ_ARRAY)) && (t.end == 0U))
                 {
-                    dlen = okj_measure_container(t->start, parser->json + parser->json_len);
+                    /* Left open by a failed parse; closed ones already span the brackets. */
+                    dlen = okj_measure_container(t.start, parser->json + parser->json_len);
                 }
 
                 (void)printf("[%3u] type=%-9s len=%3u  val='",
                             (unsigned int)i,
-                            okj_type_name(t->type),
+                            okj_type_name(t.type),
                             (unsigned int)dlen);
 
-                if (t->start != NULL)
+                if (t.start != NULL)
                 {
-                    uint16_t j;
+                    OkjSize j;
 
                     for (j = 0U; j < dlen; j++)
                     {
-                        if (t->start[j] == '\0')
+                        if (t.start[j] == '\0')
                         {
                             break;
                         }
 
-                        (void)putchar((int)(unsigned char)t->start[j]);
+                        (void)putchar((int)(unsigned char)t.start[j]);
                     }
                 }
 
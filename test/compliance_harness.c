@@ -70,7 +70,7 @@ int main(int argc, char *argv[])
 
     /* Run the parser */
     OkJsonParser parser;
-    okj_init(&parser, json_data, (uint16_t)read_len);
+    okj_init(&parser, json_data, (OkjSize)read_len);
     OkjError result = okj_parse(&parser);
 
     free(json_data);
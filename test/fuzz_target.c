@@ -73,7 +73,7 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
 
     OkJsonParser parser;
 
-    okj_init(&parser, input_buf, (uint16_t)size);
+    okj_init(&parser, input_buf, (OkjSize)size);
 
     /* We don't care about the return code (syntax errors are expected with fuzzing),
      * we only care if this function causes a segfault, hang, or ASan violation. */
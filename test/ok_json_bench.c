@@ -0,0 +1,1197 @@
+/**********************************************************************************
+ * This file is part of the OK_JSON project. You can always find the latest
+ * version of this file and project at: https://github.com/ionux/ok_json/
+ *
+ * Copyright (c) 2026 Rich Morgan
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **********************************************************************************/
+
+/* Include the implementation directly (same pattern as the unit tests) so the
+ * static helpers can be timed in isolation against reference versions. */
+#include "../src/ok_json.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Size of the micro-benchmark documents: the default OKJ_MAX_JSON_LEN, kept
+ * fixed so an OK_JSON_LARGE_DOCS build times the same inputs. */
+#define BENCH_DOC_LEN 4096U
+
+/* Results are accumulated here so the optimiser cannot discard the work. */
+static volatile unsigned long bench_sink = 0UL;
+
+static double bench_seconds(clock_t start, clock_t stop)
+{
+    return (double)(stop - start) / (double)CLOCKS_PER_SEC;
+}
+
+static void bench_report(const char *name, unsigned long bytes, double secs)
+{
+    double mbps = 0.0;
+
+    if (secs > 0.0)
+    {
+        mbps = ((double)bytes / (1024.0 * 1024.0)) / secs;
+    }
+
+    printf("  %-34s %8.3f s  %10.1f MB/s\n", name, secs, mbps);
+}
+
+/* --------------------------------------------------------------------------
+ * Whitespace skipping: SWAR okj_skip_whitespace() vs the byte-at-a-time loop
+ * -------------------------------------------------------------------------- */
+
+static void bench_skip_whitespace_bytewise(OkJsonParser *parser)
+{
+    /* The pre-SWAR implementation, kept here as the reference. */
+    while ((parser->position < parser->json_len) &&
+           (okj_is_whitespace(parser->json[parser->position]) == 1U))
+    {
+        parser->position++;
+    }
+}
+
+static void bench_step_over_token(OkJsonParser *parser)
+{
+    /* Advance over the non-whitespace run that follows a whitespace run.
+     * Shared by both variants so only the whitespace skipping differs. */
+    while ((parser->position < parser->json_len) &&
+           (okj_is_whitespace(parser->json[parser->position]) == 0U))
+    {
+        parser->position++;
+    }
+}
+
+static uint16_t bench_build_indented(char *buf, uint16_t cap, uint16_t indent)
+{
+    /* Fill `buf` with a pretty-printed object whose members are indented by
+     * up to `indent` spaces (nesting-style variation from a fixed LCG so runs
+     * are repeatable but not trivially predictable), the shape of typical
+     * config/telemetry payloads.  The member count stays inside the token
+     * budget so okj_parse() completes. */
+    uint16_t len = 0U;
+    uint16_t member = 0U;
+    unsigned long lcg = 12345UL;
+
+    buf[len++] = '{';
+
+    while (((uint16_t)(len + indent + 24U) < cap) &&
+           (member < ((OKJ_MAX_TOKENS - 1U) / 2U)))
+    {
+        int written;
+        uint16_t i;
+        uint16_t run;
+
+        lcg = (lcg * 1103515245UL) + 12345UL;
+        run = (uint16_t)(((lcg >> 16U) % indent) + 1U);
+
+        buf[len++] = '\n';
+
+        for (i = 0U; i < run; i++)
+        {
+            buf[len++] = ' ';
+        }
+
+        written = snprintf(&buf[len], (size_t)(cap - len), "\"k%u\": %u,", (unsigned)member, (unsigned)member);
+        len = (uint16_t)(len + (uint16_t)written);
+        member++;
+    }
+
+    buf[len - 1U] = '\n';   /* replace the trailing comma */
+    buf[len++]    = '}';
+
+    return len;
+}
+
+/* Both variants are called through this pointer so neither can be inlined
+ * into the timing loop and the comparison stays like-for-like. */
+static void (*volatile bench_skip_fn)(OkJsonParser *parser) = NULL;
+
+static double bench_walk(OkJsonParser *parser, unsigned long iterations)
+{
+    /* Walk the whole buffer: skip a whitespace run, step over the token that
+     * follows it, repeat — the access pattern the parser has between
+     * tokens. */
+    unsigned long it;
+    clock_t t0 = clock();
+
+    for (it = 0UL; it < iterations; it++)
+    {
+        parser->position = 0U;
+
+        while (parser->position < parser->json_len)
+        {
+            bench_skip_fn(parser);
+            bench_sink += parser->position;
+            bench_step_over_token(parser);
+        }
+    }
+
+    return bench_seconds(t0, clock());
+}
+
+static void bench_whitespace(unsigned long iterations)
+{
+    static char buf[BENCH_DOC_LEN];
+    static const uint16_t indents[] = { 4U, 16U, 32U, 64U };
+    size_t k;
+
+    printf("okj_skip_whitespace (indented input, %lu passes)\n", iterations);
+
+    for (k = 0U; k < (sizeof(indents) / sizeof(indents[0])); k++)
+    {
+        uint16_t len = bench_build_indented(buf, (uint16_t)sizeof(buf), indents[k]);
+        unsigned long bytes = (unsigned long)len * iterations;
+        unsigned long it;
+        clock_t t0;
+        char label[64];
+        OkJsonParser parser;
+
+        okj_init(&parser, buf, len);
+
+        bench_skip_fn = bench_skip_whitespace_bytewise;
+        (void)snprintf(label, sizeof(label), "byte loop, indent <= %u", (unsigned)indents[k]);
+        bench_report(label, bytes, bench_walk(&parser, iterations));
+
+        bench_skip_fn = okj_skip_whitespace;
+        (void)snprintf(label, sizeof(label), "SWAR,      indent <= %u", (unsigned)indents[k]);
+        bench_report(label, bytes, bench_walk(&parser, iterations));
+
+        /* Full parse of the same document for context. */
+        t0 = clock();
+        for (it = 0UL; it < iterations; it++)
+        {
+            okj_init(&parser, buf, len);
+            bench_sink += (unsigned long)okj_parse(&parser);
+        }
+
+        (void)snprintf(label, sizeof(label), "okj_parse, indent <= %u", (unsigned)indents[k]);
+        bench_report(label, bytes, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * String bodies: okj_scan_string_run() + okj_validate_utf8_block() vs the
+ * code-point-at-a-time loop
+ * -------------------------------------------------------------------------- */
+
+static OkjSize bench_scan_string_codepoints(const char *src, OkjSize pos,
+                                            OkjSize limit, uint8_t *non_ascii)
+{
+    /* The pre-bulk-scan inner loop, kept here as the reference: one
+     * okj_validate_utf8_sequence() call per code point. */
+    uint16_t advance = 0U;
+
+    *non_ascii = 0U;
+
+    while ((pos < limit) && (src[pos] != '"') && (src[pos] != '\\') &&
+           ((uint8_t)src[pos] >= 0x20U) &&
+           (okj_validate_utf8_sequence(src, pos, limit, &advance) == 1U))
+    {
+        if (advance > 1U)
+        {
+            *non_ascii = 1U;
+        }
+
+        pos = (OkjSize)(pos + advance);
+    }
+
+    return pos;
+}
+
+static OkjSize bench_scan_and_validate(const char *src, OkjSize pos,
+                                       OkjSize limit, uint8_t *non_ascii)
+{
+    /* What the parser does now: bulk scan, then validate the run with
+     * okj_validate_utf8_block() only if it contains non-ASCII bytes. */
+    OkjSize end  = okj_scan_string_run(src, pos, limit, non_ascii);
+    OkjSize stop = end;
+
+    if ((*non_ascii != 0U) &&
+        (okj_validate_utf8_block(src, pos, end, limit, &stop) == 0U))
+    {
+        stop = pos;
+    }
+
+    return stop;
+}
+
+static uint16_t bench_build_strings(char *buf, uint16_t cap, uint8_t utf8)
+{
+    /* An array of near-maximal strings (60 content bytes each), optionally
+     * sprinkled with two- and three-byte UTF-8 sequences. */
+    static const char ascii[] = "Lorem ipsum dolor sit amet, consectetur adipiscing elit sed";
+    static const char mixed[] = "Lor\xC3\xA9m ipsum d\xC3\xB6lor sit \xE2\x82\xAC amet, consectetur elit";
+    const char *body = (utf8 != 0U) ? mixed : ascii;
+    uint16_t body_len = (uint16_t)strlen(body);
+    uint16_t len = 0U;
+    uint16_t n   = 0U;
+
+    buf[len++] = '[';
+
+    while (((uint16_t)(len + body_len + 4U) < cap) && (n < (OKJ_MAX_ARRAY_SIZE - 1U)))
+    {
+        if (n > 0U)
+        {
+            buf[len++] = ',';
+        }
+
+        buf[len++] = '"';
+        (void)memcpy(&buf[len], body, body_len);
+        len = (uint16_t)(len + body_len);
+        buf[len++] = '"';
+        n++;
+    }
+
+    buf[len++] = ']';
+
+    return len;
+}
+
+static OkjSize (*volatile bench_scan_fn)(const char *src, OkjSize pos,
+                                         OkjSize limit, uint8_t *non_ascii) = NULL;
+
+static double bench_scan_all(const char *buf, OkjSize len, unsigned long iterations)
+{
+    /* Scan every string body in the buffer: find the opening quote, scan
+     * the body, resume after the closing quote. */
+    unsigned long it;
+    clock_t t0 = clock();
+
+    for (it = 0UL; it < iterations; it++)
+    {
+        OkjSize pos = 0U;
+
+        while (pos < len)
+        {
+            uint8_t non_ascii = 0U;
+
+            while ((pos < len) && (buf[pos] != '"'))
+            {
+                pos++;
+            }
+
+            if (pos < len)
+            {
+                pos = bench_scan_fn(buf, (OkjSize)(pos + 1U), len, &non_ascii);
+                bench_sink += (unsigned long)pos + non_ascii;
+                pos++;
+            }
+        }
+    }
+
+    return bench_seconds(t0, clock());
+}
+
+static void bench_strings(unsigned long iterations)
+{
+    static char buf[BENCH_DOC_LEN];
+    uint8_t utf8;
+
+    printf("string bodies (60-byte strings, %lu passes)\n", iterations);
+
+    for (utf8 = 0U; utf8 <= 1U; utf8++)
+    {
+        uint16_t len = bench_build_strings(buf, (uint16_t)sizeof(buf), utf8);
+        unsigned long bytes = (unsigned long)len * iterations;
+        const char *kind = (utf8 != 0U) ? "UTF-8" : "ASCII";
+        unsigned long it;
+        clock_t t0;
+        char label[64];
+        OkJsonParser parser;
+
+        bench_scan_fn = bench_scan_string_codepoints;
+        (void)snprintf(label, sizeof(label), "per code point, %s", kind);
+        bench_report(label, bytes, bench_scan_all(buf, len, iterations));
+
+        bench_scan_fn = okj_scan_string_run;
+        (void)snprintf(label, sizeof(label), "bulk scan,      %s", kind);
+        bench_report(label, bytes, bench_scan_all(buf, len, iterations));
+
+        bench_scan_fn = bench_scan_and_validate;
+        (void)snprintf(label, sizeof(label), "scan+validate,  %s", kind);
+        bench_report(label, bytes, bench_scan_all(buf, len, iterations));
+
+        t0 = clock();
+        for (it = 0UL; it < iterations; it++)
+        {
+            okj_init(&parser, buf, len);
+            bench_sink += (unsigned long)okj_parse(&parser);
+        }
+
+        (void)snprintf(label, sizeof(label), "okj_parse,      %s", kind);
+        bench_report(label, bytes, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Key lookups: linear okj_find_value_index() scans vs an OkjHashIndex
+ * -------------------------------------------------------------------------- */
+
+static void bench_lookups(unsigned long iterations)
+{
+    /* A flat 30-member message from which 20 fields are read, the pattern
+     * the batch and hash lookups target.  Times cover parse plus lookups,
+     * and for the hashed run the table build as well. */
+    static const char *const labels[] = {
+        "parse + 20 getters, scan",
+        "parse + okj_get_many(20)",
+        "parse + 20 getters, hash index",
+        "parse + 20 key getters, scan",
+        "parse + 20 ID lookups, interned"
+    };
+    static char buf[BENCH_DOC_LEN];
+    static char keys[20][9];
+    static OkjHashSlot slots[256];
+    static uint8_t ids[OKJ_MAX_TOKENS];
+    OkjSize first[20];
+    OkjKeySet key_set;
+    OkjGetRequest requests[20];
+    OkjKey handles[20];
+    OkjHashIndex hash;
+    OkjSize len = 0U;
+    uint16_t m;
+    uint8_t variant;
+
+    buf[len++] = '{';
+    for (m = 0U; m < 30U; m++)
+    {
+        int written = snprintf(&buf[len], (size_t)(BENCH_DOC_LEN - len), "%s\"field_%02u\": %u",
+                               (m == 0U) ? "" : ", ", (unsigned int)m, (unsigned int)(m * 7U));
+
+        len = (OkjSize)(len + (OkjSize)written);
+    }
+    buf[len++] = '}';
+
+    /* The last 20 fields, read in reverse order. */
+    for (m = 0U; m < 20U; m++)
+    {
+        (void)snprintf(keys[m], sizeof(keys[m]), "field_%02u", (unsigned int)(29U - m));
+        requests[m].key     = keys[m];
+        requests[m].key_len = 8U;
+        requests[m].type    = OKJ_NUMBER;
+        (void)okj_key_init(&handles[m], keys[m], 8U);
+    }
+
+    printf("key lookups (20 of 30 members, %lu passes)\n", iterations);
+
+    for (variant = 0U; variant < 5U; variant++)
+    {
+        unsigned long it;
+        clock_t t0 = clock();
+
+        for (it = 0UL; it < iterations; it++)
+        {
+            OkJsonParser parser;
+            OkJsonNumber num;
+
+            okj_init(&parser, buf, len);
+
+            if (variant == 2U)
+            {
+                (void)okj_hash_attach(&parser, &hash, slots, 256U);
+            }
+            else if (variant == 4U)
+            {
+                (void)okj_keys_attach(&parser, &key_set, handles, 20U, ids, first);
+            }
+            else
+            {
+                /* Plain parse. */
+            }
+
+            bench_sink += (unsigned long)okj_parse(&parser);
+
+            if (variant == 1U)
+            {
+                bench_sink += (unsigned long)okj_get_many(&parser, requests, 20U);
+            }
+            else if (variant == 4U)
+            {
+                OkJsonToken tok;
+
+                for (m = 0U; m < 20U; m++)
+                {
+                    if (okj_get_by_id(&parser, (uint8_t)m, &tok) == OKJ_SUCCESS)
+                    {
+                        bench_sink += (unsigned long)tok.length;
+                    }
+                }
+            }
+            else if (variant == 3U)
+            {
+                for (m = 0U; m < 20U; m++)
+                {
+                    if (okj_get_number_key(&parser, &handles[m], &num) == OKJ_SUCCESS)
+                    {
+                        bench_sink += (unsigned long)num.length;
+                    }
+                }
+            }
+            else
+            {
+                for (m = 0U; m < 20U; m++)
+                {
+                    if (okj_get_number(&parser, keys[m], 8U, &num) == OKJ_SUCCESS)
+                    {
+                        bench_sink += (unsigned long)num.length;
+                    }
+                }
+            }
+        }
+
+        bench_report(labels[variant], (unsigned long)len * iterations, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Cursor lookups: document order versus scattered order
+ * -------------------------------------------------------------------------- */
+
+static void bench_cursor(unsigned long iterations)
+{
+    /* All 30 fields of the bench_lookups() message, read either in document
+     * order or in the scattered order 7m mod 30.  The getters rescan from
+     * token 0 either way.  The cursor resumes after its last hit: in
+     * document order it finds each key at the first token it looks at,
+     * scattered it scans forward up to seven members, wrapping as needed. */
+    static const char *const labels[] = {
+        "parse + 30 getters, in order",
+        "parse + 30 cursor, in order",
+        "parse + 30 getters, scattered",
+        "parse + 30 cursor, scattered"
+    };
+    static char buf[BENCH_DOC_LEN];
+    static char keys[30][9];
+    OkjSize len = 0U;
+    uint16_t m;
+    uint8_t variant;
+
+    buf[len++] = '{';
+    for (m = 0U; m < 30U; m++)
+    {
+        int written = snprintf(&buf[len], (size_t)(BENCH_DOC_LEN - len), "%s\"field_%02u\": %u",
+                               (m == 0U) ? "" : ", ", (unsigned int)m, (unsigned int)(m * 7U));
+
+        len = (OkjSize)(len + (OkjSize)written);
+    }
+    buf[len++] = '}';
+
+    printf("cursor lookups (30 of 30 members, %lu passes)\n", iterations);
+
+    for (variant = 0U; variant < 4U; variant++)
+    {
+        unsigned long it;
+        clock_t t0;
+
+        for (m = 0U; m < 30U; m++)
+        {
+            unsigned int field = (variant < 2U) ? (unsigned int)m : (unsigned int)((m * 7U) % 30U);
+
+            (void)snprintf(keys[m], sizeof(keys[m]), "field_%02u", field);
+        }
+
+        t0 = clock();
+        for (it = 0UL; it < iterations; it++)
+        {
+            OkJsonParser parser;
+            OkjCursor    cursor;
+            OkJsonNumber num;
+            OkjSize      idx = 0U;
+
+            okj_init(&parser, buf, len);
+            bench_sink += (unsigned long)okj_parse(&parser);
+            (void)okj_cursor_init(&parser, &cursor);
+
+            for (m = 0U; m < 30U; m++)
+            {
+                if ((variant & 1U) == 0U)
+                {
+                    if (okj_get_number(&parser, keys[m], 8U, &num) == OKJ_SUCCESS)
+                    {
+                        bench_sink += (unsigned long)num.length;
+                    }
+                }
+                else if (okj_cursor_find(&cursor, keys[m], 8U, &idx) == OKJ_SUCCESS)
+                {
+                    bench_sink += (unsigned long)okj_tok_length(&parser, idx);
+                }
+                else
+                {
+                    /* Not reached: every key is present. */
+                }
+            }
+        }
+
+        bench_report(labels[variant], (unsigned long)len * iterations, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Parse-time query pushdown
+ * -------------------------------------------------------------------------- */
+
+static OkjSize bench_message(char *buf)
+{
+    /* A 2 KB message of 120 numbers and a 40-element array of objects,
+     * read three fields at a time by the sections below. */
+    OkjSize  len = 0U;
+    uint16_t m;
+
+    buf[len++] = '{';
+    for (m = 0U; m < 120U; m++)
+    {
+        int written = snprintf(&buf[len], (size_t)(BENCH_DOC_LEN - len), "\"f%03u\": %u, ",
+                               (unsigned int)m, (unsigned int)(m * 7U));
+
+        len = (OkjSize)(len + (OkjSize)written);
+    }
+    len = (OkjSize)(len + (OkjSize)snprintf(&buf[len], (size_t)(BENCH_DOC_LEN - len), "\"samples\": ["));
+    for (m = 0U; m < 40U; m++)
+    {
+        int written = snprintf(&buf[len], (size_t)(BENCH_DOC_LEN - len), "%s{\"v\": %u}",
+                               (m == 0U) ? "" : ", ", (unsigned int)m);
+
+        len = (OkjSize)(len + (OkjSize)written);
+    }
+    buf[len++] = ']';
+    buf[len++] = '}';
+
+    return len;
+}
+
+static void bench_select(unsigned long iterations)
+{
+    /* Three fields out of a 2 KB message of 120 numbers and a 40-element
+     * array of objects.  A full parse needs a caller token buffer, since
+     * the message has over 400 tokens; with the three paths pushed down the
+     * fixed array holds the 7 tokens kept.  Both read the same values. */
+    static const char *const labels[] = {
+        "full parse + 3 getters",
+        "pushdown parse + 3 getters"
+    };
+    static const char *const texts[3] = { "$.f003", "$.f060", "$.f117" };
+    static const char *const keys[3]  = { "f003", "f060", "f117" };
+    static char buf[BENCH_DOC_LEN];
+    static OkJsonToken tokens[1024];
+    OkjDepthFrame depth[4];
+    OkjPath       paths[3];
+    OkjPathStep   steps[3][2];
+    OkjSize       len = bench_message(buf);
+    uint16_t      m;
+    uint8_t       variant;
+
+    for (m = 0U; m < 3U; m++)
+    {
+        (void)okj_path_compile(&paths[m], texts[m], 6U, steps[m], 2U);
+    }
+
+    printf("parse-time pushdown (3 of 160 fields, %u bytes, %lu passes)\n",
+           (unsigned int)len, iterations);
+
+    for (variant = 0U; variant < 2U; variant++)
+    {
+        unsigned long it;
+        clock_t t0 = clock();
+
+        for (it = 0UL; it < iterations; it++)
+        {
+            OkJsonParser parser;
+            OkjSelect    sel;
+            OkJsonNumber num;
+
+            if (variant == 0U)
+            {
+                (void)okj_init_ex(&parser, buf, len, tokens, 1024U, depth, 4U);
+            }
+            else
+            {
+                okj_init(&parser, buf, len);
+                (void)okj_select_attach(&parser, &sel, paths, 3U);
+            }
+
+            bench_sink += (unsigned long)okj_parse(&parser);
+
+            for (m = 0U; m < 3U; m++)
+            {
+                if (okj_get_number(&parser, keys[m], 4U, &num) == OKJ_SUCCESS)
+                {
+                    bench_sink += (unsigned long)num.length;
+                }
+            }
+        }
+
+        bench_report(labels[variant], (unsigned long)len * iterations, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * On-demand document access
+ * -------------------------------------------------------------------------- */
+
+static void bench_doc(unsigned long iterations)
+{
+    /* The pushdown message again, three fields read without a token array.
+     * okj_doc_field() scans from the object's start for each key;
+     * okj_doc_find() on one iterator reads the object once for all three.
+     * Neither checks the members it steps over, unlike a full parse. */
+    static const char *const labels[] = {
+        "full parse + 3 getters",
+        "on-demand, okj_doc_field x3",
+        "on-demand, okj_doc_find in order"
+    };
+    static const char *const keys[3] = { "f003", "f060", "f117" };
+    static char buf[BENCH_DOC_LEN];
+    static OkJsonToken tokens[1024];
+    OkjDepthFrame depth[4];
+    OkjSize       len = bench_message(buf);
+    uint16_t      m;
+    uint8_t       variant;
+
+    printf("on-demand access (3 of 160 fields, %u bytes, %lu passes)\n",
+           (unsigned int)len, iterations);
+
+    for (variant = 0U; variant < 3U; variant++)
+    {
+        unsigned long it;
+        clock_t t0 = clock();
+
+        for (it = 0UL; it < iterations; it++)
+        {
+            if (variant == 0U)
+            {
+                OkJsonParser parser;
+                OkJsonNumber num;
+
+                (void)okj_init_ex(&parser, buf, len, tokens, 1024U, depth, 4U);
+                bench_sink += (unsigned long)okj_parse(&parser);
+
+                for (m = 0U; m < 3U; m++)
+                {
+                    if (okj_get_number(&parser, keys[m], 4U, &num) == OKJ_SUCCESS)
+                    {
+                        bench_sink += (unsigned long)num.length;
+                    }
+                }
+            }
+            else
+            {
+                OkjDoc      doc;
+                OkjDocIter  iter;
+                OkJsonToken root, val;
+
+                (void)okj_doc_init(&doc, buf, len);
+                (void)okj_doc_root(&doc, &root);
+                (void)okj_doc_iter(&doc, &root, &iter);
+
+                for (m = 0U; m < 3U; m++)
+                {
+                    OkjError found = (variant == 1U) ?
+                                     okj_doc_field(&doc, &root, keys[m], 4U, &val) :
+                                     okj_doc_find(&iter, keys[m], 4U, &val);
+
+                    if (found == OKJ_SUCCESS)
+                    {
+                        bench_sink += (unsigned long)val.length;
+                    }
+                }
+            }
+        }
+
+        bench_report(labels[variant], (unsigned long)len * iterations, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Validation without tokens
+ * -------------------------------------------------------------------------- */
+
+static void bench_validate(unsigned long iterations)
+{
+    /* A yes/no answer on the pushdown message: okj_parse() into a caller
+     * token buffer against okj_validate(), which runs the same checks with
+     * no tokens and no parser. */
+    static const char *const labels[] = {
+        "okj_parse (1024 tokens)",
+        "okj_validate"
+    };
+    static char buf[BENCH_DOC_LEN];
+    static OkJsonToken tokens[1024];
+    OkjDepthFrame depth[OKJ_MAX_DEPTH];
+    OkjSize       len = bench_message(buf);
+    uint8_t       variant;
+
+    printf("validate only (%u bytes, %lu passes)\n", (unsigned int)len, iterations);
+
+    for (variant = 0U; variant < 2U; variant++)
+    {
+        unsigned long it;
+        clock_t t0 = clock();
+
+        for (it = 0UL; it < iterations; it++)
+        {
+            if (variant == 0U)
+            {
+                OkJsonParser parser;
+
+                (void)okj_init_ex(&parser, buf, len, tokens, 1024U, depth, OKJ_MAX_DEPTH);
+                bench_sink += (unsigned long)okj_parse(&parser);
+            }
+            else
+            {
+                bench_sink += (unsigned long)okj_validate(buf, len);
+            }
+        }
+
+        bench_report(labels[variant], (unsigned long)len * iterations, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Chunked input
+ * -------------------------------------------------------------------------- */
+
+static void bench_feed(unsigned long iterations)
+{
+    /* The pushdown message parsed whole, and received through okj_feed() in
+     * 256- and 16-byte chunks copied from a receive buffer.  Tokens near the
+     * end of each chunk are checked for completeness and a value cut by the
+     * boundary is scanned again, which the small chunks pay for. */
+    static const char *const labels[] = {
+        "okj_parse, whole message",
+        "okj_feed, 256-byte chunks",
+        "okj_feed, 16-byte chunks"
+    };
+    static const OkjSize chunk_len[] = { 0U, 256U, 16U };
+    static char rx[BENCH_DOC_LEN];
+    static char buf[BENCH_DOC_LEN];
+    static OkJsonToken tokens[1024];
+    OkjDepthFrame depth[OKJ_MAX_DEPTH];
+    OkjSize       len = bench_message(rx);
+    OkjSize       i;
+    uint8_t       variant;
+
+    for (i = 0U; i < len; i++)
+    {
+        buf[i] = rx[i];
+    }
+
+    printf("chunked input (%u bytes, %lu passes)\n", (unsigned int)len, iterations);
+
+    for (variant = 0U; variant < 3U; variant++)
+    {
+        unsigned long it;
+        clock_t t0 = clock();
+
+        for (it = 0UL; it < iterations; it++)
+        {
+            OkJsonParser parser;
+
+            if (variant == 0U)
+            {
+                (void)okj_init_ex(&parser, buf, len, tokens, 1024U, depth, OKJ_MAX_DEPTH);
+                bench_sink += (unsigned long)okj_parse(&parser);
+            }
+            else
+            {
+                OkjFeed  feed;
+                OkjSize  pos = 0U;
+                OkjError rc  = OKJ_NEED_MORE_DATA;
+
+                (void)okj_init_ex(&parser, buf, 0U, tokens, 1024U, depth, OKJ_MAX_DEPTH);
+                (void)okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf));
+                while ((rc == OKJ_NEED_MORE_DATA) && (pos < len))
+                {
+                    OkjSize n = ((OkjSize)(len - pos) < chunk_len[variant])
+                                    ? (OkjSize)(len - pos) : chunk_len[variant];
+
+                    rc  = okj_feed(&parser, &rx[pos], n);
+                    pos = (OkjSize)(pos + n);
+                }
+                bench_sink += (unsigned long)rc;
+            }
+        }
+
+        bench_report(labels[variant], (unsigned long)len * iterations, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Newline-delimited records
+ * -------------------------------------------------------------------------- */
+
+static void bench_lines(unsigned long iterations)
+{
+    /* 32 short log records, one per line, parsed with the embedded token
+     * array.  A fresh okj_init() per record clears all OKJ_MAX_TOKENS
+     * tokens and the nesting stack; okj_lines_next() resets only the read
+     * position and counters of one parser. */
+    static const char *const labels[] = {
+        "okj_init + okj_parse per line",
+        "okj_lines_next",
+        "okj_parse_lines"
+    };
+    static char  buf[BENCH_DOC_LEN];
+    OkjRecord    records[32];
+    OkjSize      len = 0U;
+    uint16_t     m;
+    uint8_t      variant;
+
+    for (m = 0U; m < 32U; m++)
+    {
+        int written = snprintf(&buf[len], (size_t)(BENCH_DOC_LEN - len),
+                               "{\"ts\": %u, \"level\": \"info\", \"svc\": \"api\", \"ms\": %u, \"ok\": true}\n",
+                               (unsigned int)(1700000000U + m), (unsigned int)(m * 3U));
+
+        len = (OkjSize)(len + (OkjSize)written);
+    }
+
+    printf("newline-delimited records (%u bytes, 32 records, %lu passes)\n",
+           (unsigned int)len, iterations);
+
+    for (variant = 0U; variant < 3U; variant++)
+    {
+        unsigned long it;
+        clock_t t0 = clock();
+
+        for (it = 0UL; it < iterations; it++)
+        {
+            OkJsonParser parser;
+
+            if (variant == 0U)
+            {
+                OkjSize start = 0U;
+
+                while (start < len)
+                {
+                    OkjSize stop = okj_line_end(buf, len, start);
+
+                    okj_init(&parser, &buf[start], (OkjSize)(stop - start));
+                    bench_sink += (unsigned long)okj_parse(&parser);
+                    start = (OkjSize)(stop + 1U);
+                }
+            }
+            else if (variant == 1U)
+            {
+                OkjLines  lines;
+                OkjRecord rec;
+
+                okj_init(&parser, buf, 0U);
+                (void)okj_lines_init(&lines, buf, len);
+                while (okj_lines_next(&parser, &lines, &rec) == 1U)
+                {
+                    bench_sink += (unsigned long)rec.status;
+                }
+            }
+            else
+            {
+                OkjSize count = 0U;
+
+                okj_init(&parser, buf, 0U);
+                bench_sink += (unsigned long)okj_parse_lines(&parser, buf, len, records, 32U, &count);
+                bench_sink += (unsigned long)count;
+            }
+        }
+
+        bench_report(labels[variant], (unsigned long)len * iterations, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Event callbacks
+ * -------------------------------------------------------------------------- */
+
+static OkjError bench_on_event(void *user, const OkjEvent *event)
+{
+    /* Sum what a transform would look at: the kind and the length. */
+    *(unsigned long *)user += (unsigned long)event->type + (unsigned long)event->length;
+
+    return OKJ_SUCCESS;
+}
+
+static void bench_events(unsigned long iterations)
+{
+    /* The pushdown message tokenized by okj_parse() and walked by
+     * okj_parse_events() with a callback that touches every event.  The
+     * event parse keeps no tokens: 1024 slots here against two bit-stack
+     * words and one offset per nesting level. */
+    static const char *const labels[] = {
+        "okj_parse (1024 tokens)",
+        "okj_parse_events"
+    };
+    static char buf[BENCH_DOC_LEN];
+    static OkJsonToken tokens[1024];
+    OkjDepthFrame depth[OKJ_MAX_DEPTH];
+    OkjSize       len = bench_message(buf);
+    uint8_t       variant;
+
+    printf("event callbacks (%u bytes, %lu passes)\n", (unsigned int)len, iterations);
+
+    for (variant = 0U; variant < 2U; variant++)
+    {
+        unsigned long it;
+        clock_t t0 = clock();
+
+        for (it = 0UL; it < iterations; it++)
+        {
+            if (variant == 0U)
+            {
+                OkJsonParser parser;
+
+                (void)okj_init_ex(&parser, buf, len, tokens, 1024U, depth, OKJ_MAX_DEPTH);
+                bench_sink += (unsigned long)okj_parse(&parser);
+            }
+            else
+            {
+                unsigned long seen = 0UL;
+
+                bench_sink += (unsigned long)okj_parse_events(buf, len, bench_on_event, &seen);
+                bench_sink += seen;
+            }
+        }
+
+        bench_report(labels[variant], (unsigned long)len * iterations, bench_seconds(t0, clock()));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Array element access by index
+ * -------------------------------------------------------------------------- */
+
+static void bench_arrays(unsigned long iterations)
+{
+    /* A time series of [t, v] pairs and a flat array of numbers, each read
+     * element by element in index order.  The document is parsed once;
+     * only the accesses are timed.  Walking the pairs costs O(n) per access,
+     * the offset table and the flat array O(1).  The walk is quadratic
+     * over a whole pass, so fewer passes are run than elsewhere. */
+    static const char *const labels[] = {
+        "pairs[n], okj_array_find walk",
+        "pairs[n], okj_array_offsets table",
+        "flat[n], okj_array_find direct"
+    };
+    static char buf[BENCH_DOC_LEN];
+    static OkJsonToken tokens[2048];
+    static OkjSize offsets[1024];
+    OkjDepthFrame depth[4];
+    unsigned long passes = (iterations / 16UL) + 1UL;
+    uint8_t variant;
+
+    printf("array element access (%lu passes over every element)\n", passes);
+
+    for (variant = 0U; variant < 3U; variant++)
+    {
+        OkJsonParser parser;
+        OkjSize len   = 0U;
+        OkjSize count = 0U;
+        OkjSize n;
+        unsigned long it;
+        clock_t t0;
+
+        buf[len++] = '[';
+        for (n = 0U; (OkjSize)(len + 16U) < BENCH_DOC_LEN; n++)
+        {
+            int written = (variant == 2U)
+                ? snprintf(&buf[len], (size_t)(BENCH_DOC_LEN - len), "%s%u",
+                           (n == 0U) ? "" : ", ", (unsigned int)(n * 3U))
+                : snprintf(&buf[len], (size_t)(BENCH_DOC_LEN - len), "%s[%u, %u]",
+                           (n == 0U) ? "" : ", ", (unsigned int)n, (unsigned int)(n * 3U));
+
+            len = (OkjSize)(len + (OkjSize)written);
+        }
+        buf[len++] = ']';
+
+        (void)okj_init_ex(&parser, buf, len, tokens, 2048U, depth, 4U);
+        bench_sink += (unsigned long)okj_parse(&parser);
+        count = okj_tok_count(&parser, 0U);
+
+        if (variant == 1U)
+        {
+            bench_sink += (unsigned long)okj_array_offsets(&parser, 0U, offsets, 1024U, &count);
+        }
+
+        t0 = clock();
+        for (it = 0UL; it < passes; it++)
+        {
+            for (n = 0U; n < count; n++)
+            {
+                OkjSize idx = 0U;
+
+                if (variant == 1U)
+                {
+                    idx = offsets[n];
+                }
+                else
+                {
+                    bench_sink += (unsigned long)okj_array_find(&parser, 0U, n, &idx);
+                }
+
+                bench_sink += (unsigned long)okj_tok_length(&parser, idx);
+            }
+        }
+
+        bench_report(labels[variant], (unsigned long)len * passes, bench_seconds(t0, clock()));
+    }
+}
+
+#ifdef OK_JSON_LARGE_DOCS
+/* --------------------------------------------------------------------------
+ * Document size scaling: okj_parse() throughput from kilobytes to hundreds of
+ * megabytes (OK_JSON_LARGE_DOCS builds only)
+ * -------------------------------------------------------------------------- */
+
+static OkjSize bench_build_records(char *buf, OkjSize cap, OkjSize *tokens)
+{
+    /* An array of small records, {"id": N, "name": "...", "ok": true},
+     * the shape of a log or table export.  Each record is seven tokens. */
+    static const char name[] = "Lorem ipsum dolor sit amet, consectetur adipiscing elit sed";
+    OkjSize len = 0U;
+    OkjSize n   = 0U;
+
+    buf[len++] = '[';
+
+    while ((OkjSize)(len + 128U) < cap)
+    {
+        int written = snprintf(&buf[len], (size_t)(cap - len),
+                               "%s{\"id\": %u, \"name\": \"%s\", \"ok\": %s}",
+                               (n == 0U) ? "" : ", ", (unsigned int)n, name,
+                               ((n & 1U) == 0U) ? "true" : "false");
+
+        len = (OkjSize)(len + (OkjSize)written);
+        n++;
+    }
+
+    buf[len++] = ']';
+    *tokens = (OkjSize)(1U + (n * 7U));
+
+    return len;
+}
+
+static void bench_scaling(unsigned long max_mb)
+{
+    /* Each size is parsed often enough to cover at least 64 MB in total, so
+     * the MB/s column compares like with like.  Flat MB/s as the document
+     * grows means okj_parse() time is linear in the input size.  Expect one
+     * step down once the input and token array outgrow the last-level
+     * cache; past that the parser runs at memory speed. */
+    static const OkjSize total = 64U * 1024U * 1024U;
+    OkjSize size;
+
+    printf("document size scaling (okj_parse, records array, up to %lu MB)\n", max_mb);
+
+    for (size = 4096U; (size / 1024U) <= (max_mb * 1024UL); size *= 4U)
+    {
+        char *buf = (char *)malloc((size_t)size);
+        OkjSize count = 0U;
+        OkjSize len = 0U;
+        OkJsonToken *tokens = NULL;
+        OkjDepthFrame depth[4];
+        unsigned long passes = 1UL;
+        unsigned long it;
+        clock_t t0;
+        char label[64];
+        OkJsonParser parser;
+
+        if (buf != NULL)
+        {
+            len = bench_build_records(buf, size, &count);
+            tokens = (OkJsonToken *)malloc((size_t)(count + 1U) * sizeof(OkJsonToken));
+        }
+
+        if (tokens == NULL)
+        {
+            printf("  %u KB: out of memory\n", (unsigned int)(size / 1024U));
+            free(buf);
+            break;
+        }
+
+        if (len < total)
+        {
+            passes = (unsigned long)(total / len);
+        }
+
+        /* One untimed pass first so page faults on the fresh token buffer
+         * are not billed to the parser. */
+        (void)okj_init_ex(&parser, buf, len, tokens, (OkjSize)(count + 1U), depth, 4U);
+        bench_sink += (unsigned long)okj_parse(&parser);
+
+        t0 = clock();
+        for (it = 0UL; it < passes; it++)
+        {
+            (void)okj_init_ex(&parser, buf, len, tokens, (OkjSize)(count + 1U), depth, 4U);
+            bench_sink += (unsigned long)okj_parse(&parser) + parser.token_count;
+        }
+
+        (void)snprintf(label, sizeof(label), "okj_parse, %9u KB x %lu",
+                       (unsigned int)(size / 1024U), passes);
+        bench_report(label, (unsigned long)len * passes, bench_seconds(t0, clock()));
+
+        free(tokens);
+        free(buf);
+
+        if (size > (OKJ_SIZE_MAX / 4U))
+        {
+            break;
+        }
+    }
+}
+#endif /* OK_JSON_LARGE_DOCS */
+
+int main(int argc, char *argv[])
+{
+    unsigned long iterations = 20000UL;
+
+    if (argc > 1)
+    {
+        iterations = strtoul(argv[1], NULL, 10);
+    }
+
+    bench_whitespace(iterations);
+    bench_strings(iterations);
+    bench_lookups(iterations);
+    bench_cursor(iterations);
+    bench_select(iterations);
+    bench_doc(iterations);
+    bench_validate(iterations);
+    bench_feed(iterations);
+    bench_lines(iterations);
+    bench_events(iterations);
+    bench_arrays(iterations);
+
+#ifdef OK_JSON_LARGE_DOCS
+    {
+        /* Second argument: largest scaling document, in MB. */
+        unsigned long max_mb = 256UL;
+
+        if (argc > 2)
+        {
+            max_mb = strtoul(argv[2], NULL, 10);
+        }
+
+        bench_scaling(max_mb);
+    }
+#endif
+
+
+    return 0;
+}
@@ -240,6 +240,107 @@ void test_oob_utf8_invalid_lead_byte_at_eof(void);
 void test_oob_utf8_three_byte_lead_at_eof(void);
 void test_oob_utf8_exhaustive_lead_sweep(void);
 void test_oob_keyword_truncated_no_padding(void);
+/* SWAR whitespace skipping in okj_skip_whitespace() */
+void test_skip_whitespace_swar_run_lengths(void);
+void test_skip_whitespace_swar_all_whitespace(void);
+void test_skip_whitespace_swar_near_miss_bytes(void);
+void test_swar_first_byte_each_lane(void);
+void test_parse_indented_document(void);
+/* Bulk string-body scanning in okj_scan_string_run() */
+void test_scan_string_run_special_each_offset(void);
+void test_scan_string_run_non_ascii_flag(void);
+void test_parse_long_strings_bulk_scanned(void);
+/* Table-driven UTF-8 DFA and okj_validate_utf8_block() */
+void test_validate_utf8_block_ascii_and_multibyte(void);
+void test_validate_utf8_block_bounds(void);
+void test_utf8_dfa_matches_rfc3629_table(void);
+/* Table-driven dispatch in okj_parse_value() */
+void test_char_class_table(void);
+void test_grammar_action_table(void);
+void test_parse_literal_prefix_is_syntax_error(void);
+/* Container extent recorded on close in okj_parse_value() */
+void test_container_extent_recorded_on_close(void);
+void test_container_extent_matches_rescan(void);
+void test_container_getters_use_recorded_extent(void);
+void test_container_extent_unclosed_fallback(void);
+/* Token accessors and the OK_JSON_COMPACT_TOKENS tape */
+void test_token_at_copies_tokens(void);
+void test_token_at_bad_args(void);
+void test_token_tape_size(void);
+/* Caller-owned storage via okj_init_ex() */
+void test_init_ex_bad_args(void);
+void test_init_ex_small_buffers_enforced(void);
+void test_init_ex_large_buffers(void);
+/* Large-document mode (OK_JSON_LARGE_DOCS) */
+void test_size_type_width(void);
+void test_large_docs_past_64k(void);
+/* Scoped member lookup via okj_find_member() */
+void test_find_member_scoped(void);
+void test_find_member_skips_containers(void);
+void test_find_member_bad_args(void);
+/* Key hash index via okj_hash_attach() */
+void test_hash_matches_scan(void);
+void test_hash_build_timing(void);
+void test_hash_too_small_falls_back(void);
+void test_hash_attach_bad_args(void);
+/* Batch lookups via okj_get_many() */
+void test_get_many_resolves_batch(void);
+void test_get_many_first_match_and_hash(void);
+void test_get_many_spans_several_passes(void);
+void test_get_many_bad_args(void);
+/* Prepared key handles */
+void test_key_handle_init(void);
+void test_key_getters_match_raw_keys(void);
+void test_key_getters_bad_args(void);
+/* Key interning */
+void test_key_ids_tagged_during_parse(void);
+void test_key_ids_reset_between_parses(void);
+void test_key_ids_bad_args(void);
+/* JSON Pointer (RFC 6901) */
+void test_pointer_rfc6901_examples(void);
+void test_pointer_nested_paths(void);
+void test_pointer_compile_errors(void);
+/* Indexed array element access */
+void test_array_at_flat_and_nested(void);
+void test_array_at_empty_and_open(void);
+void test_array_offsets_table(void);
+/* Child iterators */
+void test_iter_object_members(void);
+void test_iter_array_elements(void);
+void test_iter_skips_nested_subtrees(void);
+void test_iter_bad_args(void);
+/* Cursor lookups */
+void test_cursor_in_order_and_wrap(void);
+void test_cursor_matches_getters(void);
+void test_cursor_bad_args(void);
+/* JSONPath queries */
+void test_path_child_index_wildcard(void);
+void test_path_recursive_and_filters(void);
+void test_path_errors(void);
+/* Parse-time query pushdown */
+void test_select_keeps_requested_fields(void);
+void test_select_subtrees_and_recursion(void);
+void test_select_validates_and_errors(void);
+/* On-demand document access */
+void test_doc_reads_fields_without_tokens(void);
+void test_doc_iterate_and_find_in_order(void);
+void test_doc_errors(void);
+/* Token-free validation */
+void test_validate_matches_parse(void);
+void test_validate_has_no_token_limit(void);
+void test_validate_depth_and_errors(void);
+/* Incremental input */
+void test_feed_byte_at_a_time_matches_parse(void);
+void test_feed_in_place_and_top_level_scalars(void);
+void test_feed_errors(void);
+/* Newline-delimited records */
+void test_lines_parse_each_record_with_one_parser(void);
+void test_reset_matches_init(void);
+void test_parse_lines_fills_records(void);
+/* Event callbacks */
+void test_events_report_values_in_order(void);
+void test_events_have_no_token_limit(void);
+void test_events_errors_and_early_stop(void);
 
 /**
  * These tests are a work in progress. If you have ideas
@@ -267,9 +368,9 @@ void test_parse_simple_object(void)
     assert(result == OKJ_SUCCESS);
     assert(parser.token_count == 3);
 
-    assert(parser.tokens[0].type == OKJ_OBJECT);
-    assert(parser.tokens[1].type == OKJ_STRING);   /* "key"  */
-    assert(parser.tokens[2].type == OKJ_NUMBER);   /* 42     */
+    assert(okj_tok_type(&parser, 0) == OKJ_OBJECT);
+    assert(okj_tok_type(&parser, 1) == OKJ_STRING);   /* "key"  */
+    assert(okj_tok_type(&parser, 2) == OKJ_NUMBER);   /* 42     */
 
     printf("test_parse_simple_object passed!\n");
 }
@@ -291,10 +392,10 @@ void test_parse_array(void)
     assert(result == OKJ_SUCCESS);
     assert(parser.token_count == 4); /* 3 numbers + array itself */
 
-    assert(parser.tokens[0].type == OKJ_ARRAY);
-    assert(parser.tokens[1].type == OKJ_NUMBER);
-    assert(parser.tokens[2].type == OKJ_NUMBER);
-    assert(parser.tokens[3].type == OKJ_NUMBER);
+    assert(okj_tok_type(&parser, 0) == OKJ_ARRAY);
+    assert(okj_tok_type(&parser, 1) == OKJ_NUMBER);
+    assert(okj_tok_type(&parser, 2) == OKJ_NUMBER);
+    assert(okj_tok_type(&parser, 3) == OKJ_NUMBER);
 
     printf("test_parse_array passed!\n");
 }
@@ -2204,7 +2305,7 @@ void test_empty_object(void)
     okj_init(&parser, json1, (uint16_t)(sizeof(json1) - 1U));
     assert(okj_parse(&parser) == OKJ_SUCCESS);
     assert(parser.token_count == 1U);          /* only the OKJ_OBJECT token */
-    assert(parser.tokens[0].type == OKJ_OBJECT);
+    assert(okj_tok_type(&parser, 0) == OKJ_OBJECT);
     assert(okj_count_objects(&parser) == 1U);
 
     /* Empty object as a value — getter must return non-NULL with count 0 */
@@ -2236,7 +2337,7 @@ void test_empty_array(void)
     okj_init(&parser, json1, (uint16_t)(sizeof(json1) - 1U));
     assert(okj_parse(&parser) == OKJ_SUCCESS);
     assert(parser.token_count == 1U);          /* only the OKJ_ARRAY token */
-    assert(parser.tokens[0].type == OKJ_ARRAY);
+    assert(okj_tok_type(&parser, 0) == OKJ_ARRAY);
     assert(okj_count_arrays(&parser) == 1U);
 
     /* Empty array as a value — getter must return non-NULL with count 0 */
@@ -2269,11 +2370,11 @@ void test_nested_object(void)
     assert(okj_parse(&parser) == OKJ_SUCCESS);
     assert(parser.token_count == 5U);
 
-    assert(parser.tokens[0].type == OKJ_OBJECT);   /* outer { } */
-    assert(parser.tokens[1].type == OKJ_STRING);   /* "outer"   */
-    assert(parser.tokens[2].type == OKJ_OBJECT);   /* inner { } */
-    assert(parser.tokens[3].type == OKJ_STRING);   /* "inner"   */
-    assert(parser.tokens[4].type == OKJ_NUMBER);   /* 1         */
+    assert(okj_tok_type(&parser, 0) == OKJ_OBJECT);   /* outer { } */
+    assert(okj_tok_type(&parser, 1) == OKJ_STRING);   /* "outer"   */
+    assert(okj_tok_type(&parser, 2) == OKJ_OBJECT);   /* inner { } */
+    assert(okj_tok_type(&parser, 3) == OKJ_STRING);   /* "inner"   */
+    assert(okj_tok_type(&parser, 4) == OKJ_NUMBER);   /* 1         */
 
     assert(okj_get_object(&parser, "outer", 5U, &obj) == OKJ_SUCCESS);
 
@@ -2487,6 +2588,9 @@ void test_deeply_nested_at_limit(void)
     printf("test_deeply_nested_at_limit passed!\n");
 }
 
+#ifndef OK_JSON_LARGE_DOCS
+/* OK_JSON_LARGE_DOCS lifts OKJ_MAX_JSON_LEN to 2 GiB; these two tests build
+ * inputs just past the default 4096-byte limit. */
 void test_max_json_len_exceeded(void)
 {
     /* Build a JSON string longer than OKJ_MAX_JSON_LEN (4096) bytes.
@@ -2586,6 +2690,7 @@ void test_max_json_len_boundary(void)
 
     printf("test_max_json_len_boundary passed!\n");
 }
+#endif /* OK_JSON_LARGE_DOCS */
 
 void test_parse_null_parser(void)
 {
@@ -2621,7 +2726,7 @@ void test_null_pointer_safety(void)
     assert(okj_parse(&parser) == OKJ_SUCCESS);
 
     {
-        uint16_t saved_token_count = parser.token_count;
+        OkjSize  saved_token_count = parser.token_count;
         uint16_t saved_depth       = parser.depth;
 
         okj_init(&parser, NULL, 0U);
@@ -3394,7 +3499,7 @@ void test_top_level_number(void)
 
     assert(result == OKJ_SUCCESS);
     assert(parser.token_count == 1U);
-    assert(parser.tokens[0].type == OKJ_NUMBER);
+    assert(okj_tok_type(&parser, 0) == OKJ_NUMBER);
 
     printf("test_top_level_number passed!\n");
 }
@@ -3412,7 +3517,7 @@ void test_top_level_string(void)
 
     assert(result == OKJ_SUCCESS);
     assert(parser.token_count == 1U);
-    assert(parser.tokens[0].type == OKJ_STRING);
+    assert(okj_tok_type(&parser, 0) == OKJ_STRING);
 
     printf("test_top_level_string passed!\n");
 }
@@ -3431,14 +3536,14 @@ void test_top_level_boolean(void)
 
     assert(result == OKJ_SUCCESS);
     assert(parser.token_count == 1U);
-    assert(parser.tokens[0].type == OKJ_BOOLEAN);
+    assert(okj_tok_type(&parser, 0) == OKJ_BOOLEAN);
 
     okj_init(&parser, json2, (uint16_t)(sizeof(json2) - 1U));
     result = okj_parse(&parser);
 
     assert(result == OKJ_SUCCESS);
     assert(parser.token_count == 1U);
-    assert(parser.tokens[0].type == OKJ_BOOLEAN);
+    assert(okj_tok_type(&parser, 0) == OKJ_BOOLEAN);
 
     printf("test_top_level_boolean passed!\n");
 }
@@ -3456,7 +3561,7 @@ void test_top_level_null(void)
 
     assert(result == OKJ_SUCCESS);
     assert(parser.token_count == 1U);
-    assert(parser.tokens[0].type == OKJ_NULL);
+    assert(okj_tok_type(&parser, 0) == OKJ_NULL);
 
     printf("test_top_level_null passed!\n");
 }
@@ -3525,7 +3630,7 @@ void test_iot_sensor_json(void)
 
     /* Token budget */
     assert(parser.token_count == 48U);
-    assert(parser.tokens[0].type == OKJ_OBJECT);
+    assert(okj_tok_type(&parser, 0) == OKJ_OBJECT);
 
     /* Object and array counts (root + networkFeatures + calibrationData = 3
      * objects; recentTemperatures + systemTags + pendingErrorCodes = 3 arrays) */
@@ -3680,7 +3785,7 @@ void test_user_data_json(void)
 
     /* Token budget */
     assert(parser.token_count == 75U);
-    assert(parser.tokens[0].type == OKJ_ARRAY);
+    assert(okj_tok_type(&parser, 0) == OKJ_ARRAY);
 
     /* Structural counts */
     assert(okj_count_objects(&parser) == 4U);
@@ -3811,11 +3916,11 @@ void test_deeply_nested_valid_json(void)
 
     /* Token budget */
     assert(parser.token_count == 32U);
-    assert(parser.tokens[0].type  == OKJ_OBJECT);
-    assert(parser.tokens[26].type == OKJ_ARRAY);    /* settings array      */
-    assert(parser.tokens[27].type == OKJ_OBJECT);   /* settings[0] object  */
-    assert(parser.tokens[29].type == OKJ_NUMBER);   /* 42                  */
-    assert(parser.tokens[31].type == OKJ_BOOLEAN);  /* true                */
+    assert(okj_tok_type(&parser, 0)  == OKJ_OBJECT);
+    assert(okj_tok_type(&parser, 26) == OKJ_ARRAY);    /* settings array      */
+    assert(okj_tok_type(&parser, 27) == OKJ_OBJECT);   /* settings[0] object  */
+    assert(okj_tok_type(&parser, 29) == OKJ_NUMBER);   /* 42                  */
+    assert(okj_tok_type(&parser, 31) == OKJ_BOOLEAN);  /* true                */
 
     /* Container counts */
     assert(okj_count_objects(&parser) == 14U);
@@ -3940,7 +4045,7 @@ void test_upper_limits_json(void)
 
     /* Token budget: 125 tokens out of OKJ_MAX_TOKENS (128) */
     assert(parser.token_count == 125U);
-    assert(parser.tokens[0].type == OKJ_OBJECT);
+    assert(okj_tok_type(&parser, 0) == OKJ_OBJECT);
     assert(parser.depth == 0U);   /* all containers closed */
 
     /* Structural counts:
@@ -4086,11 +4191,11 @@ void test_empty_string_key(void)
 
     /* Three tokens: OKJ_OBJECT container, empty-string key, string value. */
     assert(parser.token_count == 3U);
-    assert(parser.tokens[0].type == OKJ_OBJECT);
+    assert(okj_tok_type(&parser, 0) == OKJ_OBJECT);
 
     /* Key token must be a zero-length STRING. */
-    assert(parser.tokens[1].type   == OKJ_STRING);
-    assert(parser.tokens[1].length == 0U);
+    assert(okj_tok_type(&parser, 1)   == OKJ_STRING);
+    assert(okj_tok_length(&parser, 1) == 0U);
 
     /* Value lookup via the empty-string key must succeed. */
     assert(okj_get_string(&parser, "", 0U, &str) == OKJ_SUCCESS);
@@ -4649,7 +4754,7 @@ void test_okj_get_object_raw_null_key(void)
 void test_okj_get_string_key_not_found(void)
 {
     /* A valid parser with a parsed object, but the requested key does not
-     * exist.  okj_find_value_index() returns OKJ_MAX_TOKENS and the getter
+     * exist.  okj_find_value_index() returns OKJ_NOT_FOUND and the getter
      * must propagate that as a non-success error code. */
 
     OkJsonParser  parser;
@@ -4667,7 +4772,7 @@ void test_okj_get_string_key_not_found(void)
 void test_okj_get_number_key_not_found(void)
 {
     /* A valid parser with a parsed object, but the requested key does not
-     * exist.  okj_find_value_index() returns OKJ_MAX_TOKENS and the getter
+     * exist.  okj_find_value_index() returns OKJ_NOT_FOUND and the getter
      * must propagate that as a non-success error code. */
 
     OkJsonParser  parser;
@@ -4685,7 +4790,7 @@ void test_okj_get_number_key_not_found(void)
 void test_okj_get_boolean_key_not_found(void)
 {
     /* A valid parser with a parsed object, but the requested key does not
-     * exist.  okj_find_value_index() returns OKJ_MAX_TOKENS and the getter
+     * exist.  okj_find_value_index() returns OKJ_NOT_FOUND and the getter
      * must propagate that as a non-success error code. */
 
     OkJsonParser   parser;
@@ -4703,7 +4808,7 @@ void test_okj_get_boolean_key_not_found(void)
 void test_okj_get_array_key_not_found(void)
 {
     /* A valid parser with a parsed object, but the requested key does not
-     * exist.  okj_find_value_index() returns OKJ_MAX_TOKENS and the getter
+     * exist.  okj_find_value_index() returns OKJ_NOT_FOUND and the getter
      * must propagate that as a non-success error code. */
 
     OkJsonParser  parser;
@@ -4721,7 +4826,7 @@ void test_okj_get_array_key_not_found(void)
 void test_okj_get_object_key_not_found(void)
 {
     /* A valid parser with a parsed object, but the requested key does not
-     * exist.  okj_find_value_index() returns OKJ_MAX_TOKENS and the getter
+     * exist.  okj_find_value_index() returns OKJ_NOT_FOUND and the getter
      * must propagate that as a non-success error code. */
 
     OkJsonParser  parser;
@@ -4739,7 +4844,7 @@ void test_okj_get_object_key_not_found(void)
 void test_okj_get_token_key_not_found(void)
 {
     /* A valid parser with a parsed object, but the requested key does not
-     * exist.  okj_find_value_index() returns OKJ_MAX_TOKENS and the getter
+     * exist.  okj_find_value_index() returns OKJ_NOT_FOUND and the getter
      * must propagate that as a non-success error code. */
 
     OkJsonParser  parser;
@@ -4757,7 +4862,7 @@ void test_okj_get_token_key_not_found(void)
 void test_okj_get_array_raw_key_not_found(void)
 {
     /* A valid parser with a parsed object, but the requested key does not
-     * exist.  okj_find_value_index() returns OKJ_MAX_TOKENS and the getter
+     * exist.  okj_find_value_index() returns OKJ_NOT_FOUND and the getter
      * must propagate that as a non-success error code. */
 
     OkJsonParser  parser;
@@ -4775,7 +4880,7 @@ void test_okj_get_array_raw_key_not_found(void)
 void test_okj_get_object_raw_key_not_found(void)
 {
     /* A valid parser with a parsed object, but the requested key does not
-     * exist.  okj_find_value_index() returns OKJ_MAX_TOKENS and the getter
+     * exist.  okj_find_value_index() returns OKJ_NOT_FOUND and the getter
      * must propagate that as a non-success error code. */
 
     OkJsonParser  parser;
@@ -4840,7 +4945,7 @@ void test_measure_container_escape_in_string(void)
      * Length: 8 characters inclusive of brackets. */
     char s[] = "[\"a\\nb\"]";
 
-    uint16_t len = okj_measure_container(s, s + (sizeof(s) - 1U));
+    OkjSize len = okj_measure_container(s, s + (sizeof(s) - 1U));
 
     assert(len == 8U);
 
@@ -4858,7 +4963,7 @@ void test_measure_container_escape_at_eof(void)
 
     /* The function must not crash; it returns whatever it measured before
      * hitting the buffer boundary (the while loop exits because p >= end). */
-    uint16_t len = okj_measure_container(s, s + (sizeof(s) - 1U));
+    OkjSize len = okj_measure_container(s, s + (sizeof(s) - 1U));
 
     /* At minimum the opening '[' was counted (length >= 1). */
     assert(len >= 1U);
@@ -5261,6 +5366,3069 @@ void test_oob_keyword_truncated_no_padding(void)
     printf("test_oob_keyword_truncated_no_padding passed!\n");
 }
 
+void test_skip_whitespace_swar_run_lengths(void)
+{
+    /* okj_skip_whitespace() classifies eight bytes per iteration.  Place a
+     * single non-whitespace byte after every run length from 0 to 40 so the
+     * stop position lands in every lane of a word, on word boundaries, and in
+     * the byte-wise tail.  Each buffer is an exact-size malloc so ASan would
+     * catch a word load that strays past json_len. */
+    static const char ws[] = { ' ', '\t', '\n', '\r' };
+    uint16_t run;
+
+    for (run = 0U; run <= 40U; run++)
+    {
+        uint16_t len = (uint16_t)(run + 1U);
+        char    *buf = (char *)malloc(len);
+        uint16_t i;
+
+        assert(buf != NULL);
+
+        for (i = 0U; i < run; i++)
+        {
+            buf[i] = ws[i % 4U];
+        }
+
+        buf[run] = 'x';
+
+        OkJsonParser parser;
+
+        okj_init(&parser, buf, len);
+        okj_skip_whitespace(&parser);
+
+        assert(parser.position == run);
+
+        free(buf);
+    }
+
+    printf("test_skip_whitespace_swar_run_lengths passed!\n");
+}
+
+void test_skip_whitespace_swar_all_whitespace(void)
+{
+    /* A buffer made only of whitespace must leave the position exactly at
+     * json_len for every length, including lengths that are not a multiple
+     * of the eight-byte word size. */
+    uint16_t len;
+
+    for (len = 1U; len <= 33U; len++)
+    {
+        char    *buf = (char *)malloc(len);
+        uint16_t i;
+
+        assert(buf != NULL);
+
+        for (i = 0U; i < len; i++)
+        {
+            buf[i] = (i % 3U == 0U) ? '\n' : ' ';
+        }
+
+        OkJsonParser parser;
+
+        okj_init(&parser, buf, len);
+        okj_skip_whitespace(&parser);
+
+        assert(parser.position == len);
+
+        free(buf);
+    }
+
+    printf("test_skip_whitespace_swar_all_whitespace passed!\n");
+}
+
+void test_skip_whitespace_swar_near_miss_bytes(void)
+{
+    /* Bytes that differ from a whitespace character by a single bit (or by
+     * the high bit only) must not be classified as whitespace by the word
+     * classifier. */
+    static const uint8_t near[] = { 0x00U, 0x08U, 0x0BU, 0x0CU, 0x0EU,
+                                    0x21U, 0x29U, 0x2AU, 0x2DU, 0x30U,
+                                    0x89U, 0x8AU, 0x8DU, 0xA0U, 0xFFU };
+    size_t k;
+
+    for (k = 0U; k < sizeof(near); k++)
+    {
+        char buf[16];
+        uint16_t i;
+
+        for (i = 0U; i < 16U; i++)
+        {
+            buf[i] = ' ';
+        }
+
+        buf[5] = (char)near[k];
+
+        OkJsonParser parser;
+
+        okj_init(&parser, buf, 16U);
+        okj_skip_whitespace(&parser);
+
+        assert(parser.position == 5U);
+    }
+
+    printf("test_skip_whitespace_swar_near_miss_bytes passed!\n");
+}
+
+void test_swar_first_byte_each_lane(void)
+{
+    /* okj_swar_first_byte() must return the lowest flagged lane regardless of
+     * which higher lanes are also flagged. */
+    uint16_t lane;
+
+    for (lane = 0U; lane < 8U; lane++)
+    {
+        okj_u64 only  = 0x80ULL << (8U * lane);
+        okj_u64 upper = 0x8080808080808080ULL & ~(only - 1U);
+
+        assert(okj_swar_first_byte(only)  == lane);
+        assert(okj_swar_first_byte(upper) == lane);
+    }
+
+    printf("test_swar_first_byte_each_lane passed!\n");
+}
+
+void test_parse_indented_document(void)
+{
+    /* End-to-end: a pretty-printed document with long indentation runs parses
+     * to the same tokens as its compact form. */
+    OkJsonParser  parser;
+    OkJsonNumber  num;
+    OkJsonString  str;
+    char json_str[] = "{\n"
+                      "                \"id\":                 7,\n"
+                      "\t\t\t\t\t\t\t\t\"tags\": [\r\n"
+                      "                        \"a\",\n"
+                      "                        \"b\"\n"
+                      "                ],\n"
+                      "                \"name\":       \"x\"\n"
+                      "}\n        ";
+
+    okj_init(&parser, json_str, (uint16_t)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(parser.token_count == 9U);
+
+    assert(okj_get_number(&parser, "id", 2U, &num) == OKJ_SUCCESS);
+    assert((num.length == 1U) && (num.start[0] == '7'));
+
+    assert(okj_get_string(&parser, "name", 4U, &str) == OKJ_SUCCESS);
+    assert((str.length == 1U) && (str.start[0] == 'x'));
+
+    printf("test_parse_indented_document passed!\n");
+}
+
+void test_scan_string_run_special_each_offset(void)
+{
+    /* okj_scan_string_run() classifies eight (or, with SSE2, sixteen) bytes
+     * per step.  Put each kind of run terminator at every offset of a
+     * 40-byte ASCII run so it lands in every lane, on block boundaries and in
+     * the byte-wise tail.  The buffer is an exact-size malloc so ASan would
+     * catch a block load past `limit`. */
+    static const char specials[] = { '"', '\\', '\x01', '\x1F', '\n', '\0' };
+    uint16_t k;
+    uint16_t at;
+
+    for (k = 0U; k < (uint16_t)sizeof(specials); k++)
+    {
+        for (at = 0U; at < 40U; at++)
+        {
+            char *buf = (char *)malloc(40U);
+            uint16_t i;
+            uint8_t non_ascii = 7U;
+
+            assert(buf != NULL);
+
+            for (i = 0U; i < 40U; i++)
+            {
+                buf[i] = (char)('a' + (char)(i % 26U));
+            }
+
+            buf[at] = specials[k];
+
+            assert(okj_scan_string_run(buf, 0U, 40U, &non_ascii) == at);
+            assert(non_ascii == 0U);
+
+            /* Starting just past the terminator scans to the end. */
+            assert(okj_scan_string_run(buf, (uint16_t)(at + 1U), 40U, &non_ascii) == 40U);
+
+            free(buf);
+        }
+    }
+
+    printf("test_scan_string_run_special_each_offset passed!\n");
+}
+
+void test_scan_string_run_non_ascii_flag(void)
+{
+    /* The non-ASCII flag reports only bytes that precede the terminator: a
+     * high byte before the quote sets it, the same byte after it does not.
+     * 0x7F (DEL) is printable ASCII for JSON and does not end the run. */
+    char buf[40];
+    uint16_t hi;
+    uint8_t non_ascii = 0U;
+
+    for (hi = 0U; hi < 39U; hi++)
+    {
+        (void)memset(buf, 'x', sizeof(buf));
+        buf[hi] = (char)0xC3;
+        buf[20] = '"';
+
+        assert(okj_scan_string_run(buf, 0U, 40U, &non_ascii) == 20U);
+        assert(non_ascii == ((hi < 20U) ? 1U : 0U));
+    }
+
+    (void)memset(buf, '\x7F', sizeof(buf));
+    assert(okj_scan_string_run(buf, 0U, 40U, &non_ascii) == 40U);
+    assert(non_ascii == 0U);
+
+    assert(okj_scan_string_run(buf, 5U, 5U, &non_ascii) == 5U);
+    assert(non_ascii == 0U);
+
+    printf("test_scan_string_run_non_ascii_flag passed!\n");
+}
+
+void test_parse_long_strings_bulk_scanned(void)
+{
+    /* End-to-end: strings whose bodies span several scan blocks, mixing
+     * ASCII, multi-byte UTF-8 and escapes, parse to the same tokens as
+     * before; the 64-byte cap still fires at exactly 65 content bytes, and
+     * invalid UTF-8 deep inside a long run is still rejected. */
+    OkJsonParser parser;
+    char ok_str[] = "[\"The quick brown fox \xC3\xA9\xE2\x82\xAC jumps\\n over the lazy dog!!\"]";
+    char bad_str[] = "[\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\xC0\x80\"]";
+    char cap_ok[3U + OKJ_MAX_STRING_LEN + 2U];
+    char cap_over[3U + OKJ_MAX_STRING_LEN + 3U];
+
+    okj_init(&parser, ok_str, (uint16_t)(sizeof(ok_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(parser.token_count == 2U);
+    assert(okj_tok_type(&parser, 1) == OKJ_STRING);
+    assert(okj_tok_length(&parser, 1) == (uint16_t)(sizeof(ok_str) - 1U - 4U));
+
+    okj_init(&parser, bad_str, (uint16_t)(sizeof(bad_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_ERROR_BAD_STRING);
+
+    /* ["<64 x 'a'>"] is accepted, ["<65 x 'a'>"] is rejected. */
+    (void)memset(cap_ok, 'a', sizeof(cap_ok));
+    cap_ok[0] = '[';
+    cap_ok[1] = '"';
+    cap_ok[2U + OKJ_MAX_STRING_LEN] = '"';
+    cap_ok[3U + OKJ_MAX_STRING_LEN] = ']';
+    okj_init(&parser, cap_ok, (uint16_t)(4U + OKJ_MAX_STRING_LEN));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_tok_length(&parser, 1) == OKJ_MAX_STRING_LEN);
+
+    (void)memset(cap_over, 'a', sizeof(cap_over));
+    cap_over[0] = '[';
+    cap_over[1] = '"';
+    cap_over[3U + OKJ_MAX_STRING_LEN] = '"';
+    cap_over[4U + OKJ_MAX_STRING_LEN] = ']';
+    okj_init(&parser, cap_over, (uint16_t)(5U + OKJ_MAX_STRING_LEN));
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_STR_LEN_EXCEEDED);
+
+    printf("test_parse_long_strings_bulk_scanned passed!\n");
+}
+
+void test_validate_utf8_block_ascii_and_multibyte(void)
+{
+    /* okj_validate_utf8_block() confirms ASCII a block at a time and runs
+     * the DFA only at lead bytes.  Place a two-, three- and four-byte
+     * sequence at every offset of a 40-byte ASCII run so each lands in
+     * every lane, across block boundaries and in the byte-wise tail.  The
+     * buffer is an exact-size malloc so ASan would catch any over-read. */
+    static const char *seqs[] = { "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" };
+    uint16_t k;
+    uint16_t at;
+
+    for (k = 0U; k < 3U; k++)
+    {
+        uint16_t slen = (uint16_t)strlen(seqs[k]);
+
+        for (at = 0U; (uint16_t)(at + slen) <= 40U; at++)
+        {
+            char *buf = (char *)malloc(40U);
+            OkjSize stop = 0U;
+
+            assert(buf != NULL);
+            (void)memset(buf, 'a', 40U);
+            (void)memcpy(&buf[at], seqs[k], slen);
+
+            assert(okj_validate_utf8_block(buf, 0U, 40U, 40U, &stop) == 1U);
+            assert(stop == 40U);
+
+            /* A lone continuation byte in place of the lead is rejected,
+             * and *stop reports where the ill-formed sequence starts. */
+            buf[at] = (char)0x80;
+            assert(okj_validate_utf8_block(buf, 0U, 40U, 40U, &stop) == 0U);
+            assert(stop == at);
+
+            free(buf);
+        }
+    }
+
+    printf("test_validate_utf8_block_ascii_and_multibyte passed!\n");
+}
+
+void test_validate_utf8_block_bounds(void)
+{
+    /* Only sequences that start before `end` are checked; the last may
+     * finish beyond it, but never beyond `len`. */
+    const char straddle[] = "abcdefg\xE2\x82\xAC";   /* lead at index 7 */
+    const char truncated[] = "abcdefghij\xF0\x9F\x98";
+    const char surrogate[] = "abcdefghij\xED\xA0\x80";
+    const char overlong[]  = "abcdefghij\xE0\x80\xAF";
+    OkjSize stop = 0U;
+
+    assert(okj_validate_utf8_block(straddle, 0U, 8U, 10U, &stop) == 1U);
+    assert(stop == 10U);
+
+    /* Nothing starts in [3, 3): no bytes are inspected at all. */
+    assert(okj_validate_utf8_block(straddle, 3U, 3U, 10U, &stop) == 1U);
+    assert(stop == 3U);
+
+    assert(okj_validate_utf8_block(truncated, 0U, 13U, 13U, &stop) == 0U);
+    assert(stop == 10U);
+
+    assert(okj_validate_utf8_block(surrogate, 0U, 13U, 13U, &stop) == 0U);
+    assert(stop == 10U);
+
+    assert(okj_validate_utf8_block(overlong, 0U, 13U, 13U, &stop) == 0U);
+    assert(stop == 10U);
+
+    printf("test_validate_utf8_block_bounds passed!\n");
+}
+
+void test_utf8_dfa_matches_rfc3629_table(void)
+{
+    /* Walk every lead byte through the DFA and check the two-byte prefix
+     * ranges of RFC 3629 section 4 (Table 3.7 of the Unicode standard): the
+     * first continuation byte that keeps the sequence alive must be exactly
+     * the listed range, and only for the listed leads. */
+    uint16_t b0;
+    uint16_t b1;
+
+    for (b0 = 0U; b0 < 256U; b0++)
+    {
+        uint8_t s0 = okj_utf8_transition[OKJ_UTF8_ACCEPT][okj_utf8_class[b0]];
+        uint16_t lo = 0x80U;
+        uint16_t hi = 0xBFU;
+        uint8_t multi = 1U;
+
+        if (b0 <= 0x7FU)
+        {
+            assert(s0 == OKJ_UTF8_ACCEPT);
+            multi = 0U;
+        }
+        else if ((b0 < 0xC2U) || (b0 > 0xF4U))
+        {
+            assert(s0 == OKJ_UTF8_REJECT);
+            multi = 0U;
+        }
+        else if (b0 == 0xE0U)
+        {
+            lo = 0xA0U;
+        }
+        else if (b0 == 0xEDU)
+        {
+            hi = 0x9FU;
+        }
+        else if (b0 == 0xF0U)
+        {
+            lo = 0x90U;
+        }
+        else if (b0 == 0xF4U)
+        {
+            hi = 0x8FU;
+        }
+        else
+        {
+            /* Unrestricted second byte. */
+        }
+
+        for (b1 = 0U; (multi == 1U) && (b1 < 256U); b1++)
+        {
+            uint8_t s1 = okj_utf8_transition[s0][okj_utf8_class[b1]];
+
+            assert((s1 != OKJ_UTF8_REJECT) == ((b1 >= lo) && (b1 <= hi)));
+        }
+    }
+
+    printf("test_utf8_dfa_matches_rfc3629_table passed!\n");
+}
+
+void test_char_class_table(void)
+{
+    /* Every byte maps to the class its token would start, and only the
+     * thirteen token-starting bytes map to anything but OKJ_CC_OTHER. */
+    uint16_t b;
+
+    for (b = 0U; b < 256U; b++)
+    {
+        char    c        = (char)b;
+        uint8_t expected = OKJ_CC_OTHER;
+
+        if (c == '{')      { expected = OKJ_CC_LBRACE; }
+        else if (c == '[') { expected = OKJ_CC_LBRACKET; }
+        else if (c == '}') { expected = OKJ_CC_RBRACE; }
+        else if (c == ']') { expected = OKJ_CC_RBRACKET; }
+        else if (c == ',') { expected = OKJ_CC_COMMA; }
+        else if (c == ':') { expected = OKJ_CC_COLON; }
+        else if (c == '"') { expected = OKJ_CC_QUOTE; }
+        else if ((okj_is_digit(c) != 0U) || (c == '-')) { expected = OKJ_CC_NUMBER; }
+        else if (c == 't') { expected = OKJ_CC_TRUE; }
+        else if (c == 'f') { expected = OKJ_CC_FALSE; }
+        else if (c == 'n') { expected = OKJ_CC_NULL; }
+        else { /* OKJ_CC_OTHER */ }
+
+        assert(okj_char_class[b] == expected);
+    }
+
+    printf("test_char_class_table passed!\n");
+}
+
+void test_grammar_action_table(void)
+{
+    /* Cross-check each (context, class) cell against the grammar rules
+     * stated as predicates. */
+    uint16_t ctx;
+    uint16_t cls;
+
+    for (ctx = 0U; ctx < OKJ_GRAMMAR_CONTEXTS; ctx++)
+    {
+        uint8_t want_value = ((ctx == (uint16_t)OKJ_CTX_WANT_VALUE) ||
+                              (ctx == (uint16_t)OKJ_CTX_WANT_VALUE_OR_CLOSE)) ? 1U : 0U;
+        uint8_t want_key   = ((ctx == (uint16_t)OKJ_CTX_WANT_KEY) ||
+                              (ctx == (uint16_t)OKJ_CTX_WANT_KEY_OR_CLOSE)) ? 1U : 0U;
+        uint8_t sep        = (ctx == (uint16_t)OKJ_CTX_WANT_SEP_OR_CLOSE) ? 1U : 0U;
+
+        for (cls = 0U; cls < OKJ_CHAR_CLASSES; cls++)
+        {
+            uint8_t expected = OKJ_ACT_SYNTAX;
+
+            if ((cls == OKJ_CC_LBRACE) && (want_value != 0U))        { expected = OKJ_ACT_OPEN_OBJECT; }
+            else if ((cls == OKJ_CC_LBRACKET) && (want_value != 0U)) { expected = OKJ_ACT_OPEN_ARRAY; }
+            else if ((cls == OKJ_CC_RBRACE) &&
+                     ((sep != 0U) || (ctx == (uint16_t)OKJ_CTX_WANT_KEY_OR_CLOSE)))
+            {
+                expected = OKJ_ACT_CLOSE_OBJECT;
+            }
+            else if ((cls == OKJ_CC_RBRACKET) &&
+                     ((sep != 0U) || (ctx == (uint16_t)OKJ_CTX_WANT_VALUE_OR_CLOSE)))
+            {
+                expected = OKJ_ACT_CLOSE_ARRAY;
+            }
+            else if ((cls == OKJ_CC_COMMA) && (sep != 0U))           { expected = OKJ_ACT_COMMA; }
+            else if ((cls == OKJ_CC_COLON) && (ctx == (uint16_t)OKJ_CTX_WANT_COLON)) { expected = OKJ_ACT_COLON; }
+            else if ((cls == OKJ_CC_QUOTE) && (want_key != 0U))      { expected = OKJ_ACT_KEY; }
+            else if ((cls == OKJ_CC_QUOTE) && (want_value != 0U))    { expected = OKJ_ACT_STRING; }
+            else if ((cls == OKJ_CC_NUMBER) && (want_value != 0U))   { expected = OKJ_ACT_NUMBER; }
+            else if ((cls == OKJ_CC_TRUE) && (want_value != 0U))     { expected = OKJ_ACT_TRUE; }
+            else if ((cls == OKJ_CC_FALSE) && (want_value != 0U))    { expected = OKJ_ACT_FALSE; }
+            else if ((cls == OKJ_CC_NULL) && (want_value != 0U))     { expected = OKJ_ACT_NULL; }
+            else { /* OKJ_ACT_SYNTAX */ }
+
+            assert(okj_grammar_action[ctx][cls] == expected);
+        }
+    }
+
+    printf("test_grammar_action_table passed!\n");
+}
+
+void test_parse_literal_prefix_is_syntax_error(void)
+{
+    /* The class table routes 't', 'f' and 'n' to the literal actions; a
+     * prefix that does not spell the full word is still a syntax error, as
+     * is a literal where a key is expected. */
+    static const char *docs[] = { "[tru]", "[fals]", "[nul]", "[t]", "[nulL]", "{true: 1}", "[x]" };
+    size_t k;
+
+    for (k = 0U; k < (sizeof(docs) / sizeof(docs[0])); k++)
+    {
+        OkJsonParser parser;
+        char buf[16];
+        uint16_t len = (uint16_t)strlen(docs[k]);
+
+        (void)memcpy(buf, docs[k], len);
+        okj_init(&parser, buf, len);
+        assert(okj_parse(&parser) == OKJ_ERROR_SYNTAX);
+    }
+
+    printf("test_parse_literal_prefix_is_syntax_error passed!\n");
+}
+
+void test_container_extent_recorded_on_close(void)
+{
+    /* Each closed container carries its full byte length, the index one
+     * past its last descendant and its direct child count. */
+    OkJsonParser parser;
+    char json_str[] = "{\"a\": [1, {\"b\": null}, []], \"c\": {}, \"d\": \"]}\"}";
+
+    okj_init(&parser, json_str, (uint16_t)(sizeof(json_str) - 1U));
+
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(parser.token_count == 12U);
+
+    /* [0] root object: members a, c, d */
+    assert(okj_tok_type(&parser, 0) == OKJ_OBJECT);
+    assert(okj_tok_length(&parser, 0) == (uint16_t)(sizeof(json_str) - 1U));
+    assert(okj_tok_end(&parser, 0) == 12U);
+    assert(okj_tok_count(&parser, 0) == 3U);
+
+    /* [2] the array under "a": elements 1, {...}, [] */
+    assert(okj_tok_type(&parser, 2) == OKJ_ARRAY);
+    assert(okj_tok_length(&parser, 2) == 20U);          /* [1, {"b": null}, []] */
+    assert(okj_tok_end(&parser, 2) == 8U);
+    assert(okj_tok_count(&parser, 2) == 3U);
+
+    /* [4] nested object with one member, [7] empty array */
+    assert(okj_tok_type(&parser, 4) == OKJ_OBJECT);
+    assert(okj_tok_length(&parser, 4) == 11U);          /* {"b": null} */
+    assert(okj_tok_end(&parser, 4) == 7U);
+    assert(okj_tok_count(&parser, 4) == 1U);
+    assert(okj_tok_type(&parser, 7) == OKJ_ARRAY);
+    assert(okj_tok_length(&parser, 7) == 2U);
+    assert(okj_tok_end(&parser, 7) == 8U);
+    assert(okj_tok_count(&parser, 7) == 0U);
+
+    /* [9] empty object under "c" */
+    assert(okj_tok_type(&parser, 9) == OKJ_OBJECT);
+    assert(okj_tok_length(&parser, 9) == 2U);
+    assert(okj_tok_end(&parser, 9) == 10U);
+    assert(okj_tok_count(&parser, 9) == 0U);
+
+    /* Scalars carry neither */
+    assert(okj_tok_type(&parser, 11) == OKJ_STRING);
+    assert(okj_tok_end(&parser, 11) == 0U);
+    assert(okj_tok_count(&parser, 11) == 0U);
+
+    printf("test_container_extent_recorded_on_close passed!\n");
+}
+
+void test_container_extent_matches_rescan(void)
+{
+    /* The recorded fields agree with the text-rescanning helpers they
+     * replace on the getter path, including brackets inside strings. */
+    OkJsonParser parser;
+    char json_str[] = "[{\"k\": \"[,]\", \"v\": [[], [{}], \"x\"]}, 2, [3, [4, 5]], \"{\"]";
+    const char *end = json_str + sizeof(json_str) - 1U;
+    uint16_t i;
+    uint16_t checked = 0U;
+
+    okj_init(&parser, json_str, (uint16_t)(sizeof(json_str) - 1U));
+
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    for (i = 0U; i < parser.token_count; i++)
+    {
+        OkJsonToken t;
+
+        assert(okj_token_at(&parser, i, &t) == OKJ_SUCCESS);
+
+        if (t.type == OKJ_ARRAY)
+        {
+            assert(t.count  == okj_count_array_elements(t.start, end));
+            assert(t.length == okj_measure_container(t.start, end));
+            checked++;
+        }
+        else if (t.type == OKJ_OBJECT)
+        {
+            assert(t.count  == okj_count_object_members(t.start, end));
+            assert(t.length == okj_measure_container(t.start, end));
+            checked++;
+        }
+        else
+        {
+            /* Scalars are not containers. */
+        }
+    }
+
+    assert(checked == 8U);
+
+    printf("test_container_extent_matches_rescan passed!\n");
+}
+
+void test_container_getters_use_recorded_extent(void)
+{
+    /* okj_get_array/okj_get_object and the _raw variants report the
+     * recorded count and length, and okj_get_token copies end and count. */
+    OkJsonParser parser;
+    OkJsonArray  arr;
+    OkJsonObject obj;
+    OkJsonToken  tok;
+    char json_str[] = "{\"list\": [10, 20, 30], \"obj\": {\"x\": 1, \"y\": [2]}}";
+
+    okj_init(&parser, json_str, (uint16_t)(sizeof(json_str) - 1U));
+
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(okj_get_array(&parser, "list", 4U, &arr) == OKJ_SUCCESS);
+    assert(arr.count == 3U);
+    assert(arr.length == 12U);
+
+    assert(okj_get_object(&parser, "obj", 3U, &obj) == OKJ_SUCCESS);
+    assert(obj.count == 2U);
+    assert(obj.length == 18U);
+
+    assert(okj_get_array_raw(&parser, "list", 4U, &arr) == OKJ_SUCCESS);
+    assert((arr.count == 3U) && (arr.length == 12U));
+
+    assert(okj_get_object_raw(&parser, "obj", 3U, &obj) == OKJ_SUCCESS);
+    assert((obj.count == 2U) && (obj.length == 18U));
+
+    assert(okj_get_token(&parser, "obj", 3U, &tok) == OKJ_SUCCESS);
+    assert(tok.type == OKJ_OBJECT);
+    assert(tok.length == 18U);
+    assert(tok.count == 2U);
+    assert(tok.end == parser.token_count);
+
+    printf("test_container_getters_use_recorded_extent passed!\n");
+}
+
+void test_container_extent_unclosed_fallback(void)
+{
+    /* Containers left open by a failed parse keep length 1 and end 0;
+     * okj_container_extent() then falls back to rescanning the text. */
+    OkJsonParser parser;
+    OkjSize count  = 0U;
+    OkjSize length = 0U;
+    char json_str[] = "{\"a\": [1, 2, {\"b\": 3}], \"c\": tru}";
+
+    okj_init(&parser, json_str, (uint16_t)(sizeof(json_str) - 1U));
+
+    assert(okj_parse(&parser) != OKJ_SUCCESS);
+
+    assert(okj_tok_type(&parser, 0) == OKJ_OBJECT);
+    assert(okj_tok_end(&parser, 0) == 0U);
+    assert(okj_tok_length(&parser, 0) == 1U);
+    assert(okj_tok_count(&parser, 0) == 2U);             /* keys seen so far */
+
+    assert(okj_tok_type(&parser, 2) == OKJ_ARRAY);        /* closed before the error */
+    assert(okj_tok_end(&parser, 2) == 8U);
+    assert(okj_tok_count(&parser, 2) == 3U);
+
+    okj_container_extent(&parser, 0U, &count, &length);
+    assert(count == 2U);
+    assert(length == (uint16_t)(sizeof(json_str) - 1U));
+
+    printf("test_container_extent_unclosed_fallback passed!\n");
+}
+
+void test_token_at_copies_tokens(void)
+{
+    /* okj_token_at() returns the same fields the getters report, in either
+     * token layout. */
+    OkJsonParser parser;
+    OkJsonToken  tok;
+    char json_str[] = "{\"id\": 7, \"tags\": [\"a\", \"b\"]}";
+
+    okj_init(&parser, json_str, (uint16_t)(sizeof(json_str) - 1U));
+
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(parser.token_count == 7U);
+
+    assert(okj_token_at(&parser, 0U, &tok) == OKJ_SUCCESS);
+    assert(tok.type == OKJ_OBJECT);
+    assert(tok.start == json_str);
+    assert(tok.length == (uint16_t)(sizeof(json_str) - 1U));
+    assert((tok.end == 7U) && (tok.count == 2U));
+
+    assert(okj_token_at(&parser, 2U, &tok) == OKJ_SUCCESS);
+    assert(tok.type == OKJ_NUMBER);
+    assert((tok.start == &json_str[7]) && (tok.length == 1U));
+    assert((tok.end == 0U) && (tok.count == 0U));
+
+    assert(okj_token_at(&parser, 6U, &tok) == OKJ_SUCCESS);
+    assert(tok.type == OKJ_STRING);
+    assert((tok.start[0] == 'b') && (tok.length == 1U));
+
+    printf("test_token_at_copies_tokens passed!\n");
+}
+
+void test_token_at_bad_args(void)
+{
+    OkJsonParser parser;
+    OkJsonToken  tok;
+    char json_str[] = "[1]";
+
+    okj_init(&parser, json_str, (uint16_t)(sizeof(json_str) - 1U));
+
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(okj_token_at(NULL, 0U, &tok) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_token_at(&parser, 0U, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_token_at(&parser, 2U, &tok) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_token_at(&parser, OKJ_MAX_TOKENS, &tok) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_token_at_bad_args passed!\n");
+}
+
+void test_token_tape_size(void)
+{
+    /* One type byte plus four OkjSize fields per token, with no padding. */
+    assert(sizeof(OkJsonTape) == (OKJ_MAX_TOKENS * (1U + (4U * sizeof(OkjSize)))));
+    assert(sizeof(OkJsonTape) < sizeof(OkJsonToken[OKJ_MAX_TOKENS]));
+
+    printf("test_token_tape_size passed!\n");
+}
+
+void test_init_ex_bad_args(void)
+{
+    OkJsonParser  parser;
+    OkJsonToken   tokens[4];
+    OkjDepthFrame depth[2];
+    char json_str[] = "[1]";
+
+    assert(okj_init_ex(NULL, json_str, 3U, tokens, 4U, depth, 2U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_init_ex(&parser, NULL, 3U, tokens, 4U, depth, 2U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_init_ex(&parser, json_str, 3U, NULL, 4U, depth, 2U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_init_ex(&parser, json_str, 3U, tokens, 4U, NULL, 2U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_init_ex(&parser, json_str, 3U, tokens, 0U, depth, 2U) == OKJ_ERROR_NO_FREE_SPACE);
+    assert(okj_init_ex(&parser, json_str, 3U, tokens, 4U, depth, 0U) == OKJ_ERROR_NO_FREE_SPACE);
+
+    assert(okj_init_ex(&parser, json_str, 3U, tokens, 4U, depth, 2U) == OKJ_SUCCESS);
+    assert(parser.token_buf == tokens);
+    assert(parser.depth_buf == depth);
+    assert(parser.token_capacity == 4U);
+    assert(parser.depth_capacity == 2U);
+
+    printf("test_init_ex_bad_args passed!\n");
+}
+
+void test_init_ex_small_buffers_enforced(void)
+{
+    /* A heartbeat-sized parser: three tokens, one level of nesting. */
+    OkJsonParser  parser;
+    OkJsonToken   tokens[3];
+    OkjDepthFrame depth[1];
+    char fits[]      = "[1]";
+    char too_many[]  = "[1, 2, 3]";
+    char too_deep[]  = "[[1]]";
+
+    assert(okj_init_ex(&parser, fits, (uint16_t)(sizeof(fits) - 1U), tokens, 3U, depth, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(parser.token_count == 2U);
+    assert((tokens[0].type == OKJ_ARRAY) && (tokens[0].count == 1U) && (tokens[0].end == 2U));
+    assert((tokens[1].type == OKJ_NUMBER) && (tokens[1].start == &fits[1]));
+
+    assert(okj_init_ex(&parser, too_many, (uint16_t)(sizeof(too_many) - 1U), tokens, 3U, depth, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_TOKENS_EXCEEDED);
+
+    assert(okj_init_ex(&parser, too_deep, (uint16_t)(sizeof(too_deep) - 1U), tokens, 3U, depth, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_DEPTH_EXCEEDED);
+
+    printf("test_init_ex_small_buffers_enforced passed!\n");
+}
+
+void test_init_ex_large_buffers(void)
+{
+    /* More tokens than OKJ_MAX_TOKENS and deeper than OKJ_MAX_DEPTH, with
+     * key lookups that land past index OKJ_MAX_TOKENS. */
+    static OkJsonToken tokens[512];
+    OkjDepthFrame depth[32];
+    OkJsonParser  parser;
+    OkJsonNumber  num;
+    OkJsonArray   arr;
+    char json[2048];
+    uint16_t len = 0U;
+    uint16_t i;
+
+    json[len++] = '{';
+    for (i = 0U; i < 150U; i++)
+    {
+        len = (uint16_t)(len + (uint16_t)snprintf(&json[len], sizeof(json) - len, "\"k%u\": %u, ", (unsigned int)i, (unsigned int)i));
+    }
+    len = (uint16_t)(len + (uint16_t)snprintf(&json[len], sizeof(json) - len, "\"deep\": "));
+    for (i = 0U; i < 24U; i++)
+    {
+        json[len++] = '[';
+    }
+    json[len++] = '7';
+    for (i = 0U; i < 24U; i++)
+    {
+        json[len++] = ']';
+    }
+    json[len++] = '}';
+
+    assert(okj_init_ex(&parser, json, len, tokens, 512U, depth, 32U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(parser.token_count == (uint16_t)(1U + (150U * 2U) + 1U + 24U + 1U));
+    assert(okj_tok_count(&parser, 0U) == 151U);
+
+    assert(okj_get_number(&parser, "k149", 4U, &num) == OKJ_SUCCESS);
+    assert((num.length == 3U) && (num.start[0] == '1') && (num.start[2] == '9'));
+
+    assert(okj_get_array(&parser, "deep", 4U, &arr) == OKJ_SUCCESS);
+    assert((arr.count == 1U) && (arr.length == 49U));
+
+    assert(okj_get_number(&parser, "k150", 4U, &num) == OKJ_ERROR_BAD_NUMBER);
+
+    /* The embedded limits still apply to okj_init() parsers. */
+    okj_init(&parser, json, len);
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_TOKENS_EXCEEDED);
+
+    printf("test_init_ex_large_buffers passed!\n");
+}
+
+void test_size_type_width(void)
+{
+    /* OkjSize and the input limit widen together. */
+#ifdef OK_JSON_LARGE_DOCS
+    assert(sizeof(OkjSize) == 4U);
+    assert(OKJ_MAX_JSON_LEN > 0xFFFFU);
+#else
+    assert(sizeof(OkjSize) == 2U);
+    assert(OKJ_MAX_JSON_LEN == 4096U);
+#endif
+    assert(OKJ_NOT_FOUND == OKJ_SIZE_MAX);
+
+    printf("test_size_type_width passed!\n");
+}
+
+void test_large_docs_past_64k(void)
+{
+    /* {"pad": [0, 1, ..., 29999], "last": 5} is about 190 KB, so offsets,
+     * lengths and token indices all pass 0xFFFF. */
+#ifdef OK_JSON_LARGE_DOCS
+    const OkjSize   n      = 30000U;
+    const OkjSize   cap    = 32768U;
+    const OkjSize   size   = 256U * 1024U;
+    char           *json   = (char *)malloc(size);
+    OkJsonToken    *tokens = (OkJsonToken *)malloc(cap * sizeof(OkJsonToken));
+    OkjDepthFrame   depth[4];
+    OkJsonParser    parser;
+    OkJsonArray     arr;
+    OkJsonNumber    num;
+    OkjSize         len = 0U;
+    OkjSize         i;
+
+    assert((json != NULL) && (tokens != NULL));
+
+    len = (OkjSize)(len + (OkjSize)snprintf(&json[len], size - len, "{\"pad\": ["));
+    for (i = 0U; i < n; i++)
+    {
+        len = (OkjSize)(len + (OkjSize)snprintf(&json[len], size - len, "%s%u", (i == 0U) ? "" : ", ", (unsigned int)i));
+    }
+    len = (OkjSize)(len + (OkjSize)snprintf(&json[len], size - len, "], \"last\": 5}"));
+    assert(len > 0xFFFFU);
+
+    assert(okj_init_ex(&parser, json, len, tokens, cap, depth, 4U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(parser.token_count == (n + 5U));
+    assert(okj_tok_length(&parser, 0U) == len);
+    assert(okj_tok_end(&parser, 2U) == (n + 3U));
+    assert(okj_tok_count(&parser, 2U) == n);
+
+    /* okj_get_array() would refuse more than OKJ_MAX_ARRAY_SIZE elements. */
+    assert(okj_get_array_raw(&parser, "pad", 3U, &arr) == OKJ_SUCCESS);
+    assert((arr.count == n) && (arr.length == (OkjSize)(len - 20U)));
+    assert(okj_get_number(&parser, "last", 4U, &num) == OKJ_SUCCESS);
+    assert((num.length == 1U) && ((OkjSize)(num.start - json) == (OkjSize)(len - 2U)));
+
+    free(tokens);
+    free(json);
+#endif /* OK_JSON_LARGE_DOCS */
+
+    printf("test_large_docs_past_64k passed!\n");
+}
+
+void test_find_member_scoped(void)
+{
+    /* Tokens: 0 {  1 "a"  2 {  3 "id"  4 1  5 "b"  6 "id"  7 "id"  8 2
+     * A whole-document scan meets the nested "id" (3) first; the scoped
+     * lookup only sees the root's keys 1, 5 and 7. */
+    OkJsonParser parser;
+    OkJsonNumber num;
+    OkjSize idx = 0U;
+    char json_str[] = "{\"a\": {\"id\": 1}, \"b\": \"id\", \"id\": 2}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(okj_get_number(&parser, "id", 2U, &num) == OKJ_SUCCESS);
+    assert(num.start[0] == '1');
+
+    assert(okj_find_member(&parser, 0U, "id", 2U, &idx) == OKJ_SUCCESS);
+    assert(idx == 8U);
+    assert(okj_find_member(&parser, 2U, "id", 2U, &idx) == OKJ_SUCCESS);
+    assert(idx == 4U);
+    assert(okj_find_member(&parser, 0U, "b", 1U, &idx) == OKJ_SUCCESS);
+    assert(idx == 6U);
+
+    idx = 99U;
+    assert(okj_find_member(&parser, 2U, "b", 1U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_member(&parser, 0U, "i", 1U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(idx == 99U);
+
+    printf("test_find_member_scoped passed!\n");
+}
+
+void test_find_member_skips_containers(void)
+{
+    /* Keys inside array elements and nested objects are jumped over whole. */
+    OkJsonParser parser;
+    OkJsonToken  tok;
+    char json_str[] = "{\"arr\": [{\"k\": 1}, [\"k\"]], \"o\": {\"p\": {\"k\": 3}}, \"k\": true}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(okj_get_member(&parser, 0U, "k", 1U, &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_BOOLEAN) && (tok.length == 4U));
+
+    assert(okj_get_member(&parser, 0U, "o", 1U, &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_OBJECT) && (tok.count == 1U));
+
+    printf("test_find_member_skips_containers passed!\n");
+}
+
+void test_find_member_bad_args(void)
+{
+    OkJsonParser parser;
+    OkJsonToken  tok;
+    OkjSize idx = 0U;
+    char json_str[]  = "{\"a\": [1], \"b\": 2}";
+    char truncated[]  = "{\"a\": {\"b\": 1}, \"c\": ";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(okj_find_member(NULL, 0U, "a", 1U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_member(&parser, 0U, NULL, 1U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_member(&parser, 0U, "a", 1U, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_member(&parser, parser.token_count, "a", 1U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_get_member(&parser, 0U, "a", 1U, NULL) == OKJ_ERROR_BAD_POINTER);
+
+    /* Token 2 is an array, token 1 a string. */
+    assert(okj_find_member(&parser, 2U, "a", 1U, &idx) == OKJ_ERROR_BAD_OBJECT);
+    assert(okj_get_member(&parser, 1U, "a", 1U, &tok) == OKJ_ERROR_BAD_OBJECT);
+
+    /* The root was never closed; the nested object was. */
+    okj_init(&parser, truncated, (OkjSize)(sizeof(truncated) - 1U));
+    assert(okj_parse(&parser) != OKJ_SUCCESS);
+    assert(okj_find_member(&parser, 0U, "a", 1U, &idx) == OKJ_ERROR_BAD_OBJECT);
+    assert(okj_find_member(&parser, 2U, "b", 1U, &idx) == OKJ_SUCCESS);
+    assert(idx == 4U);
+
+    printf("test_find_member_bad_args passed!\n");
+}
+
+void test_hash_matches_scan(void)
+{
+    /* Every string in each document, used as a key, must resolve to the same
+     * token with and without the index, both document-wide and per object.
+     * The documents repeat keys across objects, reuse keys as string values
+     * and contain duplicate keys. */
+    static char docs[4][96] = {
+        "{\"a\": 1, \"b\": {\"a\": 2, \"c\": \"a\"}, \"c\": [\"b\", {\"a\": 3}], \"a\": 4}",
+        "[\"x\", {\"x\": \"y\"}, {\"y\": {\"x\": null}}, \"y\"]",
+        "{\"\": 0, \"k\": {\"\": 1}, \"kk\": true, \"k\": false}",
+        "{\"a\": 1, \"b\": {\"c\": tru"
+    };
+    OkJsonParser  plain;
+    OkJsonParser  hashed;
+    OkjHashIndex  hash;
+    OkjHashSlot   slots[64];
+    size_t d;
+
+    for (d = 0U; d < (sizeof(docs) / sizeof(docs[0])); d++)
+    {
+        OkjSize len = (OkjSize)strlen(docs[d]);
+        OkjError rc;
+        OkjSize i;
+
+        okj_init(&plain, docs[d], len);
+        rc = okj_parse(&plain);
+        okj_init(&hashed, docs[d], len);
+        assert(okj_hash_attach(&hashed, &hash, slots, 64U) == OKJ_SUCCESS);
+        assert(okj_parse(&hashed) == rc);
+
+        for (i = 0U; i < plain.token_count; i++)
+        {
+            const char *key = okj_tok_start(&plain, i);
+            uint16_t    key_len = (uint16_t)okj_tok_length(&plain, i);
+            OkJsonToken a;
+            OkJsonToken b;
+            OkjSize o;
+
+            if (okj_tok_type(&plain, i) != OKJ_STRING)
+            {
+                continue;
+            }
+
+            rc = okj_get_token(&plain, key, key_len, &a);
+            assert(okj_get_token(&hashed, key, key_len, &b) == rc);
+            assert((rc != OKJ_SUCCESS) || (a.start == b.start));
+
+            for (o = 0U; o < plain.token_count; o++)
+            {
+                OkjSize ia = 0U;
+                OkjSize ib = 0U;
+
+                rc = okj_find_member(&plain, o, key, key_len, &ia);
+                assert(okj_find_member(&hashed, o, key, key_len, &ib) == rc);
+                assert(ia == ib);
+            }
+        }
+
+        assert(hash.state == OKJ_HASH_READY);
+    }
+
+    printf("test_hash_matches_scan passed!\n");
+}
+
+void test_hash_build_timing(void)
+{
+    /* Attached before okj_parse() the table is filled by the parse; attached
+     * after, by the first lookup. */
+    OkJsonParser parser;
+    OkjHashIndex hash;
+    OkjHashSlot  slots[16];
+    OkJsonNumber num;
+    char json_str[]  = "{\"a\": 1, \"b\": 2}";
+    char truncated[] = "{\"a\": 1, \"b\": ";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_hash_attach(&parser, &hash, slots, 16U) == OKJ_SUCCESS);
+    assert(hash.state == OKJ_HASH_UNBUILT);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(hash.state == OKJ_HASH_READY);
+    assert(hash.used == 4U);                    /* two scoped, two first-occurrence */
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(parser.hash == NULL);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_hash_attach(&parser, &hash, slots, 16U) == OKJ_SUCCESS);
+    assert(hash.state == OKJ_HASH_UNBUILT);
+    assert(okj_get_number(&parser, "b", 1U, &num) == OKJ_SUCCESS);
+    assert((hash.state == OKJ_HASH_READY) && (num.start[0] == '2'));
+
+    /* A failed parse leaves the table to be rebuilt on the next lookup. */
+    okj_init(&parser, truncated, (OkjSize)(sizeof(truncated) - 1U));
+    assert(okj_hash_attach(&parser, &hash, slots, 16U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) != OKJ_SUCCESS);
+    assert(hash.state == OKJ_HASH_UNBUILT);
+    assert(okj_get_number(&parser, "a", 1U, &num) == OKJ_SUCCESS);
+    assert(hash.state == OKJ_HASH_READY);
+
+    printf("test_hash_build_timing passed!\n");
+}
+
+void test_hash_too_small_falls_back(void)
+{
+    /* Two slots hold one entry; the build gives up and lookups scan. */
+    OkJsonParser parser;
+    OkjHashIndex hash;
+    OkjHashSlot  slots[2];
+    OkjSize idx = 0U;
+    char json_str[] = "{\"a\": 1, \"b\": {\"a\": 2}}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_hash_attach(&parser, &hash, slots, 2U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(hash.state == OKJ_HASH_FULL);
+
+    assert(okj_find_member(&parser, 4U, "a", 1U, &idx) == OKJ_SUCCESS);
+    assert(idx == 6U);
+    assert(okj_find_member(&parser, 0U, "a", 1U, &idx) == OKJ_SUCCESS);
+    assert(idx == 2U);
+
+    printf("test_hash_too_small_falls_back passed!\n");
+}
+
+void test_hash_attach_bad_args(void)
+{
+    OkJsonParser parser;
+    OkjHashIndex hash;
+    OkjHashSlot  slots[8];
+    char json_str[] = "{}";
+
+    okj_init(&parser, json_str, 2U);
+
+    assert(okj_hash_attach(NULL, &hash, slots, 8U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_hash_attach(&parser, NULL, slots, 8U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_hash_attach(&parser, &hash, NULL, 8U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_hash_attach(&parser, &hash, slots, 0U) == OKJ_ERROR_NO_FREE_SPACE);
+    assert(okj_hash_attach(&parser, &hash, slots, 1U) == OKJ_ERROR_NO_FREE_SPACE);
+    assert(okj_hash_attach(&parser, &hash, slots, 6U) == OKJ_ERROR_NO_FREE_SPACE);
+    assert(parser.hash == NULL);
+
+    printf("test_hash_attach_bad_args passed!\n");
+}
+
+static void get_many_fill(OkjGetRequest *req, const char *key, OkJsonType type)
+{
+    req->key     = key;
+    req->key_len = (uint16_t)strlen(key);
+    req->type    = type;
+}
+
+void test_get_many_resolves_batch(void)
+{
+    OkJsonParser  parser;
+    OkjGetRequest req[9];
+    OkJsonString  str;
+    OkJsonNumber  num;
+    char json_str[] = "{\"name\": \"n1\", \"n\": 42, \"ok\": true, \"list\": [1, 2, 3],"
+                      " \"obj\": {\"n\": 7}, \"nil\": null}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    get_many_fill(&req[0], "name", OKJ_STRING);
+    get_many_fill(&req[1], "n",    OKJ_NUMBER);
+    get_many_fill(&req[2], "ok",   OKJ_BOOLEAN);
+    get_many_fill(&req[3], "list", OKJ_ARRAY);
+    get_many_fill(&req[4], "obj",  OKJ_OBJECT);
+    get_many_fill(&req[5], "nil",  OKJ_UNDEFINED);
+    get_many_fill(&req[6], "n",    OKJ_STRING);     /* wrong type        */
+    get_many_fill(&req[7], "none", OKJ_NUMBER);     /* missing           */
+    get_many_fill(&req[8], "none", OKJ_UNDEFINED);  /* missing, any type */
+
+    assert(okj_get_many(&parser, req, 9U) == OKJ_ERROR_BAD_STRING);
+
+    assert(okj_get_string(&parser, "name", 4U, &str) == OKJ_SUCCESS);
+    assert((req[0].status == OKJ_SUCCESS) && (req[0].value.start == str.start));
+    assert(okj_get_number(&parser, "n", 1U, &num) == OKJ_SUCCESS);
+    assert((req[1].status == OKJ_SUCCESS) && (req[1].value.start == num.start));
+    assert((req[2].status == OKJ_SUCCESS) && (req[2].value.length == 4U));
+    assert((req[3].status == OKJ_SUCCESS) && (req[3].value.count == 3U) && (req[3].value.length == 9U));
+    assert((req[4].status == OKJ_SUCCESS) && (req[4].value.count == 1U));
+    assert((req[5].status == OKJ_SUCCESS) && (req[5].value.type == OKJ_NULL));
+    assert(req[6].status == OKJ_ERROR_BAD_STRING);
+    assert(req[7].status == OKJ_ERROR_BAD_NUMBER);
+    assert(req[8].status == OKJ_ERROR_BAD_POINTER);
+
+    assert(okj_get_many(&parser, req, 6U) == OKJ_SUCCESS);
+
+    printf("test_get_many_resolves_batch passed!\n");
+}
+
+void test_get_many_first_match_and_hash(void)
+{
+    /* "b" first appears as a string value, so like okj_get_token() the
+     * batch resolves it to the token after that value.  The hashed and
+     * scanning paths must agree, with duplicate and NULL keys mixed in. */
+    OkJsonParser  parser;
+    OkjHashIndex  hash;
+    OkjHashSlot   slots[32];
+    OkjGetRequest plain[4];
+    OkjGetRequest hashed[4];
+    OkJsonToken   tok;
+    uint16_t r;
+    char json_str[] = "{\"a\": \"b\", \"c\": {\"b\": 1}, \"b\": 2}";
+
+    get_many_fill(&plain[0], "b", OKJ_UNDEFINED);
+    get_many_fill(&plain[1], "b", OKJ_NUMBER);
+    get_many_fill(&plain[2], "a", OKJ_STRING);
+    get_many_fill(&plain[3], "", OKJ_UNDEFINED);
+    plain[3].key = NULL;
+    (void)memcpy(hashed, plain, sizeof(plain));
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_get_many(&parser, plain, 4U) == OKJ_ERROR_BAD_NUMBER);
+
+    assert(okj_get_token(&parser, "b", 1U, &tok) == OKJ_SUCCESS);
+    assert((plain[0].status == OKJ_SUCCESS) && (plain[0].value.start == tok.start));
+    assert(tok.type == OKJ_STRING);                 /* the "c" key */
+    assert(plain[3].status == OKJ_ERROR_BAD_POINTER);
+
+    assert(okj_hash_attach(&parser, &hash, slots, 32U) == OKJ_SUCCESS);
+    assert(okj_get_many(&parser, hashed, 4U) == OKJ_ERROR_BAD_NUMBER);
+
+    for (r = 0U; r < 4U; r++)
+    {
+        assert(hashed[r].status == plain[r].status);
+        assert((hashed[r].status != OKJ_SUCCESS) || (hashed[r].value.start == plain[r].value.start));
+    }
+
+    printf("test_get_many_first_match_and_hash passed!\n");
+}
+
+void test_get_many_spans_several_passes(void)
+{
+    /* More requests than one hash-table pass takes, each key asked for
+     * several times and two of them absent, against the single getters. */
+    OkJsonParser  parser;
+    OkjGetRequest req[40];
+    OkJsonNumber  num;
+    static const char *const keys[10] = {
+        "k0", "k1", "k2", "k3", "k4", "k5", "k6", "k7", "k8", "k9"
+    };
+    uint16_t r;
+    char json_str[] = "{\"k0\": 0, \"k1\": 1, \"k2\": 2, \"k3\": 3,"
+                      " \"k4\": 4, \"k5\": 5, \"k6\": 6, \"k7\": 7}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    for (r = 0U; r < 40U; r++)
+    {
+        get_many_fill(&req[r], keys[r % 10U], OKJ_NUMBER);
+    }
+
+    assert(okj_get_many(&parser, req, 40U) == OKJ_ERROR_BAD_NUMBER);
+
+    for (r = 0U; r < 40U; r++)
+    {
+        if ((r % 10U) < 8U)
+        {
+            assert(okj_get_number(&parser, keys[r % 10U], 2U, &num) == OKJ_SUCCESS);
+            assert((req[r].status == OKJ_SUCCESS) && (req[r].value.start == num.start));
+        }
+        else
+        {
+            assert(req[r].status == OKJ_ERROR_BAD_NUMBER);
+        }
+    }
+
+    printf("test_get_many_spans_several_passes passed!\n");
+}
+
+void test_get_many_bad_args(void)
+{
+    OkJsonParser  parser;
+    OkjGetRequest req[1];
+    char json_str[] = "{\"a\": 1}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    get_many_fill(&req[0], "a", OKJ_NUMBER);
+    assert(okj_get_many(NULL, req, 1U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_get_many(&parser, NULL, 1U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_get_many(&parser, req, 0U) == OKJ_SUCCESS);
+
+    printf("test_get_many_bad_args passed!\n");
+}
+
+void test_key_handle_init(void)
+{
+    OkjKey key;
+    char long_key[OKJ_MAX_STRING_LEN + 2U];
+
+    assert(OKJ_KEY(&key, "abcdefghij") == OKJ_SUCCESS);
+    assert(key.length == 10U);
+    assert(key.prefix == (okj_u64)0x6867666564636261ULL);
+
+    assert(OKJ_KEY(&key, "ab") == OKJ_SUCCESS);
+    assert((key.length == 2U) && (key.prefix == 0x6261U));
+
+    (void)memset(long_key, 'k', sizeof(long_key));
+    assert(okj_key_init(&key, long_key, OKJ_MAX_STRING_LEN) == OKJ_SUCCESS);
+    assert(okj_key_init(&key, long_key, (uint16_t)(OKJ_MAX_STRING_LEN + 1U)) ==
+           OKJ_ERROR_MAX_STR_LEN_EXCEEDED);
+    assert(okj_key_init(NULL, "a", 1U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_key_init(&key, NULL, 1U) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_key_handle_init passed!\n");
+}
+
+void test_key_getters_match_raw_keys(void)
+{
+    /* Each _key getter must return exactly what its raw-key counterpart
+     * does, with and without a hash index, including keys that share an
+     * eight-byte prefix and differ only past it. */
+    OkJsonParser  parser;
+    OkjHashIndex  hash;
+    OkjHashSlot   slots[64];
+    OkJsonString  str;
+    OkJsonNumber  num;
+    OkJsonBoolean bln;
+    OkJsonArray   arr;
+    OkJsonObject  obj;
+    OkJsonToken   tok;
+    OkjKey k_name, k_long_a, k_long_b, k_ok, k_list, k_obj, k_missing;
+    OkjSize idx = 0U;
+    uint8_t pass;
+    char json_str[] = "{\"name\": \"n1\", \"prefix_shared_a\": 1, \"prefix_shared_b\": 2,"
+                      " \"ok\": false, \"list\": [1, 2], \"obj\": {\"ok\": true}}";
+
+    assert(OKJ_KEY(&k_name,    "name") == OKJ_SUCCESS);
+    assert(OKJ_KEY(&k_long_a,  "prefix_shared_a") == OKJ_SUCCESS);
+    assert(OKJ_KEY(&k_long_b,  "prefix_shared_b") == OKJ_SUCCESS);
+    assert(OKJ_KEY(&k_ok,      "ok") == OKJ_SUCCESS);
+    assert(OKJ_KEY(&k_list,    "list") == OKJ_SUCCESS);
+    assert(OKJ_KEY(&k_obj,     "obj") == OKJ_SUCCESS);
+    assert(OKJ_KEY(&k_missing, "prefix_shared_c") == OKJ_SUCCESS);
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    for (pass = 0U; pass < 2U; pass++)
+    {
+        if (pass == 1U)
+        {
+            assert(okj_hash_attach(&parser, &hash, slots, 64U) == OKJ_SUCCESS);
+        }
+
+        assert(okj_get_string_key(&parser, &k_name, &str) == OKJ_SUCCESS);
+        assert((str.length == 2U) && (memcmp(str.start, "n1", 2U) == 0));
+
+        assert(okj_get_number_key(&parser, &k_long_a, &num) == OKJ_SUCCESS);
+        assert(num.start[0] == '1');
+        assert(okj_get_number_key(&parser, &k_long_b, &num) == OKJ_SUCCESS);
+        assert(num.start[0] == '2');
+        assert(okj_get_number_key(&parser, &k_missing, &num) == OKJ_ERROR_BAD_NUMBER);
+        assert(okj_get_number_key(&parser, &k_name, &num) == OKJ_ERROR_BAD_NUMBER);
+
+        assert(okj_get_boolean_key(&parser, &k_ok, &bln) == OKJ_SUCCESS);
+        assert(bln.length == 5U);
+
+        assert(okj_get_array_key(&parser, &k_list, &arr) == OKJ_SUCCESS);
+        assert((arr.count == 2U) && (arr.start[0] == '['));
+        assert(okj_get_array_key(&parser, &k_obj, &arr) == OKJ_ERROR_BAD_ARRAY);
+
+        assert(okj_get_object_key(&parser, &k_obj, &obj) == OKJ_SUCCESS);
+        assert(obj.count == 1U);
+        assert(okj_get_object_key(&parser, &k_list, &obj) == OKJ_ERROR_BAD_OBJECT);
+
+        assert(okj_get_token_key(&parser, &k_missing, &tok) == OKJ_ERROR_BAD_POINTER);
+        assert(okj_get_token_key(&parser, &k_long_b, &tok) == OKJ_SUCCESS);
+        assert(okj_get_number(&parser, "prefix_shared_b", 15U, &num) == OKJ_SUCCESS);
+        assert((tok.type == OKJ_NUMBER) && (tok.start == num.start));
+
+        /* Scoped: the nested "ok" is found only inside "obj". */
+        assert(okj_find_member_key(&parser, 0U, &k_ok, &idx) == OKJ_SUCCESS);
+        assert(okj_tok_length(&parser, idx) == 5U);
+        assert(okj_find_member(&parser, 0U, "obj", 3U, &idx) == OKJ_SUCCESS);
+        assert(okj_find_member_key(&parser, idx, &k_ok, &idx) == OKJ_SUCCESS);
+        assert(okj_tok_length(&parser, idx) == 4U);
+        assert(okj_find_member_key(&parser, 0U, &k_missing, &idx) == OKJ_ERROR_BAD_POINTER);
+    }
+
+    assert(hash.state == OKJ_HASH_READY);
+
+    printf("test_key_getters_match_raw_keys passed!\n");
+}
+
+void test_key_getters_bad_args(void)
+{
+    OkJsonParser parser;
+    OkJsonString str;
+    OkJsonToken  tok;
+    OkjKey  key;
+    OkjSize idx = 0U;
+    char json_str[] = "{\"a\": 1}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(OKJ_KEY(&key, "a") == OKJ_SUCCESS);
+
+    assert(okj_get_string_key(NULL, &key, &str) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_get_string_key(&parser, NULL, &str) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_get_string_key(&parser, &key, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_get_token_key(&parser, NULL, &tok) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_member_key(&parser, 0U, NULL, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_member_key(&parser, 9U, &key, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_member_key(&parser, 2U, &key, &idx) == OKJ_ERROR_BAD_OBJECT);
+
+    printf("test_key_getters_bad_args passed!\n");
+}
+
+void test_key_ids_tagged_during_parse(void)
+{
+    /* Registered keys get their IDs; unregistered keys and every value,
+     * including a string value equal to a registered key, get NONE. */
+    OkJsonParser parser;
+    OkjKeySet    set;
+    OkjKey       keys[3];
+    uint8_t      ids[OKJ_MAX_TOKENS];
+    OkjSize      first[3];
+    OkJsonToken  tok;
+    OkjSize      idx = 0U;
+    char json_str[] = "{\"seq\": \"temp\", \"temp\": 21, \"extra\": {\"temp\": 5, \"unit\": \"C\"},"
+                      " \"unit\": \"K\"}";
+
+    assert(OKJ_KEY(&keys[0], "temp") == OKJ_SUCCESS);
+    assert(OKJ_KEY(&keys[1], "unit") == OKJ_SUCCESS);
+    assert(OKJ_KEY(&keys[2], "missing") == OKJ_SUCCESS);
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_keys_attach(&parser, &set, keys, 3U, ids, first) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(ids[0] == OKJ_KEY_ID_NONE);      /* root object      */
+    assert(ids[1] == OKJ_KEY_ID_NONE);      /* "seq"            */
+    assert(ids[2] == OKJ_KEY_ID_NONE);      /* value "temp"     */
+    assert(ids[3] == 0U);                   /* key "temp"       */
+    assert(ids[4] == OKJ_KEY_ID_NONE);      /* 21               */
+    assert(ids[7] == 0U);                   /* nested "temp"    */
+    assert(ids[9] == 1U);                   /* nested "unit"    */
+    assert(ids[11] == 1U);                  /* outer "unit"     */
+
+    /* The first key, not the earlier string value, wins. */
+    assert(okj_find_by_id(&parser, 0U, &idx) == OKJ_SUCCESS);
+    assert(idx == 4U);
+    assert(okj_get_by_id(&parser, 1U, &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_STRING) && (tok.start[0] == 'C'));
+    assert(okj_find_by_id(&parser, 2U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_by_id(&parser, 3U, &idx) == OKJ_ERROR_BAD_POINTER);
+
+    /* Scoped lookups agree with okj_find_member(). */
+    assert(okj_find_member_by_id(&parser, 0U, 1U, &idx) == OKJ_SUCCESS);
+    assert(idx == 12U);
+    assert(okj_find_member_by_id(&parser, 6U, 0U, &idx) == OKJ_SUCCESS);
+    assert(idx == 8U);
+    assert(okj_find_member_by_id(&parser, 6U, 2U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_member_by_id(&parser, 4U, 0U, &idx) == OKJ_ERROR_BAD_OBJECT);
+
+    printf("test_key_ids_tagged_during_parse passed!\n");
+}
+
+void test_key_ids_reset_between_parses(void)
+{
+    OkJsonParser parser;
+    OkjKeySet    set;
+    OkjKey       keys[1];
+    uint8_t      ids[OKJ_MAX_TOKENS];
+    OkjSize      first[1];
+    OkjSize      idx = 0U;
+    char with_key[]    = "{\"a\": 1}";
+    char without_key[] = "{\"b\": 1}";
+    char truncated[]   = "{\"b\": 1, \"a\"";
+
+    assert(OKJ_KEY(&keys[0], "a") == OKJ_SUCCESS);
+
+    okj_init(&parser, with_key, (OkjSize)(sizeof(with_key) - 1U));
+    assert(okj_keys_attach(&parser, &set, keys, 1U, ids, first) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_find_by_id(&parser, 0U, &idx) == OKJ_SUCCESS);
+
+    /* Reusing the same storage for another document forgets the old match. */
+    okj_init(&parser, without_key, (OkjSize)(sizeof(without_key) - 1U));
+    assert(okj_keys_attach(&parser, &set, keys, 1U, ids, first) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_find_by_id(&parser, 0U, &idx) == OKJ_ERROR_BAD_POINTER);
+
+    /* A key that ends a failed parse has no value to return. */
+    okj_init(&parser, truncated, (OkjSize)(sizeof(truncated) - 1U));
+    assert(okj_keys_attach(&parser, &set, keys, 1U, ids, first) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) != OKJ_SUCCESS);
+    assert(ids[3] == 0U);
+    assert(okj_find_by_id(&parser, 0U, &idx) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_key_ids_reset_between_parses passed!\n");
+}
+
+void test_key_ids_bad_args(void)
+{
+    OkJsonParser parser;
+    OkjKeySet    set;
+    OkjKey       keys[1];
+    uint8_t      ids[4];
+    OkjSize      first[1];
+    OkjSize      idx = 0U;
+    OkJsonToken  tok;
+    char json_str[] = "{\"a\": 1}";
+
+    assert(OKJ_KEY(&keys[0], "a") == OKJ_SUCCESS);
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+
+    assert(okj_keys_attach(NULL, &set, keys, 1U, ids, first) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_keys_attach(&parser, NULL, keys, 1U, ids, first) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_keys_attach(&parser, &set, NULL, 1U, ids, first) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_keys_attach(&parser, &set, keys, 0U, ids, first) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_keys_attach(&parser, &set, keys, 1U, NULL, first) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_keys_attach(&parser, &set, keys, 1U, ids, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(parser.key_set == NULL);
+
+    /* Without a key set the ID lookups have nothing to read. */
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_find_by_id(&parser, 0U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_get_by_id(&parser, 0U, &tok) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_member_by_id(&parser, 0U, 0U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_find_by_id(NULL, 0U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_get_by_id(&parser, 0U, NULL) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_key_ids_bad_args passed!\n");
+}
+
+static OkjError pointer_lookup(const OkJsonParser *parser, const char *text, OkJsonToken *out_tok)
+{
+    OkjPointer        ptr;
+    OkjPointerSegment segments[8];
+    char              buf[64];
+    OkjError          result = okj_pointer_compile(&ptr, text, (uint16_t)strlen(text),
+                                                   segments, 8U, buf);
+
+    if (result == OKJ_SUCCESS)
+    {
+        result = okj_pointer_get(parser, &ptr, out_tok);
+    }
+
+    return result;
+}
+
+void test_pointer_rfc6901_examples(void)
+{
+    /* The example document and pointers of RFC 6901 section 5, except the
+     * two whose keys hold JSON escapes: tokens keep the raw text. */
+    OkJsonParser parser;
+    OkJsonToken  tok;
+    char json_str[] = "{\"foo\": [\"bar\", \"baz\"], \"\": 0, \"a/b\": 1, \"c%d\": 2, \"e^f\": 3,"
+                      " \"g|h\": 4, \" \": 7, \"m~n\": 8}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(pointer_lookup(&parser, "", &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_OBJECT) && (tok.start == json_str));
+    assert(pointer_lookup(&parser, "/foo", &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_ARRAY) && (tok.count == 2U));
+    assert(pointer_lookup(&parser, "/foo/0", &tok) == OKJ_SUCCESS);
+    assert((tok.length == 3U) && (memcmp(tok.start, "bar", 3U) == 0));
+    assert(pointer_lookup(&parser, "/foo/1", &tok) == OKJ_SUCCESS);
+    assert(memcmp(tok.start, "baz", 3U) == 0);
+    assert(pointer_lookup(&parser, "/", &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '0');
+    assert(pointer_lookup(&parser, "/a~1b", &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '1');
+    assert(pointer_lookup(&parser, "/c%d", &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '2');
+    assert(pointer_lookup(&parser, "/e^f", &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '3');
+    assert(pointer_lookup(&parser, "/g|h", &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '4');
+    assert(pointer_lookup(&parser, "/ ", &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '7');
+    assert(pointer_lookup(&parser, "/m~0n", &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '8');
+
+    printf("test_pointer_rfc6901_examples passed!\n");
+}
+
+void test_pointer_nested_paths(void)
+{
+    /* Keys repeated at other depths must not be picked up, with or without
+     * a hash index, and array steps must skip whole nested elements. */
+    OkJsonParser parser;
+    OkjHashIndex hash;
+    OkjHashSlot  slots[128];
+    OkJsonToken  tok;
+    uint8_t      pass;
+    char json_str[] = "{\"value\": -1, \"device\": {\"id\": \"d1\", \"sensors\": ["
+                      "{\"value\": 10}, [1, [2, 3]], {\"value\": 12, \"tags\": {}},"
+                      " {\"id\": 4, \"value\": 13}]}}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    for (pass = 0U; pass < 2U; pass++)
+    {
+        if (pass == 1U)
+        {
+            assert(okj_hash_attach(&parser, &hash, slots, 128U) == OKJ_SUCCESS);
+        }
+
+        assert(pointer_lookup(&parser, "/device/sensors/3/value", &tok) == OKJ_SUCCESS);
+        assert((tok.type == OKJ_NUMBER) && (memcmp(tok.start, "13", 2U) == 0));
+        assert(pointer_lookup(&parser, "/device/sensors/2/value", &tok) == OKJ_SUCCESS);
+        assert(memcmp(tok.start, "12", 2U) == 0);
+        assert(pointer_lookup(&parser, "/device/sensors/1/1/0", &tok) == OKJ_SUCCESS);
+        assert(tok.start[0] == '2');
+        assert(pointer_lookup(&parser, "/value", &tok) == OKJ_SUCCESS);
+        assert(tok.start[0] == '-');
+
+        /* Absent or not addressable. */
+        assert(pointer_lookup(&parser, "/device/sensors/4", &tok) == OKJ_ERROR_BAD_POINTER);
+        assert(pointer_lookup(&parser, "/device/sensors/-", &tok) == OKJ_ERROR_BAD_POINTER);
+        assert(pointer_lookup(&parser, "/device/sensors/03", &tok) == OKJ_ERROR_BAD_POINTER);
+        assert(pointer_lookup(&parser, "/device/sensors/value", &tok) == OKJ_ERROR_BAD_POINTER);
+        assert(pointer_lookup(&parser, "/device/id/0", &tok) == OKJ_ERROR_BAD_POINTER);
+        assert(pointer_lookup(&parser, "/device/0", &tok) == OKJ_ERROR_BAD_POINTER);
+        assert(pointer_lookup(&parser, "/device/sensors/2/tags/x", &tok) == OKJ_ERROR_BAD_POINTER);
+        assert(pointer_lookup(&parser, "/id", &tok) == OKJ_ERROR_BAD_POINTER);
+    }
+
+    printf("test_pointer_nested_paths passed!\n");
+}
+
+void test_pointer_compile_errors(void)
+{
+    OkjPointer        ptr;
+    OkjPointerSegment segments[2];
+    OkJsonParser      parser;
+    OkjSize           idx = 0U;
+    char buf[16];
+    char json_str[] = "[1]";
+
+    assert(okj_pointer_compile(&ptr, "/a~1b/7", 7U, segments, 2U, buf) == OKJ_SUCCESS);
+    assert((ptr.n_segments == 2U) && (segments[0].key.length == 3U));
+    assert(memcmp(segments[0].key.bytes, "a/b", 3U) == 0);
+    assert((segments[0].index == OKJ_SIZE_MAX) && (segments[1].index == 7U));
+
+    assert(okj_pointer_compile(&ptr, "a", 1U, segments, 2U, buf) == OKJ_ERROR_SYNTAX);
+    assert(okj_pointer_compile(&ptr, "/a~2", 4U, segments, 2U, buf) == OKJ_ERROR_SYNTAX);
+    assert(okj_pointer_compile(&ptr, "/a~", 3U, segments, 2U, buf) == OKJ_ERROR_SYNTAX);
+    assert(okj_pointer_compile(&ptr, "/a/b/c", 6U, segments, 2U, buf) == OKJ_ERROR_NO_FREE_SPACE);
+    assert(okj_pointer_compile(NULL, "/a", 2U, segments, 2U, buf) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_pointer_compile(&ptr, NULL, 2U, segments, 2U, buf) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_pointer_compile(&ptr, "/a", 2U, NULL, 2U, buf) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_pointer_compile(&ptr, "/a", 2U, segments, 2U, NULL) == OKJ_ERROR_BAD_POINTER);
+
+    /* Indices too large for a token index never match. */
+    assert(okj_pointer_compile(&ptr, "/99999999999", 12U, segments, 2U, buf) == OKJ_SUCCESS);
+    assert(segments[0].index == OKJ_SIZE_MAX);
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_pointer_compile(&ptr, "/0", 2U, segments, 2U, buf) == OKJ_SUCCESS);
+    assert(okj_pointer_find(&parser, &ptr, &idx) == OKJ_SUCCESS);
+    assert(idx == 1U);
+    assert(okj_pointer_find(NULL, &ptr, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_pointer_find(&parser, NULL, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_pointer_find(&parser, &ptr, NULL) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_pointer_compile_errors passed!\n");
+}
+
+void test_array_at_flat_and_nested(void)
+{
+    /* Root is [10, 20, 30, [1, 2], {"k": [3]}, "s"]; the inner [1, 2] is
+     * flat and takes the direct path, the root takes the walk. */
+    OkJsonParser parser;
+    OkJsonToken  tok;
+    OkjSize      idx = 0U;
+    OkjSize      inner = 0U;
+    char json_str[] = "[10, 20, 30, [1, 2], {\"k\": [3]}, \"s\"]";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(okj_array_at(&parser, 0U, 0U, &tok) == OKJ_SUCCESS);
+    assert(memcmp(tok.start, "10", 2U) == 0);
+    assert(okj_array_at(&parser, 0U, 2U, &tok) == OKJ_SUCCESS);
+    assert(memcmp(tok.start, "30", 2U) == 0);
+    assert(okj_array_find(&parser, 0U, 3U, &inner) == OKJ_SUCCESS);
+    assert(okj_tok_type(&parser, inner) == OKJ_ARRAY);
+    assert(okj_array_at(&parser, 0U, 4U, &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_OBJECT) && (tok.count == 1U));
+    assert(okj_array_at(&parser, 0U, 5U, &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_STRING) && (tok.start[0] == 's'));
+    assert(okj_array_at(&parser, 0U, 6U, &tok) == OKJ_ERROR_BAD_POINTER);
+
+    assert(okj_array_find(&parser, inner, 1U, &idx) == OKJ_SUCCESS);
+    assert((idx == (OkjSize)(inner + 2U)) && (okj_tok_start(&parser, idx)[0] == '2'));
+    assert(okj_array_find(&parser, inner, 2U, &idx) == OKJ_ERROR_BAD_POINTER);
+
+    assert(okj_array_find(&parser, 1U, 0U, &idx) == OKJ_ERROR_BAD_ARRAY);
+    assert(okj_array_find(&parser, 99U, 0U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_array_find(NULL, 0U, 0U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_array_at(&parser, 0U, 0U, NULL) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_array_at_flat_and_nested passed!\n");
+}
+
+void test_array_at_empty_and_open(void)
+{
+    OkJsonParser parser;
+    OkjSize      idx = 0U;
+    char empty[]     = "[]";
+    char truncated[] = "[1, 2, 3";
+
+    okj_init(&parser, empty, (OkjSize)(sizeof(empty) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_array_find(&parser, 0U, 0U, &idx) == OKJ_ERROR_BAD_POINTER);
+
+    /* An array a failed parse left open has no known extent. */
+    okj_init(&parser, truncated, (OkjSize)(sizeof(truncated) - 1U));
+    assert(okj_parse(&parser) != OKJ_SUCCESS);
+    assert(okj_array_find(&parser, 0U, 0U, &idx) == OKJ_ERROR_BAD_ARRAY);
+
+    printf("test_array_at_empty_and_open passed!\n");
+}
+
+void test_array_offsets_table(void)
+{
+    OkJsonParser parser;
+    OkjSize      offsets[4];
+    OkjSize      count = 0U;
+    OkjSize      n;
+    OkjSize      idx = 0U;
+    char json_str[] = "[[1, 2], {\"a\": [3, 4]}, 5, []]";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(okj_array_offsets(&parser, 0U, offsets, 4U, &count) == OKJ_SUCCESS);
+    assert(count == 4U);
+
+    for (n = 0U; n < count; n++)
+    {
+        assert(okj_array_find(&parser, 0U, n, &idx) == OKJ_SUCCESS);
+        assert(offsets[n] == idx);
+    }
+
+    assert(okj_array_offsets(&parser, 0U, offsets, 3U, &count) == OKJ_ERROR_NO_FREE_SPACE);
+    assert(okj_array_offsets(&parser, 4U, offsets, 4U, &count) == OKJ_ERROR_BAD_ARRAY);
+    assert(okj_array_offsets(&parser, 0U, NULL, 4U, &count) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_array_offsets(&parser, 0U, offsets, 4U, NULL) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_array_offsets_table passed!\n");
+}
+
+void test_iter_object_members(void)
+{
+    OkJsonParser parser;
+    OkjIter      it;
+    OkjIter      inner;
+    OkJsonToken  key;
+    OkJsonToken  val;
+    uint8_t      n = 0U;
+    char json_str[] = "{\"a\": 1, \"b\": {\"c\": [1, {\"d\": 2}]}, \"e\": [], \"f\": \"x\"}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_iter_init(&parser, 0U, &it) == OKJ_SUCCESS);
+
+    while (okj_iter_next(&it, &key, &val) == 1U)
+    {
+        assert((key.type == OKJ_STRING) && (key.length == 1U));
+        assert(key.start[0] == "abef"[n]);
+        assert(okj_tok_start(&parser, it.value) == val.start);
+        n++;
+
+        if (key.start[0] == 'b')
+        {
+            /* Descend through the value's token index. */
+            assert(val.type == OKJ_OBJECT);
+            assert(okj_iter_init(&parser, it.value, &inner) == OKJ_SUCCESS);
+            assert(okj_iter_next(&inner, &key, &val) == 1U);
+            assert((key.start[0] == 'c') && (val.type == OKJ_ARRAY) && (val.count == 2U));
+            assert(okj_iter_next(&inner, &key, &val) == 0U);
+        }
+    }
+
+    assert(n == 4U);
+    assert(okj_iter_next(&it, &key, &val) == 0U);
+
+    printf("test_iter_object_members passed!\n");
+}
+
+void test_iter_array_elements(void)
+{
+    OkJsonParser parser;
+    OkjIter      it;
+    OkJsonToken  key;
+    OkJsonToken  val;
+    OkjSize      idx = 0U;
+    OkjSize      n   = 0U;
+    char json_str[] = "[[1, [2]], 3, {\"k\": 4}, \"s\", []]";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_iter_init(&parser, 0U, &it) == OKJ_SUCCESS);
+
+    while (okj_iter_next(&it, &key, &val) == 1U)
+    {
+        assert((key.type == OKJ_UNDEFINED) && (key.start == NULL));
+        assert(okj_array_find(&parser, 0U, n, &idx) == OKJ_SUCCESS);
+        assert((it.value == idx) && (val.start == okj_tok_start(&parser, idx)));
+        n++;
+    }
+
+    assert(n == 5U);
+
+    /* Both outputs are optional; an empty container yields nothing. */
+    assert(okj_iter_init(&parser, 0U, &it) == OKJ_SUCCESS);
+    assert(okj_iter_next(&it, NULL, NULL) == 1U);
+    assert(okj_iter_init(&parser, (OkjSize)(parser.token_count - 1U), &it) == OKJ_SUCCESS);
+    assert(okj_iter_next(&it, &key, &val) == 0U);
+
+    printf("test_iter_array_elements passed!\n");
+}
+
+void test_iter_skips_nested_subtrees(void)
+{
+    /* 250 members, each with a nested value: one step per member. */
+    static char        json_str[4096];
+    static OkJsonToken tokens[1024];
+    OkjDepthFrame depth[4];
+    OkJsonParser  parser;
+    OkjIter       it;
+    OkJsonToken   key;
+    OkjSize       len   = 0U;
+    OkjSize       steps = 0U;
+    uint16_t      m;
+
+    json_str[len++] = '{';
+    for (m = 0U; m < 250U; m++)
+    {
+        int written = snprintf(&json_str[len], sizeof(json_str) - len, "%s\"k%u\":[[0]]",
+                               (m == 0U) ? "" : ",", (unsigned int)m);
+
+        len = (OkjSize)(len + (OkjSize)written);
+    }
+    json_str[len++] = '}';
+
+    assert(okj_init_ex(&parser, json_str, len, tokens, 1024U, depth, 4U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(parser.token_count == 1001U);
+
+    assert(okj_iter_init(&parser, 0U, &it) == OKJ_SUCCESS);
+
+    while (okj_iter_next(&it, &key, NULL) == 1U)
+    {
+        steps++;
+    }
+
+    assert(steps == 250U);
+    assert(memcmp(key.start, "k249", 4U) == 0);
+
+    printf("test_iter_skips_nested_subtrees passed!\n");
+}
+
+void test_iter_bad_args(void)
+{
+    OkJsonParser parser;
+    OkjIter      it;
+    char json_str[] = "{\"a\": 1}";
+    char truncated[] = "{\"a\": [1, 2";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(okj_iter_init(NULL, 0U, &it) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_iter_init(&parser, 0U, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_iter_init(&parser, 3U, &it) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_iter_init(&parser, 2U, &it) == OKJ_ERROR_BAD_OBJECT);
+    assert(okj_iter_next(NULL, NULL, NULL) == 0U);
+
+    okj_init(&parser, truncated, (OkjSize)(sizeof(truncated) - 1U));
+    assert(okj_parse(&parser) != OKJ_SUCCESS);
+    assert(okj_iter_init(&parser, 0U, &it) == OKJ_ERROR_BAD_OBJECT);
+
+    printf("test_iter_bad_args passed!\n");
+}
+
+void test_cursor_in_order_and_wrap(void)
+{
+    OkJsonParser parser;
+    OkjCursor    cursor;
+    OkJsonToken  tok;
+    OkjSize      idx = 0U;
+    char json_str[] = "{\"a\": 1, \"b\": {\"a\": 2, \"c\": 3}, \"d\": 4}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_cursor_init(&parser, &cursor) == OKJ_SUCCESS);
+
+    /* In document order each search resumes right after the last value,
+     * stepping over the "b" subtree. */
+    assert(okj_cursor_find(&cursor, "a", 1U, &idx) == OKJ_SUCCESS);
+    assert((idx == 2U) && (cursor.next == 3U));
+    assert(okj_cursor_find(&cursor, "b", 1U, &idx) == OKJ_SUCCESS);
+    assert((idx == 4U) && (cursor.next == 9U));
+    assert(okj_cursor_get(&cursor, "d", 1U, &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '4');
+
+    /* Out of order: the search wraps to find the nested key. */
+    assert(okj_cursor_get(&cursor, "c", 1U, &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '3');
+    assert(okj_cursor_get(&cursor, "a", 1U, &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == '1');
+
+    /* A miss leaves the cursor in place. */
+    idx = cursor.next;
+    assert(okj_cursor_get(&cursor, "zz", 2U, &tok) == OKJ_ERROR_BAD_POINTER);
+    assert(cursor.next == idx);
+
+    printf("test_cursor_in_order_and_wrap passed!\n");
+}
+
+void test_cursor_matches_getters(void)
+{
+    /* Each key occurs once, so in any order the cursor finds what
+     * okj_get_token() finds. */
+    static const char *const order[] = { "n", "k1", "arr", "k0", "s", "k1", "n" };
+    OkJsonParser parser;
+    OkjCursor    cursor;
+    OkJsonToken  want;
+    OkJsonToken  got;
+    uint8_t      r;
+    char json_str[] = "{\"k0\": 0, \"arr\": [1, {\"x\": 1}], \"k1\": true, \"s\": \"v\", \"n\": null}";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_cursor_init(&parser, &cursor) == OKJ_SUCCESS);
+
+    for (r = 0U; r < 7U; r++)
+    {
+        uint16_t len = (uint16_t)strlen(order[r]);
+
+        assert(okj_get_token(&parser, order[r], len, &want) == OKJ_SUCCESS);
+        assert(okj_cursor_get(&cursor, order[r], len, &got) == OKJ_SUCCESS);
+        assert((got.start == want.start) && (got.type == want.type));
+    }
+
+    printf("test_cursor_matches_getters passed!\n");
+}
+
+void test_cursor_bad_args(void)
+{
+    OkJsonParser parser;
+    OkjCursor    cursor;
+    OkJsonToken  tok;
+    OkjSize      idx = 0U;
+    char json_str[] = "\"a\"";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(okj_cursor_init(NULL, &cursor) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_cursor_init(&parser, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_cursor_init(&parser, &cursor) == OKJ_SUCCESS);
+    assert(okj_cursor_find(NULL, "a", 1U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_cursor_find(&cursor, NULL, 1U, &idx) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_cursor_find(&cursor, "a", 1U, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_cursor_get(&cursor, "a", 1U, NULL) == OKJ_ERROR_BAD_POINTER);
+
+    /* A lone top-level string is never a key: nothing follows it. */
+    assert(okj_cursor_get(&cursor, "a", 1U, &tok) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_cursor_bad_args passed!\n");
+}
+
+static char path_store[] =
+    "{\"store\": {\"book\": ["
+    "{\"category\": \"reference\", \"author\": \"Nigel Rees\", \"title\": \"Sayings\", \"price\": 8.95},"
+    " {\"category\": \"fiction\", \"author\": \"Evelyn Waugh\", \"title\": \"Sword\", \"price\": 12.99},"
+    " {\"category\": \"fiction\", \"author\": \"Herman Melville\", \"title\": \"Moby Dick\","
+    " \"isbn\": \"0-553-21311-3\", \"price\": 8.99},"
+    " {\"category\": \"fiction\", \"author\": \"J. R. R. Tolkien\", \"title\": \"LOTR\","
+    " \"isbn\": \"0-395-19395-8\", \"price\": 22.99}],"
+    " \"bicycle\": {\"color\": \"red\", \"price\": 19.95}}}";
+
+static OkjError path_query(const OkJsonParser *parser, const char *text,
+                           OkjSize *out, OkjSize capacity, OkjSize *out_count)
+{
+    OkjPath     path;
+    OkjPathStep steps[8];
+    OkjError    result = okj_path_compile(&path, text, (uint16_t)strlen(text), steps, 8U);
+
+    if (result == OKJ_SUCCESS)
+    {
+        result = okj_path_eval(parser, &path, out, capacity, out_count);
+    }
+
+    return result;
+}
+
+static uint8_t path_token_is(const OkJsonParser *parser, OkjSize idx, const char *text)
+{
+    OkJsonToken tok;
+    uint16_t    len = (uint16_t)strlen(text);
+
+    return ((okj_token_at(parser, idx, &tok) == OKJ_SUCCESS) && (tok.length == len) &&
+            (memcmp(tok.start, text, len) == 0)) ? 1U : 0U;
+}
+
+void test_path_child_index_wildcard(void)
+{
+    OkJsonParser parser;
+    OkjSize      out[16];
+    OkjSize      n = 0U;
+
+    okj_init(&parser, path_store, (OkjSize)(sizeof(path_store) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(path_query(&parser, "$", out, 16U, &n) == OKJ_SUCCESS);
+    assert((n == 1U) && (out[0] == 0U));
+
+    assert(path_query(&parser, "$.store.book[*].author", out, 16U, &n) == OKJ_SUCCESS);
+    assert(n == 4U);
+    assert(path_token_is(&parser, out[0], "Nigel Rees") == 1U);
+    assert(path_token_is(&parser, out[3], "J. R. R. Tolkien") == 1U);
+
+    assert(path_query(&parser, "$.store.book[2].title", out, 16U, &n) == OKJ_SUCCESS);
+    assert((n == 1U) && (path_token_is(&parser, out[0], "Moby Dick") == 1U));
+
+    assert(path_query(&parser, "$['store'][\"bicycle\"].color", out, 16U, &n) == OKJ_SUCCESS);
+    assert((n == 1U) && (path_token_is(&parser, out[0], "red") == 1U));
+
+    /* Children of store: the book array and the bicycle object. */
+    assert(path_query(&parser, "$.store.*", out, 16U, &n) == OKJ_SUCCESS);
+    assert((n == 2U) && (okj_tok_type(&parser, out[0]) == OKJ_ARRAY) &&
+           (okj_tok_type(&parser, out[1]) == OKJ_OBJECT));
+
+    /* Nothing there is not an error. */
+    assert(path_query(&parser, "$.store.book[4]", out, 16U, &n) == OKJ_SUCCESS);
+    assert(n == 0U);
+    assert(path_query(&parser, "$.store.bicycle[0]", out, 16U, &n) == OKJ_SUCCESS);
+    assert(n == 0U);
+    assert(path_query(&parser, "$.store.book.title", out, 16U, &n) == OKJ_SUCCESS);
+    assert(n == 0U);
+
+    printf("test_path_child_index_wildcard passed!\n");
+}
+
+void test_path_recursive_and_filters(void)
+{
+    OkJsonParser parser;
+    OkjHashIndex hash;
+    OkjHashSlot  slots[128];
+    OkjSize      out[16];
+    OkjSize      n = 0U;
+    uint8_t      pass;
+
+    okj_init(&parser, path_store, (OkjSize)(sizeof(path_store) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    for (pass = 0U; pass < 2U; pass++)
+    {
+        if (pass == 1U)
+        {
+            assert(okj_hash_attach(&parser, &hash, slots, 128U) == OKJ_SUCCESS);
+        }
+
+        assert(path_query(&parser, "$..author", out, 16U, &n) == OKJ_SUCCESS);
+        assert((n == 4U) && (path_token_is(&parser, out[1], "Evelyn Waugh") == 1U));
+
+        /* Document order, the bicycle's price last. */
+        assert(path_query(&parser, "$..price", out, 16U, &n) == OKJ_SUCCESS);
+        assert((n == 5U) && (path_token_is(&parser, out[4], "19.95") == 1U));
+
+        assert(path_query(&parser, "$..book[?(@.price < 10)].title", out, 16U, &n) == OKJ_SUCCESS);
+        assert((n == 2U) && (path_token_is(&parser, out[0], "Sayings") == 1U) &&
+               (path_token_is(&parser, out[1], "Moby Dick") == 1U));
+
+        assert(path_query(&parser, "$..book[?(@.isbn)].title", out, 16U, &n) == OKJ_SUCCESS);
+        assert((n == 2U) && (path_token_is(&parser, out[1], "LOTR") == 1U));
+
+        assert(path_query(&parser, "$..[?(@.category == 'fiction')].price", out, 16U, &n) == OKJ_SUCCESS);
+        assert(n == 3U);
+        assert(path_query(&parser, "$..[?(@.category != \"fiction\")]", out, 16U, &n) == OKJ_SUCCESS);
+        assert(n == 1U);
+
+        /* Numbers compare by value, whatever their spelling. */
+        assert(path_query(&parser, "$..[?(@.price>=8.99e0)].title", out, 16U, &n) == OKJ_SUCCESS);
+        assert((n == 3U) && (path_token_is(&parser, out[0], "Sword") == 1U));
+        assert(path_query(&parser, "$..[?(@.price == 1995e-2)]", out, 16U, &n) == OKJ_SUCCESS);
+        assert((n == 1U) && (okj_tok_type(&parser, out[0]) == OKJ_OBJECT));
+        assert(path_query(&parser, "$..[?(@.price > -100)]", out, 16U, &n) == OKJ_SUCCESS);
+        assert(n == 5U);
+
+        /* A string is never less than a number. */
+        assert(path_query(&parser, "$..[?(@.category < 5)]", out, 16U, &n) == OKJ_SUCCESS);
+        assert(n == 0U);
+
+        /* Every node below the root. */
+        assert(path_query(&parser, "$..*", out, 16U, &n) == OKJ_ERROR_NO_FREE_SPACE);
+        assert(n == 27U);
+    }
+
+    assert(okj_number_compare("-0", 2U, "0.0", 3U) == OKJ_CMP_EQUAL);
+    assert(okj_number_compare("100", 3U, "1e2", 3U) == OKJ_CMP_EQUAL);
+    assert(okj_number_compare("0.001", 5U, "1E-3", 4U) == OKJ_CMP_EQUAL);
+    assert(okj_number_compare("-10", 3U, "-5", 2U) == OKJ_CMP_LESS);
+    assert(okj_number_compare("-1.5", 4U, "-1.25", 5U) == OKJ_CMP_LESS);
+    assert(okj_number_compare("99", 2U, "100", 3U) == OKJ_CMP_LESS);
+    assert(okj_number_compare("2.50", 4U, "2.5", 3U) == OKJ_CMP_EQUAL);
+    assert(okj_number_compare("1e400", 5U, "9e399", 5U) == OKJ_CMP_GREATER);
+
+    printf("test_path_recursive_and_filters passed!\n");
+}
+
+void test_path_errors(void)
+{
+    OkJsonParser parser;
+    OkjPath      path;
+    OkjPathStep  steps[2];
+    OkjSize      out[4];
+    OkjSize      n = 0U;
+    char json_str[] = "{\"a\": [1, 2, 3], \"b\": {\"a\": 4}}";
+    char open_str[] = "{\"a\": [1, 2";
+
+    okj_init(&parser, json_str, (OkjSize)(sizeof(json_str) - 1U));
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(path_query(&parser, "", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "a.b", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$.", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$..", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$a", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$[01]", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$[-1]", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$['a'", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$[?(@.a = 1)]", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$[?(@.a == 01)]", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$[?(@.a == 'x)]", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$[?(@.a == yes)]", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$[?(@. == 1)]", out, 4U, &n) == OKJ_ERROR_SYNTAX);
+
+    /* Step storage. */
+    assert(okj_path_compile(&path, "$.a[0]", 6U, steps, 2U) == OKJ_SUCCESS);
+    assert((path.n_steps == 2U) && (steps[1].kind == OKJ_PATH_INDEX) && (steps[1].index == 0U));
+    assert(okj_path_compile(&path, "$.a[0].b", 8U, steps, 2U) == OKJ_ERROR_NO_FREE_SPACE);
+    assert(okj_path_compile(NULL, "$", 1U, steps, 2U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_path_compile(&path, NULL, 1U, steps, 2U) == OKJ_ERROR_BAD_POINTER);
+
+    /* Output storage: the count includes what did not fit. */
+    assert(path_query(&parser, "$..a", out, 1U, &n) == OKJ_ERROR_NO_FREE_SPACE);
+    assert((n == 2U) && (okj_tok_type(&parser, out[0]) == OKJ_ARRAY));
+    assert(path_query(&parser, "$.a[*]", out, 4U, &n) == OKJ_SUCCESS);
+    assert((n == 3U) && (path_token_is(&parser, out[2], "3") == 1U));
+
+    assert(okj_path_compile(&path, "$", 1U, steps, 2U) == OKJ_SUCCESS);
+    assert(okj_path_eval(NULL, &path, out, 4U, &n) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_path_eval(&parser, NULL, out, 4U, &n) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_path_eval(&parser, &path, out, 4U, NULL) == OKJ_ERROR_BAD_POINTER);
+
+    /* A document left open by a failed parse. */
+    okj_init(&parser, open_str, (OkjSize)(sizeof(open_str) - 1U));
+    assert(okj_parse(&parser) != OKJ_SUCCESS);
+    assert(path_query(&parser, "$..a", out, 4U, &n) == OKJ_ERROR_BAD_OBJECT);
+
+    printf("test_path_errors passed!\n");
+}
+
+static OkjSize select_message(char *json_str, OkjSize size)
+{
+    /* About 2 KB: 120 scalar fields, a nested meta object and a
+     * 40-element array, far more than OKJ_MAX_TOKENS tokens. */
+    OkjSize  len = 0U;
+    uint16_t m;
+
+    json_str[len++] = '{';
+    for (m = 0U; m < 120U; m++)
+    {
+        int written = snprintf(&json_str[len], (size_t)(size - len), "\"f%03u\": %u, ",
+                               (unsigned int)m, (unsigned int)(m * 10U));
+
+        len = (OkjSize)(len + (OkjSize)written);
+    }
+    len = (OkjSize)(len + (OkjSize)snprintf(&json_str[len], (size_t)(size - len),
+        "\"meta\": {\"id\": \"m-1\", \"ts\": 1700000000, \"tags\": [\"a\", \"b\"]}, \"samples\": ["));
+    for (m = 0U; m < 40U; m++)
+    {
+        int written = snprintf(&json_str[len], (size_t)(size - len), "%s{\"v\": %u}",
+                               (m == 0U) ? "" : ", ", (unsigned int)m);
+
+        len = (OkjSize)(len + (OkjSize)written);
+    }
+    json_str[len++] = ']';
+    json_str[len++] = '}';
+
+    return len;
+}
+
+static void select_compile(OkjPath *paths, OkjPathStep (*steps)[4], const char *const *texts,
+                           uint8_t n)
+{
+    uint8_t p;
+
+    for (p = 0U; p < n; p++)
+    {
+        assert(okj_path_compile(&paths[p], texts[p], (uint16_t)strlen(texts[p]),
+                                steps[p], 4U) == OKJ_SUCCESS);
+    }
+}
+
+void test_select_keeps_requested_fields(void)
+{
+    static char        json_str[4096];
+    static const char *const texts[3] = { "$.f007", "$.meta.ts", "$.f119" };
+    OkJsonParser  parser;
+    OkjPath       paths[3];
+    OkjPathStep   steps[3][4];
+    OkjSelect     sel;
+    OkJsonNumber  num;
+    OkJsonToken   tok;
+    OkjSize       len = select_message(json_str, (OkjSize)sizeof(json_str));
+
+    assert(len > 2000U);
+
+    /* Without a selection the message does not fit the fixed token array. */
+    okj_init(&parser, json_str, len);
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_TOKENS_EXCEEDED);
+
+    select_compile(paths, steps, texts, 3U);
+    okj_init(&parser, json_str, len);
+    assert(okj_select_attach(&parser, &sel, paths, 3U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    /* Root, f007 and its value, meta, ts and its value, f119 and its value. */
+    assert(parser.token_count == 9U);
+    assert((okj_tok_count(&parser, 0U) == 3U) && (okj_tok_end(&parser, 0U) == 9U));
+    assert(okj_tok_length(&parser, 0U) == len);
+
+    assert(okj_get_number(&parser, "f007", 4U, &num) == OKJ_SUCCESS);
+    assert((num.length == 2U) && (memcmp(num.start, "70", 2U) == 0));
+    assert(okj_get_number(&parser, "f119", 4U, &num) == OKJ_SUCCESS);
+    assert(memcmp(num.start, "1190", 4U) == 0);
+    assert(okj_get_number(&parser, "ts", 2U, &num) == OKJ_SUCCESS);
+    assert(memcmp(num.start, "1700000000", 10U) == 0);
+
+    /* The pruned tree is well formed: meta holds ts only. */
+    assert(pointer_lookup(&parser, "/meta", &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_OBJECT) && (tok.count == 1U));
+    assert(pointer_lookup(&parser, "/meta/ts", &tok) == OKJ_SUCCESS);
+    assert(okj_get_number(&parser, "f008", 4U, &num) != OKJ_SUCCESS);
+    assert(pointer_lookup(&parser, "/meta/id", &tok) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_select_keeps_requested_fields passed!\n");
+}
+
+void test_select_subtrees_and_recursion(void)
+{
+    static char        json_str[4096];
+    static const char *const texts[2] = { "$.samples[38]", "$.meta" };
+    static const char *const every[1] = { "$..v" };
+    OkJsonParser  parser;
+    OkjPath       paths[2];
+    OkjPathStep   steps[2][4];
+    OkjSelect     sel;
+    OkjSize       out[64];
+    OkjSize       n   = 0U;
+    OkJsonToken   tok;
+    OkjSize       len = select_message(json_str, (OkjSize)sizeof(json_str));
+
+    /* A selected value is kept whole. */
+    select_compile(paths, steps, texts, 2U);
+    okj_init(&parser, json_str, len);
+    assert(okj_select_attach(&parser, &sel, paths, 2U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+
+    assert(pointer_lookup(&parser, "/meta/tags/1", &tok) == OKJ_SUCCESS);
+    assert(tok.start[0] == 'b');
+    assert(pointer_lookup(&parser, "/meta/id", &tok) == OKJ_SUCCESS);
+
+    /* Element 38 is the only element kept, so it is element 0 of the tree. */
+    assert(pointer_lookup(&parser, "/samples", &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_ARRAY) && (tok.count == 1U));
+    assert(pointer_lookup(&parser, "/samples/0/v", &tok) == OKJ_SUCCESS);
+    assert(memcmp(tok.start, "38", 2U) == 0);
+    assert(path_query(&parser, "$.samples", out, 64U, &n) == OKJ_SUCCESS);
+    assert(okj_array_at(&parser, out[0], 0U, &tok) == OKJ_SUCCESS);
+    assert(okj_array_at(&parser, out[0], 1U, &tok) != OKJ_SUCCESS);
+
+    /* So [n] steps, which would count kept elements only, are refused. */
+    assert(path_query(&parser, "$.samples[0]", out, 64U, &n) == OKJ_ERROR_SYNTAX);
+    assert(path_query(&parser, "$.samples[*].v", out, 64U, &n) == OKJ_SUCCESS);
+    assert((n == 1U) && (path_token_is(&parser, out[0], "38") == 1U));
+
+    /* Recursive descent keeps every container on the way. */
+    select_compile(paths, steps, every, 1U);
+    okj_init(&parser, json_str, len);
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(path_query(&parser, "$.samples[*].v", out, 64U, &n) == OKJ_SUCCESS);
+    assert((n == 40U) && (path_token_is(&parser, out[39], "39") == 1U));
+    assert(path_query(&parser, "$.f000", out, 64U, &n) == OKJ_SUCCESS);
+    assert(n == 0U);
+
+    /* "$" selects everything: the same tokens as a plain parse. */
+    {
+        char        small[] = "{\"a\": [1, {\"b\": null}], \"c\": true}";
+        OkjSize     plain;
+
+        okj_init(&parser, small, (OkjSize)(sizeof(small) - 1U));
+        assert(okj_parse(&parser) == OKJ_SUCCESS);
+        plain = parser.token_count;
+
+        assert(okj_path_compile(&paths[0], "$", 1U, steps[0], 4U) == OKJ_SUCCESS);
+        okj_init(&parser, small, (OkjSize)(sizeof(small) - 1U));
+        assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+        assert(okj_parse(&parser) == OKJ_SUCCESS);
+        assert(parser.token_count == plain);
+    }
+
+    printf("test_select_subtrees_and_recursion passed!\n");
+}
+
+void test_select_validates_and_errors(void)
+{
+    static const char *const texts[1] = { "$.z" };
+    OkJsonParser  parser;
+    OkjPath       paths[2];
+    OkjPathStep   steps[2][4];
+    OkjPathStep   long_steps[20];
+    OkjSelect     sel;
+    OkJsonToken   tokens[2];
+    OkjDepthFrame depth[4];
+    char bad_escape[] = "{\"a\": 1, \"b\": {\"c\": \"\\q\"}}";
+    char trailing[]   = "{\"a\": 1, \"b\": [1, 2,]}";
+    char deep[]       = "{\"a\": 1, \"b\": [[[[[1]]]]]}";
+    char quoted[]     = "{\"b\": {\"c\": \"]}\\\"\"}, \"z\": 3}";
+    char bad_scalar[] = "{\"a\": tru, \"b\": [1]}";
+    char junk[]       = "{\"junk\":{\"a\" 1 2 [ ,, tru : ]},\"id\":7}";
+    char unclosed[]   = "{\"a\": 1, \"b\": [1, [2]";
+    char good[]       = "{\"b\": 2, \"a\": 1}";
+    char buf[32];
+    OkJsonNumber  num;
+    OkjFeed       feed;
+    OkjError      result;
+    OkjSize       i;
+
+    select_compile(paths, steps, texts, 1U);
+
+    /* Containers no query reaches are skipped without tokens but still
+     * fully validated, nesting included. */
+    okj_init(&parser, bad_escape, (OkjSize)(sizeof(bad_escape) - 1U));
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_ERROR_BAD_STRING);
+
+    okj_init(&parser, trailing, (OkjSize)(sizeof(trailing) - 1U));
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_ERROR_SYNTAX);
+
+    okj_init(&parser, junk, (OkjSize)(sizeof(junk) - 1U));
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_ERROR_SYNTAX);
+    assert(okj_validate(junk, (OkjSize)(sizeof(junk) - 1U)) == OKJ_ERROR_SYNTAX);
+
+    assert(okj_init_ex(&parser, deep, (OkjSize)(sizeof(deep) - 1U), tokens, 2U, depth, 4U) == OKJ_SUCCESS);
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_DEPTH_EXCEEDED);
+
+    /* Brackets and escaped quotes inside strings do not end the skip. */
+    okj_init(&parser, quoted, (OkjSize)(sizeof(quoted) - 1U));
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_SUCCESS);
+    assert(okj_get_number(&parser, "z", 1U, &num) == OKJ_SUCCESS);
+    assert(num.start[0] == '3');
+
+    /* Scalars at a kept level, and the end of the input, are checked too. */
+    okj_init(&parser, bad_scalar, (OkjSize)(sizeof(bad_scalar) - 1U));
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) != OKJ_SUCCESS);
+
+    okj_init(&parser, unclosed, (OkjSize)(sizeof(unclosed) - 1U));
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_ERROR_UNEXPECTED_END);
+
+    /* okj_feed() waits until the bytes received decide a skipped container,
+     * so any split gives okj_parse()'s result. */
+    okj_init(&parser, buf, 0U);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    for (i = 0U; i < (OkjSize)(sizeof(quoted) - 2U); i++)
+    {
+        assert(okj_feed(&parser, &quoted[i], 1U) == OKJ_NEED_MORE_DATA);
+    }
+    assert(okj_feed(&parser, &quoted[i], 1U) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, NULL, 0U) == OKJ_SUCCESS);
+    assert(okj_get_number(&parser, "z", 1U, &num) == OKJ_SUCCESS);
+    assert(num.start[0] == '3');
+
+    okj_init(&parser, buf, 0U);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    i = 0U;
+    result = okj_feed(&parser, &trailing[i], 1U);
+    while (result == OKJ_NEED_MORE_DATA)
+    {
+        i++;
+        result = okj_feed(&parser, &trailing[i], 1U);
+    }
+    assert(result == OKJ_ERROR_SYNTAX);
+    assert(trailing[i] == ']');
+
+    okj_init(&parser, buf, 0U);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, unclosed, 12U) == OKJ_NEED_MORE_DATA);
+    assert(okj_feed(&parser, &unclosed[12], (OkjSize)(sizeof(unclosed) - 13U)) == OKJ_NEED_MORE_DATA);
+    assert(okj_feed(&parser, NULL, 0U) == OKJ_ERROR_UNEXPECTED_END);
+
+    /* A kept member needs room for its key and its value. */
+    assert(okj_path_compile(&paths[0], "$.a", 3U, steps[0], 4U) == OKJ_SUCCESS);
+    assert(okj_init_ex(&parser, good, (OkjSize)(sizeof(good) - 1U), tokens, 2U, depth, 4U) == OKJ_SUCCESS);
+    assert(okj_select_attach(&parser, &sel, paths, 1U) == OKJ_SUCCESS);
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_TOKENS_EXCEEDED);
+
+    /* Attach errors. */
+    okj_init(&parser, good, (OkjSize)(sizeof(good) - 1U));
+    assert(okj_select_attach(NULL, &sel, paths, 1U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_select_attach(&parser, NULL, paths, 1U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_select_attach(&parser, &sel, paths, 0U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_path_compile(&paths[1], "$[?(@.a)]", 9U, steps[1], 4U) == OKJ_SUCCESS);
+    assert(okj_select_attach(&parser, &sel, paths, 2U) == OKJ_ERROR_SYNTAX);
+    assert(okj_path_compile(&paths[1], "$.a.a.a.a.a.a.a.a.a.a.a.a.a.a.a.a.a.a.a.a", 41U,
+                            long_steps, 20U) == OKJ_SUCCESS);
+    assert(okj_select_attach(&parser, &sel, paths, 2U) == OKJ_SUCCESS);
+    assert(okj_select_attach(&parser, &sel, &paths[1], 1U) == OKJ_SUCCESS);
+    paths[0] = paths[1];
+    assert(okj_select_attach(&parser, &sel, paths, 2U) == OKJ_ERROR_NO_FREE_SPACE);
+    assert(parser.select == &sel);
+
+    printf("test_select_validates_and_errors passed!\n");
+}
+
+void test_doc_reads_fields_without_tokens(void)
+{
+    char         json_str[2600];
+    OkJsonParser parser;
+    OkjDoc       doc;
+    OkJsonToken  root, meta, value, samples, sample;
+    OkjSize      len = select_message(json_str, (OkjSize)sizeof(json_str));
+
+    /* Far more values than OKJ_MAX_TOKENS: okj_parse() cannot hold it. */
+    okj_init(&parser, json_str, len);
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_TOKENS_EXCEEDED);
+
+    assert(okj_doc_init(&doc, json_str, len) == OKJ_SUCCESS);
+    assert(okj_doc_root(&doc, &root) == OKJ_SUCCESS);
+    assert(root.type == OKJ_OBJECT);
+    assert(root.start == json_str);
+    assert(root.length == 1U);
+
+    assert(okj_doc_field(&doc, &root, "f117", 4U, &value) == OKJ_SUCCESS);
+    assert(value.type == OKJ_NUMBER);
+    assert(value.length == 4U);
+    assert(memcmp(value.start, "1170", 4U) == 0);
+
+    assert(okj_doc_field(&doc, &root, "meta", 4U, &meta) == OKJ_SUCCESS);
+    assert(meta.type == OKJ_OBJECT);
+    assert(*meta.start == '{');
+    assert(okj_doc_field(&doc, &meta, "id", 2U, &value) == OKJ_SUCCESS);
+    assert(value.type == OKJ_STRING);
+    assert((value.length == 3U) && (memcmp(value.start, "m-1", 3U) == 0));
+
+    assert(okj_doc_field(&doc, &root, "samples", 7U, &samples) == OKJ_SUCCESS);
+    assert(samples.type == OKJ_ARRAY);
+    assert(okj_doc_at(&doc, &samples, 39U, &sample) == OKJ_SUCCESS);
+    assert(okj_doc_field(&doc, &sample, "v", 1U, &value) == OKJ_SUCCESS);
+    assert((value.length == 2U) && (memcmp(value.start, "39", 2U) == 0));
+
+    /* Absent keys and elements. */
+    assert(okj_doc_field(&doc, &root, "f120", 4U, &value) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_doc_at(&doc, &samples, 40U, &value) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_doc_reads_fields_without_tokens passed!\n");
+}
+
+void test_doc_iterate_and_find_in_order(void)
+{
+    char        json_str[] = " {\"a\": [1, {\"x\": [2]}, \"s\"], \"b\": true,\n"
+                             "   \"c\": {}, \"d\": null, \"e\": -1.5e3} ";
+    OkjDoc      doc;
+    OkjDocIter  it, inner;
+    OkJsonToken root, key, val;
+    uint16_t    n = 0U;
+
+    assert(okj_doc_init(&doc, json_str, (OkjSize)strlen(json_str)) == OKJ_SUCCESS);
+    assert(okj_doc_root(&doc, &root) == OKJ_SUCCESS);
+    assert(okj_doc_iter(&doc, &root, &it) == OKJ_SUCCESS);
+
+    /* Members in document order; containers come back unscanned and are
+     * stepped over by the next call. */
+    assert(okj_doc_next(&it, &key, &val) == 1U);
+    assert((key.type == OKJ_STRING) && (key.length == 1U) && (key.start[0] == 'a'));
+    assert(val.type == OKJ_ARRAY);
+    assert(okj_doc_iter(&doc, &val, &inner) == OKJ_SUCCESS);
+    assert(okj_doc_next(&inner, &key, &val) == 1U);
+    assert((key.type == OKJ_UNDEFINED) && (key.start == NULL));
+    assert((val.type == OKJ_NUMBER) && (val.start[0] == '1'));
+    assert(okj_doc_next(&inner, NULL, &val) == 1U);
+    assert(val.type == OKJ_OBJECT);
+    assert(okj_doc_next(&inner, NULL, &val) == 1U);
+    assert((val.type == OKJ_STRING) && (val.length == 1U) && (val.start[0] == 's'));
+    assert(okj_doc_next(&inner, NULL, &val) == 0U);
+    assert(inner.status == OKJ_SUCCESS);
+
+    while (okj_doc_next(&it, &key, &val) == 1U)
+    {
+        n++;
+    }
+    assert(n == 4U);
+    assert(it.status == OKJ_SUCCESS);
+    assert(okj_doc_next(&it, &key, &val) == 0U);
+
+    /* okj_doc_find() resumes where the last lookup stopped. */
+    assert(okj_doc_iter(&doc, &root, &it) == OKJ_SUCCESS);
+    assert(okj_doc_find(&it, "b", 1U, &val) == OKJ_SUCCESS);
+    assert((val.type == OKJ_BOOLEAN) && (val.length == 4U));
+    assert(okj_doc_find(&it, "c", 1U, &val) == OKJ_SUCCESS);
+    assert(val.type == OKJ_OBJECT);
+    assert(okj_doc_iter(&doc, &val, &inner) == OKJ_SUCCESS);
+    assert(okj_doc_next(&inner, &key, &val) == 0U);
+    assert(inner.status == OKJ_SUCCESS);
+    assert(okj_doc_find(&it, "e", 1U, &val) == OKJ_SUCCESS);
+    assert((val.type == OKJ_NUMBER) && (val.length == 6U));
+    assert(okj_doc_find(&it, "a", 1U, &val) == OKJ_ERROR_BAD_POINTER);
+
+    /* A scalar root. */
+    {
+        char   scalar[] = "  \"only\"  ";
+        OkjDoc sdoc;
+
+        assert(okj_doc_init(&sdoc, scalar, (OkjSize)strlen(scalar)) == OKJ_SUCCESS);
+        assert(okj_doc_root(&sdoc, &val) == OKJ_SUCCESS);
+        assert((val.type == OKJ_STRING) && (val.length == 4U));
+        assert(okj_doc_iter(&sdoc, &val, &it) == OKJ_ERROR_BAD_OBJECT);
+    }
+
+    printf("test_doc_iterate_and_find_in_order passed!\n");
+}
+
+static OkjError doc_lookup(char *json_str, const char *key)
+{
+    OkjDoc      doc;
+    OkJsonToken root, val;
+    OkjError    result = okj_doc_init(&doc, json_str, (OkjSize)strlen(json_str));
+
+    if (result == OKJ_SUCCESS)
+    {
+        result = okj_doc_root(&doc, &root);
+    }
+    if (result == OKJ_SUCCESS)
+    {
+        result = okj_doc_field(&doc, &root, key, (uint16_t)strlen(key), &val);
+    }
+
+    return result;
+}
+
+void test_doc_errors(void)
+{
+    char        bad_sep[]     = "{\"a\" 1, \"b\": 2}";
+    char        bad_value[]   = "{\"a\": \"\\q\"}";
+    char        bad_number[]  = "{\"a\": 01}";
+    char        trailing[]    = "{\"a\": 1,}";
+    char        truncated[]   = "{\"a\": [1, 2";
+    char        no_comma[]    = "{\"a\": 1 \"b\": 2}";
+    char        skipped_bad[] = "{\"a\": tru, \"b\": 2}";
+    char        empty[]       = "  ";
+    char        arr[]         = "[10, [20], 30]";
+    OkjDoc      doc;
+    OkJsonToken root, val;
+
+    assert(doc_lookup(bad_sep, "b") == OKJ_ERROR_SYNTAX);
+    assert(doc_lookup(bad_value, "a") == OKJ_ERROR_BAD_STRING);
+    assert(doc_lookup(bad_number, "a") == OKJ_ERROR_BAD_NUMBER);
+    assert(doc_lookup(trailing, "z") == OKJ_ERROR_SYNTAX);
+    assert(doc_lookup(truncated, "z") == OKJ_ERROR_UNEXPECTED_END);
+    assert(doc_lookup(no_comma, "b") == OKJ_ERROR_SYNTAX);
+
+    /* Values stepped over on the way are delimited, not checked. */
+    assert(doc_lookup(skipped_bad, "b") == OKJ_SUCCESS);
+    assert(doc_lookup(skipped_bad, "a") == OKJ_ERROR_SYNTAX);
+
+    assert(okj_doc_init(&doc, empty, 2U) == OKJ_SUCCESS);
+    assert(okj_doc_root(&doc, &root) == OKJ_ERROR_UNEXPECTED_END);
+
+    assert(okj_doc_init(&doc, arr, (OkjSize)strlen(arr)) == OKJ_SUCCESS);
+    assert(okj_doc_root(&doc, &root) == OKJ_SUCCESS);
+    assert(okj_doc_at(&doc, &root, 2U, &val) == OKJ_SUCCESS);
+    assert((val.length == 2U) && (memcmp(val.start, "30", 2U) == 0));
+    assert(okj_doc_field(&doc, &root, "a", 1U, &val) == OKJ_ERROR_BAD_OBJECT);
+    assert(okj_doc_at(&doc, &val, 0U, &val) == OKJ_ERROR_BAD_ARRAY);
+
+    assert(okj_doc_init(NULL, arr, 1U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_doc_init(&doc, arr, (OkjSize)(OKJ_MAX_JSON_LEN + 1U)) == OKJ_ERROR_MAX_JSON_LEN_EXCEEDED);
+    assert(okj_doc_init(&doc, arr, (OkjSize)strlen(arr)) == OKJ_SUCCESS);
+    assert(okj_doc_root(&doc, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_doc_at(&doc, &root, 0U, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_doc_next(NULL, &root, &val) == 0U);
+
+    printf("test_doc_errors passed!\n");
+}
+
+void test_validate_matches_parse(void)
+{
+    static const char *const inputs[] = {
+        "{\"a\": [1, -0.5e+3, \"\\u00e9\\n\", true, false, null], \"b\": {}}",
+        "  [ ]  ", "\"top\"", "0", "-", "01", "1.", "1e", "[1,]", "{\"a\":1,}",
+        "{\"a\" 1}", "{1: 2}", "[1 2]", "[1}", "{\"a\": 1]", "[[[]]", "]",
+        "{\"a\": \"\\q\"}", "\"\x01\"", "\"\xC3\"", "truex", "[nul]", "1 2",
+        "", "   ", "{\"a\": [tru]}", "[\"\\uZZZZ\"]", "[1]x"
+    };
+    static OkJsonToken tokens[256];
+    OkjDepthFrame depth[OKJ_MAX_DEPTH];
+    uint16_t      i;
+
+    for (i = 0U; i < (uint16_t)(sizeof(inputs) / sizeof(inputs[0])); i++)
+    {
+        char         json_str[128];
+        OkJsonParser parser;
+        OkjSize      len = (OkjSize)strlen(inputs[i]);
+
+        memcpy(json_str, inputs[i], len);
+        assert(okj_init_ex(&parser, json_str, len, tokens, 256U, depth, OKJ_MAX_DEPTH) == OKJ_SUCCESS);
+        assert(okj_validate(json_str, len) == okj_parse(&parser));
+    }
+
+    assert(okj_validate(inputs[0], (OkjSize)strlen(inputs[0])) == OKJ_SUCCESS);
+    assert(okj_validate(inputs[13], (OkjSize)strlen(inputs[13])) == OKJ_ERROR_BRACKET_MISMATCH);
+
+    printf("test_validate_matches_parse passed!\n");
+}
+
+void test_validate_has_no_token_limit(void)
+{
+    static char  json_str[4096];
+    OkJsonParser parser;
+    OkjSize      len = select_message(json_str, (OkjSize)sizeof(json_str));
+    uint16_t     i;
+
+    okj_init(&parser, json_str, len);
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_TOKENS_EXCEEDED);
+    assert(okj_validate(json_str, len) == OKJ_SUCCESS);
+
+    /* 2000 one-digit elements: far past OKJ_MAX_TOKENS and OKJ_MAX_ARRAY_SIZE. */
+    len = 0U;
+    json_str[len++] = '[';
+    for (i = 0U; i < 2000U; i++)
+    {
+        json_str[len++] = (char)('0' + (i % 10U));
+        json_str[len++] = (i < 1999U) ? ',' : ']';
+    }
+    assert(okj_validate(json_str, len) == OKJ_SUCCESS);
+
+    /* A fault after the point where okj_parse() would run out of tokens. */
+    json_str[len - 2U] = 'x';
+    assert(okj_validate(json_str, len) == OKJ_ERROR_SYNTAX);
+
+    printf("test_validate_has_no_token_limit passed!\n");
+}
+
+void test_validate_depth_and_errors(void)
+{
+    char     json_str[96];
+    OkjSize  len = 0U;
+    uint16_t i;
+
+    /* OKJ_MAX_DEPTH levels pass; one more is rejected. */
+    for (i = 0U; i < OKJ_MAX_DEPTH; i++)
+    {
+        json_str[len++] = ((i % 2U) == 0U) ? '[' : '{';
+        if ((i % 2U) == 1U)
+        {
+            json_str[len++] = '"';
+            json_str[len++] = 'k';
+            json_str[len++] = '"';
+            json_str[len++] = ':';
+        }
+    }
+    json_str[len++] = '1';
+    for (i = OKJ_MAX_DEPTH; i > 0U; i--)
+    {
+        json_str[len++] = ((i % 2U) == 1U) ? ']' : '}';
+    }
+    assert(okj_validate(json_str, len) == OKJ_SUCCESS);
+
+    json_str[len - (OkjSize)OKJ_MAX_DEPTH - 1U] = '[';
+    assert(okj_validate(json_str, len) == OKJ_ERROR_MAX_DEPTH_EXCEEDED);
+
+    assert(okj_validate(NULL, 4U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_validate(json_str, (OkjSize)(OKJ_MAX_JSON_LEN + 1U)) == OKJ_ERROR_MAX_JSON_LEN_EXCEEDED);
+    assert(okj_validate(json_str, 0U) == OKJ_ERROR_UNEXPECTED_END);
+    assert(okj_validate("[1, 2", 5U) == OKJ_ERROR_UNEXPECTED_END);
+    assert(okj_validate("{\"a\": 1} {}", 11U) == OKJ_ERROR_SYNTAX);
+
+    printf("test_validate_depth_and_errors passed!\n");
+}
+
+void test_feed_byte_at_a_time_matches_parse(void)
+{
+    static const char doc[] =
+        "{\"name\": \"caf\xC3\xA9 \\u00e9\\n\", \"n\": -12.5e+3, \"ok\": true,\n"
+        " \"list\": [1, 22, 333, null, false], \"empty\": {}}";
+    char         whole[sizeof(doc)];
+    char         buf[sizeof(doc)];
+    OkJsonParser reference;
+    OkJsonParser parser;
+    OkjFeed      feed;
+    OkJsonNumber num;
+    OkjSize      len = (OkjSize)(sizeof(doc) - 1U);
+    OkjSize      i;
+
+    memcpy(whole, doc, len);
+    okj_init(&reference, whole, len);
+    assert(okj_parse(&reference) == OKJ_SUCCESS);
+
+    okj_init(&parser, buf, 0U);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+
+    /* Every cut, including inside escapes, UTF-8 sequences, numbers and
+     * literals, waits for more data until the closing brace. */
+    for (i = 0U; i < (OkjSize)(len - 1U); i++)
+    {
+        assert(okj_feed(&parser, &doc[i], 1U) == OKJ_NEED_MORE_DATA);
+    }
+    assert(okj_feed(&parser, &doc[len - 1U], 1U) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, NULL, 0U) == OKJ_SUCCESS);
+
+    assert(parser.token_count == reference.token_count);
+    for (i = 0U; i < parser.token_count; i++)
+    {
+        assert(okj_tok_type(&parser, i) == okj_tok_type(&reference, i));
+        assert((okj_tok_start(&parser, i) - buf) == (okj_tok_start(&reference, i) - whole));
+        assert(okj_tok_length(&parser, i) == okj_tok_length(&reference, i));
+        assert(okj_tok_end(&parser, i) == okj_tok_end(&reference, i));
+        assert(okj_tok_count(&parser, i) == okj_tok_count(&reference, i));
+    }
+
+    assert(okj_get_number(&parser, "n", 1U, &num) == OKJ_SUCCESS);
+    assert((num.length == 8U) && (memcmp(num.start, "-12.5e+3", 8U) == 0));
+
+    printf("test_feed_byte_at_a_time_matches_parse passed!\n");
+}
+
+void test_feed_in_place_and_top_level_scalars(void)
+{
+    char         buf[32];
+    OkJsonParser parser;
+    OkjFeed      feed;
+    OkJsonToken  tok;
+
+    /* Bytes received straight into the buffer's tail are not copied. */
+    okj_init(&parser, buf, 0U);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+    memcpy(buf, "[12", 3U);
+    assert(okj_feed(&parser, buf, 3U) == OKJ_NEED_MORE_DATA);
+    memcpy(&buf[3], "34, t", 5U);
+    assert(okj_feed(&parser, &buf[3], 5U) == OKJ_NEED_MORE_DATA);
+    memcpy(&buf[8], "rue]  ", 6U);
+    assert(okj_feed(&parser, &buf[8], 6U) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, "\n", 1U) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, NULL, 0U) == OKJ_SUCCESS);
+    assert(parser.token_count == 3U);
+    assert(okj_token_at(&parser, 1U, &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_NUMBER) && (tok.length == 4U));
+
+    /* A bare number only ends with the input. */
+    okj_init(&parser, buf, 0U);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, "-1", 2U) == OKJ_NEED_MORE_DATA);
+    assert(okj_feed(&parser, "05", 2U) == OKJ_NEED_MORE_DATA);
+    assert(okj_feed(&parser, NULL, 0U) == OKJ_SUCCESS);
+    assert(okj_token_at(&parser, 0U, &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_NUMBER) && (tok.length == 4U));
+
+    /* Bytes already in the buffer at attach time count as received. */
+    memcpy(buf, "\"ab", 3U);
+    okj_init(&parser, buf, 3U);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, "c\"", 2U) == OKJ_SUCCESS);
+    assert(okj_token_at(&parser, 0U, &tok) == OKJ_SUCCESS);
+    assert((tok.type == OKJ_STRING) && (tok.length == 3U));
+
+    printf("test_feed_in_place_and_top_level_scalars passed!\n");
+}
+
+static OkjError feed_split(const char *text, OkjSize cut, uint8_t finish)
+{
+    static char  buf[64];
+    OkJsonParser parser;
+    OkjFeed      feed;
+    OkjSize      len    = (OkjSize)strlen(text);
+    OkjError     result = OKJ_NEED_MORE_DATA;
+
+    okj_init(&parser, buf, 0U);
+    (void)okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf));
+    result = okj_feed(&parser, text, cut);
+    if ((result == OKJ_NEED_MORE_DATA) || (result == OKJ_SUCCESS))
+    {
+        result = okj_feed(&parser, &text[cut], (OkjSize)(len - cut));
+    }
+    if (finish != 0U)
+    {
+        result = okj_feed(&parser, NULL, 0U);
+    }
+
+    return result;
+}
+
+void test_feed_errors(void)
+{
+    char         buf[8];
+    OkJsonParser parser;
+    OkjFeed      feed;
+
+    /* The same errors as okj_parse(), wherever the input is cut. */
+    assert(feed_split("{\"a\": \"\\q\"}", 8U, 1U) == OKJ_ERROR_BAD_STRING);
+    assert(feed_split("[1, 2,]", 6U, 1U) == OKJ_ERROR_SYNTAX);
+    assert(feed_split("[01]", 2U, 1U) == OKJ_ERROR_BAD_NUMBER);
+    assert(feed_split("[tr", 2U, 0U) == OKJ_NEED_MORE_DATA);
+    assert(feed_split("[tr ]", 2U, 1U) == OKJ_ERROR_SYNTAX);
+    assert(feed_split("{\"a\": [1}", 4U, 1U) == OKJ_ERROR_BRACKET_MISMATCH);
+    assert(feed_split("{} x", 2U, 1U) == OKJ_ERROR_SYNTAX);
+
+    /* Truncation is only an error once the end of input is announced. */
+    assert(feed_split("{\"a\": [1, 2", 5U, 0U) == OKJ_NEED_MORE_DATA);
+    assert(feed_split("{\"a\": [1, 2", 5U, 1U) == OKJ_ERROR_UNEXPECTED_END);
+    assert(feed_split("   ", 1U, 1U) == OKJ_ERROR_UNEXPECTED_END);
+
+    /* Errors and the end of input are final. */
+    okj_init(&parser, buf, 0U);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, "[1]]", 4U) == OKJ_ERROR_SYNTAX);
+    assert(okj_feed(&parser, " ", 1U) == OKJ_ERROR_SYNTAX);
+
+    okj_init(&parser, buf, 0U);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, "[1,", 3U) == OKJ_NEED_MORE_DATA);
+    assert(okj_feed(&parser, "2,3,4,5]", 8U) == OKJ_ERROR_NO_FREE_SPACE);
+    assert(okj_feed(&parser, "2]", 2U) == OKJ_ERROR_NO_FREE_SPACE);
+
+    okj_init(&parser, buf, 0U);
+    assert(okj_feed(&parser, "1", 1U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_feed_attach(&parser, NULL, 8U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_feed_attach(&parser, &feed, (OkjSize)sizeof(buf)) == OKJ_SUCCESS);
+    assert(okj_feed(&parser, NULL, 1U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_feed(NULL, "1", 1U) == OKJ_ERROR_BAD_POINTER);
+
+    okj_init(&parser, buf, 8U);
+    assert(okj_feed_attach(&parser, &feed, 4U) == OKJ_ERROR_NO_FREE_SPACE);
+
+    printf("test_feed_errors passed!\n");
+}
+
+void test_lines_parse_each_record_with_one_parser(void)
+{
+    static char  buf[] = "{\"id\": 1, \"msg\": \"up\"}\r\n"
+                         "\n"
+                         "  \t\n"
+                         "{\"id\": 2, \"msg\": }\n"
+                         "[1, 2, 3]\n"
+                         "{\"id\": 3, \"msg\": \"down\"}";
+    OkJsonParser parser;
+    OkjLines     lines;
+    OkjRecord    rec;
+    OkJsonNumber num;
+    OkJsonString str;
+
+    okj_init(&parser, buf, 0U);
+    assert(okj_lines_init(&lines, buf, (OkjSize)(sizeof(buf) - 1U)) == OKJ_SUCCESS);
+
+    /* "\r\n" is not part of the record; the tokens point into buf. */
+    assert(okj_lines_next(&parser, &lines, &rec) == 1U);
+    assert((rec.offset == 0U) && (rec.length == 22U) && (rec.status == OKJ_SUCCESS));
+    assert(okj_get_number(&parser, "id", 2U, &num) == OKJ_SUCCESS);
+    assert((num.length == 1U) && (num.start == &buf[7]));
+
+    /* Blank lines are skipped; a malformed record does not stop the rest. */
+    assert(okj_lines_next(&parser, &lines, &rec) == 1U);
+    assert((rec.offset == 29U) && (rec.length == 18U) && (rec.status == OKJ_ERROR_SYNTAX));
+
+    assert(okj_lines_next(&parser, &lines, &rec) == 1U);
+    assert((rec.offset == 48U) && (rec.length == 9U) && (rec.status == OKJ_SUCCESS));
+    assert(parser.token_count == 4U);
+
+    /* The last line needs no line feed. */
+    assert(okj_lines_next(&parser, &lines, &rec) == 1U);
+    assert((rec.offset == 58U) && (rec.length == 24U) && (rec.status == OKJ_SUCCESS));
+    assert(okj_get_string(&parser, "msg", 3U, &str) == OKJ_SUCCESS);
+    assert((str.length == 4U) && (memcmp(str.start, "down", 4U) == 0));
+
+    assert(okj_lines_next(&parser, &lines, &rec) == 0U);
+    assert(okj_lines_next(&parser, &lines, &rec) == 0U);
+
+    printf("test_lines_parse_each_record_with_one_parser passed!\n");
+}
+
+void test_reset_matches_init(void)
+{
+    char          big[]   = "{\"a\": [1, {\"b\": [true, null]}, \"x\"], \"c\": {\"d\": 2}}";
+    char          small[] = "[\"k\", {\"v\": false}]";
+    OkJsonToken   buf_tokens[32];
+    OkjDepthFrame buf_depth[4];
+    OkJsonParser  reused;
+    OkJsonParser  fresh;
+    OkjSize       i;
+
+    okj_init_ex(&reused, big, (OkjSize)strlen(big), buf_tokens, 32U, buf_depth, 4U);
+    assert(okj_parse(&reused) == OKJ_SUCCESS);
+
+    /* The caller buffers stay; the stale tokens beyond the new count are
+     * never reported. */
+    assert(okj_reset(&reused, small, (OkjSize)strlen(small)) == OKJ_SUCCESS);
+    assert((reused.token_buf == buf_tokens) && (reused.token_capacity == 32U));
+    assert(okj_parse(&reused) == OKJ_SUCCESS);
+
+    okj_init(&fresh, small, (OkjSize)strlen(small));
+    assert(okj_parse(&fresh) == OKJ_SUCCESS);
+
+    assert(reused.token_count == fresh.token_count);
+    for (i = 0U; i < fresh.token_count; i++)
+    {
+        assert(okj_tok_type(&reused, i) == okj_tok_type(&fresh, i));
+        assert(okj_tok_start(&reused, i) == okj_tok_start(&fresh, i));
+        assert(okj_tok_length(&reused, i) == okj_tok_length(&fresh, i));
+        assert(okj_tok_end(&reused, i) == okj_tok_end(&fresh, i));
+        assert(okj_tok_count(&reused, i) == okj_tok_count(&fresh, i));
+    }
+    assert(okj_count_objects(&reused) == 1U);
+
+    /* A failed parse leaves nothing behind for the next document. */
+    assert(okj_reset(&reused, big, 9U) == OKJ_SUCCESS);
+    assert(okj_parse(&reused) == OKJ_ERROR_UNEXPECTED_END);
+    assert(okj_reset(&reused, small, (OkjSize)strlen(small)) == OKJ_SUCCESS);
+    assert(okj_parse(&reused) == OKJ_SUCCESS);
+    assert(reused.token_count == fresh.token_count);
+
+    assert(okj_reset(NULL, small, 1U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_reset(&reused, NULL, 1U) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_reset_matches_init passed!\n");
+}
+
+void test_parse_lines_fills_records(void)
+{
+    static char  buf[] = "{\"n\": 1}\n[]\n\"s\"\ntru\n\n42\n";
+    OkJsonParser parser;
+    OkjRecord    records[8];
+    OkjSize      count = 0U;
+
+    okj_init(&parser, buf, 0U);
+    assert(okj_parse_lines(&parser, buf, (OkjSize)(sizeof(buf) - 1U), records, 8U, &count) == OKJ_SUCCESS);
+    assert(count == 5U);
+    assert((records[0].offset == 0U) && (records[0].length == 8U) && (records[0].status == OKJ_SUCCESS));
+    assert((records[1].offset == 9U) && (records[1].length == 2U) && (records[1].status == OKJ_SUCCESS));
+    assert((records[2].offset == 12U) && (records[2].status == OKJ_SUCCESS));
+    assert((records[3].offset == 16U) && (records[3].status != OKJ_SUCCESS));
+    assert((records[4].offset == 21U) && (records[4].length == 2U) && (records[4].status == OKJ_SUCCESS));
+
+    /* The first `capacity` records are reported when there are more. */
+    assert(okj_parse_lines(&parser, buf, (OkjSize)(sizeof(buf) - 1U), records, 5U, &count) == OKJ_SUCCESS);
+    assert(count == 5U);
+    assert(okj_parse_lines(&parser, buf, (OkjSize)(sizeof(buf) - 1U), records, 2U, &count) == OKJ_ERROR_NO_FREE_SPACE);
+    assert((count == 2U) && (records[1].offset == 9U));
+
+    assert(okj_parse_lines(&parser, buf, 0U, records, 8U, &count) == OKJ_SUCCESS);
+    assert(count == 0U);
+    assert(okj_parse_lines(&parser, "\n \n", 3U, records, 8U, &count) == OKJ_SUCCESS);
+    assert(count == 0U);
+
+    assert(okj_parse_lines(NULL, buf, 4U, records, 8U, &count) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_parse_lines(&parser, buf, 4U, NULL, 8U, &count) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_parse_lines(&parser, buf, 4U, records, 8U, NULL) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_lines_init(NULL, buf, 4U) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_lines_next(&parser, NULL, &records[0]) == 0U);
+
+    printf("test_parse_lines_fills_records passed!\n");
+}
+
+typedef struct
+{
+    char     log[512];
+    uint16_t used;
+    uint16_t events;
+    uint16_t stop_after;
+} EventLog;
+
+static OkjError record_event(void *user, const OkjEvent *event)
+{
+    static const char kinds[] = "{}[]ksnbz";
+    EventLog *log    = (EventLog *)user;
+    OkjError  result = OKJ_SUCCESS;
+    int       written;
+
+    written = snprintf(&log->log[log->used], sizeof(log->log) - log->used, "%c%u:%.*s ",
+                       kinds[event->type], (unsigned int)event->depth,
+                       (int)event->length, event->start);
+    log->used = (uint16_t)(log->used + (uint16_t)written);
+    log->events++;
+
+    if ((log->stop_after != 0U) && (log->events == log->stop_after))
+    {
+        result = OKJ_ERROR_NO_FREE_SPACE;
+    }
+
+    return result;
+}
+
+void test_events_report_values_in_order(void)
+{
+    const char *json = "{\"a\": [1, -2.5e3, \"x\\ny\"], \"b\": {\"t\": true, \"f\": false}, \"n\": null, \"e\": []}";
+    EventLog    log;
+
+    memset(&log, 0, sizeof(log));
+    assert(okj_parse_events(json, (OkjSize)strlen(json), record_event, &log) == OKJ_SUCCESS);
+
+    /* Strings without quotes or decoding; END events span the container. */
+    assert(strcmp(log.log,
+                  "{0:{ k1:a [1:[ n2:1 n2:-2.5e3 s2:x\\ny ]1:[1, -2.5e3, \"x\\ny\"] "
+                  "k1:b {1:{ k2:t b2:true k2:f b2:false }1:{\"t\": true, \"f\": false} "
+                  "k1:n z1:null k1:e [1:[ ]1:[] "
+                  "}0:{\"a\": [1, -2.5e3, \"x\\ny\"], \"b\": {\"t\": true, \"f\": false}, \"n\": null, \"e\": []} ") == 0);
+
+    /* A top-level scalar is a single event. */
+    memset(&log, 0, sizeof(log));
+    assert(okj_parse_events(" \"s\" ", 5U, record_event, &log) == OKJ_SUCCESS);
+    assert(strcmp(log.log, "s0:s ") == 0);
+
+    printf("test_events_report_values_in_order passed!\n");
+}
+
+static OkjError count_numbers(void *user, const OkjEvent *event)
+{
+    if (event->type == OKJ_EVENT_NUMBER)
+    {
+        (*(okj_u32 *)user)++;
+    }
+
+    return OKJ_SUCCESS;
+}
+
+void test_events_have_no_token_limit(void)
+{
+    static char  json[2048];
+    OkJsonParser parser;
+    okj_u32      numbers = 0U;
+    OkjSize      len     = 0U;
+    uint16_t     i;
+
+    /* Far more values than OKJ_MAX_TOKENS. */
+    json[len++] = '[';
+    for (i = 0U; i < 500U; i++)
+    {
+        json[len++] = (char)('0' + (i % 10U));
+        json[len++] = ',';
+    }
+    json[len - 1U] = ']';
+
+    okj_init(&parser, json, len);
+    assert(okj_parse(&parser) == OKJ_ERROR_MAX_TOKENS_EXCEEDED);
+    assert(okj_parse_events(json, len, count_numbers, &numbers) == OKJ_SUCCESS);
+    assert(numbers == 500U);
+
+    /* Nesting is still bounded by OKJ_MAX_DEPTH. */
+    len = 0U;
+    for (i = 0U; i <= OKJ_MAX_DEPTH; i++)
+    {
+        json[len++] = '[';
+    }
+    for (i = 0U; i <= OKJ_MAX_DEPTH; i++)
+    {
+        json[len++] = ']';
+    }
+    assert(okj_parse_events(json, len, count_numbers, &numbers) == OKJ_ERROR_MAX_DEPTH_EXCEEDED);
+    assert(okj_parse_events(&json[1], (OkjSize)(len - 2U), count_numbers, &numbers) == OKJ_SUCCESS);
+
+    printf("test_events_have_no_token_limit passed!\n");
+}
+
+void test_events_errors_and_early_stop(void)
+{
+    const char *json = "{\"a\": 1, \"b\": [true, nul]}";
+    EventLog    log;
+
+    /* Events before the error have been delivered; the code is
+     * okj_validate()'s. */
+    memset(&log, 0, sizeof(log));
+    assert(okj_parse_events(json, (OkjSize)strlen(json), record_event, &log) == okj_validate(json, (OkjSize)strlen(json)));
+    assert(strcmp(log.log, "{0:{ k1:a n1:1 k1:b [1:[ b2:true ") == 0);
+
+    memset(&log, 0, sizeof(log));
+    assert(okj_parse_events("[1, 2] 3", 8U, record_event, &log) == OKJ_ERROR_SYNTAX);
+    assert(okj_parse_events("[1, 2}", 6U, record_event, &log) == OKJ_ERROR_BRACKET_MISMATCH);
+    assert(okj_parse_events("   ", 3U, record_event, &log) == OKJ_ERROR_UNEXPECTED_END);
+
+    /* A callback result other than OKJ_SUCCESS ends the parse. */
+    memset(&log, 0, sizeof(log));
+    log.stop_after = 3U;
+    assert(okj_parse_events("[1, 2, 3, 4]", 12U, record_event, &log) == OKJ_ERROR_NO_FREE_SPACE);
+    assert((log.events == 3U) && (strcmp(log.log, "[0:[ n1:1 n1:2 ") == 0));
+
+    assert(okj_parse_events(NULL, 2U, record_event, &log) == OKJ_ERROR_BAD_POINTER);
+    assert(okj_parse_events("[]", 2U, NULL, &log) == OKJ_ERROR_BAD_POINTER);
+
+    printf("test_events_errors_and_early_stop passed!\n");
+}
+
 int main(int argc, char* argv[])
 {
     (void)argc;
@@ -5354,8 +8522,10 @@ int main(int argc, char* argv[])
     test_key_exactly_64_chars();
     test_key_65_chars_error();
     test_deeply_nested_at_limit();
+#ifndef OK_JSON_LARGE_DOCS
     test_max_json_len_exceeded();
     test_max_json_len_boundary();
+#endif
     test_parse_null_parser();
     test_null_pointer_safety();
     test_truncated_backslash_at_eof();
@@ -5493,6 +8663,131 @@ int main(int argc, char* argv[])
     test_oob_utf8_exhaustive_lead_sweep();
     test_oob_keyword_truncated_no_padding();
 
+    /* SWAR whitespace skipping in okj_skip_whitespace() */
+    test_skip_whitespace_swar_run_lengths();
+    test_skip_whitespace_swar_all_whitespace();
+    test_skip_whitespace_swar_near_miss_bytes();
+    test_swar_first_byte_each_lane();
+    test_parse_indented_document();
+
+    /* Bulk string-body scanning in okj_scan_string_run() */
+    test_scan_string_run_special_each_offset();
+    test_scan_string_run_non_ascii_flag();
+    test_parse_long_strings_bulk_scanned();
+
+    /* Table-driven UTF-8 DFA and okj_validate_utf8_block() */
+    test_validate_utf8_block_ascii_and_multibyte();
+    test_validate_utf8_block_bounds();
+    test_utf8_dfa_matches_rfc3629_table();
+
+    /* Table-driven dispatch in okj_parse_value() */
+    test_char_class_table();
+    test_grammar_action_table();
+    test_parse_literal_prefix_is_syntax_error();
+
+    /* Container extent recorded on close in okj_parse_value() */
+    test_container_extent_recorded_on_close();
+    test_container_extent_matches_rescan();
+    test_container_getters_use_recorded_extent();
+    test_container_extent_unclosed_fallback();
+
+    /* Token accessors and the OK_JSON_COMPACT_TOKENS tape */
+    test_token_at_copies_tokens();
+    test_token_at_bad_args();
+    test_token_tape_size();
+
+    /* Caller-owned storage via okj_init_ex() */
+    test_init_ex_bad_args();
+    test_init_ex_small_buffers_enforced();
+    test_init_ex_large_buffers();
+
+    /* Large-document mode (OK_JSON_LARGE_DOCS) */
+    test_size_type_width();
+    test_large_docs_past_64k();
+
+    /* Scoped member lookup via okj_find_member() */
+    test_find_member_scoped();
+    test_find_member_skips_containers();
+    test_find_member_bad_args();
+
+    /* Key hash index via okj_hash_attach() */
+    test_hash_matches_scan();
+    test_hash_build_timing();
+    test_hash_too_small_falls_back();
+    test_hash_attach_bad_args();
+
+    /* Batch lookups via okj_get_many() */
+    test_get_many_resolves_batch();
+    test_get_many_first_match_and_hash();
+    test_get_many_spans_several_passes();
+    test_get_many_bad_args();
+
+    /* Prepared key handles */
+    test_key_handle_init();
+    test_key_getters_match_raw_keys();
+    test_key_getters_bad_args();
+
+    /* Key interning */
+    test_key_ids_tagged_during_parse();
+    test_key_ids_reset_between_parses();
+    test_key_ids_bad_args();
+
+    /* JSON Pointer (RFC 6901) */
+    test_pointer_rfc6901_examples();
+    test_pointer_nested_paths();
+    test_pointer_compile_errors();
+
+    /* Indexed array element access */
+    test_array_at_flat_and_nested();
+    test_array_at_empty_and_open();
+    test_array_offsets_table();
+
+    /* Child iterators */
+    test_iter_object_members();
+    test_iter_array_elements();
+    test_iter_skips_nested_subtrees();
+    test_iter_bad_args();
+
+    /* Cursor lookups */
+    test_cursor_in_order_and_wrap();
+    test_cursor_matches_getters();
+    test_cursor_bad_args();
+
+    /* JSONPath queries */
+    test_path_child_index_wildcard();
+    test_path_recursive_and_filters();
+    test_path_errors();
+
+    /* Parse-time query pushdown */
+    test_select_keeps_requested_fields();
+    test_select_subtrees_and_recursion();
+    test_select_validates_and_errors();
+
+    /* On-demand document access */
+    test_doc_reads_fields_without_tokens();
+    test_doc_iterate_and_find_in_order();
+    test_doc_errors();
+
+    /* Token-free validation */
+    test_validate_matches_parse();
+    test_validate_has_no_token_limit();
+    test_validate_depth_and_errors();
+
+    /* Incremental input */
+    test_feed_byte_at_a_time_matches_parse();
+    test_feed_in_place_and_top_level_scalars();
+    test_feed_errors();
+
+    /* Newline-delimited records */
+    test_lines_parse_each_record_with_one_parser();
+    test_reset_matches_init();
+    test_parse_lines_fills_records();
+
+    /* Event callbacks */
+    test_events_report_values_in_order();
+    test_events_have_no_token_limit();
+    test_events_errors_and_early_stop();
+
     printf("All OK_JSON tests passed!\n");
 
     return 0;